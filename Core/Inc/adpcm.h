@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+  * @file           : adpcm.h
+  * @brief          : IMA-ADPCM (4-bit) Encoder/Decoder
+  * @details        : Compressed audio transport for SPI data packets
+  *                   4 bits per sample = 1/4 of the 16-bit PCM bandwidth
+  ******************************************************************************
+  * @attention
+  *
+  * Codec: standard IMA/DVI ADPCM (89-entry step table)
+  * - Nibble order: low nibble = first sample, high nibble = second sample
+  * - PCM domain: signed 16-bit (predictor)
+  * - Wire domain: unsigned 16-bit offset-binary (0x8000 = mid-scale),
+  *   identical to the 0xDA data packet samples
+  *
+  * This module has no HAL dependency so the encoder can be built on the host
+  * (Master firmware / PC tools) from the same source.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ADPCM_H
+#define __ADPCM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ============================================================================ */
+/* Codec State */
+/* ============================================================================ */
+
+/**
+ * @brief ADPCM codec state (predictor + step index)
+ * @note  Each ADPCM data packet carries its initial state in the header,
+ *        so a lost packet never desynchronizes the following ones
+ */
+typedef struct {
+    int16_t predictor;          // Last decoded sample (signed PCM)
+    uint8_t step_index;         // Index into step table (0~88)
+} AdpcmState_t;
+
+#define ADPCM_STEP_INDEX_MAX    88
+
+/**
+ * @brief Encoded payload size in bytes for a given sample count
+ */
+#define ADPCM_PAYLOAD_BYTES(samples)    (((uint32_t)(samples) + 1) / 2)
+
+/* ============================================================================ */
+/* Tables (shared by inline decoder) */
+/* ============================================================================ */
+
+extern const int16_t adpcm_step_table[ADPCM_STEP_INDEX_MAX + 1];
+extern const int8_t  adpcm_index_table[16];
+
+/* ============================================================================ */
+/* Inline Decoder */
+/* ============================================================================ */
+
+/**
+ * @brief Decode one 4-bit code
+ * @param st Codec state (updated)
+ * @param code 4-bit ADPCM code (upper bits ignored)
+ * @return Decoded signed 16-bit PCM sample
+ * @note  Inlined into the audio fill path - keep branch-light
+ */
+static inline __attribute__((always_inline))
+int16_t adpcm_decode_sample(AdpcmState_t *st, uint8_t code)
+{
+    int32_t step = adpcm_step_table[st->step_index];
+    int32_t diff = step >> 3;
+
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+
+    int32_t pred = st->predictor;
+    pred = (code & 8) ? (pred - diff) : (pred + diff);
+
+    // Clamp to int16 range
+    if (pred > 32767)  pred = 32767;
+    if (pred < -32768) pred = -32768;
+    st->predictor = (int16_t)pred;
+
+    int32_t index = (int32_t)st->step_index + adpcm_index_table[code & 0x0F];
+    if (index < 0) index = 0;
+    if (index > ADPCM_STEP_INDEX_MAX) index = ADPCM_STEP_INDEX_MAX;
+    st->step_index = (uint8_t)index;
+
+    return st->predictor;
+}
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Reset codec state (predictor=0, step_index=0)
+ * @param st Codec state
+ */
+void adpcm_init(AdpcmState_t *st);
+
+/**
+ * @brief Encode offset-binary 16-bit samples to 4-bit ADPCM
+ * @param st Codec state (updated - pass the same state for consecutive blocks)
+ * @param samples Input samples (unsigned 16-bit, 0x8000 = mid-scale)
+ * @param count Number of samples
+ * @param out Output buffer (must be ADPCM_PAYLOAD_BYTES(count) bytes)
+ * @return Number of bytes written
+ */
+uint32_t adpcm_encode(AdpcmState_t *st, const uint16_t *samples, uint32_t count, uint8_t *out);
+
+/**
+ * @brief Decode 4-bit ADPCM to offset-binary 16-bit samples
+ * @param st Codec state (updated)
+ * @param in Encoded data (ADPCM_PAYLOAD_BYTES(count) bytes)
+ * @param count Number of samples to decode
+ * @param samples Output samples (unsigned 16-bit, 0x8000 = mid-scale)
+ * @return Number of samples decoded
+ */
+uint32_t adpcm_decode(AdpcmState_t *st, const uint8_t *in, uint32_t count, uint16_t *samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADPCM_H */
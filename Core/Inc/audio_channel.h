@@ -13,6 +13,50 @@
   * - Resolution: 12-bit DAC (converted from 16-bit samples)
   * - Channels: 2 independent channels (DAC1, DAC2)
   *
+  * Data Flow:
+  *   SPI fill -> A/B buffers (signed 16-bit PCM, staging)
+  *               (or tone generator, CMD_TONE / cached clip, CMD_CLIP_PLAY -
+  *                A/B buffers bypassed)
+  *            -> render (per 32-sample block, DMA half-transfer IRQ):
+  *               voice mixer (audio_mixer, clips / tones over the source)
+  *               -> gain -> DSP chain (audio_dsp, optional)
+  *               -> 2x/4x half-band upsampler (oversampling mode)
+  *               -> 12-bit quantizer (truncate, or TPDF dither with optional
+  *                  1st/2nd order noise shaping)
+  *            -> DAC output ring
+  * - Fade in/out and volume gain are applied in render, the kernel is
+  *   selected once per block (unity / constant / ramp / silence) - no
+  *   per-sample branches
+  * - Gain changes are linearly interpolated across each block, so a volume
+  *   change is heard within 1 ms (not after the buffered 128 ms)
+  *
+  * A/B hand-off (fill in CS EXTI, render in DAC DMA IRQ, which preempts):
+  * - Every field has one writer. Producer (audio_channel_fill*): fill_index,
+  *   fill_seq, fill_epoch, flush_ack. Consumer (render / swap / reset):
+  *   play_seq, play_index, flush_req
+  * - Buffer slot of a sequence number: even = A, odd = B. Render plays
+  *   slot(play_seq), the producer fills slot(fill_seq + 1) while
+  *   fill_seq == play_seq
+  * - A full fill buffer is published with a release store of fill_seq + 1,
+  *   render takes it with a release store of play_seq + 1 - the samples
+  *   are complete before the index moves, and neither side waits
+  * - fill_index is stored (release) after the samples it covers, and goes
+  *   back to 0 only after the new fill_seq - a live read that sees 0
+  *   finds the published buffer on the swap check that follows
+  * - Reset drops the producer's partial buffer through flush_req / flush_ack
+  *   (a buffer published across a reset is played as silence)
+  * - Consumer-side calls from other contexts (CMD_PLAY swap, CMD_RESET)
+  *   run with render locked out (audio_lock) or stopped
+  *
+  * Underrun (active buffer played out, fill buffer not yet full):
+  * - Render keeps reading the fill buffer up to the producer's fill_index
+  *   (live_index), so late data is played as soon as it arrives - the swap
+  *   then continues from the same position
+  * - With no data at all the gap is concealed (CMD_CONCEAL): fade to
+  *   silence, hold the last sample, or loop the last 8 ms with crossfaded
+  *   seams (fading out after 32 ms). Returning data is crossfaded in
+  * - Underruns are counted and measured in samples (total, longest)
+  *
   ******************************************************************************
   */
 
@@ -25,35 +69,197 @@ extern "C" {
 
 #include <stdint.h>
 #include "spi_protocol.h"
+#include "adpcm.h"
+#include "audio_dsp.h"
+#include "audio_gen.h"
+#include "clip_cache.h"
+#include "audio_mixer.h"
+#include "audio_jitter.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief DAC sample rate (TIM1/TIM7 update rate)
+ */
+#define AUDIO_SAMPLE_RATE       32000
+
+/**
+ * @brief Render block size (samples)
+ * @note  32 samples @ 32kHz = 1ms, must divide AUDIO_BUFFER_SIZE
+ */
+#define AUDIO_BLOCK_SIZE        32
+
+/**
+ * @brief Maximum DAC oversampling factor (1, 2 or 4)
+ * @note  A/B buffers stay at 32kHz - only the output ring grows
+ */
+#define AUDIO_OVERSAMPLE_MAX    4
+
+/**
+ * @brief Default fade in/out time (ms), 0 = hard start/stop
+ */
+#define AUDIO_FADE_DEFAULT_MS   5
+
+/**
+ * @brief Default volume ramp time (ms), 0 = step change
+ */
+#define AUDIO_VOLUME_RAMP_DEFAULT_MS    20
+
+/**
+ * @brief Gain format (Q30, 1 << 30 = unity)
+ */
+#define AUDIO_FADE_UNITY        (1L << 30)
+
+/**
+ * @brief 16 -> 12-bit quantizer modes (CMD_DITHER)
+ */
+#define AUDIO_DITHER_OFF        0       // Truncate (>> 4)
+#define AUDIO_DITHER_TPDF       1       // TPDF dither, +/-1 LSB (12-bit)
+#define AUDIO_DITHER_NS1        2       // TPDF + 1st order noise shaping
+#define AUDIO_DITHER_NS2        3       // TPDF + 2nd order noise shaping
+#define AUDIO_DITHER_MAX        AUDIO_DITHER_NS2
+
+/**
+ * @brief Underrun concealment modes (CMD_CONCEAL)
+ */
+#define AUDIO_CONCEAL_SILENCE   0       // Fade the last sample to silence
+#define AUDIO_CONCEAL_HOLD      1       // Hold the last sample
+#define AUDIO_CONCEAL_REPEAT    2       // Loop the last segment, then fade
+#define AUDIO_CONCEAL_MAX       AUDIO_CONCEAL_REPEAT
+
+/**
+ * @brief Concealment timing (samples @ 32kHz)
+ */
+#define AUDIO_CONCEAL_FADE          32      // Fade / seam / resume crossfade (1 ms)
+#define AUDIO_CONCEAL_SEGMENT       256     // Repeat segment (8 ms)
+#define AUDIO_CONCEAL_REPEAT_MAX    (AUDIO_CONCEAL_SEGMENT * 4)    // Then fade out
+
+/**
+ * @brief audio_channel_render() result flags
+ */
+#define AUDIO_RENDER_SWAPPED    0x01    // Buffers swapped (fill buffer free again)
+#define AUDIO_RENDER_UNDERRUN   0x02    // Concealment started (no stream data)
+#define AUDIO_RENDER_FADED_OUT  0x04    // Fade-out ramp reached zero
+#define AUDIO_RENDER_SOURCE_END 0x08    // One-shot clip played out (stop channel)
+#define AUDIO_RENDER_NEED_DATA  0x10    // Depth dropped below the jitter target (RDY)
 
 /* ============================================================================ */
 /* Audio Channel Structure */
 /* ============================================================================ */
 
+/**
+ * @brief Linear gain ramp (fade, volume)
+ */
+typedef struct {
+    int32_t gain;               // Current gain (Q30)
+    int32_t step;               // Gain increment per sample (Q30)
+    int32_t target;             // Gain at end of ramp (Q30)
+    uint16_t remaining;         // Samples left in ramp (0 = steady)
+    uint16_t samples;           // Configured ramp length (samples)
+} AudioRamp_t;
+
+/**
+ * @brief Underrun concealment state (consumer side)
+ */
+typedef struct {
+    uint8_t mode;               // AUDIO_CONCEAL_xxx
+    uint8_t active;             // Concealing (no stream data)
+    uint8_t resume;             // Crossfade samples left after data returned
+    int16_t last;               // Last output sample (stream or concealed)
+    int16_t from;               // Fade start value
+    uint16_t pos;               // Position in fade / repeat segment
+    uint32_t run;               // Samples concealed in this underrun
+    int16_t segment[AUDIO_CONCEAL_SEGMENT];    // Last stream samples (repeat)
+} AudioConceal_t;
+
 /**
  * @brief Audio Channel State
  */
 typedef struct {
     // Double buffers
-    uint16_t *buffer_a;         // Buffer A (2048 samples, 12-bit DAC values)
-    uint16_t *buffer_b;         // Buffer B (2048 samples, 12-bit DAC values)
+    int16_t *buffer_a;          // Buffer A (2048 samples, signed 16-bit PCM)
+    int16_t *buffer_b;          // Buffer B (2048 samples, signed 16-bit PCM)
 
-    // Buffer management
-    uint16_t *active_buffer;    // Currently being output by DAC DMA
-    uint16_t *fill_buffer;      // Currently being filled from SPI
+    // Buffer hand-off, producer side (SPI fill)
+    uint32_t fill_seq;          // Buffers published (fill buffer = slot fill_seq + 1)
+    uint32_t fill_epoch;        // flush_ack at the last publish
+    uint32_t flush_ack;         // Last flush_req seen
     uint16_t fill_index;        // Current fill position (0~2047)
 
+    // Buffer hand-off, consumer side (render)
+    uint32_t play_seq;          // Buffers taken (active buffer = slot play_seq)
+    uint32_t flush_req;         // Incremented by reset (drop partial fill)
+    uint16_t play_index;        // Current render position in active buffer
+    uint16_t live_index;        // Render position in the fill buffer (underrun)
+
+    // Underrun concealment
+    AudioConceal_t conceal;
+
+    // Queued depth statistics / target (sampled per render call)
+    AudioJitter_t jitter;
+
+    // Gain ramps (applied in render)
+    AudioRamp_t fade;           // Fade in/out
+    AudioRamp_t vol;            // Volume (follows CMD_VOLUME)
+
+    // Output DSP chain (EQ, DC blocker, limiter)
+    AudioDsp_t dsp;
+
+    // Tone / noise generator (render source while active)
+    AudioGen_t gen;
+
+    // Cached clip player (render source while active, tone has priority)
+    ClipVoice_t clip;
+
+    // Extra voices mixed over the source (CMD_CLIP_PLAY / CMD_TONE mix flag)
+    AudioMixer_t mixer;
+
+    // Oversampling (set by audio_output, applies to both channels)
+    uint8_t oversample;         // 1, 2 or 4
+    AudioUpsampler_t upsampler;
+
+    // 12-bit quantizer
+    uint8_t dither;             // AUDIO_DITHER_xxx
+    uint32_t dither_seed;       // PRNG state (xorshift32, never 0)
+    int32_t ns_err[2];          // Quantization error history (e[n-1], e[n-2])
+
     // Playback state
-    uint8_t is_playing;         // 0=stopped, 1=playing
+    volatile uint8_t is_playing;    // 0=stopped, 1=playing
     uint8_t underrun;           // Buffer underrun flag
-    uint8_t volume;             // Volume level (0-100)
+    uint8_t volume;             // Volume level (0-100), target of vol ramp
 
     // Statistics
     uint32_t total_samples;     // Total samples received
     uint32_t buffer_swaps;      // Number of buffer swaps
     uint32_t underrun_count;    // Number of underruns detected
+    uint32_t underrun_samples;  // Samples concealed (total)
+    uint32_t underrun_max;      // Longest underrun (samples)
 } AudioChannel_t;
 
+/* ============================================================================ */
+/* Buffer Slots */
+/* ============================================================================ */
+
+/**
+ * @brief A/B buffer of a sequence number (even = A, odd = B)
+ */
+static inline __attribute__((always_inline))
+int16_t *audio_channel_slot(const AudioChannel_t *ch, uint32_t seq)
+{
+    return (seq & 1) ? ch->buffer_b : ch->buffer_a;
+}
+
+/**
+ * @brief Buffer currently rendered (consumer side)
+ */
+static inline __attribute__((always_inline))
+int16_t *audio_channel_active(const AudioChannel_t *ch)
+{
+    return audio_channel_slot(ch, ch->play_seq);
+}
+
 /* ============================================================================ */
 /* Function Prototypes */
 /* ============================================================================ */
@@ -64,28 +270,155 @@ typedef struct {
  * @param buf_a Pointer to buffer A (must be 2048 * 2 bytes)
  * @param buf_b Pointer to buffer B (must be 2048 * 2 bytes)
  */
-void audio_channel_init(AudioChannel_t *ch, uint16_t *buf_a, uint16_t *buf_b);
+void audio_channel_init(AudioChannel_t *ch, int16_t *buf_a, int16_t *buf_b);
 
 /**
  * @brief Fill audio channel buffer with samples
  * @param ch Pointer to AudioChannel_t structure
  * @param samples Pointer to 16-bit samples (little-endian)
  * @param count Number of samples to fill
- * @note  Automatically converts 16-bit samples to 12-bit DAC values
- *        Applies volume scaling
+ * @note  Converts unsigned 16-bit samples to signed PCM
  *        Stops filling when buffer is full
  * @return Number of samples actually filled
  */
 uint16_t audio_channel_fill(AudioChannel_t *ch, uint16_t *samples, uint16_t count);
 
+/**
+ * @brief Fill audio channel buffer from a packed data packet payload
+ * @param ch Pointer to AudioChannel_t structure
+ * @param format Sample format (SAMPLE_FORMAT_16BIT / 12BIT / 8BIT)
+ * @param data Pointer to payload bytes (DATA_PAYLOAD_BYTES(format, count))
+ * @param count Number of samples to fill
+ * @note  Each format has its own unpacking kernel writing straight
+ *        into the PCM buffer.
+ *        Stops filling when buffer is full
+ * @return Number of samples actually filled (0 for unknown format)
+ */
+uint16_t audio_channel_fill_packed(AudioChannel_t *ch, uint8_t format,
+                                   const uint8_t *data, uint16_t count);
+
+/**
+ * @brief Unpack a packed payload into signed 16-bit PCM
+ * @param dst Destination (count samples)
+ * @param format Sample format (SAMPLE_FORMAT_16BIT / 12BIT / 8BIT)
+ * @param data Pointer to payload bytes (DATA_PAYLOAD_BYTES(format, count))
+ * @param count Number of samples
+ * @note  Shared by the channel fill path and the clip cache upload
+ * @return 0 on success, 1 for unknown format
+ */
+uint8_t audio_channel_unpack(int16_t *dst, uint8_t format, const uint8_t *data, uint16_t count);
+
+/**
+ * @brief Decode IMA-ADPCM data into audio channel buffer
+ * @param ch Pointer to AudioChannel_t structure
+ * @param state ADPCM decoder state (initialized from packet header, updated)
+ * @param data Pointer to 4-bit codes (low nibble first)
+ * @param count Number of samples to decode
+ * @note  Decodes directly into the fill buffer (no intermediate buffer)
+ *        Stops decoding when buffer is full
+ * @return Number of samples actually filled
+ */
+uint16_t audio_channel_fill_adpcm(AudioChannel_t *ch, AdpcmState_t *state,
+                                  const uint8_t *data, uint16_t count);
+
 /**
  * @brief Swap active and fill buffers
  * @param ch Pointer to AudioChannel_t structure
- * @note  Call this from DMA complete callback when fill buffer is ready
+ * @note  Consumer side - called by render at the end of the active buffer
+ *        (and by PLAY, render locked out)
  * @return 1 if swap successful, 0 if fill buffer not ready
  */
 uint8_t audio_channel_swap_buffers(AudioChannel_t *ch);
 
+/**
+ * @brief Render samples from the active buffer to 12-bit DAC values
+ * @param ch Pointer to AudioChannel_t structure
+ * @param out Output (DAC ring half, 12-bit right aligned),
+ *            count * oversample values
+ * @param count Number of 32kHz samples (normally AUDIO_BLOCK_SIZE)
+ * @note  Called from DAC DMA half/complete IRQ
+ *        Swaps buffers at the end of the active buffer if fill buffer is full,
+ *        otherwise plays the fill buffer as far as written and conceals
+ *        the rest (underrun)
+ * @return AUDIO_RENDER_xxx flags
+ */
+uint8_t audio_channel_render(AudioChannel_t *ch, uint16_t *out, uint16_t count);
+
+/**
+ * @brief Set fade in/out time
+ * @param ch Pointer to AudioChannel_t structure
+ * @param ms Ramp time in ms (0 = hard start/stop)
+ */
+void audio_channel_set_fade_time(AudioChannel_t *ch, uint16_t ms);
+
+/**
+ * @brief Start fade-in ramp (gain 0 -> unity)
+ * @param ch Pointer to AudioChannel_t structure
+ */
+void audio_channel_fade_in(AudioChannel_t *ch);
+
+/**
+ * @brief Start fade-out ramp (current gain -> 0)
+ * @param ch Pointer to AudioChannel_t structure
+ * @return 1 if already silent (no ramp needed - stop immediately), 0 if ramping
+ */
+uint8_t audio_channel_fade_out(AudioChannel_t *ch);
+
+/**
+ * @brief Set oversampling factor (upsampler history cleared)
+ * @param ch Pointer to AudioChannel_t structure
+ * @param factor 1, 2 or 4
+ * @return 0 on success, 1 if factor is invalid
+ * @note  Change only while the channel is stopped (audio_output_set_oversample)
+ */
+uint8_t audio_channel_set_oversample(AudioChannel_t *ch, uint8_t factor);
+
+/**
+ * @brief Select 16 -> 12-bit quantizer mode
+ * @param ch Pointer to AudioChannel_t structure
+ * @param mode AUDIO_DITHER_xxx
+ * @return 0 on success, 1 if mode is invalid
+ */
+uint8_t audio_channel_set_dither(AudioChannel_t *ch, uint8_t mode);
+
+/**
+ * @brief Select underrun concealment
+ * @param ch Pointer to AudioChannel_t structure
+ * @param mode AUDIO_CONCEAL_xxx
+ * @return 0 on success, 1 if mode is invalid
+ */
+uint8_t audio_channel_set_conceal(AudioChannel_t *ch, uint8_t mode);
+
+/**
+ * @brief Set volume (ramped from the current gain)
+ * @param ch Pointer to AudioChannel_t structure
+ * @param volume Volume level (0-100, clamped)
+ * @note  Takes effect from the next rendered block
+ */
+void audio_channel_set_volume(AudioChannel_t *ch, uint8_t volume);
+
+/**
+ * @brief Set volume ramp time
+ * @param ch Pointer to AudioChannel_t structure
+ * @param ms Ramp time in ms (0 = step change)
+ */
+void audio_channel_set_volume_ramp(AudioChannel_t *ch, uint16_t ms);
+
+/**
+ * @brief Samples waiting for render (any context)
+ * @param ch Pointer to AudioChannel_t structure
+ * @return AUDIO_BUFFER_SIZE while a full buffer waits for the swap,
+ *         otherwise the fill position (0 after a reset)
+ */
+uint16_t audio_channel_fill_level(const AudioChannel_t *ch);
+
+/**
+ * @brief Samples queued for render (rest of active buffer + fill buffer)
+ * @param ch Pointer to AudioChannel_t structure
+ * @return 0 .. 2 x AUDIO_BUFFER_SIZE
+ */
+uint16_t audio_channel_depth(const AudioChannel_t *ch);
+
 /**
  * @brief Check if channel is ready for playback
  * @param ch Pointer to AudioChannel_t structure
@@ -96,6 +429,8 @@ uint8_t audio_channel_ready(AudioChannel_t *ch);
 /**
  * @brief Reset audio channel to initial state
  * @param ch Pointer to AudioChannel_t structure
+ * @note  Consumer side - from render, or with render locked out / stopped.
+ *        The partial fill buffer is dropped by the producer's next fill
  */
 void audio_channel_reset(AudioChannel_t *ch);
 
@@ -111,6 +446,14 @@ void audio_channel_get_stats(AudioChannel_t *ch,
                              uint32_t *buffer_swaps,
                              uint32_t *underrun_count);
 
+/**
+ * @brief Get underrun duration statistics
+ * @param ch Pointer to AudioChannel_t structure
+ * @param samples Output: Samples concealed (total)
+ * @param longest Output: Longest underrun (samples, completed underruns)
+ */
+void audio_channel_get_underrun(AudioChannel_t *ch, uint32_t *samples, uint32_t *longest);
+
 /**
  * @brief Clear underrun flag
  * @param ch Pointer to AudioChannel_t structure
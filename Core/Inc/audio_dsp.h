@@ -0,0 +1,236 @@
+/**
+  ******************************************************************************
+  * @file           : audio_dsp.h
+  * @brief          : Output Stage DSP Chain (EQ, DC blocker, limiter)
+  * @details        : Per-channel processing between render gain and DAC
+  *                   conversion, configured by PARAM packets (0xCB)
+  ******************************************************************************
+  * @attention
+  *
+  * Chain (per render block, each stage optional):
+  *   gain stage -> biquad EQ (up to 4 stages) -> DC blocker -> limiter -> DAC
+  *
+  * Sample domain: int32, 16-bit PCM scale (EQ boost may exceed +/-32767,
+  * the limiter brings it back, DAC conversion saturates)
+  *
+  * Biquad (Direct Form I, 64-bit accumulator - SMLAL per tap):
+  *   y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+  *   Coefficients Q30 (|c| < 2), a0 normalized to 1
+  *   Truncation error fed back (2nd order) - no DC offset or low-frequency
+  *   noise gain from poles near z = 1
+  *
+  * DC blocker: y[n] = x[n] - x[n-1] + R*y[n-1], R = 0.998 (~10 Hz @ 32 kHz),
+  * truncated fraction carried to the next sample
+  *
+  * Limiter: 1 ms lookahead delay. Envelope = minimum required gain of the
+  * samples in the delay line (held 1 ms, then released linearly), applied
+  * as its 1 ms moving average - every sample in the delay line is covered
+  * by the attack ramp, so a larger peak never cancels an earlier one
+  *
+  * Upsampler (oversampling mode, after the chain, before the quantizer):
+  * - 2x: 23-tap half-band FIR (polyphase - 6 MACs per input sample)
+  *       flat to 11 kHz, -0.5 dB @ 12.8 kHz, images >= 20.8 kHz below -55 dB
+  * - 4x: 2x stage above + 11-tap half-band (3 MACs per stage-2 input sample)
+  * - Q15 coefficients, inputs saturated to 16 bits (32-bit accumulator)
+  *
+  * Called from the DAC DMA IRQ. Configuration is written from the CS EXTI
+  * IRQ (lower priority) inside audio_lock() - see irq_prio.h.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __AUDIO_DSP_H
+#define __AUDIO_DSP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Maximum cascaded biquad stages per channel
+ */
+#define AUDIO_DSP_MAX_BIQUADS       4
+
+/**
+ * @brief Limiter lookahead (samples, 1 ms @ 32 kHz, power of 2)
+ */
+#define AUDIO_DSP_LOOKAHEAD         32
+
+/**
+ * @brief Coefficient / gain format (Q30)
+ */
+#define AUDIO_DSP_Q30_ONE           (1L << 30)
+
+/**
+ * @brief DC blocker pole (Q30, 0.998)
+ */
+#define AUDIO_DSP_DC_POLE           ((int32_t)(0.998 * AUDIO_DSP_Q30_ONE))
+
+/**
+ * @brief Default limiter settings
+ */
+#define AUDIO_DSP_LIMIT_DEFAULT     32000   // Threshold (16-bit PCM peak)
+#define AUDIO_DSP_RELEASE_DEFAULT   50      // Release time (ms, unity from 0)
+
+/**
+ * @brief Half-band upsampler polyphase branch lengths
+ */
+#define AUDIO_HB1_TAPS              12      // Stage 1 (23-tap half-band)
+#define AUDIO_HB2_TAPS              6       // Stage 2 (11-tap half-band)
+
+/**
+ * @brief Stage enable flags (AudioDsp_t.enable)
+ */
+#define AUDIO_DSP_EN_EQ             0x01
+#define AUDIO_DSP_EN_DC             0x02
+#define AUDIO_DSP_EN_LIMIT          0x04
+#define AUDIO_DSP_EN_MASK           0x07
+
+/* ============================================================================ */
+/* DSP State */
+/* ============================================================================ */
+
+/**
+ * @brief Biquad coefficients (Q30, a1/a2 as in the denominator - the
+ *        difference equation subtracts them)
+ */
+typedef struct {
+    int32_t b0;
+    int32_t b1;
+    int32_t b2;
+    int32_t a1;
+    int32_t a2;
+} AudioBiquad_t;
+
+/**
+ * @brief Per-channel DSP chain
+ */
+typedef struct {
+    uint8_t enable;             // AUDIO_DSP_EN_xxx
+    uint8_t num_biquads;        // Active EQ stages (0~AUDIO_DSP_MAX_BIQUADS)
+
+    // EQ
+    AudioBiquad_t coef[AUDIO_DSP_MAX_BIQUADS];
+    int32_t eq_state[AUDIO_DSP_MAX_BIQUADS][6];   // x1, x2, y1, y2, e1, e2
+
+    // DC blocker
+    int32_t dc_x1;
+    int32_t dc_y1;
+    int32_t dc_frac;            // Truncated fraction (Q30)
+
+    // Limiter
+    int32_t lim_threshold;      // Peak level (16-bit PCM)
+    int32_t lim_release;        // Release step per sample (Q30, > 0)
+    int32_t lim_gain;           // Applied gain (Q30, average of lim_env_hist)
+    int32_t lim_env;            // Envelope (Q30, <= lim_min)
+    int32_t lim_min;            // Minimum of lim_req (Q30)
+    uint16_t lim_min_age;       // Samples since lim_min entered the window
+    uint16_t lim_hold_left;     // Hold samples remaining before release
+    uint16_t lim_pos;           // Delay line write position
+    int64_t lim_env_sum;        // Sum of lim_env_hist (Q30)
+    int32_t lim_delay[AUDIO_DSP_LOOKAHEAD];
+    int32_t lim_req[AUDIO_DSP_LOOKAHEAD];       // Required gain per delayed sample (Q30)
+    int32_t lim_env_hist[AUDIO_DSP_LOOKAHEAD];  // Last envelope values (Q30)
+} AudioDsp_t;
+
+/**
+ * @brief 2x/4x interpolator state (input history per half-band stage)
+ */
+typedef struct {
+    int32_t hb1[AUDIO_HB1_TAPS - 1];
+    int32_t hb2[AUDIO_HB2_TAPS - 1];
+} AudioUpsampler_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize DSP chain (all stages bypassed, EQ flat)
+ * @param dsp Pointer to AudioDsp_t structure
+ */
+void audio_dsp_init(AudioDsp_t *dsp);
+
+/**
+ * @brief Clear filter/limiter history (coefficients kept)
+ * @param dsp Pointer to AudioDsp_t structure
+ * @note  Call on RESET so the next PLAY starts from silence
+ */
+void audio_dsp_reset(AudioDsp_t *dsp);
+
+/**
+ * @brief Process one block in place
+ * @param dsp Pointer to AudioDsp_t structure
+ * @param buf Samples (int32, 16-bit PCM scale)
+ * @param count Number of samples (<= AUDIO_BLOCK_SIZE)
+ */
+void audio_dsp_process(AudioDsp_t *dsp, int32_t *buf, uint16_t count);
+
+/**
+ * @brief Check if any stage is enabled
+ */
+static inline __attribute__((always_inline))
+uint8_t audio_dsp_active(const AudioDsp_t *dsp)
+{
+    return dsp->enable;
+}
+
+/**
+ * @brief Enable/disable stages
+ * @param dsp Pointer to AudioDsp_t structure
+ * @param enable AUDIO_DSP_EN_xxx flags
+ */
+void audio_dsp_set_enable(AudioDsp_t *dsp, uint8_t enable);
+
+/**
+ * @brief Load one biquad stage
+ * @param dsp Pointer to AudioDsp_t structure
+ * @param stage Stage index (0~AUDIO_DSP_MAX_BIQUADS-1)
+ * @param coef Coefficients (Q30)
+ * @return 0 on success, 1 if stage index is invalid
+ */
+uint8_t audio_dsp_set_biquad(AudioDsp_t *dsp, uint8_t stage, const AudioBiquad_t *coef);
+
+/**
+ * @brief Set number of active biquad stages
+ * @return 0 on success, 1 if count > AUDIO_DSP_MAX_BIQUADS
+ */
+uint8_t audio_dsp_set_eq_stages(AudioDsp_t *dsp, uint8_t count);
+
+/**
+ * @brief Configure limiter
+ * @param dsp Pointer to AudioDsp_t structure
+ * @param threshold Peak level (16-bit PCM, 1~32767)
+ * @param release_ms Release time from gain 0 to unity (ms)
+ */
+void audio_dsp_set_limiter(AudioDsp_t *dsp, uint16_t threshold, uint16_t release_ms);
+
+/**
+ * @brief Clear upsampler history
+ * @param up Pointer to AudioUpsampler_t structure
+ */
+void audio_dsp_upsample_reset(AudioUpsampler_t *up);
+
+/**
+ * @brief Upsample one block by 2 or 4
+ * @param up Pointer to AudioUpsampler_t structure
+ * @param in Input samples (int32, 16-bit PCM scale - saturated here)
+ * @param out Output samples (count * factor)
+ * @param count Number of input samples (<= AUDIO_BLOCK_SIZE)
+ * @param factor 2 or 4
+ * @note  Group delay: 2x = 6 input samples, 4x = 6 + 1.25 input samples
+ */
+void audio_dsp_upsample(AudioUpsampler_t *up, const int32_t *in, int32_t *out,
+                        uint16_t count, uint8_t factor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_DSP_H */
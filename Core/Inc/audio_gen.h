@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file           : audio_gen.h
+  * @brief          : Block-based Tone / Noise Generator
+  * @details        : Alternative render source for a channel (test tones,
+  *                   alarms) - no SPI data streaming needed
+  ******************************************************************************
+  * @attention
+  *
+  * Waveforms (CMD_TONE param):
+  * - SINE   : 256-entry Q15 table, linear interpolation
+  * - SQUARE : phase MSB (not band-limited)
+  * - SWEEP  : sine with linear frequency sweep, restarts at the end
+  * - WHITE  : xorshift32 uniform noise
+  * - PINK   : Voss-McCartney (8 octave rows + white)
+  *
+  * Phase: 32-bit accumulator, increment = f * 2^32 / 32000
+  * Level: -6 dBFS, channel volume / fade / DSP chain still apply
+  *
+  * Rendered in the DAC DMA IRQ (same path as streamed data), so the channel
+  * A/B buffers are left untouched while a tone is playing.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __AUDIO_GEN_H
+#define __AUDIO_GEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Waveforms
+ */
+#define AUDIO_GEN_OFF           0
+#define AUDIO_GEN_SINE          1
+#define AUDIO_GEN_SQUARE        2
+#define AUDIO_GEN_SWEEP         3
+#define AUDIO_GEN_WHITE         4
+#define AUDIO_GEN_PINK          5
+#define AUDIO_GEN_MAX           AUDIO_GEN_PINK
+
+/**
+ * @brief Output level (Q15, -6 dBFS)
+ */
+#define AUDIO_GEN_LEVEL         16384
+
+/**
+ * @brief Defaults (Hz / ms)
+ */
+#define AUDIO_GEN_FREQ_DEFAULT          1000
+#define AUDIO_GEN_SWEEP_START_DEFAULT   100
+#define AUDIO_GEN_SWEEP_END_DEFAULT     10000
+#define AUDIO_GEN_SWEEP_MS_DEFAULT      1000
+
+/**
+ * @brief Highest frequency (below Nyquist)
+ */
+#define AUDIO_GEN_FREQ_MAX      15999
+
+/**
+ * @brief Pink noise octave rows
+ */
+#define AUDIO_GEN_PINK_ROWS     8
+
+/* ============================================================================ */
+/* Generator State */
+/* ============================================================================ */
+
+typedef struct {
+    uint8_t wave;               // AUDIO_GEN_xxx (OFF = channel plays A/B data)
+
+    // Oscillator
+    uint32_t phase;             // Phase accumulator (2^32 = one cycle)
+    uint32_t phase_inc;         // Phase increment per sample (tone)
+
+    // Sweep
+    uint32_t sweep_start_inc;   // Phase increment at sweep start
+    int32_t sweep_step;         // Increment change per sample
+    uint32_t sweep_len;         // Sweep length (samples)
+    uint32_t sweep_inc;         // Current increment
+    uint32_t sweep_left;        // Samples until restart
+
+    // Noise
+    uint32_t seed;              // xorshift32 state (never 0)
+    uint32_t pink_count;        // Row select counter
+    int32_t pink_rows[AUDIO_GEN_PINK_ROWS];
+    int32_t pink_sum;           // Sum of all rows
+} AudioGen_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize generator (off, default frequency and sweep)
+ * @param gen Pointer to AudioGen_t structure
+ * @param seed Noise seed (any value, 0 is replaced)
+ */
+void audio_gen_init(AudioGen_t *gen, uint32_t seed);
+
+/**
+ * @brief Select waveform and restart from phase 0
+ * @param gen Pointer to AudioGen_t structure
+ * @param wave AUDIO_GEN_xxx (AUDIO_GEN_OFF = off)
+ * @return 0 on success, 1 if wave is invalid
+ */
+uint8_t audio_gen_start(AudioGen_t *gen, uint8_t wave);
+
+/**
+ * @brief Turn generator off (channel renders its A/B buffers again)
+ * @param gen Pointer to AudioGen_t structure
+ */
+void audio_gen_stop(AudioGen_t *gen);
+
+/**
+ * @brief Check if generator is the render source
+ */
+static inline __attribute__((always_inline))
+uint8_t audio_gen_active(const AudioGen_t *gen)
+{
+    return (gen->wave != AUDIO_GEN_OFF);
+}
+
+/**
+ * @brief Set tone frequency (SINE / SQUARE), takes effect immediately
+ * @param gen Pointer to AudioGen_t structure
+ * @param hz Frequency (1~AUDIO_GEN_FREQ_MAX, clamped)
+ */
+void audio_gen_set_freq(AudioGen_t *gen, uint16_t hz);
+
+/**
+ * @brief Configure sweep (applies from the next SWEEP start)
+ * @param gen Pointer to AudioGen_t structure
+ * @param start_hz Start frequency
+ * @param end_hz End frequency (may be below start)
+ * @param ms Sweep time (0 = 1 ms)
+ */
+void audio_gen_set_sweep(AudioGen_t *gen, uint16_t start_hz, uint16_t end_hz, uint16_t ms);
+
+/**
+ * @brief Render one block
+ * @param gen Pointer to AudioGen_t structure
+ * @param out Signed 16-bit PCM output
+ * @param count Number of samples
+ */
+void audio_gen_render(AudioGen_t *gen, int16_t *out, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_GEN_H */
@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file           : audio_jitter.h
+  * @brief          : Per-channel Jitter Buffer Manager (target depth, fill-level
+  *                   histogram)
+  * @details        : Tracks how much streamed audio is queued ahead of the DAC
+  *                   and gates RDY at a target depth, so the Master cadence
+  *                   can be tuned for minimum latency without underruns
+  ******************************************************************************
+  * @attention
+  *
+  * Depth = samples queued for render: rest of the active buffer + fill
+  * buffer (published, or as far as written). 0 .. 2 x AUDIO_BUFFER_SIZE.
+  *
+  * Sampling (render, once per DMA event = 1 block, stream source only):
+  * - Histogram of depth in AUDIO_JITTER_BIN wide bins
+  * - Exact min / max, events below the low-water threshold (time in ms)
+  * - Percentiles are taken from the histogram (bin lower edge, i.e.
+  *   rounded towards empty)
+  *
+  * Target depth (PARAM_JITTER, 0 = off):
+  * - While playing, RDY is only LOW while a playing channel is below its
+  *   target (or has no target) - the Master sends just enough to hold
+  *   the target instead of filling both buffers (128 ms)
+  * - Limited to AUDIO_BUFFER_SIZE, so a channel below target always has
+  *   at least AUDIO_BUFFER_SIZE - target samples of fill space
+  * - Render reports the crossing below target (AUDIO_RENDER_NEED_DATA),
+  *   RDY is updated from the DMA callback
+  *
+  ******************************************************************************
+  */
+
+#ifndef __AUDIO_JITTER_H
+#define __AUDIO_JITTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "spi_protocol.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Histogram bin width (samples, 2 ms @ 32kHz)
+ */
+#define AUDIO_JITTER_BIN            64
+
+/**
+ * @brief Histogram bins (depth 0 .. A + B buffers)
+ */
+#define AUDIO_JITTER_BINS           ((2 * AUDIO_BUFFER_SIZE) / AUDIO_JITTER_BIN)
+
+/**
+ * @brief Default low-water threshold (samples, 8 ms)
+ */
+#define AUDIO_JITTER_LOW_DEFAULT    256
+
+/* ============================================================================ */
+/* Jitter Buffer State */
+/* ============================================================================ */
+
+/**
+ * @brief Per-channel jitter buffer manager
+ */
+typedef struct {
+    // Configuration (PARAM_JITTER)
+    uint16_t target;            // Target depth (samples, 0 = RDY not gated)
+    uint16_t low;               // Low-water threshold (samples)
+
+    // Statistics (written by render)
+    uint16_t depth;             // Depth at the last DMA event
+    uint16_t min;               // Lowest depth
+    uint16_t max;               // Highest depth
+    uint32_t events;            // Depth samples taken
+    uint32_t below;             // Samples below the low-water threshold
+    uint32_t hist[AUDIO_JITTER_BINS];
+} AudioJitter_t;
+
+/**
+ * @brief Statistics summary (audio_jitter_report)
+ */
+typedef struct {
+    uint32_t events;            // Depth samples taken (1 per ms)
+    uint16_t min;               // Lowest depth (samples)
+    uint16_t p1;                // 1st percentile (samples)
+    uint16_t p5;                // 5th percentile
+    uint16_t p50;               // Median
+    uint16_t p95;               // 95th percentile
+    uint16_t max;               // Highest depth
+    uint32_t below_ms;          // Time below the low-water threshold (ms)
+} AudioJitterReport_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize (target off, default threshold, statistics cleared)
+ * @param jit Jitter buffer state
+ */
+void audio_jitter_init(AudioJitter_t *jit);
+
+/**
+ * @brief Set target depth and low-water threshold
+ * @param jit Jitter buffer state
+ * @param target Target depth in samples (0 = off, max AUDIO_BUFFER_SIZE)
+ * @param low Low-water threshold in samples (0 = AUDIO_JITTER_LOW_DEFAULT)
+ * @return 0 on success, 1 if target is out of range
+ * @note  Statistics are cleared (new measurement)
+ */
+uint8_t audio_jitter_set(AudioJitter_t *jit, uint16_t target, uint16_t low);
+
+/**
+ * @brief Clear statistics (configuration kept)
+ * @param jit Jitter buffer state
+ */
+void audio_jitter_clear(AudioJitter_t *jit);
+
+/**
+ * @brief Record the depth at one DMA event (render)
+ * @param jit Jitter buffer state
+ * @param depth Samples queued for render
+ * @return 1 if the depth has just dropped below the target (RDY update)
+ */
+uint8_t audio_jitter_sample(AudioJitter_t *jit, uint16_t depth);
+
+/**
+ * @brief Check if the channel wants data (RDY while playing)
+ * @param jit Jitter buffer state
+ * @param depth Current depth (audio_channel_depth)
+ * @return 1 if no target is set or depth is below it
+ */
+uint8_t audio_jitter_wants_data(const AudioJitter_t *jit, uint16_t depth);
+
+/**
+ * @brief Summarize statistics (min / percentiles / max, time below threshold)
+ * @param jit Jitter buffer state
+ * @param report Output summary
+ */
+void audio_jitter_report(const AudioJitter_t *jit, AudioJitterReport_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_JITTER_H */
@@ -0,0 +1,145 @@
+/**
+  ******************************************************************************
+  * @file           : audio_mixer.h
+  * @brief          : Per-channel Voice Mixer (cached clips / tones over the stream)
+  * @details        : Sums up to AUDIO_MIX_VOICES extra voices onto the channel
+  *                   source block, so alerts can overlap the live SPI stream
+  ******************************************************************************
+  * @attention
+  *
+  * Position in render (per 32-sample block):
+  *   source (A/B stream / tone / clip) -> mixer -> fade x volume -> DSP ...
+  * - Voices follow the channel volume and fade (STOP fades them out too)
+  * - Sum in 32 bits, saturated once to 16 bits at the mixer output
+  *
+  * Voices (CMD_CLIP_PLAY / CMD_TONE with the mix flag):
+  * - CLIP: zero-copy read from the clip cache, one-shot or looped
+  * - GEN : own tone / noise generator (settings copied from the channel)
+  * - Own gain (Q15), ramped over one block on start / stop - no clicks
+  * - One-shot clips free their voice when played out
+  *
+  * Cost: one MAC per voice and sample (+ generator for GEN voices),
+  * nothing when no voice is active. Measured by test 7 (kernel benchmark).
+  *
+  ******************************************************************************
+  */
+
+#ifndef __AUDIO_MIXER_H
+#define __AUDIO_MIXER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "audio_gen.h"
+#include "clip_cache.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Mixed voices per channel (on top of the channel source)
+ */
+#define AUDIO_MIX_VOICES        4
+
+/**
+ * @brief Voice kinds (also used as stop mask)
+ */
+#define AUDIO_MIX_OFF           0x00
+#define AUDIO_MIX_CLIP          0x01
+#define AUDIO_MIX_GEN           0x02
+#define AUDIO_MIX_ALL           (AUDIO_MIX_CLIP | AUDIO_MIX_GEN)
+
+/* ============================================================================ */
+/* Mixer State */
+/* ============================================================================ */
+
+/**
+ * @brief One mixed voice
+ */
+typedef struct {
+    uint8_t kind;               // AUDIO_MIX_xxx (OFF = free)
+    uint8_t stopping;           // Ramping to 0, freed at the end of the block
+    int32_t gain;               // Gain at block start (Q15)
+    int32_t target;             // Gain at block end (Q15)
+    ClipVoice_t clip;           // AUDIO_MIX_CLIP source
+    AudioGen_t gen;             // AUDIO_MIX_GEN source
+} AudioMixVoice_t;
+
+/**
+ * @brief Per-channel mixer
+ */
+typedef struct {
+    uint8_t active;             // Voices in use
+    AudioMixVoice_t voice[AUDIO_MIX_VOICES];
+} AudioMixer_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize mixer (no voices)
+ * @param mix Pointer to AudioMixer_t structure
+ */
+void audio_mixer_init(AudioMixer_t *mix);
+
+/**
+ * @brief Drop all voices immediately (channel reset)
+ * @param mix Pointer to AudioMixer_t structure
+ */
+void audio_mixer_reset(AudioMixer_t *mix);
+
+/**
+ * @brief Check if any voice is mixed in
+ */
+static inline __attribute__((always_inline))
+uint8_t audio_mixer_active(const AudioMixer_t *mix)
+{
+    return (mix->active != 0);
+}
+
+/**
+ * @brief Add a cached clip voice
+ * @param mix Pointer to AudioMixer_t structure
+ * @param slot Clip slot
+ * @param loop 1 = loop until stopped
+ * @param gain Gain in percent (1~100, 0 = 100)
+ * @return 0 on success, 1 if no voice is free or the slot is not loaded
+ */
+uint8_t audio_mixer_add_clip(AudioMixer_t *mix, uint8_t slot, uint8_t loop, uint8_t gain);
+
+/**
+ * @brief Add a tone / noise voice
+ * @param mix Pointer to AudioMixer_t structure
+ * @param cfg Generator to copy frequency / sweep / seed from (channel generator)
+ * @param wave AUDIO_GEN_xxx (not OFF)
+ * @param gain Gain in percent (1~100, 0 = 100)
+ * @return 0 on success, 1 if no voice is free or wave is invalid
+ */
+uint8_t audio_mixer_add_gen(AudioMixer_t *mix, const AudioGen_t *cfg, uint8_t wave, uint8_t gain);
+
+/**
+ * @brief Fade out voices (one block ramp)
+ * @param mix Pointer to AudioMixer_t structure
+ * @param kinds AUDIO_MIX_CLIP / AUDIO_MIX_GEN / AUDIO_MIX_ALL
+ */
+void audio_mixer_stop(AudioMixer_t *mix, uint8_t kinds);
+
+/**
+ * @brief Mix all voices onto one source block
+ * @param mix Pointer to AudioMixer_t structure
+ * @param src Channel source block (n samples)
+ * @param out Mixed output (n samples, saturated to 16 bits)
+ * @param n Number of samples (<= AUDIO_BLOCK_SIZE)
+ * @return out
+ */
+const int16_t *audio_mixer_process(AudioMixer_t *mix, const int16_t *src, int16_t *out, uint16_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_MIXER_H */
@@ -0,0 +1,222 @@
+/**
+  ******************************************************************************
+  * @file           : audio_output.h
+  * @brief          : DAC Output Control (DMA arm/start/stop, shared time base)
+  * @details        : Owns the DAC trigger timers (TIM1: CH1, TIM7: CH2) and a
+  *                   free-running sample clock (TIM2) used for scheduled start
+  ******************************************************************************
+  * @attention
+  *
+  * Time Base (TIM2, 32-bit):
+  * - Counts at the DAC sample rate (PSC = TIM1 period, 1 tick = 1 sample)
+  * - CMD_SYNC latches TIM2 at the CS rising edge and stores the offset to the
+  *   Master sample index (16-bit, wraps every ~2 s)
+  * - CMD_PLAY_AT converts the Master tick to a local TIM2 tick
+  *
+  * Scheduled Start:
+  * - CH1: TIM2 OC1REF -> TRGO -> TIM1 ITR1 (trigger mode), started by hardware
+  *        exactly on the target tick
+  * - CH2: TIM2 CC2 interrupt starts TIM7 (basic timer has no slave mode,
+  *        start latency = IRQ entry, < 1 us)
+  *
+  * Output Ring:
+  * - Each DAC channel runs circular DMA over 2 render blocks (2 x 32 samples)
+  * - Half/complete IRQ renders the next block from the channel PCM buffer
+  *   (buffer swap happens in render - DMA is never restarted while playing)
+  * - STOP/RESET fade out first, the DMA is stopped once the last faded block
+  *   has been output (deferred stop)
+  * - A one-shot cached clip stops its channel the same way once played out
+  *
+  * Oversampling (CMD_OVERSAMPLE 2/4):
+  * - TIM1/TIM7 period divided by the factor (64/128 kHz DAC update),
+  *   render interpolates each 32-sample block to 64/128 ring samples
+  * - TIM2 keeps counting 32kHz samples (scheduling unchanged)
+  *
+  * Stereo Lock (CMD_STEREO):
+  * - DAC CH2 trigger re-routed from TIM7 TRGO to TIM1 TRGO
+  * - Both DMAs are armed first, then a single TIM1 start/stop gates both
+  *   channels -> left/right offset is exactly 0 samples
+  *
+  ******************************************************************************
+  */
+
+#ifndef __AUDIO_OUTPUT_H
+#define __AUDIO_OUTPUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "audio_channel.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Latest allowed schedule distance (Master ticks)
+ * @note  Half of the 16-bit Master tick range - anything further is treated
+ *        as "in the past" (wrap-around)
+ */
+#define AUDIO_OUTPUT_MAX_LEAD       0x7FFF
+
+/**
+ * @brief DAC output ring size per channel (samples, 2 render blocks)
+ * @note  Allocated at the maximum factor from the dma_arena non-cacheable
+ *        pool (DMA_ARENA_NONCACHED_SIZE, dma_arena.h): 2 x 256 x 2 = 1 KB
+ *        at 4x next to the A/B buffers. Only the ring scales with the
+ *        oversampling factor, the A/B buffers stay at 32kHz
+ */
+#define AUDIO_OUT_RING_SIZE(os)     (AUDIO_BLOCK_SIZE * 2 * (os))
+#define AUDIO_OUT_RING_MAX          AUDIO_OUT_RING_SIZE(AUDIO_OVERSAMPLE_MAX)
+
+/**
+ * @brief Minimum schedule distance (local ticks)
+ * @note  Target closer than this is started immediately
+ */
+#define AUDIO_OUTPUT_MIN_LEAD       2
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize output control and start the TIM2 sample clock
+ * @param dac1_ch Audio channel rendered to DAC CH1
+ * @param dac2_ch Audio channel rendered to DAC CH2
+ * @note  Call once before spi_handler_init()
+ */
+void audio_output_init(AudioChannel_t *dac1_ch, AudioChannel_t *dac2_ch);
+
+/**
+ * @brief Read the local sample clock (TIM2 CNT)
+ * @return Current tick (1 tick = 1 sample period)
+ */
+static inline __attribute__((always_inline))
+uint32_t audio_output_now(void)
+{
+    return TIM2->CNT;
+}
+
+/**
+ * @brief Pre-render the output ring and start DAC DMA (timer not started)
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @param ch Audio channel (rendered from the active buffer, starts with fade-in)
+ * @return HAL status of HAL_DAC_Start_DMA
+ */
+HAL_StatusTypeDef audio_output_arm(uint32_t dac_channel, AudioChannel_t *ch);
+
+/**
+ * @brief DAC DMA half/complete event - render the next block
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @param half 0 = first half done (HalfCplt), 1 = second half done (Cplt)
+ * @note  Call from HAL_DAC_ConvHalfCplt/ConvCplt callbacks
+ * @return 1 if RDY needs an update (buffers swapped - fill buffer free,
+ *         or depth dropped below the jitter target)
+ */
+uint8_t audio_output_dma_event(uint32_t dac_channel, uint8_t half);
+
+/**
+ * @brief Fade out and stop a channel (deferred until the ramp is output)
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @param reset 1 = audio_channel_reset() after stop (CMD_RESET)
+ * @note  is_playing is cleared when the stop completes
+ */
+void audio_output_request_stop(uint32_t dac_channel, uint8_t reset);
+
+/**
+ * @brief Cancel a pending deferred stop (channel keeps playing, fades in)
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @note  New source started while the old one fades out (CMD_CLIP_PLAY,
+ *        CMD_TONE retrigger)
+ */
+void audio_output_cancel_stop(uint32_t dac_channel);
+
+/**
+ * @brief Start the trigger timer of a DAC channel now
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ */
+void audio_output_start(uint32_t dac_channel);
+
+/**
+ * @brief Start the trigger timer of a DAC channel at a local tick
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @param local_tick TIM2 tick to start on
+ * @note  DMA must already be armed (audio_output_arm)
+ */
+void audio_output_start_at(uint32_t dac_channel, uint32_t local_tick);
+
+/**
+ * @brief Stop DAC DMA and the trigger timer of a DAC channel
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @note  Cancels a pending scheduled start
+ *        Stereo lock: TIM1 keeps running while the other channel is active
+ */
+void audio_output_stop(uint32_t dac_channel);
+
+/**
+ * @brief Stop both channels on the same sample (stereo lock)
+ * @note  TIM1 is stopped first so neither channel gets another trigger
+ */
+void audio_output_stop_stereo(void);
+
+/**
+ * @brief Enable/disable stereo lock (both DAC triggers from TIM1)
+ * @param enable 1 = CH2 on TIM1 TRGO, 0 = CH2 on TIM7 TRGO (independent)
+ * @return HAL_BUSY if a channel DMA is running (change only while stopped)
+ */
+HAL_StatusTypeDef audio_output_set_stereo_lock(uint8_t enable);
+
+/**
+ * @brief Check stereo lock mode
+ * @return 1 if both channels are triggered by TIM1
+ */
+uint8_t audio_output_is_stereo_locked(void);
+
+/**
+ * @brief Set DAC oversampling factor (both channels)
+ * @param factor 1, 2 or 4
+ * @return HAL_BUSY if a channel DMA is running (change only while stopped),
+ *         HAL_ERROR for an invalid factor
+ */
+HAL_StatusTypeDef audio_output_set_oversample(uint8_t factor);
+
+/**
+ * @brief Get DAC oversampling factor
+ * @return 1, 2 or 4
+ */
+uint8_t audio_output_get_oversample(void);
+
+/**
+ * @brief Safely stop DAC DMA without HAL_DMA_Abort hang
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ */
+void audio_output_stop_dma(uint32_t dac_channel);
+
+/**
+ * @brief Align local clock to Master sample index
+ * @param master_tick Master sample index (low 16 bits)
+ * @param local_tick TIM2 tick latched when the SYNC packet ended (CS rising)
+ */
+void audio_output_sync(uint16_t master_tick, uint32_t local_tick);
+
+/**
+ * @brief Convert Master tick to local tick
+ * @param master_tick Target Master sample index (low 16 bits)
+ * @param local_tick Output: local TIM2 tick
+ * @return 1 if target is in the future, 0 if in the past / not synced
+ */
+uint8_t audio_output_to_local(uint16_t master_tick, uint32_t *local_tick);
+
+/**
+ * @brief TIM2 interrupt handler (scheduled CH2 start)
+ * @note  Call from TIM2_IRQHandler
+ */
+void audio_output_tim_irq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AUDIO_OUTPUT_H */
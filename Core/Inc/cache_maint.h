@@ -0,0 +1,113 @@
+/**
+  ******************************************************************************
+  * @file           : cache_maint.h
+  * @brief          : DCACHE1 Range Maintenance for DMA Buffers in Cacheable RAM
+  ******************************************************************************
+  * @attention
+  *
+  * Rules for a DMA buffer in cacheable RAM (DMA_MEM_CACHED arena block):
+  * - Peripheral -> memory (RX): invalidate the received range after the
+  *   DMA has stopped, before the CPU reads it
+  * - Memory -> peripheral (TX): clean the range after the CPU has written
+  *   it, before the DMA starts
+  * - CPU writes to an RX buffer (e.g. memset) need clean + invalidate
+  *   before the next DMA, or an evicted dirty line overwrites DMA data
+  *
+  * Ranges are widened to whole 32-byte lines. Invalidate on a partial line
+  * would drop the neighbour's dirty data, so buffers must start and end on
+  * a line (the arena guarantees this) - misaligned calls are counted.
+  *
+  * All calls are no-ops while DCACHE1 is disabled.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __CACHE_MAINT_H
+#define __CACHE_MAINT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Cache line size (bytes)
+ */
+#define CACHE_LINE_SIZE         32
+
+/* ============================================================================ */
+/* Types */
+/* ============================================================================ */
+
+/**
+ * @brief Maintenance statistics
+ */
+typedef struct {
+    uint32_t invalidate_count;  // Invalidate calls
+    uint32_t clean_count;       // Clean (and clean + invalidate) calls
+    uint32_t line_count;        // Lines maintained
+    uint32_t misaligned_count;  // Ranges not on line boundaries
+    uint32_t error_count;       // HAL busy / timeout
+} CacheMaintStats_t;
+
+/* ============================================================================ */
+/* Line Arithmetic */
+/* ============================================================================ */
+
+/**
+ * @brief Widen a byte range to whole cache lines
+ * @param addr Range start
+ * @param size Range size (bytes)
+ * @param start Output: first line address
+ * @return Size of the widened range (bytes, multiple of CACHE_LINE_SIZE)
+ */
+static inline uint32_t cache_maint_lines(uint32_t addr, uint32_t size, uint32_t *start)
+{
+    uint32_t first = addr & ~(uint32_t)(CACHE_LINE_SIZE - 1);
+    uint32_t end = (addr + size + CACHE_LINE_SIZE - 1) & ~(uint32_t)(CACHE_LINE_SIZE - 1);
+
+    *start = first;
+
+    return (size > 0) ? (end - first) : 0;
+}
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Discard cached copies of a range (after DMA RX)
+ * @param addr Range start (line aligned)
+ * @param size Range size (bytes, rounded up to lines)
+ */
+void cache_invalidate(const void *addr, uint32_t size);
+
+/**
+ * @brief Write dirty lines of a range back to RAM (before DMA TX)
+ * @param addr Range start
+ * @param size Range size (bytes, rounded up to lines)
+ */
+void cache_clean(const void *addr, uint32_t size);
+
+/**
+ * @brief Clean then invalidate a range (CPU-written RX buffer before DMA)
+ * @param addr Range start
+ * @param size Range size (bytes, rounded up to lines)
+ */
+void cache_clean_invalidate(const void *addr, uint32_t size);
+
+/**
+ * @brief Get maintenance statistics
+ */
+const CacheMaintStats_t *cache_maint_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CACHE_MAINT_H */
@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file           : clip_cache.h
+  * @brief          : On-slave PCM Clip Cache (chimes, alerts)
+  * @details        : Clips are uploaded once over SPI (0xCC packets) and
+  *                   played on a channel by CMD_CLIP_PLAY - no streaming
+  ******************************************************************************
+  * @attention
+  *
+  * Storage:
+  * - One pool of signed 16-bit PCM in internal RAM (96 KB = 1.5 s @ 32 kHz)
+  * - CLIP_SLOT_COUNT slots, each a contiguous region of the pool
+  * - Allocation is append-only: re-uploading a slot with the same length
+  *   rewrites it in place, a new length takes a new region. CMD_CLIP_ERASE
+  *   clears the whole pool
+  *
+  * Upload (0xCC packets, see spi_protocol.h):
+  * - Chunks must arrive in order (offset = samples already loaded),
+  *   offset 0 (re)starts the slot
+  * - The slot can be played once all samples are loaded
+  *
+  * Playback (ClipVoice_t, one per channel):
+  * - Render source like the tone generator - A/B buffers are not consumed
+  * - Zero copy: render reads straight from the pool
+  * - One-shot clips end with silence and the channel stops itself,
+  *   looped clips run until CMD_CLIP_STOP / STOP
+  *
+  * The pool is written from the CS EXTI IRQ and read from the DAC DMA IRQ,
+  * which may preempt the upload. Voices keep their own pointer / length
+  * (set under audio_lock() by CMD_CLIP_PLAY), so an upload only changes
+  * samples - re-uploading a playing slot is audible, never unsafe.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __CLIP_CACHE_H
+#define __CLIP_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Number of clip slots
+ */
+#define CLIP_SLOT_COUNT         16
+
+/**
+ * @brief Pool size (samples, 96 KB)
+ */
+#define CLIP_POOL_SAMPLES       49152
+
+/**
+ * @brief Clip gain format (Q15, 32768 = unity)
+ */
+#define CLIP_GAIN_UNITY         32768
+
+/* ============================================================================ */
+/* Clip Voice */
+/* ============================================================================ */
+
+/**
+ * @brief Per-channel clip player
+ */
+typedef struct {
+    const int16_t *data;        // Clip samples in the pool (NULL = off)
+    uint16_t length;            // Clip length (samples)
+    uint16_t pos;               // Next sample to render
+    uint8_t loop;               // 1 = restart at the end
+    uint8_t done;               // One-shot end reached (renders silence)
+    int32_t gain;               // Clip gain (Q15)
+} ClipVoice_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize cache (all slots empty)
+ */
+void clip_cache_init(void);
+
+/**
+ * @brief Store one uploaded chunk
+ * @param slot Slot index (0~CLIP_SLOT_COUNT-1)
+ * @param format Sample format (SAMPLE_FORMAT_16BIT / 12BIT / 8BIT)
+ * @param total Clip length (samples)
+ * @param offset First sample of this chunk (0 = start a new upload)
+ * @param data Packed payload (DATA_PAYLOAD_BYTES(format, count))
+ * @param count Number of samples in this chunk
+ * @return 0 on success, 1 on bad slot / format, no space or out of order chunk
+ */
+uint8_t clip_cache_write(uint8_t slot, uint8_t format, uint16_t total,
+                         uint16_t offset, const uint8_t *data, uint16_t count);
+
+/**
+ * @brief Clear all slots and the pool
+ * @note  No voice may be playing from the pool (caller checks)
+ */
+void clip_cache_erase(void);
+
+/**
+ * @brief Check if a slot is completely loaded
+ * @param slot Slot index
+ * @return 1 if the clip can be played
+ */
+uint8_t clip_cache_ready(uint8_t slot);
+
+/**
+ * @brief Get unallocated pool space
+ * @return Free samples
+ */
+uint32_t clip_cache_free(void);
+
+/**
+ * @brief Start a clip on a voice (from the first sample)
+ * @param v Pointer to ClipVoice_t structure
+ * @param slot Slot index
+ * @param loop 1 = loop until stopped
+ * @param gain Clip gain in percent (1~100, 0 = 100)
+ * @return 0 on success, 1 if the slot is not loaded
+ */
+uint8_t clip_voice_start(ClipVoice_t *v, uint8_t slot, uint8_t loop, uint8_t gain);
+
+/**
+ * @brief Turn voice off (channel renders its A/B buffers again)
+ * @param v Pointer to ClipVoice_t structure
+ */
+void clip_voice_stop(ClipVoice_t *v);
+
+/**
+ * @brief Check if voice is the render source
+ */
+static inline __attribute__((always_inline))
+uint8_t clip_voice_active(const ClipVoice_t *v)
+{
+    return (v->data != NULL);
+}
+
+/**
+ * @brief Get the next source segment
+ * @param v Pointer to ClipVoice_t structure
+ * @param n In: samples wanted, out: samples available (clip end / loop point)
+ * @param silence Zero block for the one-shot tail (>= *n samples)
+ * @param ended Output: set to 1 on the block where a one-shot clip ends
+ * @return Pointer to *n samples
+ */
+const int16_t *clip_voice_next(ClipVoice_t *v, uint16_t *n, int16_t *silence, uint8_t *ended);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CLIP_CACHE_H */
@@ -0,0 +1,145 @@
+/**
+  ******************************************************************************
+  * @file           : cobs.h
+  * @brief          : COBS Framing and CRC-16 for Binary UART Frames
+  ******************************************************************************
+  * @attention
+  *
+  * Wire format of a frame:
+  *
+  *   0x00 | COBS( payload | CRC16 LE ) | 0x00
+  *
+  * - COBS (Consistent Overhead Byte Stuffing) removes every 0x00 from the
+  *   frame body, so 0x00 only ever appears as delimiter. A receiver
+  *   resynchronizes on the next 0x00 after noise or dropped bytes
+  * - Overhead: 1 byte per started 254 bytes + 2 delimiters. The leading
+  *   delimiter ends any text that was sent before the frame
+  * - CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection) over the
+  *   payload, appended little-endian before encoding
+  *
+  ******************************************************************************
+  */
+
+#ifndef __COBS_H
+#define __COBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Frame delimiter
+ */
+#define COBS_DELIMITER          0x00
+
+/**
+ * @brief Worst-case encoded size of n bytes (without delimiters)
+ */
+#define COBS_MAX_ENCODED(n)     ((n) + ((n) / 254U) + 1U)
+
+/**
+ * @brief Worst-case frame size of an n-byte payload (CRC + delimiters)
+ */
+#define COBS_MAX_FRAME(n)       (COBS_MAX_ENCODED((n) + 2U) + 2U)
+
+/* ============================================================================ */
+/* Types */
+/* ============================================================================ */
+
+/**
+ * @brief Incremental frame decoder (byte stream -> payloads)
+ * @note  Decodes while bytes arrive, so a frame never has to fit in the
+ *        receive buffer - only in the payload buffer
+ */
+typedef struct {
+    uint8_t *buf;               // Payload + CRC output
+    uint32_t size;              // buf capacity
+    uint32_t len;               // Bytes decoded in the current frame
+    uint8_t left;               // Data bytes left in the current block
+    uint8_t zero;               // Implicit zero owed before the next block
+    uint8_t active;             // Frame body started
+    uint8_t skip;               // Discard up to the next delimiter
+    uint32_t frames;            // Valid frames
+    uint32_t bad_frames;        // Malformed / CRC mismatch
+    uint32_t overflows;         // Frames longer than buf
+} CobsStream_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief CRC-16/CCITT-FALSE
+ * @param data Input bytes
+ * @param len Number of bytes
+ * @return CRC (check value of "123456789" = 0x29B1)
+ */
+uint16_t crc16_ccitt(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief COBS encode (no delimiter)
+ * @param src Input bytes
+ * @param len Number of input bytes
+ * @param dst Output (at least COBS_MAX_ENCODED(len) bytes, must not overlap src)
+ * @return Encoded length
+ */
+uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst);
+
+/**
+ * @brief COBS decode (frame body between delimiters)
+ * @param src Encoded bytes (no delimiter)
+ * @param len Number of encoded bytes
+ * @param dst Output (at least len bytes, may be src - decoding in place)
+ * @return Decoded length, 0 if the input is malformed
+ */
+uint32_t cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst);
+
+/**
+ * @brief Build a complete frame (delimiters, COBS, CRC)
+ * @param payload Payload bytes
+ * @param len Payload length
+ * @param frame Output (at least COBS_MAX_FRAME(len) bytes)
+ * @return Frame length
+ */
+uint32_t cobs_frame_build(const uint8_t *payload, uint32_t len, uint8_t *frame);
+
+/**
+ * @brief Decode a frame body in place and check its CRC
+ * @param buf Encoded bytes between delimiters (overwritten with payload)
+ * @param len Number of encoded bytes
+ * @return Payload length, 0 if malformed or CRC mismatch
+ */
+uint32_t cobs_frame_open(uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Initialize a stream decoder
+ * @param s Decoder
+ * @param buf Payload buffer (largest payload + 2 CRC bytes)
+ * @param size Buffer size
+ */
+void cobs_stream_init(CobsStream_t *s, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Feed received bytes
+ * @param s Decoder
+ * @param data Received bytes
+ * @param len Number of bytes
+ * @param payload_len Output: payload length in s->buf when a valid frame
+ *                    ended at the last consumed byte, 0 otherwise
+ * @return Bytes consumed - stops after a valid frame so the caller can
+ *         use s->buf before the next frame overwrites it
+ */
+uint32_t cobs_stream_feed(CobsStream_t *s, const uint8_t *data, uint32_t len,
+                          uint32_t *payload_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COBS_H */
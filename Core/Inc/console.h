@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file           : console.h
+  * @brief          : UART3 Console - Command Table, Line Editor, Jobs
+  ******************************************************************************
+  * @attention
+  *
+  * Commands are registered as tables of ConsoleCmd_t. The registry keeps
+  * pointers sorted by name, so lookup and TAB completion are binary
+  * searches, and it is the only list of valid commands (no separate
+  * whitelist to keep in sync).
+  *
+  * Argument schema (ConsoleCmd_t.args), one token per argument:
+  *   <name:t>   required      [name:t]   optional (only after required)
+  *   t = u (unsigned, dec / 0x hex), i (signed), s (word)
+  * e.g. "<dev:u> <dir:s> [speed:u]". The console checks count and types
+  * and prints "Usage: <cmd> <schema>" on a mismatch - handlers get
+  * converted values only.
+  *
+  * Handlers run as jobs and must not block: each call does one step and
+  * returns CONSOLE_BUSY to be called again from console_poll(), or
+  * CONSOLE_DONE. Step 0 is the first call. ESC / 'q' sets job->abort:
+  * the handler cleans up and returns CONSOLE_DONE. One job runs at a
+  * time; input other than ESC / 'q' is dropped while it runs.
+  *
+  * Line editing: backspace, TAB completes the command name (unique match
+  * or longest common prefix, lists candidates otherwise), Ctrl-C clears
+  * the line, VT100 escape sequences (arrow keys) are ignored.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __CONSOLE_H
+#define __CONSOLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+#define CONSOLE_MAX_CMDS        32      // Registered commands (all tables)
+#define CONSOLE_MAX_ARGS        4       // Arguments per command
+#define CONSOLE_LINE_MAX        80      // Input line (bytes, without NUL)
+
+/* ============================================================================ */
+/* Types */
+/* ============================================================================ */
+
+/**
+ * @brief Handler result
+ */
+typedef enum {
+    CONSOLE_DONE = 0,           // Job finished - prompt is shown
+    CONSOLE_BUSY                // Call again from the next console_poll()
+} ConsoleStatus_t;
+
+/**
+ * @brief Converted argument (type per schema)
+ */
+typedef union {
+    uint32_t u;
+    int32_t i;
+    const char *s;              // Points into the line buffer
+} ConsoleArg_t;
+
+struct ConsoleCmd;
+
+/**
+ * @brief Running command
+ */
+typedef struct {
+    const struct ConsoleCmd *cmd;
+    uint8_t argc;               // Arguments given (optional ones may be missing)
+    ConsoleArg_t argv[CONSOLE_MAX_ARGS];
+    uint32_t step;              // Handler state, 0 on the first call
+    uint32_t tick;              // Handler timer (HAL tick)
+    uint32_t count;             // Handler counter
+    uint8_t abort;              // ESC / 'q': clean up and return CONSOLE_DONE
+} ConsoleJob_t;
+
+/**
+ * @brief Command handler (one non-blocking step)
+ */
+typedef ConsoleStatus_t (*ConsoleHandler_t)(ConsoleJob_t *job);
+
+/**
+ * @brief Command table entry
+ */
+typedef struct ConsoleCmd {
+    const char *name;           // Command word
+    const char *args;           // Argument schema ("" = none)
+    const char *help;           // One line for 'help'
+    ConsoleHandler_t handler;
+} ConsoleCmd_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Clear the registry and the input line
+ * @param prompt Prompt string (e.g. "> ")
+ */
+void console_init(const char *prompt);
+
+/**
+ * @brief Register a command table
+ * @param cmds Table (static storage, any order)
+ * @param count Number of entries
+ * @return 0 on success, 1 if the registry is full, a name is taken or a
+ *         schema is malformed (that entry and the rest are skipped)
+ */
+uint8_t console_register(const ConsoleCmd_t *cmds, uint32_t count);
+
+/**
+ * @brief Look up a command (binary search)
+ * @return Entry, NULL if unknown
+ */
+const ConsoleCmd_t *console_find(const char *name);
+
+/**
+ * @brief Read input, run the current job step (main loop)
+ */
+void console_poll(void);
+
+/**
+ * @brief A job is running
+ */
+uint8_t console_busy(void);
+
+/**
+ * @brief Print all commands (name, schema, help)
+ */
+void console_help(void);
+
+/**
+ * @brief Print the prompt and the current input line
+ */
+void console_prompt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CONSOLE_H */
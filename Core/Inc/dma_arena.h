@@ -0,0 +1,124 @@
+/**
+  ******************************************************************************
+  * @file           : dma_arena.h
+  * @brief          : Static DMA Memory Arena (planned buffer placement)
+  * @details        : All DMA buffers are carved from fixed pools at init,
+  *                   tagged with their cache attribute, and listed at boot
+  ******************************************************************************
+  * @attention
+  *
+  * Pools:
+  * - DMA_MEM_NONCACHED: section .dma_arena at the start of RAM_DMA
+  *   (MPU region 0, non-cacheable) - no cache maintenance needed
+  * - DMA_MEM_CACHED   : plain .bss (cacheable RAM), every allocation
+  *   starts and ends on a cache line so maintenance never touches
+  *   a neighbour. Owner must clean / invalidate around each DMA transfer
+  *   (cache_maint.h)
+  *
+  * Rules:
+  * - Allocation only at init (bump pointer, nothing is freed)
+  * - Allocating the same name again returns the existing block, so
+  *   re-running an init (test menu -> slave mode) does not leak
+  * - Running out of a pool is a configuration error -> Error_Handler()
+  * - The linker script asserts that .dma_buffer (arena + hand-placed
+  *   buffers) fits RAM_DMA
+  *
+  * Sizes of the planned buffers stay with their owners (AUDIO_BUFFER_SIZE,
+  * SPI_RX_BUFFER_SIZE, AUDIO_OUT_RING_MAX, DMA_TX_BUFFER_SIZE), only the
+  * pool sizes are configured here. dma_arena_report() prints the plan.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DMA_ARENA_H
+#define __DMA_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Cache line size (Cortex-M33 DCACHE1)
+ */
+#define DMA_ARENA_LINE              32
+
+/**
+ * @brief Non-cacheable pool (bytes, in RAM_DMA)
+ * @note  DAC A/B buffers 16 KB + output rings 1 KB + UART3 TX 0.5 KB
+ *        + UART3 RX ring 1 KB + UART1 RX ring 4 KB, rest is headroom
+ */
+#define DMA_ARENA_NONCACHED_SIZE    (24 * 1024)
+
+/**
+ * @brief Cacheable pool (bytes, in RAM, 0 = none)
+ * @note  SPI RX 8.3 KB (cache_maint.h)
+ */
+#define DMA_ARENA_CACHED_SIZE       (9 * 1024)
+
+/**
+ * @brief Allocation table entries (boot report)
+ */
+#define DMA_ARENA_MAX_BLOCKS        12
+
+/**
+ * @brief Round up to whole cache lines
+ */
+#define DMA_ARENA_ROUND(size)       (((size) + DMA_ARENA_LINE - 1) & ~(DMA_ARENA_LINE - 1))
+
+/* ============================================================================ */
+/* Types */
+/* ============================================================================ */
+
+/**
+ * @brief Cache attribute of a DMA buffer
+ */
+typedef enum {
+    DMA_MEM_NONCACHED = 0,      // RAM_DMA, coherent
+    DMA_MEM_CACHED    = 1       // RAM, owner does cache maintenance
+} DmaMemAttr_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Allocate a DMA buffer
+ * @param attr DMA_MEM_NONCACHED / DMA_MEM_CACHED
+ * @param size Size in bytes
+ * @param align Alignment in bytes (power of 2, at least DMA_ARENA_LINE is used)
+ * @param name Buffer name (static string, also the lookup key)
+ * @return Buffer (never NULL - Error_Handler() when the pool is exhausted)
+ */
+void *dma_arena_alloc(DmaMemAttr_t attr, size_t size, size_t align, const char *name);
+
+/**
+ * @brief Check that a buffer lies in the non-cacheable region (RAM_DMA)
+ * @param addr Buffer address
+ * @param size Size in bytes
+ * @return 1 if the whole range is non-cacheable
+ */
+uint8_t dma_arena_is_noncached(const void *addr, size_t size);
+
+/**
+ * @brief Bytes left in a pool
+ * @param attr DMA_MEM_NONCACHED / DMA_MEM_CACHED
+ */
+uint32_t dma_arena_free(DmaMemAttr_t attr);
+
+/**
+ * @brief Print allocation table and RAM_DMA usage
+ */
+void dma_arena_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DMA_ARENA_H */
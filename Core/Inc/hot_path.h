@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file           : hot_path.h
+  * @brief          : SRAM Placement of Interrupt Hot Paths
+  * @details        : Code that runs in the CS EXTI and DAC DMA interrupts is
+  *                   executed from SRAM, so its timing does not depend on
+  *                   ICACHE hits (flash wait states on a miss)
+  ******************************************************************************
+  * @attention
+  *
+  * HOT_PATH puts a function into .RamFunc.hot. The linker script collects
+  * .RamFunc* into .data (copied from flash by the startup code) between
+  * _sramfunc and _eramfunc, and asserts the HOT_PATH_BUDGET.
+  *
+  * Placed (per packet / per render block):
+  * - EXTI15 work (exti15_cs_irq) -> spi_handler_cs_falling / cs_rising
+  *   -> packet parsing (audio_channel_fill_packed / unpack,
+  *   audio_channel_fill_adpcm)
+  * - DAC DMA callbacks -> audio_output_dma_event -> audio_channel_render
+  *   (source, mixer, gain, DSP, upsampler, quantizer)
+  *
+  * Not placed: the generated IRQ handlers (vector entries, one call into
+  * SRAM), HAL calls on these paths (DMA IRQ dispatch, SPI re-init, DMA
+  * start) and const tables - they still go through ICACHE.
+  *
+  * Placement is listed by hot_path_report() at boot (and in the .map file,
+  * section .RamFunc.hot). Test 7 measures the worst render block with a
+  * cold ICACHE, and the worst ADPCM packet fill block from SRAM vs. the
+  * same loop built into flash.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HOT_PATH_H
+#define __HOT_PATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Place function in SRAM
+ * @note  Helpers called from placed code are static inline with
+ *        __attribute__((always_inline)): a plain static inline is emitted
+ *        out of line into .text (flash) at -O0 (Debug build)
+ */
+#define HOT_PATH                __attribute__((section(".RamFunc.hot")))
+
+/**
+ * @brief SRAM code budget (bytes, checked by the linker script)
+ */
+#define HOT_PATH_BUDGET         (16 * 1024)
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Check if an address is executed from SRAM
+ * @param fn Function address
+ * @return 1 if in SRAM, 0 if in flash
+ */
+uint8_t hot_path_in_sram(const void *fn);
+
+/**
+ * @brief Print hot path placement and SRAM code size
+ */
+void hot_path_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOT_PATH_H */
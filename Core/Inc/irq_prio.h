@@ -0,0 +1,205 @@
+/**
+  ******************************************************************************
+  * @file           : irq_prio.h
+  * @brief          : Interrupt Priority Plan, Audio Critical Sections and
+  *                   ISR Latency Measurement
+  ******************************************************************************
+  * @attention
+  *
+  * Priority plan (NVIC_PRIORITYGROUP_4 from HAL_Init: 16 preemption levels,
+  * no sub-priority bits - equal levels are taken in IRQ number order):
+  *
+  *   Level  IRQ                                   Deadline
+  *   0      SysTick                               (never masked)
+  *   1      GPDMA2 CH0/CH1 (DAC DMA), TIM2        1 ring half (32 samples)
+  *   2      EXTI15 (SPI CS), SPI1, GPDMA1 CH4/5   next CS frame
+  *   3      USART1/3, GPDMA1 CH0~3                console only
+  *   4      TIM7 (DAC CH2 trigger, no IRQ work)
+  *
+  * - DAC refill preempts a long spi_handler_cs_rising() (packet parsing,
+  *   SPI re-init), so packet size no longer adds to refill latency
+  * - CS EXTI and SPI DMA share a level - SPI state is never preempted
+  *   by its own driver
+  * - irq_prio_apply() re-asserts the plan after CubeMX init. The generated
+  *   NVIC calls and the .ioc use the same values (SPI1 is re-initialized
+  *   on every CS rising edge)
+  *
+  * Shared AudioChannel_t state (written at level 2 or from the main loop,
+  * rendered at level 1) is changed inside audio_lock() / audio_unlock():
+  * BASEPRI masks levels >= 1, SysTick keeps running. Sample data is
+  * written lock-free, render (level 1) preempting the writer (level 2):
+  * - A/B fill buffer: the swap takes it once full (fill_seq release). On
+  *   an underrun render also reads it live, up to fill_index - a release
+  *   store after the samples it covers, so every sample below it is
+  *   complete and never rewritten until the next reset; a reset drops the
+  *   live window (flush_req != flush_ack) before the producer rewinds
+  * - Clip pool: an upload may write a slot a voice is playing. Voices keep
+  *   their own pointer / length (set under audio_lock()), so render only
+  *   ever reads inside the allocated clip - old and new samples may mix
+  *   (audible), never memory outside it (audio_channel.h, clip_cache.h)
+  * Sections hold the state update only - printf, HAL start / stop calls
+  * and DMA stop waits stay outside (spi_handler.c cmd_lock()).
+  *
+  * Latency measurement (irq_lat_enable()):
+  * - DAC DMA callbacks: entry delay = trigger timer count since the DAC
+  *   trigger that raised the DMA event (timer clock = CPU clock)
+  * - EXTI15: main loop pends the IRQ by software (probe) and the handler
+  *   measures DWT cycles from pend to entry
+  * - Worst handler run time per IRQ and worst audio_lock() hold time
+  *
+  ******************************************************************************
+  */
+
+#ifndef __IRQ_PRIO_H
+#define __IRQ_PRIO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ============================================================================ */
+/* Priority Plan */
+/* ============================================================================ */
+
+#define IRQ_PRIO_TICK           0   // SysTick (TICK_INT_PRIORITY)
+#define IRQ_PRIO_AUDIO          1   // DAC DMA, TIM2 sample clock
+#define IRQ_PRIO_SPI            2   // CS EXTI, SPI1, SPI DMA
+#define IRQ_PRIO_COM            3   // UART console + DMA
+#define IRQ_PRIO_LOW            4   // Trigger timers without IRQ work
+
+/**
+ * @brief BASEPRI value masking a level and everything below it
+ */
+#define IRQ_PRIO_BASEPRI(level) ((level) << (8U - __NVIC_PRIO_BITS))
+
+/* ============================================================================ */
+/* Audio Critical Section */
+/* ============================================================================ */
+
+/**
+ * @brief Worst audio_lock() hold time (DWT cycles, measurement mode)
+ */
+extern volatile uint32_t g_audio_lock_max;
+
+/**
+ * @brief Measurement mode flag (irq_lat_enable())
+ */
+extern volatile uint8_t g_irq_lat_enabled;
+
+/**
+ * @brief Lock out the render path (DAC DMA, TIM2)
+ * @return Previous BASEPRI (pass to audio_unlock)
+ * @note   Nests - BASEPRI is only ever raised
+ */
+static inline __attribute__((always_inline))
+uint32_t audio_lock(void)
+{
+    uint32_t prev = __get_BASEPRI();
+
+    __set_BASEPRI_MAX(IRQ_PRIO_BASEPRI(IRQ_PRIO_AUDIO));
+    __ISB();
+
+    return prev;
+}
+
+/**
+ * @brief Leave an audio_lock() section
+ * @param prev Value returned by audio_lock()
+ */
+static inline __attribute__((always_inline))
+void audio_unlock(uint32_t prev)
+{
+    __set_BASEPRI(prev);
+}
+
+/* ============================================================================ */
+/* Latency Measurement */
+/* ============================================================================ */
+
+/**
+ * @brief Measured IRQs
+ */
+typedef enum {
+    IRQ_LAT_DAC1 = 0,           // DAC CH1 DMA half / complete
+    IRQ_LAT_DAC2,               // DAC CH2 DMA half / complete
+    IRQ_LAT_CS,                 // EXTI15 (CS edges + probes)
+    IRQ_LAT_COUNT
+} IrqLatId_t;
+
+/**
+ * @brief Per IRQ statistics (DWT cycles)
+ */
+typedef struct {
+    uint32_t count;             // Measured entries
+    uint32_t entry_max;         // Worst entry delay
+    uint32_t run_max;           // Worst handler run time
+} IrqLatStats_t;
+
+/**
+ * @brief Read cycle counter at handler entry (0 when not measuring)
+ */
+static inline __attribute__((always_inline))
+uint32_t irq_lat_begin(void)
+{
+    return g_irq_lat_enabled ? DWT->CYCCNT : 0;
+}
+
+/**
+ * @brief Apply the priority plan to all used IRQs
+ */
+void irq_prio_apply(void);
+
+/**
+ * @brief Print the priority plan (current NVIC values)
+ */
+void irq_prio_report(void);
+
+/**
+ * @brief Start / stop latency measurement (clears statistics on start)
+ * @param enable 1 = measure
+ */
+void irq_lat_enable(uint8_t enable);
+
+/**
+ * @brief Record one handler run
+ * @param id IRQ_LAT_xxx
+ * @param t0 irq_lat_begin() value
+ * @param entry Entry delay (cycles, 0 = not known for this entry)
+ */
+void irq_lat_end(IrqLatId_t id, uint32_t t0, uint32_t entry);
+
+/**
+ * @brief Entry delay of a DAC DMA event (trigger timer count, cycles)
+ * @param dac_channel DAC_CHANNEL_1 / DAC_CHANNEL_2
+ */
+uint32_t irq_lat_dac_entry(uint32_t dac_channel);
+
+/**
+ * @brief Pend an EXTI15 probe (main loop, measurement mode only)
+ */
+void irq_lat_probe(void);
+
+/**
+ * @brief Take a pending probe at EXTI15 entry
+ * @return Entry delay in cycles, 0 if no probe was pending
+ */
+uint32_t irq_lat_probe_taken(void);
+
+/**
+ * @brief Record an audio_lock() hold time
+ * @param t0 irq_lat_begin() value at lock
+ */
+void irq_lat_lock_end(uint32_t t0);
+
+/**
+ * @brief Get statistics of one IRQ
+ */
+const IrqLatStats_t *irq_lat_get(IrqLatId_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IRQ_PRIO_H */
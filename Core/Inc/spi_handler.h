@@ -31,6 +31,17 @@ extern "C" {
 #include "spi_protocol.h"
 #include "audio_channel.h"
 
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief SPI RX DMA buffer (bytes, one packet per CS frame)
+ * @note  DataPacketHeader_t (5) + MAX_SAMPLES_PER_PACKET * 2 = 8205,
+ *        rounded up for headroom. Allocated from the DMA arena
+ */
+#define SPI_RX_BUFFER_SIZE      8300
+
 /* ============================================================================ */
 /* SPI Reception State Machine */
 /* ============================================================================ */
@@ -58,10 +69,14 @@ typedef struct {
     uint32_t cs_falling_count;      // CS falling edge count
     uint32_t cs_rising_count;       // CS rising edge count
     uint32_t cmd_packet_count;      // Command packets received
-    uint32_t data_packet_count;     // Data packets received
+    uint32_t data_packet_count;     // Data packets received (PCM + ADPCM)
+    uint32_t adpcm_packet_count;    // ADPCM data packets received
+    uint32_t param_packet_count;    // Parameter packets applied
+    uint32_t clip_packet_count;     // Clip upload chunks stored
     uint32_t last_received_bytes;   // Last packet size
     uint32_t dma_start_fail_count;  // DMA start failed count
     uint32_t last_spi_state;        // Last SPI state when DMA failed
+    uint32_t schedule_miss_count;   // CMD_PLAY_AT target passed / not synced
 } SPI_ErrorStats_t;
 
 /* ============================================================================ */
@@ -150,6 +165,16 @@ void spi_handler_cs_falling(void);
  */
 void spi_handler_cs_rising(void);
 
+/**
+ * @brief Process one packet received over another transport
+ * @param buf Packet bytes, same layout as one SPI CS frame (0xC0 / 0xDA /
+ *            0xDB / 0xCB / 0xCC header first)
+ * @param len Packet length
+ * @note  Main loop only (UART1 bench link, uart_link.h). Updates the same
+ *        counters as SPI packets
+ */
+void spi_handler_process_packet(uint8_t *buf, uint32_t len);
+
 /**
  * @brief Get last received packet (for debugging)
  * @param buffer Output buffer (must be at least 5 bytes)
@@ -9,8 +9,25 @@
   *
   * SPI Protocol Specification v1.2 (2025-11-07)
   * - Command Packet: 5 bytes (0xC0 header) - slave_id removed
-  * - Data Packet: 4 bytes header + N*2 bytes samples (max 2048 samples)
+  * - Data Packet: 4 bytes header + N samples (max 2048 samples)
+  *   - format 0: 16-bit (N*2 bytes), 1: 12-bit packed (N*3/2 bytes), 2: 8-bit (N bytes)
+  * - ADPCM Data Packet: 8 bytes header + (N+1)/2 bytes (4-bit IMA-ADPCM)
+  * - Parameter Packet: 4 bytes header + len bytes (0xCB, output DSP config)
+  * - Clip Upload Packet: 10 bytes header + N samples (0xCC, clip cache)
   * - Handshake: RDY pin control (Active Low)
+  * - Scheduled start: CMD_SYNC then CMD_PLAY_AT (16-bit sample index @ 32kHz,
+  *   target must be < 1 s ahead)
+  * - Stereo lock: CMD_STEREO 1 -> PLAY/STOP on either channel starts/stops both
+  * - PLAY fades in, STOP/RESET fade out (CMD_FADE sets the ramp, default 5 ms)
+  * - CMD_VOLUME is ramped at output (CMD_VOLUME_RAMP sets the ramp, default 20 ms)
+  * - CMD_TONE plays a built-in test tone / noise without data packets
+  * - Clip cache: upload once with 0xCC packets, CMD_CLIP_PLAY plays from the
+  *   slave RAM (no streaming)
+  * - Mix flag (CMD_CLIP_PLAY / CMD_TONE): voice is mixed over the playing
+  *   stream instead of replacing it (up to 4 voices per channel)
+  * - Late data is played as it arrives, gaps are concealed (CMD_CONCEAL)
+  * - PARAM_JITTER target depth: while playing, RDY is LOW only while a
+  *   channel is below its target
   * - Hardware CS pin selects slave (no software slave_id needed)
   *
   ******************************************************************************
@@ -57,6 +74,9 @@ extern "C" {
  */
 #define HEADER_CMD              0xC0    // Command packet header
 #define HEADER_DATA             0xDA    // Data packet header
+#define HEADER_DATA_ADPCM       0xDB    // ADPCM data packet header (4-bit IMA)
+#define HEADER_PARAM            0xCB    // Parameter packet header (DSP config)
+#define HEADER_CLIP             0xCC    // Clip upload packet header (clip cache)
 
 /**
  * @brief Command codes
@@ -64,6 +84,19 @@ extern "C" {
 #define CMD_PLAY                0x01    // Start playback
 #define CMD_STOP                0x02    // Stop playback
 #define CMD_VOLUME              0x03    // Set volume (0-100)
+#define CMD_SYNC                0x04    // Align time base (param = Master sample index)
+#define CMD_PLAY_AT             0x05    // Start playback at Master sample index (param)
+#define CMD_STEREO              0x06    // Stereo lock (1 = both channels on one timer)
+#define CMD_FADE                0x07    // Fade in/out time in ms (0 = off)
+#define CMD_VOLUME_RAMP         0x08    // Volume change ramp time in ms (0 = step)
+#define CMD_DITHER              0x09    // 12-bit quantizer (0 = off, 1 = TPDF, 2/3 = shaped)
+#define CMD_OVERSAMPLE          0x0A    // DAC oversampling 1/2/4x (both channels, stopped)
+#define CMD_TONE                0x0B    // Tone generator (0 = stop, 1 sine, 2 square, 3 sweep, 4 white, 5 pink, | TONE_PARAM_MIX)
+#define CMD_TONE_FREQ           0x0C    // Tone frequency in Hz
+#define CMD_CLIP_PLAY           0x0D    // Play cached clip ([7] loop, [6] mix, [3:0] slot | gain %)
+#define CMD_CLIP_STOP           0x0E    // Stop cached clip (fade out)
+#define CMD_CLIP_ERASE          0x0F    // Erase all cached clips
+#define CMD_CONCEAL             0x10    // Underrun concealment (0 = fade to silence, 1 = hold, 2 = repeat)
 #define CMD_RESET               0xFF    // Reset channel
 
 /**
@@ -72,6 +105,29 @@ extern "C" {
 #define CHANNEL_DAC1            0       // DAC1_CH1
 #define CHANNEL_DAC2            1       // DAC1_CH2
 
+/**
+ * @brief Data packet sample formats (upper nibble of data header byte [1])
+ * @note  FORMAT_16BIT = 0 keeps legacy Masters (channel byte 0x00/0x01) working
+ */
+#define SAMPLE_FORMAT_16BIT     0       // 16-bit unsigned LE, 2 bytes/sample
+#define SAMPLE_FORMAT_12BIT     1       // 12-bit packed, 3 bytes per 2 samples
+#define SAMPLE_FORMAT_8BIT      2       // 8-bit unsigned, 1 byte/sample
+
+/**
+ * @brief Parameter packet IDs (byte [2] of 0xCB packet)
+ */
+#define PARAM_DSP_ENABLE        0x01    // [flags] AUDIO_DSP_EN_xxx (EQ/DC/limiter)
+#define PARAM_DSP_EQ_STAGES     0x02    // [count] active biquad stages (0~4)
+#define PARAM_DSP_BIQUAD        0x03    // [stage][b0 b1 b2 a1 a2] int32 LE Q30
+#define PARAM_DSP_LIMITER       0x04    // [threshold LE16][release_ms LE16]
+#define PARAM_TONE_SWEEP        0x05    // [start_hz LE16][end_hz LE16][ms LE16]
+#define PARAM_JITTER            0x06    // [target LE16][low LE16] samples (target 0 = off)
+
+/**
+ * @brief Maximum parameter payload (bytes)
+ */
+#define PARAM_MAX_PAYLOAD       64
+
 /* ============================================================================ */
 /* Packet Structures */
 /* ============================================================================ */
@@ -82,7 +138,10 @@ extern "C" {
  * Byte Layout:
  * [0] header    : 0xC0
  * [1] channel   : 0=DAC1, 1=DAC2
- * [2] command   : CMD_PLAY, CMD_STOP, CMD_VOLUME, CMD_RESET
+ * [2] command   : CMD_PLAY, CMD_STOP, CMD_VOLUME, CMD_SYNC, CMD_PLAY_AT,
+ *                 CMD_STEREO, CMD_FADE, CMD_VOLUME_RAMP, CMD_DITHER,
+ *                 CMD_OVERSAMPLE, CMD_TONE, CMD_TONE_FREQ, CMD_CLIP_PLAY,
+ *                 CMD_CLIP_STOP, CMD_CLIP_ERASE, CMD_CONCEAL, CMD_RESET
  * [3] param_h   : Parameter high byte
  * [4] param_l   : Parameter low byte
  *
@@ -101,23 +160,115 @@ typedef struct __attribute__((packed)) {
  *
  * Byte Layout:
  * [0] header      : 0xDA
- * [1] channel     : 0=DAC1, 1=DAC2
+ * [1] channel     : bit[3:0] = channel (0=DAC1, 1=DAC2)
+ *                   bit[7:4] = sample format (SAMPLE_FORMAT_xxx)
  * [2] length_h    : Number of samples (high byte, big-endian)
  * [3] length_l    : Number of samples (low byte, big-endian)
- * [4~] samples[]  : Audio samples (16-bit little-endian each)
+ * [4~] samples[]  : Audio samples (see format)
+ *
+ * Sample Formats:
+ *   16BIT : 16-bit little-endian each (0x8000 = mid-scale)
+ *   12BIT : 2 samples in 3 bytes (0x800 = mid-scale)
+ *           b0 = s0[7:0], b1 = s0[11:8] | s1[3:0] << 4, b2 = s1[11:4]
+ *           Odd count: last sample uses 2 bytes (b0, b1 low nibble)
+ *   8BIT  : 1 byte each (0x80 = mid-scale)
  *
- * Total Size: 4 + (num_samples * 2) bytes
+ * Total Size: 4 + DATA_PAYLOAD_BYTES(format, num_samples) bytes
  * Maximum Size: 4 + (2048 * 2) = 4100 bytes
  *
  * NOTE: slave_id removed - hardware CS pin selects slave
  */
 typedef struct __attribute__((packed)) {
     uint8_t header;         // 0xDA
-    uint8_t channel;        // 0=DAC1, 1=DAC2
+    uint8_t channel;        // [3:0] channel, [7:4] sample format
     uint8_t length_h;       // Sample count high byte
     uint8_t length_l;       // Sample count low byte
 } DataPacketHeader_t;
 
+/**
+ * @brief ADPCM Data Packet Header Structure (8 bytes)
+ *
+ * Byte Layout:
+ * [0] header      : 0xDB
+ * [1] channel     : 0=DAC1, 1=DAC2
+ * [2] length_h    : Number of samples (high byte, big-endian)
+ * [3] length_l    : Number of samples (low byte, big-endian)
+ * [4] pred_l      : Initial predictor (signed 16-bit, little-endian)
+ * [5] pred_h
+ * [6] step_index  : Initial step index (0~88)
+ * [7] reserved    : 0x00
+ * [8~] data[]     : 4-bit codes, low nibble first
+ *
+ * Total Size: 8 + (num_samples + 1) / 2 bytes
+ *
+ * NOTE: Decoder state is carried per packet - no state across packets
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t header;         // 0xDB
+    uint8_t channel;        // 0=DAC1, 1=DAC2
+    uint8_t length_h;       // Sample count high byte
+    uint8_t length_l;       // Sample count low byte
+    uint8_t pred_l;         // Initial predictor low byte
+    uint8_t pred_h;         // Initial predictor high byte
+    uint8_t step_index;     // Initial step index
+    uint8_t reserved;       // Reserved (0x00)
+} AdpcmPacketHeader_t;
+
+/**
+ * @brief Parameter Packet Header Structure (4 bytes)
+ *
+ * Byte Layout:
+ * [0] header      : 0xCB
+ * [1] channel     : 0=DAC1, 1=DAC2
+ * [2] param_id    : PARAM_xxx
+ * [3] length      : Payload length in bytes (0~PARAM_MAX_PAYLOAD)
+ * [4~] payload[]  : Parameter value (multi-byte values little-endian)
+ *
+ * Total Size: 4 + length bytes
+ *
+ * NOTE: Parameters take effect from the next rendered block (1 ms)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t header;         // 0xCB
+    uint8_t channel;        // 0=DAC1, 1=DAC2
+    uint8_t param_id;       // Parameter ID
+    uint8_t length;         // Payload length (bytes)
+} ParamPacketHeader_t;
+
+/**
+ * @brief Clip Upload Packet Header Structure (10 bytes)
+ *
+ * Byte Layout:
+ * [0] header      : 0xCC
+ * [1] slot        : Clip slot (0~CLIP_SLOT_COUNT-1)
+ * [2] format      : Sample format (SAMPLE_FORMAT_xxx)
+ * [3] reserved    : 0x00
+ * [4] total_h     : Clip length in samples (big-endian)
+ * [5] total_l
+ * [6] offset_h    : First sample of this chunk (big-endian, 0 = new upload)
+ * [7] offset_l
+ * [8] length_h    : Samples in this chunk (big-endian)
+ * [9] length_l
+ * [10~] samples[] : Packed samples (same encoding as 0xDA)
+ *
+ * Total Size: 10 + DATA_PAYLOAD_BYTES(format, num_samples) bytes
+ *
+ * NOTE: Chunks must be sent in order, the clip is playable once
+ *       offset + length reaches total
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t header;         // 0xCC
+    uint8_t slot;           // Clip slot
+    uint8_t format;         // Sample format
+    uint8_t reserved;       // Reserved (0x00)
+    uint8_t total_h;        // Clip length high byte
+    uint8_t total_l;        // Clip length low byte
+    uint8_t offset_h;       // Chunk offset high byte
+    uint8_t offset_l;       // Chunk offset low byte
+    uint8_t length_h;       // Chunk sample count high byte
+    uint8_t length_l;       // Chunk sample count low byte
+} ClipPacketHeader_t;
+
 /**
  * @brief Complete Data Packet (variable size)
  * @note  This structure is used for buffer allocation only.
@@ -143,7 +294,57 @@ typedef struct __attribute__((packed)) {
 #define GET_SAMPLE_COUNT(hdr) ((uint16_t)(((hdr)->length_h << 8) | (hdr)->length_l))
 
 /**
- * @brief Convert 16-bit sample to 12-bit DAC value
+ * @brief Decode channel / sample format from data packet header byte [1]
+ */
+#define GET_DATA_CHANNEL(hdr) ((uint8_t)((hdr)->channel & 0x0F))
+#define GET_DATA_FORMAT(hdr)  ((uint8_t)((hdr)->channel >> 4))
+
+/**
+ * @brief Payload size in bytes for a given sample format and count
+ */
+#define DATA_PAYLOAD_BYTES(fmt, cnt) \
+    (((fmt) == SAMPLE_FORMAT_12BIT) ? (((uint32_t)(cnt) * 3 + 1) / 2) : \
+     ((fmt) == SAMPLE_FORMAT_8BIT)  ? ((uint32_t)(cnt)) :                \
+                                      ((uint32_t)(cnt) * 2))
+
+/**
+ * @brief Decode clip upload packet fields (chunk count: GET_SAMPLE_COUNT)
+ */
+#define GET_CLIP_TOTAL(hdr)   ((uint16_t)(((hdr)->total_h << 8) | (hdr)->total_l))
+#define GET_CLIP_OFFSET(hdr)  ((uint16_t)(((hdr)->offset_h << 8) | (hdr)->offset_l))
+
+/**
+ * @brief Decode CMD_CLIP_PLAY parameter
+ * @note  param_h = [7] loop, [6] mix, [3:0] slot; param_l = gain % (1~100, 0 = 100)
+ */
+#define CLIP_PARAM_LOOP       0x80
+#define CLIP_PARAM_MIX        0x40
+#define GET_CLIP_SLOT(cmd)    ((uint8_t)((cmd)->param_h & 0x0F))
+#define GET_CLIP_LOOP(cmd)    ((uint8_t)(((cmd)->param_h & CLIP_PARAM_LOOP) ? 1 : 0))
+#define GET_CLIP_MIX(cmd)     ((uint8_t)(((cmd)->param_h & CLIP_PARAM_MIX) ? 1 : 0))
+#define GET_CLIP_GAIN(cmd)    ((uint8_t)(cmd)->param_l)
+
+/**
+ * @brief CMD_TONE parameter flag: mix the tone over the playing source
+ * @note  Other bits above [7:0] are reserved - the command is rejected
+ */
+#define TONE_PARAM_MIX        0x0100
+
+/**
+ * @brief Decode initial predictor from ADPCM packet header
+ */
+#define GET_ADPCM_PREDICTOR(hdr) ((int16_t)(((hdr)->pred_h << 8) | (hdr)->pred_l))
+
+/**
+ * @brief Read little-endian values from a parameter payload
+ */
+#define GET_LE16(p) ((uint16_t)((p)[0] | ((p)[1] << 8)))
+#define GET_LE32(p) ((int32_t)((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | \
+                               ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24)))
+
+/**
+ * @brief Convert 16-bit sample to 12-bit DAC value (truncation)
+ * @note  Render uses this with CMD_DITHER off
  */
 #define SAMPLE_TO_DAC12(sample) ((uint16_t)((sample) >> 4))
 
@@ -167,6 +368,11 @@ typedef struct __attribute__((packed)) {
  */
 #define IS_VALID_CHANNEL(ch) ((ch) <= 1)
 
+/**
+ * @brief Validate data packet sample format
+ */
+#define IS_VALID_SAMPLE_FORMAT(fmt) ((fmt) <= SAMPLE_FORMAT_8BIT)
+
 /**
  * @brief Validate sample count
  */
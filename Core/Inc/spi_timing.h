@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file           : spi_timing.h
+  * @brief          : SPI Transaction Timing Capture (CS-to-CS intervals,
+  *                   bus utilization)
+  * @details        : Timestamps CS edges in EXTI15 and keeps rolling
+  *                   histograms of packet duration, inter-packet gap,
+  *                   throughput and duty cycle, so the Master's efficiency
+  *                   (SPI clock vs actual data rate) is measurable here
+  ******************************************************************************
+  * @attention
+  *
+  * Time base: DWT CYCCNT (CPU clock, free-running, no timer setup). Read
+  * as the first thing in EXTI15_IRQHandler (spi_timing_stamp()), so the
+  * stamps carry only the (constant) EXTI entry delay, not handler work.
+  * Intervals are exact up to 2^32 cycles (~17 s @ 250 MHz); a longer idle
+  * gap is recorded as "no previous packet".
+  *
+  * Per packet (CS falling .. CS rising):
+  * - Duration  = CS low time
+  * - Gap       = CS high time before the packet (previous rising .. falling)
+  * - Rate      = bytes / duration (kB/s while CS is low = effective clock)
+  * - Duty      = duration / (duration + gap)
+  *
+  * Windows: two windows, the edge handlers write the active one.
+  * spi_timing_roll() (main loop) clears the other one, switches and
+  * returns the completed window - the ISR never sees a half-cleared
+  * window, and the main loop never reads the one being written.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __SPI_TIMING_H
+#define __SPI_TIMING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Log2 histogram bins (bin n = [2^(n-1), 2^n), bin 0 = 0)
+ * @note  Duration / gap in us: bin 15 = 16.4 ms and up
+ *        Rate in kB/s:         bin 15 = 16.4 MB/s and up
+ */
+#define SPI_TIMING_BINS         16
+
+/**
+ * @brief Duty cycle bins (10 % wide)
+ */
+#define SPI_TIMING_DUTY_BINS    10
+
+/* ============================================================================ */
+/* Statistics */
+/* ============================================================================ */
+
+/**
+ * @brief One measurement window
+ */
+typedef struct {
+    uint32_t start_ms;          // HAL tick at window start
+    uint32_t length_ms;         // Window length (set by spi_timing_roll)
+
+    uint32_t packets;           // Completed CS frames
+    uint32_t bytes;             // Bytes received in them
+    uint64_t busy_cycles;       // Sum of CS low time
+
+    uint32_t dur_min;           // Shortest / longest packet (us)
+    uint32_t dur_max;
+    uint32_t gap_min;           // Shortest / longest gap (us)
+    uint32_t gap_max;
+
+    uint32_t dur_hist[SPI_TIMING_BINS];
+    uint32_t gap_hist[SPI_TIMING_BINS];
+    uint32_t rate_hist[SPI_TIMING_BINS];
+    uint32_t duty_hist[SPI_TIMING_DUTY_BINS];
+} SpiTimingWindow_t;
+
+/* ============================================================================ */
+/* Edge Stamp */
+/* ============================================================================ */
+
+/**
+ * @brief Cycle count at the last EXTI15 entry
+ */
+extern volatile uint32_t g_spi_edge_cycles;
+
+/**
+ * @brief Timestamp a CS edge (first statement of EXTI15_IRQHandler)
+ */
+static inline __attribute__((always_inline))
+void spi_timing_stamp(void)
+{
+    g_spi_edge_cycles = DWT->CYCCNT;
+}
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Start the cycle counter and clear both windows
+ */
+void spi_timing_init(void);
+
+/**
+ * @brief Record a CS falling edge (packet start, spi_handler_cs_falling)
+ */
+void spi_timing_cs_falling(void);
+
+/**
+ * @brief Record a CS rising edge (packet end, spi_handler_cs_rising)
+ * @param bytes Bytes received during the CS frame
+ */
+void spi_timing_cs_rising(uint32_t bytes);
+
+/**
+ * @brief Close the current window and start a new one (main loop)
+ * @param out Output: completed window
+ */
+void spi_timing_roll(SpiTimingWindow_t *out);
+
+/**
+ * @brief Print a window (min / median / max per histogram, utilization)
+ * @param win Window from spi_timing_roll()
+ */
+void spi_timing_report(const SpiTimingWindow_t *win);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPI_TIMING_H */
@@ -76,6 +76,9 @@ extern volatile uint32_t g_dac1_cplt_count;
 extern volatile uint32_t g_dac2_half_cplt_count;
 extern volatile uint32_t g_dac2_cplt_count;
 
+// CS edge work of EXTI15_IRQHandler (SRAM, hot_path.h)
+void exti15_cs_irq(void);
+
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
@@ -0,0 +1,124 @@
+/**
+  ******************************************************************************
+  * @file           : task_sched.h
+  * @brief          : Cooperative Main Loop Scheduler (run-to-completion)
+  ******************************************************************************
+  * @attention
+  *
+  * The main loop is a fixed table of tasks. sched_run() makes one pass
+  * in table order and calls every task that is due:
+  *
+  *   - period 0      : every pass (pollers: console, UART1 link)
+  *   - period N ms   : timer, due every N ms (no drift, skips missed
+  *                     periods instead of bursting)
+  *   - event flags   : sched_signal() sets bits (ISR safe), the task runs
+  *                     on the next pass and gets the bits (cleared)
+  *
+  * Tasks run to completion and must not block: long work is split into
+  * steps kept in the task's own state (console jobs, console.h). One slow
+  * task delays all others - 'tasks' (sched_report()) shows the longest
+  * run of each task in CPU cycles (DWT).
+  *
+  * Interrupt work (SPI, DAC DMA, UART DMA) is not affected: tasks only
+  * replace the polling that used to live in per-mode while(1) loops.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TASK_SCHED_H
+#define __TASK_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+#define SCHED_MAX_TASKS         12
+
+/* ============================================================================ */
+/* Types */
+/* ============================================================================ */
+
+/**
+ * @brief Task function
+ * @param events Event flags taken for this run (0 = timer / poll)
+ */
+typedef void (*SchedTaskFn_t)(uint32_t events);
+
+/**
+ * @brief Task handle (index in the task table), -1 = none
+ */
+typedef int8_t SchedTask_t;
+
+/**
+ * @brief Per-task statistics
+ */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;         // 0 = every pass
+    uint8_t enabled;
+    uint32_t runs;
+    uint32_t max_cycles;        // Longest run (DWT cycles)
+    uint32_t late_max_ms;       // Timer tasks: largest start delay
+} SchedTaskStats_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Clear the task table, enable the DWT cycle counter
+ */
+void sched_init(void);
+
+/**
+ * @brief Add a task (enabled, runs in table order)
+ * @param name Name for sched_report()
+ * @param fn Task function
+ * @param period_ms Timer period, 0 = every pass
+ * @return Handle, -1 if the table is full
+ */
+SchedTask_t sched_add(const char *name, SchedTaskFn_t fn, uint32_t period_ms);
+
+/**
+ * @brief Enable / disable a task (pending events are kept)
+ * @note  Enabling restarts the timer: first run after one period
+ */
+void sched_enable(SchedTask_t task, uint8_t enable);
+
+/**
+ * @brief Change the timer period (restarts the timer)
+ */
+void sched_set_period(SchedTask_t task, uint32_t period_ms);
+
+/**
+ * @brief Set event flags, task runs on the next pass (ISR safe)
+ */
+void sched_signal(SchedTask_t task, uint32_t events);
+
+/**
+ * @brief One pass over the task table (main loop)
+ */
+void sched_run(void);
+
+/**
+ * @brief Get task statistics
+ * @return 0 on success, 1 if the handle is invalid
+ */
+uint8_t sched_get_stats(SchedTask_t task, SchedTaskStats_t *stats);
+
+/**
+ * @brief Print task table, passes per second, clear the maxima
+ */
+void sched_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TASK_SCHED_H */
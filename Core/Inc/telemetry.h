@@ -0,0 +1,137 @@
+/**
+  ******************************************************************************
+  * @file           : telemetry.h
+  * @brief          : Binary Telemetry Frames over UART3
+  * @details        : Compact COBS-framed snapshot of all channel and SPI
+  *                   counters at up to 100 Hz, replacing the text STATUS
+  *                   dump while enabled (decoder: tools/telemetry.py)
+  ******************************************************************************
+  * @attention
+  *
+  * Frame = cobs.h framing of TelemetryFrame_t (little-endian, packed):
+  * 84 byte payload -> 89 bytes on the wire. 100 Hz uses ~77 % of
+  * 115200 baud; the rate is limited to what the console baud rate carries.
+  *
+  * Transport: frames go through the UART3 TX queue and are sent by DMA
+  * like printf output, so building a frame costs a struct copy, a CRC
+  * and COBS over 86 bytes (no vsprintf). A frame is queued whole or
+  * dropped (queue full) - the host sees the gap in seq.
+  *
+  * Counters are free-running (host takes differences); 16-bit fields
+  * wrap and are unwrapped by the decoder.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include "audio_channel.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_MAX_HZ        100
+
+/* ============================================================================ */
+/* Frame Layout */
+/* ============================================================================ */
+
+/**
+ * @brief Channel state bits
+ */
+#define TELEM_CH_PLAYING        0x01    // is_playing
+#define TELEM_CH_ACTIVE_B       0x02    // Playing buffer B
+#define TELEM_CH_LOCAL_SRC      0x04    // Tone / clip source active
+#define TELEM_CH_CONCEAL        0x08    // Concealing an underrun
+
+/**
+ * @brief Per-channel counters (21 bytes)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  state;             // TELEM_CH_xxx
+    uint16_t depth;             // Samples queued (audio_channel_depth)
+    uint32_t samples;           // Samples played
+    uint32_t swaps;             // A/B buffer swaps
+    uint32_t underruns;         // Underrun events
+    uint32_t underrun_samples;  // Samples concealed
+    uint16_t underrun_max;      // Longest gap (saturated)
+} TelemetryChannel_t;
+
+/**
+ * @brief SPI counters (36 bytes)
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t cs_falling;
+    uint32_t cs_rising;
+    uint32_t cmd_packets;
+    uint32_t data_packets;      // PCM + ADPCM
+    uint32_t spi_errors;
+    uint16_t adpcm_packets;
+    uint16_t param_packets;
+    uint16_t clip_packets;
+    uint16_t invalid_headers;
+    uint16_t overflows;
+    uint16_t dma_start_fails;
+    uint16_t schedule_misses;
+    uint16_t last_rx_bytes;
+} TelemetrySpi_t;
+
+/**
+ * @brief Telemetry frame payload (84 bytes)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  version;           // TELEMETRY_VERSION
+    uint8_t  seq;               // Frame counter (gaps = dropped frames)
+    uint32_t tick_ms;           // HAL tick at capture
+    TelemetryChannel_t ch[2];   // DAC1, DAC2
+    TelemetrySpi_t spi;
+} TelemetryFrame_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Initialize (telemetry off)
+ * @param dac1_ch DAC1 audio channel
+ * @param dac2_ch DAC2 audio channel
+ */
+void telemetry_init(AudioChannel_t *dac1_ch, AudioChannel_t *dac2_ch);
+
+/**
+ * @brief Set frame rate
+ * @param hz Frames per second (0 = off, max TELEMETRY_MAX_HZ)
+ * @return 0 on success, 1 if out of range
+ */
+uint8_t telemetry_set_rate(uint8_t hz);
+
+/**
+ * @brief Get frame rate (0 = off)
+ */
+uint8_t telemetry_get_rate(void);
+
+/**
+ * @brief Send a frame when due (main loop)
+ * @param now HAL tick
+ * @return 1 if a frame was queued
+ */
+uint8_t telemetry_poll(uint32_t now);
+
+/**
+ * @brief Frames dropped because the TX queue was full
+ */
+uint32_t telemetry_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEMETRY_H */
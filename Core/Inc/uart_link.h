@@ -0,0 +1,115 @@
+/**
+  ******************************************************************************
+  * @file           : uart_link.h
+  * @brief          : UART1 Binary Packet Link (bench streaming)
+  * @details        : Receives the SPI packet set over UART1 so a PC can
+  *                   drive the slave without a Master board
+  *                   (streamer: tools/uart_stream.py)
+  ******************************************************************************
+  * @attention
+  *
+  * Wire format: one SPI CS frame (CommandPacket_t, DataPacketHeader_t +
+  * samples, ADPCM / parameter / clip packets) per cobs.h frame:
+  *
+  *   0x00 | COBS( packet | CRC16 LE ) | 0x00
+  *
+  * The delimiter takes the place of CS: a frame is exactly the bytes a
+  * Master would clock out between CS falling and rising. Valid frames go
+  * to spi_handler_process_packet(), the path SPI packets take, so the
+  * same counters (STATUS / telemetry) show UART1 traffic.
+  *
+  * Reception: circular DMA (GPDMA1 CH2, linked list) into a ring in the
+  * non-cacheable DMA arena, idle line / half / full events advance the
+  * write count (as UART3, user_com.c). The main loop decodes COBS while
+  * bytes arrive, so a frame (up to 8.2 KB) never has to fit in the ring -
+  * the ring only covers main loop latency (4 KB = 13 ms at 3 Mbaud).
+  *
+  * USART1 is single-wire half-duplex on PB14 (CubeMX): the link only
+  * receives. There is no RDY on UART1 - the streamer paces itself on
+  * its clock and corrects from the slave's telemetry (UART3).
+  *
+  * Throughput (10 bits per byte): 16-bit stereo at 32 kHz = 128 KB/s,
+  * ~1.3 Mbaud with framing. Default 3 Mbaud, USART1 kernel clock
+  * PCLK2 = 250 MHz allows up to 15.6 Mbaud.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __UART_LINK_H
+#define __UART_LINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+/**
+ * @brief Link baud rate (max PCLK2 / 16 = 15.6 Mbaud)
+ */
+#define UART_LINK_BAUD          3000000
+
+/**
+ * @brief DMA RX ring (bytes, power of 2)
+ */
+#define UART_LINK_RING_SIZE     4096
+
+/* ============================================================================ */
+/* Types */
+/* ============================================================================ */
+
+/**
+ * @brief Link statistics
+ */
+typedef struct {
+    uint32_t bytes;             // Bytes decoded
+    uint32_t frames;            // Valid frames (packets handed to spi_handler)
+    uint32_t bad_frames;        // Malformed / CRC mismatch
+    uint32_t oversize;          // Frames longer than SPI_RX_BUFFER_SIZE
+    uint32_t ring_overruns;     // Ring lapped before the main loop read it
+    uint32_t uart_errors;       // Overrun / noise / framing errors
+} UartLinkStats_t;
+
+/* ============================================================================ */
+/* Function Prototypes */
+/* ============================================================================ */
+
+/**
+ * @brief Configure USART1 (UART_LINK_BAUD, receiver) and start reception
+ * @note  Call after spi_handler_init(). Re-init keeps the ring block
+ */
+void uart_link_init(void);
+
+/**
+ * @brief RX event (idle line, half, full) - advance the write count
+ * @param pos DMA position in the ring
+ * @note  From HAL_UARTEx_RxEventCallback (USART1 / GPDMA1 CH2 IRQ)
+ */
+void uart_link_rx_event(uint16_t pos);
+
+/**
+ * @brief UART error - restart reception if HAL stopped it
+ * @note  From HAL_UART_ErrorCallback
+ */
+void uart_link_rx_error(void);
+
+/**
+ * @brief Decode received bytes and apply complete packets (main loop)
+ */
+void uart_link_poll(void);
+
+/**
+ * @brief Get link statistics
+ * @param stats Output
+ */
+void uart_link_get_stats(UartLinkStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UART_LINK_H */
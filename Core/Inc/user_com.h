@@ -26,6 +26,15 @@
 #define DMA_RX_BUFFER_SIZE	256
 #define DMA_TX_BUFFER_SIZE	512
 
+// UART3 console: USART3 kernel clock = PCLK1 (250 MHz), 16x oversampling
+// -> up to 15.6 Mbaud. Host terminal must match (UART3_Set_Baud)
+#define UART3_BAUD_RATE		115200
+
+// UART3 RX: circular DMA ring (power of 2, non-cacheable DMA arena)
+// Read in place by UART3_RX_Peek() / UART3_RX_Byte(). Sized for the main
+// loop latency: 1024 bytes = 5 ms at 2 Mbaud
+#define UART3_RX_RING_SIZE	1024
+
 // DMA TX state
 extern volatile uint8_t g_uart3_tx_busy;
 
@@ -42,17 +51,6 @@ struct uart_Stat_ST {
 	uint16_t cal_CRC16;
 };
 
-typedef enum
-{
-  NOT_LINE = 0,
-  RCV_LINE = 1,
-  WNG_LINE = 2,
-  PAS_LINE = 3,
-} COM_Idy_Typ;
-
-#define UART3_ECHO
-#define UART3_ETX		'\r'
-
 #define UART1_ECHO
 #define UART1_ETX		'\r'
 
@@ -65,10 +63,19 @@ void UART_baudrate_set(UART_HandleTypeDef *tm_hart,uint32_t baud_rate);
 void init_UART_COM(void);
 void printf_UARTC(UART_HandleTypeDef *h_tmUART,uint8_t color,const char *str_buf,...);
 
-COM_Idy_Typ UART3_GetLine(uint8_t *line_buf);
+// DMA circular RX (idle line / half / full events)
+void UART3_RX_Start(void);
+void UART3_RX_Event(uint16_t pos);
+uint16_t UART3_RX_Len(void);
+uint8_t UART3_RX_Byte(void);
+uint32_t UART3_RX_Peek(const uint8_t **data);
+void UART3_RX_Take(uint32_t len);
+uint32_t UART3_RX_Get_Overruns(void);
+uint8_t UART3_Set_Baud(uint32_t baud_rate);
 
 // DMA-based TX functions
 void UART3_Process_TX_Queue(void);
+uint8_t UART3_TX_Idle(void);
 void UART3_TX_Complete_Callback(void);
 
 // Debug function
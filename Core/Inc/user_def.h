@@ -1,29 +1,20 @@
 #include "main.h"
 
 // Phase 1: Hardware Verification Tests
-void test_led_blink(void);           // Test 1: LED blink test
-void test_dac_sine_wave(void);       // Test 2: DAC sine wave test (TIM6 + DMA)
-void test_dac_quick(void);           // Test 3: DAC quick test (5 sec)
-void test_uart_loopback(void);       // Test 4: UART loopback test (HW test)
-void test_uart_echo(void);           // Test 5: UART echo test (RX test)
-void test_rdy_pin(void);             // Test 6: RDY pin toggle test
-void test_dac_dma_sine(void);        // Test 7: DAC DMA sine wave (buffer fill)
-
-// Legacy test functions
-void test_gpio(void);
-void test_dac_sine(void);
-void init_sine_table(void);
-
-void proc_uart3(void);
+// Menu tests (LED, siren, DAC, RDY, SPI, DAC DMA, benchmark) are console
+// commands in user_def.c (g_menu_cmds, console.h)
+void init_sine_table(void);          // Sine table (DAC DMA / benchmark tests)
 
 // Main application
 void init_proc(void);
 void run_proc(void);
 
-// Slave mode (main application)
+// Slave mode (main application): starts the slave tasks and returns,
+// the tasks run from the run_test_menu() loop
 void run_slave_mode(void);
+uint8_t slave_mode_running(void);
 
-// Test menu
+// Test menu / console, main loop (scheduler, task_sched.h)
 void show_test_menu(void);
 void run_test_menu(void);
 
@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+  * @file           : adpcm.c
+  * @brief          : IMA-ADPCM (4-bit) Encoder/Decoder Implementation
+  ******************************************************************************
+  */
+
+#include "adpcm.h"
+
+/* ============================================================================ */
+/* Tables */
+/* ============================================================================ */
+
+const int16_t adpcm_step_table[ADPCM_STEP_INDEX_MAX + 1] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const int8_t adpcm_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/* ============================================================================ */
+/* Private Functions */
+/* ============================================================================ */
+
+/**
+ * @brief Encode one signed PCM sample to a 4-bit code
+ * @note  Uses the decoder to track the predictor, so encoder and decoder
+ *        states stay bit-identical
+ */
+static uint8_t adpcm_encode_sample(AdpcmState_t *st, int16_t sample)
+{
+    int32_t step = adpcm_step_table[st->step_index];
+    int32_t diff = (int32_t)sample - st->predictor;
+    uint8_t code = 0;
+
+    if (diff < 0)
+    {
+        code = 8;
+        diff = -diff;
+    }
+
+    if (diff >= step)
+    {
+        code |= 4;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        code |= 2;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        code |= 1;
+    }
+
+    (void)adpcm_decode_sample(st, code);
+
+    return code;
+}
+
+/* ============================================================================ */
+/* Public Functions */
+/* ============================================================================ */
+
+void adpcm_init(AdpcmState_t *st)
+{
+    st->predictor = 0;
+    st->step_index = 0;
+}
+
+uint32_t adpcm_encode(AdpcmState_t *st, const uint16_t *samples, uint32_t count, uint8_t *out)
+{
+    uint32_t bytes = 0;
+
+    for (uint32_t i = 0; i < count; i += 2)
+    {
+        uint8_t lo = adpcm_encode_sample(st, (int16_t)(samples[i] ^ 0x8000));
+        uint8_t hi = 0;
+
+        if ((i + 1) < count)
+        {
+            hi = adpcm_encode_sample(st, (int16_t)(samples[i + 1] ^ 0x8000));
+        }
+
+        out[bytes++] = (uint8_t)(lo | (hi << 4));
+    }
+
+    return bytes;
+}
+
+uint32_t adpcm_decode(AdpcmState_t *st, const uint8_t *in, uint32_t count, uint16_t *samples)
+{
+    uint32_t i = 0;
+
+    // Two samples per byte
+    for (; (i + 1) < count; i += 2)
+    {
+        uint8_t byte = *in++;
+        samples[i]     = (uint16_t)adpcm_decode_sample(st, byte & 0x0F) ^ 0x8000;
+        samples[i + 1] = (uint16_t)adpcm_decode_sample(st, byte >> 4) ^ 0x8000;
+    }
+
+    // Odd sample count: last byte holds one sample in the low nibble
+    if (i < count)
+    {
+        samples[i++] = (uint16_t)adpcm_decode_sample(st, *in & 0x0F) ^ 0x8000;
+    }
+
+    return i;
+}
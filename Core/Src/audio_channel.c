@@ -6,100 +6,324 @@
   */
 
 #include "audio_channel.h"
+#include "hot_path.h"
 #include <string.h>
 
+/**
+ * @brief Cross-context access to the hand-off indices (single writer each)
+ * @note  Cortex-M33: aligned word load / store + DMB
+ */
+#define CH_LOAD(field)          __atomic_load_n(&(field), __ATOMIC_ACQUIRE)
+#define CH_STORE(field, value)  __atomic_store_n(&(field), (value), __ATOMIC_RELEASE)
+
 /* ============================================================================ */
 /* Initialization */
 /* ============================================================================ */
 
-void audio_channel_init(AudioChannel_t *ch, uint16_t *buf_a, uint16_t *buf_b)
+void audio_channel_init(AudioChannel_t *ch, int16_t *buf_a, int16_t *buf_b)
 {
     // Set buffer pointers
     ch->buffer_a = buf_a;
     ch->buffer_b = buf_b;
-    ch->active_buffer = buf_a;
-    ch->fill_buffer = buf_b;
+
+    // Render from A (seq 0), fill B
+    ch->fill_seq = 0;
+    ch->fill_epoch = 0;
+    ch->flush_ack = 0;
     ch->fill_index = 0;
+    ch->play_seq = 0;
+    ch->flush_req = 0;
+    ch->play_index = 0;
+    ch->live_index = 0;
+
+    // Underrun concealment (fade to silence until CMD_CONCEAL)
+    memset(&ch->conceal, 0, sizeof(ch->conceal));
+    ch->conceal.mode = AUDIO_CONCEAL_SILENCE;
+
+    // Jitter buffer (no target until PARAM_JITTER)
+    audio_jitter_init(&ch->jitter);
 
     // Initialize state
     ch->is_playing = 0;
     ch->underrun = 0;
     ch->volume = 100;  // Default: 100% volume
 
+    // Fade ramp (starts silent, PLAY fades in)
+    memset(&ch->fade, 0, sizeof(ch->fade));
+    audio_channel_set_fade_time(ch, AUDIO_FADE_DEFAULT_MS);
+
+    // Volume ramp (starts at unity)
+    memset(&ch->vol, 0, sizeof(ch->vol));
+    ch->vol.gain = AUDIO_FADE_UNITY;
+    ch->vol.target = AUDIO_FADE_UNITY;
+    audio_channel_set_volume_ramp(ch, AUDIO_VOLUME_RAMP_DEFAULT_MS);
+
+    // Output DSP chain (bypassed until configured)
+    audio_dsp_init(&ch->dsp);
+
+    // No oversampling until CMD_OVERSAMPLE
+    ch->oversample = 1;
+    audio_dsp_upsample_reset(&ch->upsampler);
+
+    // Quantizer (truncate until CMD_DITHER), channels get different seeds
+    ch->dither = AUDIO_DITHER_OFF;
+    ch->dither_seed = 0x12345678u ^ (uint32_t)(uintptr_t)ch;
+    if (ch->dither_seed == 0)
+    {
+        ch->dither_seed = 1;
+    }
+    ch->ns_err[0] = 0;
+    ch->ns_err[1] = 0;
+
+    // Tone generator / clip voice off (render from A/B buffers)
+    audio_gen_init(&ch->gen, ~ch->dither_seed);
+    memset(&ch->clip, 0, sizeof(ch->clip));
+    audio_mixer_init(&ch->mixer);
+
     // Clear statistics
     ch->total_samples = 0;
     ch->buffer_swaps = 0;
     ch->underrun_count = 0;
+    ch->underrun_samples = 0;
+    ch->underrun_max = 0;
 
-    // Clear buffers (set to mid-scale for 12-bit DAC: 2048)
-    for (uint16_t i = 0; i < AUDIO_BUFFER_SIZE; i++)
-    {
-        buf_a[i] = 2048;  // Mid-scale (0V for AC-coupled output)
-        buf_b[i] = 2048;
-    }
+    // Clear buffers (PCM 0 = DAC mid-scale 2048)
+    memset(buf_a, 0, AUDIO_BUFFER_SIZE * sizeof(int16_t));
+    memset(buf_b, 0, AUDIO_BUFFER_SIZE * sizeof(int16_t));
 }
 
 /* ============================================================================ */
 /* Buffer Management */
 /* ============================================================================ */
 
+/**
+ * @brief Convert one unsigned 16-bit wire sample to signed PCM
+ * @note  Volume is applied in render, not here
+ */
+static inline int16_t audio_channel_convert(uint16_t sample_16bit)
+{
+    // Offset-binary -> two's complement (0x8000 -> 0)
+    return (int16_t)(sample_16bit ^ 0x8000);
+}
+
+/**
+ * @brief Claim space in the fill buffer (producer)
+ * @param count Samples wanted
+ * @param dst Output: write position
+ * @return Samples that fit (0 while the full buffer waits for the swap)
+ */
+static inline __attribute__((always_inline))
+uint16_t audio_channel_fill_claim(AudioChannel_t *ch, uint16_t count, int16_t **dst)
+{
+    // Reset since the last fill - drop the partial buffer
+    uint32_t req = CH_LOAD(ch->flush_req);
+    if (req != ch->flush_ack)
+    {
+        // Index cleared before the ack - render may read it once acked
+        CH_STORE(ch->fill_index, 0);
+        CH_STORE(ch->flush_ack, req);
+    }
+
+    // Published buffer not taken yet - nothing to fill
+    if (CH_LOAD(ch->play_seq) != ch->fill_seq)
+    {
+        return 0;
+    }
+
+    uint16_t space = AUDIO_BUFFER_SIZE - ch->fill_index;
+    *dst = &audio_channel_slot(ch, ch->fill_seq + 1)[ch->fill_index];
+
+    return (count > space) ? space : count;
+}
+
+/**
+ * @brief Commit written samples, publish the buffer when full (producer)
+ */
+static inline __attribute__((always_inline))
+void audio_channel_fill_commit(AudioChannel_t *ch, uint16_t count)
+{
+    uint16_t index = ch->fill_index + count;
+
+    // Update statistics
+    ch->total_samples += count;
+
+    if (index >= AUDIO_BUFFER_SIZE)
+    {
+        // Samples and epoch are visible before the new fill_seq, and
+        // fill_seq before the index goes back to 0: render never sees an
+        // empty fill buffer that is about to be published (false underrun)
+        ch->fill_epoch = ch->flush_ack;
+        CH_STORE(ch->fill_seq, ch->fill_seq + 1);
+        CH_STORE(ch->fill_index, 0);
+    }
+    else
+    {
+        CH_STORE(ch->fill_index, index);
+    }
+}
+
 uint16_t audio_channel_fill(AudioChannel_t *ch, uint16_t *samples, uint16_t count)
 {
-    uint16_t filled = 0;
+    int16_t *dst;
+
+    // Limit to free space (stop filling when buffer is full)
+    count = audio_channel_fill_claim(ch, count, &dst);
 
     for (uint16_t i = 0; i < count; i++)
     {
-        // Check if buffer is full
-        if (ch->fill_index >= AUDIO_BUFFER_SIZE)
-        {
-            break;  // Buffer full, stop filling
-        }
+        dst[i] = audio_channel_convert(samples[i]);
+    }
 
-        // Convert 16-bit sample to 12-bit DAC value
-        uint16_t sample_16bit = samples[i];
-        uint16_t dac_12bit = SAMPLE_TO_DAC12(sample_16bit);
+    audio_channel_fill_commit(ch, count);
 
-        // Apply volume scaling
-        if (ch->volume < 100)
-        {
-            // Scale DAC value around mid-point (2048)
-            int32_t offset = (int32_t)dac_12bit - 2048;
-            offset = (offset * ch->volume) / 100;
-            dac_12bit = (uint16_t)(2048 + offset);
-        }
+    return count;
+}
 
-        // Clamp to 12-bit range (0-4095)
-        if (dac_12bit > 4095)
-        {
-            dac_12bit = 4095;
-        }
+/**
+ * @brief 12-bit packed kernel (2 samples / 3 bytes) -> PCM buffer
+ */
+static HOT_PATH void audio_channel_unpack12(int16_t *dst, const uint8_t *src, uint16_t count)
+{
+    uint16_t pairs = count / 2;
+
+    for (uint16_t i = 0; i < pairs; i++)
+    {
+        int32_t s0 = (int32_t)(src[0] | ((src[1] & 0x0F) << 8)) - 2048;
+        int32_t s1 = (int32_t)((src[1] >> 4) | (src[2] << 4)) - 2048;
+        src += 3;
 
-        // Fill buffer
-        ch->fill_buffer[ch->fill_index++] = dac_12bit;
-        filled++;
+        // 12-bit -> 16-bit (0x800 -> 0)
+        *dst++ = (int16_t)(s0 << 4);
+        *dst++ = (int16_t)(s1 << 4);
     }
 
-    // Update statistics
-    ch->total_samples += filled;
+    // Odd count: last sample in b0 + low nibble of b1
+    if (count & 1)
+    {
+        int32_t s0 = (int32_t)(src[0] | ((src[1] & 0x0F) << 8)) - 2048;
+        *dst = (int16_t)(s0 << 4);
+    }
+}
 
-    return filled;
+/**
+ * @brief 8-bit unsigned kernel -> PCM buffer
+ */
+static HOT_PATH void audio_channel_unpack8(int16_t *dst, const uint8_t *src, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        // 8-bit -> 16-bit (0x80 -> 0)
+        dst[i] = (int16_t)(((int32_t)src[i] - 128) << 8);
+    }
 }
 
-uint8_t audio_channel_swap_buffers(AudioChannel_t *ch)
+/**
+ * @brief 16-bit little-endian kernel -> PCM buffer
+ * @note  Byte access - payload is not guaranteed to be 2-byte aligned
+ */
+static HOT_PATH void audio_channel_unpack16(int16_t *dst, const uint8_t *src, uint16_t count)
 {
-    // Check if fill buffer is ready (full or close to full)
-    if (ch->fill_index < AUDIO_BUFFER_SIZE)
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint16_t sample = (uint16_t)(src[0] | (src[1] << 8));
+        src += 2;
+        dst[i] = audio_channel_convert(sample);
+    }
+}
+
+HOT_PATH uint8_t audio_channel_unpack(int16_t *dst, uint8_t format, const uint8_t *data, uint16_t count)
+{
+    switch (format)
+    {
+        case SAMPLE_FORMAT_12BIT:
+            audio_channel_unpack12(dst, data, count);
+            break;
+
+        case SAMPLE_FORMAT_8BIT:
+            audio_channel_unpack8(dst, data, count);
+            break;
+
+        case SAMPLE_FORMAT_16BIT:
+            audio_channel_unpack16(dst, data, count);
+            break;
+
+        default:
+            return 1;  // Unknown format
+    }
+
+    return 0;
+}
+
+HOT_PATH uint16_t audio_channel_fill_packed(AudioChannel_t *ch, uint8_t format,
+                                            const uint8_t *data, uint16_t count)
+{
+    int16_t *dst;
+
+    // Limit to free space (stop filling when buffer is full)
+    count = audio_channel_fill_claim(ch, count, &dst);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (audio_channel_unpack(dst, format, data, count) != 0)
+    {
+        return 0;  // Unknown format
+    }
+
+    audio_channel_fill_commit(ch, count);
+
+    return count;
+}
+
+HOT_PATH uint16_t audio_channel_fill_adpcm(AudioChannel_t *ch, AdpcmState_t *state,
+                                           const uint8_t *data, uint16_t count)
+{
+    int16_t *dst;
+
+    // Limit to free space (stop filling when buffer is full)
+    count = audio_channel_fill_claim(ch, count, &dst);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        // Low nibble = even sample, high nibble = odd sample
+        uint8_t byte = data[i >> 1];
+        uint8_t code = (i & 1) ? (byte >> 4) : (byte & 0x0F);
+
+        // Decode straight into the PCM buffer
+        dst[i] = adpcm_decode_sample(state, code);
+    }
+
+    audio_channel_fill_commit(ch, count);
+
+    return count;
+}
+
+HOT_PATH uint8_t audio_channel_swap_buffers(AudioChannel_t *ch)
+{
+    uint32_t seq = ch->play_seq;
+
+    // Check if fill buffer is ready (published since the last swap)
+    if (CH_LOAD(ch->fill_seq) == seq)
     {
         return 0;  // Not ready to swap
     }
 
-    // Swap buffers
-    uint16_t *temp = ch->active_buffer;
-    ch->active_buffer = ch->fill_buffer;
-    ch->fill_buffer = temp;
+    // Filled before a reset - read before the slot goes back to the producer
+    uint8_t stale = (ch->fill_epoch != ch->flush_req);
 
-    // Reset fill index
-    ch->fill_index = 0;
+    // Take the fill buffer, hand the played one back. Samples already
+    // played from it during an underrun are skipped
+    seq++;
+    CH_STORE(ch->play_seq, seq);
+    ch->play_index = ch->live_index;
+    ch->live_index = 0;
+
+    if (stale)
+    {
+        memset(audio_channel_slot(ch, seq), 0, AUDIO_BUFFER_SIZE * sizeof(int16_t));
+    }
 
     // Update statistics
     ch->buffer_swaps++;
@@ -107,11 +331,42 @@ uint8_t audio_channel_swap_buffers(AudioChannel_t *ch)
     return 1;  // Swap successful
 }
 
-uint8_t audio_channel_ready(AudioChannel_t *ch)
+HOT_PATH uint16_t audio_channel_fill_level(const AudioChannel_t *ch)
+{
+    // Full buffer waiting for the swap
+    if (CH_LOAD(ch->fill_seq) != CH_LOAD(ch->play_seq))
+    {
+        return AUDIO_BUFFER_SIZE;
+    }
+
+    // Reset not yet seen by the producer - partial buffer is dropped
+    if (CH_LOAD(ch->flush_req) != CH_LOAD(ch->flush_ack))
+    {
+        return 0;
+    }
+
+    return CH_LOAD(ch->fill_index);
+}
+
+HOT_PATH uint16_t audio_channel_depth(const AudioChannel_t *ch)
+{
+    uint16_t depth = (ch->play_index < AUDIO_BUFFER_SIZE) ? (AUDIO_BUFFER_SIZE - ch->play_index) : 0;
+    uint16_t pending = audio_channel_fill_level(ch);
+
+    // Part of the fill buffer may already be played (underrun, live)
+    if (pending > ch->live_index)
+    {
+        depth += pending - ch->live_index;
+    }
+
+    return depth;
+}
+
+HOT_PATH uint8_t audio_channel_ready(AudioChannel_t *ch)
 {
     // Ready if fill buffer has at least half full
     // This provides some margin before starting playback
-    return (ch->fill_index >= (AUDIO_BUFFER_SIZE / 2));
+    return (audio_channel_fill_level(ch) >= (AUDIO_BUFFER_SIZE / 2));
 }
 
 void audio_channel_reset(AudioChannel_t *ch)
@@ -119,18 +374,746 @@ void audio_channel_reset(AudioChannel_t *ch)
     // Stop playback
     ch->is_playing = 0;
 
-    // Reset buffer state
-    ch->fill_index = 0;
+    // Take a published buffer (its samples are dropped below), then ask
+    // the producer to restart its fill buffer
+    CH_STORE(ch->play_seq, CH_LOAD(ch->fill_seq));
+    CH_STORE(ch->flush_req, ch->flush_req + 1);
+    ch->play_index = 0;
+    ch->live_index = 0;
     ch->underrun = 0;
 
-    // Clear buffers
-    for (uint16_t i = 0; i < AUDIO_BUFFER_SIZE; i++)
+    // Concealment restarts from silence (mode kept)
+    ch->conceal.active = 0;
+    ch->conceal.resume = 0;
+    ch->conceal.last = 0;
+
+    // Output is silent after reset (next PLAY fades in)
+    ch->fade.gain = 0;
+    ch->fade.remaining = 0;
+
+    // Volume lands on its target (no ramp pending)
+    ch->vol.gain = ch->vol.target;
+    ch->vol.remaining = 0;
+
+    // Clear filter history (configuration kept)
+    audio_dsp_reset(&ch->dsp);
+    audio_dsp_upsample_reset(&ch->upsampler);
+    audio_gen_stop(&ch->gen);
+    clip_voice_stop(&ch->clip);
+    audio_mixer_reset(&ch->mixer);
+    ch->ns_err[0] = 0;
+    ch->ns_err[1] = 0;
+
+    // Clear the active buffer (the fill buffer is only played once refilled)
+    memset(audio_channel_active(ch), 0, AUDIO_BUFFER_SIZE * sizeof(int16_t));
+
+    // Don't reset statistics - keep for debugging
+}
+
+/* ============================================================================ */
+/* Render (PCM -> DAC) */
+/* ============================================================================ */
+
+/**
+ * @brief Work block (int32, 16-bit PCM scale) -> 12-bit DAC values
+ * @note  Saturates - DSP stages may exceed the 16-bit range
+ */
+static HOT_PATH void render_to_dac(uint16_t *out, const int32_t *work, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
     {
-        ch->buffer_a[i] = 2048;
-        ch->buffer_b[i] = 2048;
+        int32_t pcm = work[i];
+
+        if (pcm > 32767)  pcm = 32767;
+        if (pcm < -32768) pcm = -32768;
+
+        out[i] = SAMPLE_TO_DAC12((uint16_t)(pcm ^ 0x8000));
     }
+}
 
-    // Don't reset statistics - keep for debugging
+/**
+ * @brief TPDF dither / noise-shaping quantizer
+ * @param order Noise shaping order (0 = plain TPDF, 1, 2) - constant per
+ *        call site so the per-sample branches fold away
+ * @note  Error feedback: u = x - H(e), NTF = (1 - z^-1)^order
+ *        Dither = sum of two 4-bit uniform values from one xorshift32 step
+ *        (triangular, +/-15 = just under +/-1 LSB of the 12-bit output)
+ */
+static inline __attribute__((always_inline))
+void render_quantize(AudioChannel_t *ch, uint16_t *out, const int32_t *work,
+                     uint16_t n, const uint8_t order)
+{
+    uint32_t seed = ch->dither_seed;
+    int32_t e1 = ch->ns_err[0];
+    int32_t e2 = ch->ns_err[1];
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int32_t u = work[i];
+
+        if (order == 1)
+        {
+            u -= e1;
+        }
+        else if (order == 2)
+        {
+            u -= 2 * e1 - e2;
+        }
+
+        // xorshift32 (LFSR family, 3 shifts + 3 XORs)
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int32_t tpdf = (int32_t)(seed & 0x0F) + (int32_t)((seed >> 4) & 0x0F) - 15;
+
+        // 16-bit offset-binary -> 12-bit code (floor), saturated
+        int32_t code = (u + tpdf + 32768) >> 4;
+        if (code > 4095) code = 4095;
+        if (code < 0)    code = 0;
+        out[i] = (uint16_t)code;
+
+        // Total error seen by the feedback filter (clamped so a saturated
+        // DAC cannot wind up the loop)
+        int32_t e = ((code << 4) - 32768) - u;
+        if (e > 256)  e = 256;
+        if (e < -256) e = -256;
+        e2 = e1;
+        e1 = e;
+    }
+
+    ch->dither_seed = seed;
+    ch->ns_err[0] = e1;
+    ch->ns_err[1] = e2;
+}
+
+/**
+ * @brief Convert a work block with the selected quantizer
+ * @note  Mode is selected once per block
+ */
+static HOT_PATH void render_output(AudioChannel_t *ch, uint16_t *out, const int32_t *work, uint16_t n)
+{
+    switch (ch->dither)
+    {
+        case AUDIO_DITHER_TPDF:
+            render_quantize(ch, out, work, n, 0);
+            break;
+
+        case AUDIO_DITHER_NS1:
+            render_quantize(ch, out, work, n, 1);
+            break;
+
+        case AUDIO_DITHER_NS2:
+            render_quantize(ch, out, work, n, 2);
+            break;
+
+        default:
+            render_to_dac(out, work, n);
+            break;
+    }
+}
+
+/**
+ * @brief Unity gain kernel
+ */
+static HOT_PATH void render_unity(int32_t *work, const int16_t *src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        work[i] = src[i];
+    }
+}
+
+/**
+ * @brief Constant gain kernel
+ * @param gain Q15 gain (0 < gain < 32768)
+ */
+static HOT_PATH void render_gain(int32_t *work, const int16_t *src, uint16_t n, int32_t gain)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        work[i] = (src[i] * gain) >> 15;
+    }
+}
+
+/**
+ * @brief Linear ramp kernel (gain stepped every sample)
+ * @param gain Q30 gain (updated)
+ * @param step Q30 increment per sample
+ */
+static HOT_PATH void render_ramp(int32_t *work, const int16_t *src, uint16_t n,
+                                 int32_t *gain, int32_t step)
+{
+    int32_t g = *gain;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        g += step;
+        work[i] = (src[i] * (g >> 15)) >> 15;
+    }
+
+    *gain = g;
+}
+
+/**
+ * @brief Silence kernel
+ */
+static HOT_PATH void render_silence(int32_t *work, uint16_t n)
+{
+    memset(work, 0, n * sizeof(int32_t));
+}
+
+/**
+ * @brief Advance a gain ramp by n samples
+ * @return 1 if the ramp ended within these samples
+ */
+static HOT_PATH uint8_t ramp_advance(AudioRamp_t *r, uint16_t n)
+{
+    if (r->remaining == 0)
+    {
+        return 0;
+    }
+
+    if (n >= r->remaining)
+    {
+        // Land exactly on target (step rounding)
+        r->gain = r->target;
+        r->remaining = 0;
+        return 1;
+    }
+
+    r->gain += r->step * n;
+    r->remaining -= n;
+    return 0;
+}
+
+/**
+ * @brief Combined fade x volume gain (Q30)
+ */
+static inline __attribute__((always_inline))
+int32_t render_gain_now(const AudioChannel_t *ch)
+{
+    int32_t g = (ch->fade.gain >> 15) * (ch->vol.gain >> 15);
+
+    // Cached clip gain on top (unity keeps the exact unity kernel)
+    if (clip_voice_active(&ch->clip) && ch->clip.gain < CLIP_GAIN_UNITY)
+    {
+        g = (g >> 15) * ch->clip.gain;
+    }
+
+    return g;
+}
+
+/**
+ * @brief Apply fade and volume gain to one segment (at most one block)
+ * @note  Gain is interpolated linearly from block start to block end,
+ *        the kernel is selected once per segment, not per sample
+ */
+static HOT_PATH uint8_t render_segment(AudioChannel_t *ch, int32_t *work, const int16_t *src, uint16_t n)
+{
+    uint8_t flags = 0;
+    int32_t g0 = render_gain_now(ch);
+
+    // Advance both ramps to the end of this segment
+    if (ramp_advance(&ch->fade, n) && (ch->fade.target == 0))
+    {
+        flags |= AUDIO_RENDER_FADED_OUT;
+    }
+    (void)ramp_advance(&ch->vol, n);
+
+    int32_t g1 = render_gain_now(ch);
+
+    if (g0 != g1)
+    {
+        render_ramp(work, src, n, &g0, (g1 - g0) / n);
+    }
+    else if (g1 >= AUDIO_FADE_UNITY)
+    {
+        render_unity(work, src, n);
+    }
+    else if (g1 <= 0)
+    {
+        render_silence(work, n);
+    }
+    else
+    {
+        render_gain(work, src, n, g1 >> 15);
+    }
+
+    return flags;
+}
+
+/**
+ * @brief Samples written to the fill buffer past live_index (underrun)
+ * @note  Producer fields are only read. 0 once the buffer is published
+ *        (swap instead) or while a reset drops it
+ */
+static inline __attribute__((always_inline))
+uint16_t render_live_avail(const AudioChannel_t *ch)
+{
+    if (CH_LOAD(ch->fill_seq) != ch->play_seq ||
+        CH_LOAD(ch->flush_ack) != ch->flush_req)
+    {
+        return 0;
+    }
+
+    uint16_t written = CH_LOAD(ch->fill_index);
+
+    return (written > ch->live_index) ? (written - ch->live_index) : 0;
+}
+
+/**
+ * @brief Keep the last stream samples for AUDIO_CONCEAL_REPEAT
+ * @note  Active buffer tail + fill buffer head (played live), both still
+ *        readable by the consumer at this point
+ */
+static HOT_PATH void conceal_capture(AudioChannel_t *ch)
+{
+    int16_t *seg = ch->conceal.segment;
+    uint16_t live = ch->live_index;
+
+    if (live >= AUDIO_CONCEAL_SEGMENT)
+    {
+        memcpy(seg, &audio_channel_slot(ch, ch->play_seq + 1)[live - AUDIO_CONCEAL_SEGMENT],
+               AUDIO_CONCEAL_SEGMENT * sizeof(int16_t));
+        return;
+    }
+
+    uint16_t tail = AUDIO_CONCEAL_SEGMENT - live;
+
+    memcpy(seg, &audio_channel_active(ch)[AUDIO_BUFFER_SIZE - tail], tail * sizeof(int16_t));
+    memcpy(&seg[tail], audio_channel_slot(ch, ch->play_seq + 1), live * sizeof(int16_t));
+}
+
+/**
+ * @brief Fade kernel (from -> 0 over AUDIO_CONCEAL_FADE, then silence)
+ */
+static HOT_PATH void conceal_fade(AudioConceal_t *c, int16_t *dst, uint16_t n)
+{
+    uint16_t i = 0;
+
+    for (; i < n && c->pos < AUDIO_CONCEAL_FADE; i++)
+    {
+        c->pos++;
+        dst[i] = (int16_t)((c->from * (AUDIO_CONCEAL_FADE - c->pos)) / AUDIO_CONCEAL_FADE);
+    }
+
+    if (i < n)
+    {
+        memset(&dst[i], 0, (n - i) * sizeof(int16_t));
+    }
+}
+
+/**
+ * @brief Hold kernel (last sample)
+ */
+static HOT_PATH void conceal_hold(AudioConceal_t *c, int16_t *dst, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = c->last;
+    }
+}
+
+/**
+ * @brief Repeat kernel (segment loop, seam crossfaded from its last sample)
+ */
+static HOT_PATH void conceal_repeat(AudioConceal_t *c, int16_t *dst, uint16_t n)
+{
+    const int16_t *seg = c->segment;
+    int32_t seam = seg[AUDIO_CONCEAL_SEGMENT - 1];
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        uint16_t j = c->pos;
+        int32_t v = seg[j];
+
+        // Start of each pass: ramp from the sample before the seam
+        if (j < AUDIO_CONCEAL_FADE)
+        {
+            v = (v * j + seam * (AUDIO_CONCEAL_FADE - j)) / AUDIO_CONCEAL_FADE;
+        }
+
+        dst[i] = (int16_t)v;
+        c->pos = (j + 1 < AUDIO_CONCEAL_SEGMENT) ? (j + 1) : 0;
+    }
+}
+
+/**
+ * @brief Fill a segment with concealment (no stream data)
+ */
+static HOT_PATH const int16_t *render_conceal(AudioChannel_t *ch, uint16_t n,
+                                              int16_t *tmp, uint8_t *flags)
+{
+    AudioConceal_t *c = &ch->conceal;
+
+    if (!c->active)
+    {
+        // Underrun starts - concealment continues from the last sample
+        c->active = 1;
+        c->resume = 0;
+        c->run = 0;
+        c->pos = 0;
+        c->from = c->last;
+
+        if (c->mode == AUDIO_CONCEAL_REPEAT)
+        {
+            conceal_capture(ch);
+        }
+
+        ch->underrun = 1;
+        ch->underrun_count++;
+        *flags |= AUDIO_RENDER_UNDERRUN;
+    }
+
+    // Repeat time over - fade out from the current loop value
+    if (c->mode == AUDIO_CONCEAL_REPEAT && c->run >= AUDIO_CONCEAL_REPEAT_MAX)
+    {
+        if (c->run == AUDIO_CONCEAL_REPEAT_MAX)
+        {
+            c->from = c->last;
+            c->pos = 0;
+        }
+        conceal_fade(c, tmp, n);
+    }
+    else if (c->mode == AUDIO_CONCEAL_REPEAT)
+    {
+        // Block may cross the repeat limit - split it
+        uint32_t left = AUDIO_CONCEAL_REPEAT_MAX - c->run;
+        uint16_t k = (n > left) ? (uint16_t)left : n;
+
+        conceal_repeat(c, tmp, k);
+        if (k < n)
+        {
+            c->from = tmp[k - 1];
+            c->pos = 0;
+            conceal_fade(c, &tmp[k], n - k);
+        }
+    }
+    else if (c->mode == AUDIO_CONCEAL_HOLD)
+    {
+        conceal_hold(c, tmp, n);
+    }
+    else
+    {
+        conceal_fade(c, tmp, n);
+    }
+
+    c->run += n;
+    c->last = tmp[n - 1];
+    ch->underrun_samples += n;
+
+    return tmp;
+}
+
+/**
+ * @brief Stream data returned - close the underrun, crossfade from the
+ *        last concealed sample into the data
+ */
+static HOT_PATH const int16_t *render_resume(AudioChannel_t *ch, const int16_t *src,
+                                             uint16_t n, int16_t *tmp)
+{
+    AudioConceal_t *c = &ch->conceal;
+
+    if (c->active)
+    {
+        c->active = 0;
+        c->resume = AUDIO_CONCEAL_FADE;
+        c->from = c->last;
+
+        if (c->run > ch->underrun_max)
+        {
+            ch->underrun_max = c->run;
+        }
+        audio_channel_clear_underrun(ch);
+    }
+
+    if (c->resume == 0)
+    {
+        return src;
+    }
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int32_t w = c->resume;      // AUDIO_CONCEAL_FADE .. 1 (weight of from)
+
+        if (w > 0)
+        {
+            c->resume--;
+        }
+
+        tmp[i] = (int16_t)(src[i] + ((c->from - src[i]) * w) / AUDIO_CONCEAL_FADE);
+    }
+
+    return tmp;
+}
+
+/**
+ * @brief Next segment of the A/B stream (swap, live fill buffer or concealment)
+ */
+static HOT_PATH const int16_t *render_stream(AudioChannel_t *ch, uint16_t *n,
+                                             int16_t *tmp, uint8_t *flags)
+{
+    const int16_t *src;
+
+    // End of active buffer: swap to the fill buffer once published,
+    // until then play it as far as written
+    if (ch->play_index >= AUDIO_BUFFER_SIZE)
+    {
+        // Read before the swap check - valid if nothing was published
+        uint16_t avail = render_live_avail(ch);
+
+        if (audio_channel_swap_buffers(ch))
+        {
+            *flags |= AUDIO_RENDER_SWAPPED;
+        }
+        else if (avail == 0)
+        {
+            return render_conceal(ch, *n, tmp, flags);
+        }
+        else
+        {
+            if (*n > avail)
+            {
+                *n = avail;
+            }
+
+            src = &audio_channel_slot(ch, ch->play_seq + 1)[ch->live_index];
+            ch->live_index += *n;
+
+            src = render_resume(ch, src, *n, tmp);
+            ch->conceal.last = src[*n - 1];
+            return src;
+        }
+    }
+
+    uint16_t left = AUDIO_BUFFER_SIZE - ch->play_index;
+    if (*n > left)
+    {
+        *n = left;
+    }
+
+    src = &audio_channel_active(ch)[ch->play_index];
+    ch->play_index += *n;
+
+    src = render_resume(ch, src, *n, tmp);
+    ch->conceal.last = src[*n - 1];
+
+    return src;
+}
+
+/**
+ * @brief Get the next source segment (A/B buffer, generator or cached clip)
+ * @param n In: samples wanted (<= AUDIO_BLOCK_SIZE), out: samples available
+ * @param gen_buf Generator output / clip tail block (tone or clip active)
+ * @param flags AUDIO_RENDER_xxx (updated on swap / underrun)
+ */
+static HOT_PATH const int16_t *render_source(AudioChannel_t *ch, uint16_t *n,
+                                    int16_t *gen_buf, uint8_t *flags)
+{
+    // Test tone / alarm: A/B buffers are not consumed
+    if (audio_gen_active(&ch->gen))
+    {
+        audio_gen_render(&ch->gen, gen_buf, *n);
+        return gen_buf;
+    }
+
+    // Cached clip: read straight from the pool (silence once played out)
+    if (clip_voice_active(&ch->clip))
+    {
+        uint8_t ended = 0;
+        return clip_voice_next(&ch->clip, n, gen_buf, &ended);
+    }
+
+    return render_stream(ch, n, gen_buf, flags);
+}
+
+HOT_PATH uint8_t audio_channel_render(AudioChannel_t *ch, uint16_t *out, uint16_t count)
+{
+    uint8_t flags = 0;
+    int16_t gen_buf[AUDIO_BLOCK_SIZE];
+    int16_t mix_buf[AUDIO_BLOCK_SIZE];
+    int32_t work[AUDIO_BLOCK_SIZE];
+    int32_t work_os[AUDIO_BLOCK_SIZE * AUDIO_OVERSAMPLE_MAX];
+    uint8_t os = ch->oversample;
+
+    // Queue depth at this DMA event (streamed source only)
+    if (!audio_gen_active(&ch->gen) && !clip_voice_active(&ch->clip))
+    {
+        if (audio_jitter_sample(&ch->jitter, audio_channel_depth(ch)))
+        {
+            flags |= AUDIO_RENDER_NEED_DATA;
+        }
+    }
+
+    while (count > 0)
+    {
+        // One block at most (gain interpolation interval)
+        uint16_t n = (count > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : count;
+        const int16_t *src = render_source(ch, &n, gen_buf, &flags);
+
+        // Overlapping voices (alerts over the stream)
+        if (audio_mixer_active(&ch->mixer))
+        {
+            src = audio_mixer_process(&ch->mixer, src, mix_buf, n);
+        }
+
+        // Gain -> DSP chain -> DAC
+        flags |= render_segment(ch, work, src, n);
+
+        if (audio_dsp_active(&ch->dsp))
+        {
+            audio_dsp_process(&ch->dsp, work, n);
+        }
+
+        if (os > 1)
+        {
+            // Interpolate to the DAC rate, quantize at the higher rate
+            audio_dsp_upsample(&ch->upsampler, work, work_os, n, os);
+            render_output(ch, out, work_os, n * os);
+        }
+        else
+        {
+            render_output(ch, out, work, n);
+        }
+
+        out += n * os;
+        count -= n;
+    }
+
+    // One-shot clip played out and no mixed voice left - channel can stop
+    if (ch->clip.done && !audio_mixer_active(&ch->mixer))
+    {
+        flags |= AUDIO_RENDER_SOURCE_END;
+    }
+
+    return flags;
+}
+
+/* ============================================================================ */
+/* Fade Control */
+/* ============================================================================ */
+
+/**
+ * @brief Ramp length in samples from ms (capped at 16 bits)
+ */
+static uint16_t audio_channel_ms_to_samples(uint16_t ms)
+{
+    uint32_t samples = ((uint32_t)ms * AUDIO_SAMPLE_RATE) / 1000;
+
+    return (samples > 0xFFFF) ? 0xFFFF : (uint16_t)samples;
+}
+
+/**
+ * @brief Start a ramp from the current gain to target over r->samples
+ */
+static void audio_channel_start_ramp(AudioRamp_t *r, int32_t target)
+{
+    r->target = target;
+
+    if (r->samples == 0)
+    {
+        // Hard switch
+        r->gain = target;
+        r->remaining = 0;
+        return;
+    }
+
+    r->step = (target - r->gain) / r->samples;
+    r->remaining = r->samples;
+}
+
+void audio_channel_set_fade_time(AudioChannel_t *ch, uint16_t ms)
+{
+    ch->fade.samples = audio_channel_ms_to_samples(ms);
+}
+
+void audio_channel_fade_in(AudioChannel_t *ch)
+{
+    ch->fade.gain = 0;
+    audio_channel_start_ramp(&ch->fade, AUDIO_FADE_UNITY);
+}
+
+uint8_t audio_channel_fade_out(AudioChannel_t *ch)
+{
+    audio_channel_start_ramp(&ch->fade, 0);
+
+    // Silent already (hard stop or gain was 0) - caller stops now
+    return (ch->fade.gain == 0 && ch->fade.remaining == 0);
+}
+
+/* ============================================================================ */
+/* Oversampling Control */
+/* ============================================================================ */
+
+uint8_t audio_channel_set_oversample(AudioChannel_t *ch, uint8_t factor)
+{
+    if (factor != 1 && factor != 2 && factor != 4)
+    {
+        return 1;
+    }
+
+    audio_dsp_upsample_reset(&ch->upsampler);
+    ch->oversample = factor;
+
+    return 0;
+}
+
+/* ============================================================================ */
+/* Quantizer Control */
+/* ============================================================================ */
+
+uint8_t audio_channel_set_dither(AudioChannel_t *ch, uint8_t mode)
+{
+    if (mode > AUDIO_DITHER_MAX)
+    {
+        return 1;
+    }
+
+    // Start the shaping filter from zero error
+    ch->ns_err[0] = 0;
+    ch->ns_err[1] = 0;
+    ch->dither = mode;
+
+    return 0;
+}
+
+/* ============================================================================ */
+/* Underrun Concealment */
+/* ============================================================================ */
+
+uint8_t audio_channel_set_conceal(AudioChannel_t *ch, uint8_t mode)
+{
+    if (mode > AUDIO_CONCEAL_MAX)
+    {
+        return 1;
+    }
+
+    // Takes effect at the next underrun
+    ch->conceal.mode = mode;
+
+    return 0;
+}
+
+/* ============================================================================ */
+/* Volume Control */
+/* ============================================================================ */
+
+void audio_channel_set_volume(AudioChannel_t *ch, uint8_t volume)
+{
+    if (volume > 100)
+    {
+        volume = 100;
+    }
+
+    ch->volume = volume;
+
+    // 0-100% -> Q30 (100 = exactly unity)
+    audio_channel_start_ramp(&ch->vol, (int32_t)(((int64_t)AUDIO_FADE_UNITY * volume) / 100));
+}
+
+void audio_channel_set_volume_ramp(AudioChannel_t *ch, uint16_t ms)
+{
+    ch->vol.samples = audio_channel_ms_to_samples(ms);
 }
 
 /* ============================================================================ */
@@ -158,6 +1141,19 @@ void audio_channel_get_stats(AudioChannel_t *ch,
     }
 }
 
+void audio_channel_get_underrun(AudioChannel_t *ch, uint32_t *samples, uint32_t *longest)
+{
+    if (samples)
+    {
+        *samples = ch->underrun_samples;
+    }
+
+    if (longest)
+    {
+        *longest = ch->underrun_max;
+    }
+}
+
 void audio_channel_clear_underrun(AudioChannel_t *ch)
 {
     ch->underrun = 0;
@@ -0,0 +1,423 @@
+/**
+  ******************************************************************************
+  * @file           : audio_dsp.c
+  * @brief          : Output Stage DSP Chain Implementation
+  ******************************************************************************
+  */
+
+#include "audio_dsp.h"
+#include "hot_path.h"
+#include "audio_channel.h"
+#include <string.h>
+
+/* ============================================================================ */
+/* Initialization */
+/* ============================================================================ */
+
+/**
+ * @brief Clear limiter history (unity gain, empty delay line)
+ */
+static void audio_dsp_limit_reset(AudioDsp_t *dsp)
+{
+    memset(dsp->lim_delay, 0, sizeof(dsp->lim_delay));
+
+    for (uint16_t i = 0; i < AUDIO_DSP_LOOKAHEAD; i++)
+    {
+        dsp->lim_req[i] = AUDIO_DSP_Q30_ONE;
+        dsp->lim_env_hist[i] = AUDIO_DSP_Q30_ONE;
+    }
+
+    dsp->lim_gain = AUDIO_DSP_Q30_ONE;
+    dsp->lim_env = AUDIO_DSP_Q30_ONE;
+    dsp->lim_min = AUDIO_DSP_Q30_ONE;
+    dsp->lim_min_age = 0;
+    dsp->lim_hold_left = 0;
+    dsp->lim_pos = 0;
+    dsp->lim_env_sum = (int64_t)AUDIO_DSP_Q30_ONE * AUDIO_DSP_LOOKAHEAD;
+}
+
+void audio_dsp_init(AudioDsp_t *dsp)
+{
+    memset(dsp, 0, sizeof(AudioDsp_t));
+
+    // Flat EQ (b0 = 1) so enabling without coefficients is transparent
+    for (uint8_t s = 0; s < AUDIO_DSP_MAX_BIQUADS; s++)
+    {
+        dsp->coef[s].b0 = AUDIO_DSP_Q30_ONE;
+    }
+
+    audio_dsp_set_limiter(dsp, AUDIO_DSP_LIMIT_DEFAULT, AUDIO_DSP_RELEASE_DEFAULT);
+    audio_dsp_reset(dsp);
+}
+
+void audio_dsp_reset(AudioDsp_t *dsp)
+{
+    memset(dsp->eq_state, 0, sizeof(dsp->eq_state));
+
+    dsp->dc_x1 = 0;
+    dsp->dc_y1 = 0;
+    dsp->dc_frac = 0;
+
+    audio_dsp_limit_reset(dsp);
+}
+
+/* ============================================================================ */
+/* Stages */
+/* ============================================================================ */
+
+/**
+ * @brief Cascaded biquads (DF1), one stage over the whole block at a time
+ * @note  State stays in registers for the inner loop, 5 SMLAL per sample.
+ *        Truncation error is fed back (2nd order, 2 e[n-1] - e[n-2]) - with
+ *        poles near z = 1 (40 Hz high-pass) plain truncation adds a DC offset
+ *        of thousands of LSB
+ */
+static HOT_PATH void audio_dsp_eq(AudioDsp_t *dsp, int32_t *buf, uint16_t count)
+{
+    for (uint8_t s = 0; s < dsp->num_biquads; s++)
+    {
+        const AudioBiquad_t *c = &dsp->coef[s];
+        int32_t *st = dsp->eq_state[s];
+        int32_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3], e1 = st[4], e2 = st[5];
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            int32_t x = buf[i];
+            int64_t acc = ((int64_t)e1 << 1) - e2;
+            acc += (int64_t)c->b0 * x;
+            acc += (int64_t)c->b1 * x1;
+            acc += (int64_t)c->b2 * x2;
+            acc -= (int64_t)c->a1 * y1;
+            acc -= (int64_t)c->a2 * y2;
+
+            int32_t y = (int32_t)(acc >> 30);
+            e2 = e1;
+            e1 = (int32_t)(acc & (AUDIO_DSP_Q30_ONE - 1));
+
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            buf[i] = y;
+        }
+
+        st[0] = x1;
+        st[1] = x2;
+        st[2] = y1;
+        st[3] = y2;
+        st[4] = e1;
+        st[5] = e2;
+    }
+}
+
+/**
+ * @brief First-order DC blocker
+ * @note  Fraction carried like the EQ - truncating R * y[n-1] alone leaves
+ *        an offset of -0.5 / (1 - R) = -250 LSB
+ */
+static HOT_PATH void audio_dsp_dc_block(AudioDsp_t *dsp, int32_t *buf, uint16_t count)
+{
+    int32_t x1 = dsp->dc_x1;
+    int32_t y1 = dsp->dc_y1;
+    int32_t frac = dsp->dc_frac;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        int32_t x = buf[i];
+        int64_t acc = ((int64_t)(x - x1) << 30) + (int64_t)AUDIO_DSP_DC_POLE * y1 + frac;
+        int32_t y = (int32_t)(acc >> 30);
+
+        frac = (int32_t)(acc & (AUDIO_DSP_Q30_ONE - 1));
+        x1 = x;
+        y1 = y;
+        buf[i] = y;
+    }
+
+    dsp->dc_x1 = x1;
+    dsp->dc_y1 = y1;
+    dsp->dc_frac = frac;
+}
+
+/**
+ * @brief Find the window minimum again (the old one left the delay line)
+ * @param pos Position of the newest required gain
+ * @note  Ties keep the youngest entry - it stays valid the longest
+ */
+static HOT_PATH void audio_dsp_limit_rescan(AudioDsp_t *dsp, uint16_t pos)
+{
+    int32_t min = dsp->lim_req[pos];
+    uint16_t age = 0;
+
+    for (uint16_t k = 1; k < AUDIO_DSP_LOOKAHEAD; k++)
+    {
+        int32_t r = dsp->lim_req[(pos - k) & (AUDIO_DSP_LOOKAHEAD - 1)];
+
+        if (r < min)
+        {
+            min = r;
+            age = k;
+        }
+    }
+
+    dsp->lim_min = min;
+    dsp->lim_min_age = age;
+}
+
+/**
+ * @brief Lookahead peak limiter
+ * @note  Division only on samples above threshold, window rescan only
+ *        when the minimum leaves the delay line
+ */
+static HOT_PATH void audio_dsp_limit(AudioDsp_t *dsp, int32_t *buf, uint16_t count)
+{
+    int32_t thr = dsp->lim_threshold;
+    int32_t gain = dsp->lim_gain;
+    int32_t env = dsp->lim_env;
+    int64_t sum = dsp->lim_env_sum;
+    uint16_t pos = dsp->lim_pos;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        int32_t x = buf[i];
+        int32_t ax = (x < 0) ? -x : x;
+        int32_t req = AUDIO_DSP_Q30_ONE;
+
+        if (ax > thr)
+        {
+            req = (int32_t)(((uint32_t)thr << 15) / (uint32_t)ax) << 15;
+        }
+
+        // Window minimum of the required gain (samples still in the delay line)
+        dsp->lim_req[pos] = req;
+        if (req <= dsp->lim_min)
+        {
+            dsp->lim_min = req;
+            dsp->lim_min_age = 0;
+        }
+        else if (++dsp->lim_min_age >= AUDIO_DSP_LOOKAHEAD)
+        {
+            audio_dsp_limit_rescan(dsp, pos);
+        }
+
+        // Envelope: follows a lower minimum at once, hold, then release
+        if (dsp->lim_min < env)
+        {
+            env = dsp->lim_min;
+            dsp->lim_hold_left = AUDIO_DSP_LOOKAHEAD;
+        }
+        else if (dsp->lim_hold_left > 0)
+        {
+            dsp->lim_hold_left--;
+        }
+        else if (env < dsp->lim_min)
+        {
+            env += dsp->lim_release;
+            if (env > dsp->lim_min)
+            {
+                env = dsp->lim_min;
+            }
+        }
+
+        // Gain of the sample leaving the delay line = average of the last
+        // AUDIO_DSP_LOOKAHEAD envelope values, all <= its required gain
+        gain = (int32_t)(sum / AUDIO_DSP_LOOKAHEAD);
+        sum += env - dsp->lim_env_hist[pos];
+        dsp->lim_env_hist[pos] = env;
+
+        // Delay line
+        int32_t delayed = dsp->lim_delay[pos];
+        dsp->lim_delay[pos] = x;
+        pos = (pos + 1) & (AUDIO_DSP_LOOKAHEAD - 1);
+
+        buf[i] = (int32_t)(((int64_t)delayed * gain) >> 30);
+    }
+
+    dsp->lim_gain = gain;
+    dsp->lim_env = env;
+    dsp->lim_env_sum = sum;
+    dsp->lim_pos = pos;
+}
+
+/* ============================================================================ */
+/* Processing */
+/* ============================================================================ */
+
+HOT_PATH void audio_dsp_process(AudioDsp_t *dsp, int32_t *buf, uint16_t count)
+{
+    uint8_t en = dsp->enable;
+
+    if ((en & AUDIO_DSP_EN_EQ) && dsp->num_biquads > 0)
+    {
+        audio_dsp_eq(dsp, buf, count);
+    }
+
+    if (en & AUDIO_DSP_EN_DC)
+    {
+        audio_dsp_dc_block(dsp, buf, count);
+    }
+
+    if (en & AUDIO_DSP_EN_LIMIT)
+    {
+        audio_dsp_limit(dsp, buf, count);
+    }
+}
+
+/* ============================================================================ */
+/* Upsampler */
+/* ============================================================================ */
+
+/**
+ * @brief Half-band odd-phase coefficients (Q15, Kaiser windowed sinc,
+ *        sum = 0.5 so each symmetric pair gives unity DC gain)
+ */
+static const int16_t hb1_coef[AUDIO_HB1_TAPS / 2] = {
+    20473, -5871, 2570, -1093, 375, -70
+};
+
+static const int16_t hb2_coef[AUDIO_HB2_TAPS / 2] = {
+    19569, -3556, 371
+};
+
+static inline __attribute__((always_inline))
+int32_t audio_dsp_sat16(int32_t x)
+{
+    if (x > 32767)  return 32767;
+    if (x < -32768) return -32768;
+    return x;
+}
+
+/**
+ * @brief 2x half-band interpolation (polyphase)
+ * @param taps Branch length (constant per call site - inner loop unrolls)
+ * @note  Even output = delayed input (center tap), odd output = symmetric
+ *        FIR over the input history, so only taps/2 MACs per input sample
+ */
+static inline __attribute__((always_inline))
+void audio_dsp_halfband(int32_t *hist, const int16_t *coef, const uint8_t taps,
+                        const int32_t *in, int32_t *out, uint16_t count)
+{
+    int32_t buf[AUDIO_HB1_TAPS - 1 + AUDIO_BLOCK_SIZE * 2];
+    const uint8_t half = taps / 2;
+
+    memcpy(buf, hist, (taps - 1) * sizeof(int32_t));
+    for (uint16_t i = 0; i < count; i++)
+    {
+        buf[taps - 1 + i] = audio_dsp_sat16(in[i]);
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const int32_t *w = &buf[i];     // w[taps - 1] = newest
+        int32_t acc = 1 << 14;          // Rounding
+
+        for (uint8_t k = 0; k < half; k++)
+        {
+            acc += coef[k] * (w[half - 1 - k] + w[half + k]);
+        }
+
+        *out++ = w[half - 1];
+        *out++ = acc >> 15;
+    }
+
+    memcpy(hist, &buf[count], (taps - 1) * sizeof(int32_t));
+}
+
+void audio_dsp_upsample_reset(AudioUpsampler_t *up)
+{
+    memset(up, 0, sizeof(AudioUpsampler_t));
+}
+
+HOT_PATH void audio_dsp_upsample(AudioUpsampler_t *up, const int32_t *in, int32_t *out,
+                        uint16_t count, uint8_t factor)
+{
+    if (factor == 4)
+    {
+        int32_t mid[AUDIO_BLOCK_SIZE * 2];
+
+        audio_dsp_halfband(up->hb1, hb1_coef, AUDIO_HB1_TAPS, in, mid, count);
+        audio_dsp_halfband(up->hb2, hb2_coef, AUDIO_HB2_TAPS, mid, out, count * 2);
+    }
+    else
+    {
+        audio_dsp_halfband(up->hb1, hb1_coef, AUDIO_HB1_TAPS, in, out, count);
+    }
+}
+
+/* ============================================================================ */
+/* Configuration */
+/* ============================================================================ */
+
+void audio_dsp_set_enable(AudioDsp_t *dsp, uint8_t enable)
+{
+    enable &= AUDIO_DSP_EN_MASK;
+
+    // Newly enabled stages start from clean history
+    uint8_t turned_on = enable & ~dsp->enable;
+
+    if (turned_on & AUDIO_DSP_EN_EQ)
+    {
+        memset(dsp->eq_state, 0, sizeof(dsp->eq_state));
+    }
+    if (turned_on & AUDIO_DSP_EN_DC)
+    {
+        dsp->dc_x1 = 0;
+        dsp->dc_y1 = 0;
+        dsp->dc_frac = 0;
+    }
+    if (turned_on & AUDIO_DSP_EN_LIMIT)
+    {
+        // Delay line is not primed - limiter adds AUDIO_DSP_LOOKAHEAD latency
+        audio_dsp_limit_reset(dsp);
+    }
+
+    dsp->enable = enable;
+}
+
+uint8_t audio_dsp_set_biquad(AudioDsp_t *dsp, uint8_t stage, const AudioBiquad_t *coef)
+{
+    if (stage >= AUDIO_DSP_MAX_BIQUADS)
+    {
+        return 1;
+    }
+
+    dsp->coef[stage] = *coef;
+
+    return 0;
+}
+
+uint8_t audio_dsp_set_eq_stages(AudioDsp_t *dsp, uint8_t count)
+{
+    if (count > AUDIO_DSP_MAX_BIQUADS)
+    {
+        return 1;
+    }
+
+    // Added stages start from clean history
+    for (uint8_t s = dsp->num_biquads; s < count; s++)
+    {
+        memset(dsp->eq_state[s], 0, sizeof(dsp->eq_state[s]));
+    }
+
+    dsp->num_biquads = count;
+
+    return 0;
+}
+
+void audio_dsp_set_limiter(AudioDsp_t *dsp, uint16_t threshold, uint16_t release_ms)
+{
+    if (threshold == 0)
+    {
+        threshold = 1;
+    }
+    if (threshold > 32767)
+    {
+        threshold = 32767;
+    }
+
+    dsp->lim_threshold = threshold;
+
+    // Release: full range (0 -> unity) in release_ms
+    uint32_t samples = ((uint32_t)release_ms * AUDIO_SAMPLE_RATE) / 1000;
+    dsp->lim_release = (samples > 0) ? (int32_t)(AUDIO_DSP_Q30_ONE / samples)
+                                     : AUDIO_DSP_Q30_ONE;
+}
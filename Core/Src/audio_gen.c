@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file           : audio_gen.c
+  * @brief          : Block-based Tone / Noise Generator Implementation
+  ******************************************************************************
+  */
+
+#include "audio_gen.h"
+#include "hot_path.h"
+#include "audio_channel.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================ */
+/* Sine Table */
+/* ============================================================================ */
+
+#define GEN_TABLE_BITS      8
+#define GEN_TABLE_SIZE      (1 << GEN_TABLE_BITS)
+
+// Q15 sine (+1 guard entry for interpolation), built once at init
+static int16_t g_gen_sine[GEN_TABLE_SIZE + 1];
+static uint8_t g_gen_table_ready = 0;
+
+static void audio_gen_build_table(void)
+{
+    for (int i = 0; i <= GEN_TABLE_SIZE; i++)
+    {
+        g_gen_sine[i] = (int16_t)lrint(32767.0 * sin(2.0 * M_PI * i / GEN_TABLE_SIZE));
+    }
+
+    g_gen_table_ready = 1;
+}
+
+/**
+ * @brief Frequency -> phase increment
+ */
+static uint32_t audio_gen_inc(uint16_t hz)
+{
+    if (hz > AUDIO_GEN_FREQ_MAX)
+    {
+        hz = AUDIO_GEN_FREQ_MAX;
+    }
+
+    return (uint32_t)(((uint64_t)hz << 32) / AUDIO_SAMPLE_RATE);
+}
+
+/**
+ * @brief One xorshift32 step
+ */
+static inline __attribute__((always_inline))
+uint32_t audio_gen_rand(uint32_t *seed)
+{
+    uint32_t x = *seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+
+    return x;
+}
+
+/* ============================================================================ */
+/* Initialization / Control */
+/* ============================================================================ */
+
+void audio_gen_init(AudioGen_t *gen, uint32_t seed)
+{
+    if (!g_gen_table_ready)
+    {
+        audio_gen_build_table();
+    }
+
+    memset(gen, 0, sizeof(AudioGen_t));
+
+    gen->seed = (seed != 0) ? seed : 0x2545F491u;
+
+    audio_gen_set_freq(gen, AUDIO_GEN_FREQ_DEFAULT);
+    audio_gen_set_sweep(gen, AUDIO_GEN_SWEEP_START_DEFAULT,
+                        AUDIO_GEN_SWEEP_END_DEFAULT, AUDIO_GEN_SWEEP_MS_DEFAULT);
+}
+
+uint8_t audio_gen_start(AudioGen_t *gen, uint8_t wave)
+{
+    if (wave > AUDIO_GEN_MAX)
+    {
+        return 1;
+    }
+
+    gen->phase = 0;
+    gen->sweep_inc = gen->sweep_start_inc;
+    gen->sweep_left = gen->sweep_len;
+
+    gen->pink_count = 0;
+    gen->pink_sum = 0;
+    memset(gen->pink_rows, 0, sizeof(gen->pink_rows));
+
+    gen->wave = wave;
+
+    return 0;
+}
+
+void audio_gen_stop(AudioGen_t *gen)
+{
+    gen->wave = AUDIO_GEN_OFF;
+}
+
+void audio_gen_set_freq(AudioGen_t *gen, uint16_t hz)
+{
+    gen->phase_inc = audio_gen_inc(hz);
+}
+
+void audio_gen_set_sweep(AudioGen_t *gen, uint16_t start_hz, uint16_t end_hz, uint16_t ms)
+{
+    uint32_t len = ((uint32_t)((ms > 0) ? ms : 1) * AUDIO_SAMPLE_RATE) / 1000;
+    int32_t span = (int32_t)audio_gen_inc(end_hz) - (int32_t)audio_gen_inc(start_hz);
+
+    gen->sweep_start_inc = audio_gen_inc(start_hz);
+    gen->sweep_step = span / (int32_t)len;
+    gen->sweep_len = len;
+}
+
+/* ============================================================================ */
+/* Kernels */
+/* ============================================================================ */
+
+/**
+ * @brief Interpolated table lookup (Q15)
+ */
+static inline __attribute__((always_inline))
+int32_t audio_gen_sine_at(uint32_t phase)
+{
+    uint32_t idx = phase >> (32 - GEN_TABLE_BITS);
+    int32_t frac = (int32_t)((phase >> (16 - GEN_TABLE_BITS)) & 0xFFFF);
+    int32_t a = g_gen_sine[idx];
+    int32_t b = g_gen_sine[idx + 1];
+
+    return a + (((b - a) * frac) >> 16);
+}
+
+static HOT_PATH void audio_gen_sine(AudioGen_t *gen, int16_t *out, uint16_t count)
+{
+    uint32_t phase = gen->phase;
+    uint32_t inc = gen->phase_inc;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        out[i] = (int16_t)((audio_gen_sine_at(phase) * AUDIO_GEN_LEVEL) >> 15);
+        phase += inc;
+    }
+
+    gen->phase = phase;
+}
+
+static HOT_PATH void audio_gen_square(AudioGen_t *gen, int16_t *out, uint16_t count)
+{
+    uint32_t phase = gen->phase;
+    uint32_t inc = gen->phase_inc;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        out[i] = (phase & 0x80000000u) ? -AUDIO_GEN_LEVEL : AUDIO_GEN_LEVEL;
+        phase += inc;
+    }
+
+    gen->phase = phase;
+}
+
+static HOT_PATH void audio_gen_sweep(AudioGen_t *gen, int16_t *out, uint16_t count)
+{
+    uint32_t phase = gen->phase;
+    uint32_t inc = gen->sweep_inc;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        out[i] = (int16_t)((audio_gen_sine_at(phase) * AUDIO_GEN_LEVEL) >> 15);
+        phase += inc;
+        inc += (uint32_t)gen->sweep_step;
+
+        if (--gen->sweep_left == 0)
+        {
+            // Restart (phase continues - no discontinuity)
+            inc = gen->sweep_start_inc;
+            gen->sweep_left = gen->sweep_len;
+        }
+    }
+
+    gen->phase = phase;
+    gen->sweep_inc = inc;
+}
+
+static HOT_PATH void audio_gen_white(AudioGen_t *gen, int16_t *out, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        int32_t w = (int32_t)audio_gen_rand(&gen->seed) >> 16;
+        out[i] = (int16_t)((w * AUDIO_GEN_LEVEL) >> 15);
+    }
+}
+
+/**
+ * @brief Voss-McCartney pink noise
+ * @note  Row k is refreshed every 2^(k+1) samples (trailing zeros of the
+ *        counter), one row + one white value per sample
+ */
+static HOT_PATH void audio_gen_pink(AudioGen_t *gen, int16_t *out, uint16_t count)
+{
+    int32_t sum = gen->pink_sum;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint32_t n = ++gen->pink_count;
+        uint32_t k = (uint32_t)__builtin_ctz(n);
+
+        if (k < AUDIO_GEN_PINK_ROWS)
+        {
+            int32_t r = (int32_t)audio_gen_rand(&gen->seed) >> 19;   // +/-4096
+            sum += r - gen->pink_rows[k];
+            gen->pink_rows[k] = r;
+        }
+
+        int32_t white = (int32_t)audio_gen_rand(&gen->seed) >> 19;
+
+        // 9 x 13-bit sources -> +/-36864 peak, x0.5 level
+        out[i] = (int16_t)(((sum + white) * AUDIO_GEN_LEVEL) >> 15);
+    }
+
+    gen->pink_sum = sum;
+}
+
+HOT_PATH void audio_gen_render(AudioGen_t *gen, int16_t *out, uint16_t count)
+{
+    switch (gen->wave)
+    {
+        case AUDIO_GEN_SINE:
+            audio_gen_sine(gen, out, count);
+            break;
+
+        case AUDIO_GEN_SQUARE:
+            audio_gen_square(gen, out, count);
+            break;
+
+        case AUDIO_GEN_SWEEP:
+            audio_gen_sweep(gen, out, count);
+            break;
+
+        case AUDIO_GEN_WHITE:
+            audio_gen_white(gen, out, count);
+            break;
+
+        case AUDIO_GEN_PINK:
+            audio_gen_pink(gen, out, count);
+            break;
+
+        default:
+            memset(out, 0, count * sizeof(int16_t));
+            break;
+    }
+}
@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file           : audio_jitter.c
+  * @brief          : Per-channel Jitter Buffer Manager Implementation
+  ******************************************************************************
+  */
+
+#include "audio_jitter.h"
+#include "hot_path.h"
+#include "audio_channel.h"
+#include <string.h>
+
+/* ============================================================================ */
+/* Initialization / Control */
+/* ============================================================================ */
+
+void audio_jitter_init(AudioJitter_t *jit)
+{
+    jit->target = 0;
+    jit->low = AUDIO_JITTER_LOW_DEFAULT;
+    audio_jitter_clear(jit);
+}
+
+uint8_t audio_jitter_set(AudioJitter_t *jit, uint16_t target, uint16_t low)
+{
+    if (target > AUDIO_BUFFER_SIZE)
+    {
+        return 1;
+    }
+
+    jit->target = target;
+    jit->low = (low != 0) ? low : AUDIO_JITTER_LOW_DEFAULT;
+    audio_jitter_clear(jit);
+
+    return 0;
+}
+
+void audio_jitter_clear(AudioJitter_t *jit)
+{
+    jit->depth = 0;
+    jit->min = 0xFFFF;
+    jit->max = 0;
+    jit->events = 0;
+    jit->below = 0;
+    memset(jit->hist, 0, sizeof(jit->hist));
+}
+
+/* ============================================================================ */
+/* Sampling (render) */
+/* ============================================================================ */
+
+HOT_PATH uint8_t audio_jitter_sample(AudioJitter_t *jit, uint16_t depth)
+{
+    uint16_t prev = jit->depth;
+    uint32_t bin = depth / AUDIO_JITTER_BIN;
+
+    if (bin >= AUDIO_JITTER_BINS)
+    {
+        bin = AUDIO_JITTER_BINS - 1;
+    }
+
+    jit->hist[bin]++;
+    jit->events++;
+    jit->depth = depth;
+
+    if (depth < jit->min)
+    {
+        jit->min = depth;
+    }
+    if (depth > jit->max)
+    {
+        jit->max = depth;
+    }
+    if (depth < jit->low)
+    {
+        jit->below++;
+    }
+
+    // Crossed below target since the last event - RDY goes LOW again
+    return (jit->target != 0 && depth < jit->target && prev >= jit->target);
+}
+
+HOT_PATH uint8_t audio_jitter_wants_data(const AudioJitter_t *jit, uint16_t depth)
+{
+    return (jit->target == 0 || depth < jit->target);
+}
+
+/* ============================================================================ */
+/* Report */
+/* ============================================================================ */
+
+/**
+ * @brief Depth below which pct % of the samples lie (bin lower edge)
+ */
+static uint16_t audio_jitter_percentile(const AudioJitter_t *jit, uint32_t pct)
+{
+    uint32_t rank = (jit->events * pct + 99) / 100;   // At least one sample
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < AUDIO_JITTER_BINS; i++)
+    {
+        sum += jit->hist[i];
+        if (sum >= rank)
+        {
+            return (uint16_t)(i * AUDIO_JITTER_BIN);
+        }
+    }
+
+    return jit->max;
+}
+
+void audio_jitter_report(const AudioJitter_t *jit, AudioJitterReport_t *report)
+{
+    memset(report, 0, sizeof(AudioJitterReport_t));
+
+    report->events = jit->events;
+    if (jit->events == 0)
+    {
+        return;
+    }
+
+    report->min = jit->min;
+    report->max = jit->max;
+    report->p1 = audio_jitter_percentile(jit, 1);
+    report->p5 = audio_jitter_percentile(jit, 5);
+    report->p50 = audio_jitter_percentile(jit, 50);
+    report->p95 = audio_jitter_percentile(jit, 95);
+
+    // One sample per rendered block
+    report->below_ms = (uint32_t)(((uint64_t)jit->below * AUDIO_BLOCK_SIZE * 1000U) / AUDIO_SAMPLE_RATE);
+}
@@ -0,0 +1,243 @@
+/**
+  ******************************************************************************
+  * @file           : audio_mixer.c
+  * @brief          : Per-channel Voice Mixer Implementation
+  ******************************************************************************
+  */
+
+#include "audio_mixer.h"
+#include "hot_path.h"
+#include "audio_channel.h"
+#include <string.h>
+
+/* ============================================================================ */
+/* Initialization / Control */
+/* ============================================================================ */
+
+void audio_mixer_init(AudioMixer_t *mix)
+{
+    memset(mix, 0, sizeof(AudioMixer_t));
+}
+
+void audio_mixer_reset(AudioMixer_t *mix)
+{
+    for (uint8_t i = 0; i < AUDIO_MIX_VOICES; i++)
+    {
+        mix->voice[i].kind = AUDIO_MIX_OFF;
+        clip_voice_stop(&mix->voice[i].clip);
+    }
+    mix->active = 0;
+}
+
+/**
+ * @brief Gain percent -> Q15 (0 = unity)
+ */
+static int32_t audio_mixer_gain(uint8_t percent)
+{
+    if (percent == 0 || percent > 100)
+    {
+        percent = 100;
+    }
+    return ((int32_t)percent * CLIP_GAIN_UNITY) / 100;
+}
+
+/**
+ * @brief Find a free voice
+ * @return Voice or NULL if all are in use
+ */
+static AudioMixVoice_t *audio_mixer_alloc(AudioMixer_t *mix)
+{
+    for (uint8_t i = 0; i < AUDIO_MIX_VOICES; i++)
+    {
+        if (mix->voice[i].kind == AUDIO_MIX_OFF)
+        {
+            return &mix->voice[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Activate a prepared voice (ramps in over the first block)
+ */
+static void audio_mixer_activate(AudioMixer_t *mix, AudioMixVoice_t *v, uint8_t kind, uint8_t gain)
+{
+    v->gain = 0;
+    v->target = audio_mixer_gain(gain);
+    v->stopping = 0;
+    v->kind = kind;
+    mix->active++;
+}
+
+uint8_t audio_mixer_add_clip(AudioMixer_t *mix, uint8_t slot, uint8_t loop, uint8_t gain)
+{
+    AudioMixVoice_t *v = audio_mixer_alloc(mix);
+
+    // Voice gain is applied here, the clip itself plays at unity
+    if (v == NULL || clip_voice_start(&v->clip, slot, loop, 100) != 0)
+    {
+        return 1;
+    }
+
+    audio_mixer_activate(mix, v, AUDIO_MIX_CLIP, gain);
+
+    return 0;
+}
+
+uint8_t audio_mixer_add_gen(AudioMixer_t *mix, const AudioGen_t *cfg, uint8_t wave, uint8_t gain)
+{
+    AudioMixVoice_t *v = audio_mixer_alloc(mix);
+
+    if (v == NULL || wave == AUDIO_GEN_OFF)
+    {
+        return 1;
+    }
+
+    // Same frequency / sweep as the channel generator, own phase
+    v->gen = *cfg;
+    if (audio_gen_start(&v->gen, wave) != 0)
+    {
+        return 1;
+    }
+
+    audio_mixer_activate(mix, v, AUDIO_MIX_GEN, gain);
+
+    return 0;
+}
+
+void audio_mixer_stop(AudioMixer_t *mix, uint8_t kinds)
+{
+    for (uint8_t i = 0; i < AUDIO_MIX_VOICES; i++)
+    {
+        AudioMixVoice_t *v = &mix->voice[i];
+
+        if (v->kind & kinds)
+        {
+            v->target = 0;
+            v->stopping = 1;
+        }
+    }
+}
+
+/* ============================================================================ */
+/* Processing */
+/* ============================================================================ */
+
+/**
+ * @brief Next n samples of a clip voice
+ * @note  Zero copy unless the clip ends / loops inside the block
+ */
+static HOT_PATH const int16_t *audio_mixer_clip_source(ClipVoice_t *c, int16_t *buf,
+                                              uint16_t n, uint8_t *ended)
+{
+    uint16_t m = n;
+    const int16_t *p = clip_voice_next(c, &m, buf, ended);
+
+    if (m == n)
+    {
+        return p;
+    }
+
+    // Gather segments: clip end (rest silent) or loop point
+    uint16_t got = 0;
+    for (;;)
+    {
+        memcpy(&buf[got], p, m * sizeof(int16_t));
+        got += m;
+
+        if (got >= n)
+        {
+            break;
+        }
+        if (c->done)
+        {
+            memset(&buf[got], 0, (n - got) * sizeof(int16_t));
+            break;
+        }
+
+        m = n - got;
+        p = clip_voice_next(c, &m, buf, ended);
+    }
+
+    return buf;
+}
+
+/**
+ * @brief acc += voice * gain, gain interpolated g0 -> g1 across the block
+ */
+static HOT_PATH void audio_mixer_accumulate(int32_t *acc, const int16_t *s, uint16_t n,
+                                   int32_t g0, int32_t g1)
+{
+    if (g0 == g1)
+    {
+        for (uint16_t i = 0; i < n; i++)
+        {
+            acc[i] += (s[i] * g1) >> 15;
+        }
+        return;
+    }
+
+    int32_t step = (g1 - g0) / n;
+    int32_t g = g0;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        acc[i] += (s[i] * g) >> 15;
+        g += step;
+    }
+}
+
+HOT_PATH const int16_t *audio_mixer_process(AudioMixer_t *mix, const int16_t *src, int16_t *out, uint16_t n)
+{
+    int32_t acc[AUDIO_BLOCK_SIZE];
+    int16_t vbuf[AUDIO_BLOCK_SIZE];
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        acc[i] = src[i];
+    }
+
+    for (uint8_t k = 0; k < AUDIO_MIX_VOICES; k++)
+    {
+        AudioMixVoice_t *v = &mix->voice[k];
+        const int16_t *vs;
+        uint8_t ended = 0;
+
+        if (v->kind == AUDIO_MIX_OFF)
+        {
+            continue;
+        }
+
+        if (v->kind == AUDIO_MIX_CLIP)
+        {
+            vs = audio_mixer_clip_source(&v->clip, vbuf, n, &ended);
+        }
+        else
+        {
+            audio_gen_render(&v->gen, vbuf, n);
+            vs = vbuf;
+        }
+
+        audio_mixer_accumulate(acc, vs, n, v->gain, v->target);
+        v->gain = v->target;
+
+        // Played out / faded out: free the voice
+        if (ended || v->stopping)
+        {
+            v->kind = AUDIO_MIX_OFF;
+            clip_voice_stop(&v->clip);
+            mix->active--;
+        }
+    }
+
+    // Single saturation of the sum
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int32_t x = acc[i];
+        if (x > 32767)  x = 32767;
+        if (x < -32768) x = -32768;
+        out[i] = (int16_t)x;
+    }
+
+    return out;
+}
@@ -0,0 +1,543 @@
+/**
+  ******************************************************************************
+  * @file           : audio_output.c
+  * @brief          : DAC Output Control Implementation
+  ******************************************************************************
+  */
+
+#include "audio_output.h"
+#include "hot_path.h"
+#include "dma_arena.h"
+#include "irq_prio.h"
+
+/* ============================================================================ */
+/* External DAC/TIM handles (from main.c) */
+/* ============================================================================ */
+
+extern DAC_HandleTypeDef hdac1;
+extern TIM_HandleTypeDef htim1;  // DAC CH1 trigger
+extern TIM_HandleTypeDef htim7;  // DAC CH2 trigger
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+// Shared sample clock (32-bit, 1 tick = 1 sample)
+static TIM_HandleTypeDef htim2;
+
+// Master sample index = local tick + offset (16-bit domain)
+static uint16_t g_sync_offset = 0;
+static uint8_t g_synced = 0;
+
+// Stereo lock: both DAC channels triggered by TIM1 TRGO
+static uint8_t g_stereo_lock = 0;
+
+// DAC output rings (2 render blocks each, sized for 4x) - non-cacheable DMA arena
+static uint16_t *g_out_ring[2] = {NULL, NULL};
+
+// Oversampling factor (1/2/4) and trigger timer period at 1x (ARR + 1)
+static uint8_t g_oversample = 1;
+static uint32_t g_base_period = 0;
+
+// Per output channel state (index 0 = DAC CH1, 1 = DAC CH2)
+static AudioChannel_t *g_channels[2] = {NULL, NULL};
+static volatile uint8_t g_running[2] = {0, 0};       // Ring DMA owned by this module
+static volatile uint8_t g_stop_pending[2] = {0, 0};  // Stop after fade-out
+static volatile uint8_t g_stop_reset[2] = {0, 0};    // Reset channel after stop
+static volatile uint8_t g_stop_drain[2] = {0, 0};    // DMA events until ring played out
+
+/**
+ * @brief DAC channel -> output index
+ */
+static inline __attribute__((always_inline))
+uint8_t audio_output_index(uint32_t dac_channel)
+{
+    return (dac_channel == DAC_CHANNEL_1) ? 0 : 1;
+}
+
+/* ============================================================================ */
+/* Initialization */
+/* ============================================================================ */
+
+void audio_output_init(AudioChannel_t *dac1_ch, AudioChannel_t *dac2_ch)
+{
+    TIM_OC_InitTypeDef sConfigOC = {0};
+    TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    // Same kernel clock as TIM1 (APB1 = APB2 = HCLK), prescaler = TIM1 period
+    // -> one TIM2 tick per DAC sample
+    htim2.Instance = TIM2;
+    htim2.Init.Prescaler = htim1.Init.Period;
+    htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim2.Init.Period = 0xFFFFFFFF;
+    htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // CH1: OC1REF drives TRGO (TIM1 start), kept inactive until armed
+    sConfigOC.OCMode = TIM_OCMODE_FORCED_INACTIVE;
+    sConfigOC.Pulse = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // CH2: compare interrupt only (TIM7 start)
+    sConfigOC.OCMode = TIM_OCMODE_TIMING;
+    if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_2) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC1REF;
+    sMasterConfig.MasterOutputTrigger2 = TIM_TRGO2_RESET;
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // Same level as DAC DMA (scheduled start is timing critical)
+    HAL_NVIC_SetPriority(TIM2_IRQn, IRQ_PRIO_AUDIO, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+
+    HAL_TIM_Base_Start(&htim2);
+
+    g_synced = 0;
+
+    g_channels[0] = dac1_ch;
+    g_channels[1] = dac2_ch;
+
+    g_out_ring[0] = dma_arena_alloc(DMA_MEM_NONCACHED, AUDIO_OUT_RING_MAX * sizeof(uint16_t),
+                                    DMA_ARENA_LINE, "dac1_ring");
+    g_out_ring[1] = dma_arena_alloc(DMA_MEM_NONCACHED, AUDIO_OUT_RING_MAX * sizeof(uint16_t),
+                                    DMA_ARENA_LINE, "dac2_ring");
+
+    // 1x trigger period (TIM1 and TIM7 are generated with the same period)
+    g_base_period = htim1.Init.Period + 1;
+    g_oversample = 1;
+}
+
+/* ============================================================================ */
+/* DMA Control */
+/* ============================================================================ */
+
+void audio_output_stop_dma(uint32_t dac_channel)
+{
+    uint8_t idx = audio_output_index(dac_channel);
+
+    // Render callbacks no longer touch this ring
+    g_running[idx] = 0;
+    g_stop_pending[idx] = 0;
+    g_stop_drain[idx] = 0;
+
+    DMA_HandleTypeDef *hdma = (dac_channel == DAC_CHANNEL_1) ? hdac1.DMA_Handle1 : hdac1.DMA_Handle2;
+
+    if (hdma == NULL || hdma->Instance == NULL)
+    {
+        return;  // No DMA configured
+    }
+
+    DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
+
+    // Disable DMA channel directly (avoid HAL_DMA_Abort hang)
+    dma_ch->CCR &= ~DMA_CCR_EN;
+
+    // Wait for DMA to stop (with timeout)
+    uint32_t timeout = 10000;
+    while ((dma_ch->CCR & DMA_CCR_EN) && (timeout > 0))
+    {
+        timeout--;
+    }
+
+    // Disable DAC DMA request
+    if (dac_channel == DAC_CHANNEL_1)
+    {
+        CLEAR_BIT(DAC1->CR, DAC_CR_DMAEN1);
+        hdac1.State = HAL_DAC_STATE_READY;
+    }
+    else
+    {
+        CLEAR_BIT(DAC1->CR, DAC_CR_DMAEN2);
+    }
+
+    // Reset DMA state
+    hdma->State = HAL_DMA_STATE_READY;
+}
+
+HAL_StatusTypeDef audio_output_arm(uint32_t dac_channel, AudioChannel_t *ch)
+{
+    uint8_t idx = audio_output_index(dac_channel);
+    uint16_t *ring = g_out_ring[idx];
+
+    // Pre-render both ring halves, starting with the fade-in ramp
+    audio_channel_fade_in(ch);
+    audio_channel_render(ch, ring, AUDIO_BLOCK_SIZE * 2);
+
+    g_stop_pending[idx] = 0;
+    g_stop_drain[idx] = 0;
+    g_running[idx] = 1;
+
+    // Start DAC DMA with HAL (automatically uses DHR12R1 or DHR12R2)
+    // Circular over the ring, conversion begins on the first trigger TRGO
+    HAL_StatusTypeDef status = HAL_DAC_Start_DMA(&hdac1, dac_channel,
+                                                 (uint32_t*)ring,
+                                                 AUDIO_OUT_RING_SIZE(g_oversample),
+                                                 DAC_ALIGN_12B_R);
+    if (status != HAL_OK)
+    {
+        g_running[idx] = 0;
+    }
+
+    return status;
+}
+
+/* ============================================================================ */
+/* Render / Deferred Stop */
+/* ============================================================================ */
+
+/**
+ * @brief Complete a deferred stop (fade-out has been played out)
+ */
+static void audio_output_finish_stop(uint32_t dac_channel)
+{
+    uint8_t idx = audio_output_index(dac_channel);
+    AudioChannel_t *ch = g_channels[idx];
+    uint8_t reset = g_stop_reset[idx];
+
+    audio_output_stop(dac_channel);
+    ch->is_playing = 0;
+
+    if (reset)
+    {
+        audio_channel_reset(ch);
+    }
+}
+
+HOT_PATH uint8_t audio_output_dma_event(uint32_t dac_channel, uint8_t half)
+{
+    uint8_t idx = audio_output_index(dac_channel);
+
+    if (!g_running[idx])
+    {
+        return 0;  // DMA not started by this module (test menu)
+    }
+
+    // Faded block has left the DAC - stop now
+    if (g_stop_drain[idx] && (--g_stop_drain[idx] == 0))
+    {
+        audio_output_finish_stop(dac_channel);
+        return 0;
+    }
+
+    // Render next block into the half that has just been output
+    uint8_t flags = audio_channel_render(g_channels[idx],
+                                         &g_out_ring[idx][half ? AUDIO_BLOCK_SIZE * g_oversample : 0],
+                                         AUDIO_BLOCK_SIZE);
+
+    // Block rendered now is output between the next two events
+    if ((flags & AUDIO_RENDER_FADED_OUT) && g_stop_pending[idx])
+    {
+        g_stop_drain[idx] = 2;
+    }
+
+    // One-shot clip ended in this block (rest is silence) - no fade needed
+    if ((flags & AUDIO_RENDER_SOURCE_END) && !g_stop_pending[idx])
+    {
+        g_stop_pending[idx] = 1;
+        g_stop_reset[idx] = 0;
+        g_stop_drain[idx] = 2;
+    }
+
+    return (flags & (AUDIO_RENDER_SWAPPED | AUDIO_RENDER_NEED_DATA)) ? 1 : 0;
+}
+
+void audio_output_request_stop(uint32_t dac_channel, uint8_t reset)
+{
+    uint8_t idx = audio_output_index(dac_channel);
+    AudioChannel_t *ch = g_channels[idx];
+
+    if (!g_running[idx])
+    {
+        // Not playing from the ring - nothing to fade
+        audio_output_stop(dac_channel);
+        ch->is_playing = 0;
+        if (reset)
+        {
+            audio_channel_reset(ch);
+        }
+        return;
+    }
+
+    g_stop_reset[idx] = reset;
+
+    if (audio_channel_fade_out(ch))
+    {
+        // Fade disabled (or already silent) - hard stop
+        audio_output_finish_stop(dac_channel);
+        return;
+    }
+
+    g_stop_pending[idx] = 1;
+}
+
+void audio_output_cancel_stop(uint32_t dac_channel)
+{
+    uint8_t idx = audio_output_index(dac_channel);
+
+    if (!g_running[idx] || !g_stop_pending[idx])
+    {
+        return;
+    }
+
+    g_stop_pending[idx] = 0;
+    g_stop_reset[idx] = 0;
+    g_stop_drain[idx] = 0;
+
+    // New source starts from silence
+    audio_channel_fade_in(g_channels[idx]);
+}
+
+/* ============================================================================ */
+/* Timer Control */
+/* ============================================================================ */
+
+/**
+ * @brief Trigger timer of a DAC channel (TIM1 for both in stereo lock)
+ */
+static TIM_HandleTypeDef *audio_output_timer(uint32_t dac_channel)
+{
+    if (g_stereo_lock || dac_channel == DAC_CHANNEL_1)
+    {
+        return &htim1;
+    }
+    return &htim7;
+}
+
+/**
+ * @brief Cancel a pending scheduled start (both trigger paths)
+ */
+static void audio_output_cancel(uint32_t dac_channel)
+{
+    if (dac_channel == DAC_CHANNEL_1)
+    {
+        __HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC1);
+        MODIFY_REG(TIM2->CCMR1, TIM_CCMR1_OC1M, TIM_OCMODE_FORCED_INACTIVE);
+        CLEAR_BIT(TIM1->SMCR, TIM_SMCR_SMS | TIM_SMCR_TS);
+    }
+    else
+    {
+        __HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC2);
+    }
+}
+
+void audio_output_start(uint32_t dac_channel)
+{
+    if (g_stereo_lock)
+    {
+        dac_channel = DAC_CHANNEL_1;  // Single master timer for both
+    }
+
+    audio_output_cancel(dac_channel);
+
+    // CH1 uses TIM1, CH2 uses TIM7
+    HAL_TIM_Base_Start(audio_output_timer(dac_channel));
+}
+
+void audio_output_start_at(uint32_t dac_channel, uint32_t local_tick)
+{
+    if (g_stereo_lock)
+    {
+        dac_channel = DAC_CHANNEL_1;  // Hardware trigger path starts both
+    }
+
+    audio_output_cancel(dac_channel);
+
+    // Too close (or already passed) - start now
+    if ((int32_t)(local_tick - audio_output_now()) < AUDIO_OUTPUT_MIN_LEAD)
+    {
+        audio_output_start(dac_channel);
+        return;
+    }
+
+    if (dac_channel == DAC_CHANNEL_1)
+    {
+        // TIM1 waits in trigger mode: ITR1 = TIM2 TRGO (OC1REF)
+        TIM1->CNT = 0;
+        MODIFY_REG(TIM1->SMCR, TIM_SMCR_TS | TIM_SMCR_SMS, TIM_TS_ITR1 | TIM_SLAVEMODE_TRIGGER);
+
+        // OC1REF rises on match -> TRGO -> TIM1 CEN set by hardware
+        TIM2->CCR1 = local_tick;
+        __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC1);
+        MODIFY_REG(TIM2->CCMR1, TIM_CCMR1_OC1M, TIM_OCMODE_ACTIVE);
+
+        // Interrupt only for cleanup (slave mode off, OC1REF back to inactive)
+        __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_CC1);
+    }
+    else
+    {
+        // TIM7 is a basic timer (no slave mode) - started from CC2 interrupt
+        TIM7->CNT = 0;
+        TIM2->CCR2 = local_tick;
+        __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC2);
+        __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_CC2);
+    }
+}
+
+void audio_output_stop(uint32_t dac_channel)
+{
+    if (!g_stereo_lock)
+    {
+        audio_output_cancel(dac_channel);
+        HAL_TIM_Base_Stop(audio_output_timer(dac_channel));
+        audio_output_stop_dma(dac_channel);
+        return;
+    }
+
+    audio_output_stop_dma(dac_channel);
+
+    // Shared TIM1: stop only when the other channel is idle too
+    if (!(DAC1->CR & (DAC_CR_DMAEN1 | DAC_CR_DMAEN2)))
+    {
+        audio_output_cancel(DAC_CHANNEL_1);
+        HAL_TIM_Base_Stop(&htim1);
+    }
+}
+
+void audio_output_stop_stereo(void)
+{
+    // Gate first - both channels receive their last trigger together
+    audio_output_cancel(DAC_CHANNEL_1);
+    audio_output_cancel(DAC_CHANNEL_2);
+    HAL_TIM_Base_Stop(&htim1);
+    HAL_TIM_Base_Stop(&htim7);
+
+    audio_output_stop_dma(DAC_CHANNEL_1);
+    audio_output_stop_dma(DAC_CHANNEL_2);
+}
+
+HAL_StatusTypeDef audio_output_set_stereo_lock(uint8_t enable)
+{
+    enable = enable ? 1 : 0;
+
+    if (enable == g_stereo_lock)
+    {
+        return HAL_OK;
+    }
+
+    // TSEL2 can only be changed with the channel idle
+    if (DAC1->CR & (DAC_CR_DMAEN1 | DAC_CR_DMAEN2))
+    {
+        return HAL_BUSY;
+    }
+
+    uint32_t trigger = enable ? DAC_TRIGGER_T1_TRGO : DAC_TRIGGER_T7_TRGO;
+
+    // EN2 must be 0 while writing TSEL2 (re-enabled by HAL_DAC_Start_DMA)
+    __HAL_DAC_DISABLE(&hdac1, DAC_CHANNEL_2);
+    MODIFY_REG(DAC1->CR, (DAC_CR_TSEL1 | DAC_CR_TEN1) << (DAC_CHANNEL_2 & 0x10UL),
+               trigger << (DAC_CHANNEL_2 & 0x10UL));
+
+    g_stereo_lock = enable;
+    return HAL_OK;
+}
+
+uint8_t audio_output_is_stereo_locked(void)
+{
+    return g_stereo_lock;
+}
+
+HAL_StatusTypeDef audio_output_set_oversample(uint8_t factor)
+{
+    if (factor != 1 && factor != 2 && factor != 4)
+    {
+        return HAL_ERROR;
+    }
+
+    // Same rule as stereo lock - trigger period and ring layout change
+    if (DAC1->CR & (DAC_CR_DMAEN1 | DAC_CR_DMAEN2))
+    {
+        return HAL_BUSY;
+    }
+
+    // Base period 7812 is divisible by 4 -> exact 64k/128k trigger rate
+    uint32_t period = g_base_period / factor;
+    __HAL_TIM_SET_AUTORELOAD(&htim1, period - 1);
+    __HAL_TIM_SET_AUTORELOAD(&htim7, period - 1);
+    __HAL_TIM_SET_COUNTER(&htim1, 0);
+    __HAL_TIM_SET_COUNTER(&htim7, 0);
+
+    // TIM2 prescaler is untouched - sample clock stays at 32kHz
+    audio_channel_set_oversample(g_channels[0], factor);
+    audio_channel_set_oversample(g_channels[1], factor);
+    g_oversample = factor;
+
+    return HAL_OK;
+}
+
+uint8_t audio_output_get_oversample(void)
+{
+    return g_oversample;
+}
+
+/* ============================================================================ */
+/* Time Base */
+/* ============================================================================ */
+
+void audio_output_sync(uint16_t master_tick, uint32_t local_tick)
+{
+    g_sync_offset = (uint16_t)(master_tick - (uint16_t)local_tick);
+    g_synced = 1;
+}
+
+uint8_t audio_output_to_local(uint16_t master_tick, uint32_t *local_tick)
+{
+    if (!g_synced)
+    {
+        return 0;
+    }
+
+    uint32_t now = audio_output_now();
+    uint16_t master_now = (uint16_t)((uint16_t)now + g_sync_offset);
+    uint16_t lead = (uint16_t)(master_tick - master_now);
+
+    if (lead > AUDIO_OUTPUT_MAX_LEAD)
+    {
+        return 0;  // Target already passed
+    }
+
+    *local_tick = now + lead;
+    return 1;
+}
+
+/* ============================================================================ */
+/* Interrupt Handler */
+/* ============================================================================ */
+
+void audio_output_tim_irq(void)
+{
+    uint32_t sr = TIM2->SR;
+    uint32_t dier = TIM2->DIER;
+
+    // CH2 scheduled start
+    if ((sr & TIM_SR_CC2IF) && (dier & TIM_DIER_CC2IE))
+    {
+        __HAL_TIM_ENABLE(&htim7);
+        __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC2);
+        __HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC2);
+    }
+
+    // CH1 already started by hardware - disarm trigger path
+    if ((sr & TIM_SR_CC1IF) && (dier & TIM_DIER_CC1IE))
+    {
+        __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC1);
+        audio_output_cancel(DAC_CHANNEL_1);
+    }
+}
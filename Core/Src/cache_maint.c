@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file           : cache_maint.c
+  * @brief          : DCACHE1 Range Maintenance Implementation
+  ******************************************************************************
+  */
+
+#include "cache_maint.h"
+#include "main.h"
+
+/* ============================================================================ */
+/* External DCACHE handle (from main.c) */
+/* ============================================================================ */
+
+extern DCACHE_HandleTypeDef hdcache1;
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+static CacheMaintStats_t g_cache_stats = {0};
+
+/**
+ * @brief Widen range, update statistics
+ * @return Widened size (0 = nothing to do)
+ */
+static uint32_t cache_maint_prepare(const void *addr, uint32_t size, uint32_t *start)
+{
+    if (size == 0 || (DCACHE1->CR & DCACHE_CR_EN) == 0)
+    {
+        return 0;
+    }
+
+    if ((((uint32_t)addr | size) & (CACHE_LINE_SIZE - 1)) != 0)
+    {
+        g_cache_stats.misaligned_count++;
+    }
+
+    uint32_t bytes = cache_maint_lines((uint32_t)addr, size, start);
+    g_cache_stats.line_count += bytes / CACHE_LINE_SIZE;
+
+    return bytes;
+}
+
+/* ============================================================================ */
+/* Maintenance */
+/* ============================================================================ */
+
+void cache_invalidate(const void *addr, uint32_t size)
+{
+    uint32_t start;
+    uint32_t bytes = cache_maint_prepare(addr, size, &start);
+
+    if (bytes == 0)
+    {
+        return;
+    }
+
+    g_cache_stats.invalidate_count++;
+    if (HAL_DCACHE_InvalidateByAddr(&hdcache1, (const uint32_t *)start, bytes) != HAL_OK)
+    {
+        g_cache_stats.error_count++;
+    }
+}
+
+void cache_clean(const void *addr, uint32_t size)
+{
+    uint32_t start;
+    uint32_t bytes = cache_maint_prepare(addr, size, &start);
+
+    if (bytes == 0)
+    {
+        return;
+    }
+
+    g_cache_stats.clean_count++;
+    if (HAL_DCACHE_CleanByAddr(&hdcache1, (const uint32_t *)start, bytes) != HAL_OK)
+    {
+        g_cache_stats.error_count++;
+    }
+}
+
+void cache_clean_invalidate(const void *addr, uint32_t size)
+{
+    uint32_t start;
+    uint32_t bytes = cache_maint_prepare(addr, size, &start);
+
+    if (bytes == 0)
+    {
+        return;
+    }
+
+    g_cache_stats.clean_count++;
+    if (HAL_DCACHE_CleanInvalidByAddr(&hdcache1, (const uint32_t *)start, bytes) != HAL_OK)
+    {
+        g_cache_stats.error_count++;
+    }
+}
+
+const CacheMaintStats_t *cache_maint_get_stats(void)
+{
+    return &g_cache_stats;
+}
@@ -0,0 +1,176 @@
+/**
+  ******************************************************************************
+  * @file           : clip_cache.c
+  * @brief          : On-slave PCM Clip Cache Implementation
+  ******************************************************************************
+  */
+
+#include "clip_cache.h"
+#include "hot_path.h"
+#include "audio_channel.h"
+#include <string.h>
+
+/* ============================================================================ */
+/* Private Types / Variables */
+/* ============================================================================ */
+
+/**
+ * @brief Slot descriptor
+ */
+typedef struct {
+    uint32_t offset;            // First sample in the pool
+    uint16_t length;            // Clip length (samples, 0 = empty)
+    uint16_t loaded;            // Samples uploaded so far
+} ClipSlot_t;
+
+// Sample pool - CPU access only (render reads, SPI handler writes)
+__attribute__((aligned(4)))
+static int16_t g_clip_pool[CLIP_POOL_SAMPLES];
+
+static ClipSlot_t g_clip_slots[CLIP_SLOT_COUNT];
+static uint32_t g_clip_pool_used = 0;
+
+/* ============================================================================ */
+/* Cache */
+/* ============================================================================ */
+
+void clip_cache_init(void)
+{
+    clip_cache_erase();
+}
+
+void clip_cache_erase(void)
+{
+    memset(g_clip_slots, 0, sizeof(g_clip_slots));
+    g_clip_pool_used = 0;
+}
+
+uint8_t clip_cache_write(uint8_t slot, uint8_t format, uint16_t total,
+                         uint16_t offset, const uint8_t *data, uint16_t count)
+{
+    if (slot >= CLIP_SLOT_COUNT || total == 0 || !IS_VALID_SAMPLE_FORMAT(format))
+    {
+        return 1;
+    }
+
+    ClipSlot_t *s = &g_clip_slots[slot];
+
+    if (offset == 0)
+    {
+        // New upload: same length rewrites in place, otherwise a new region
+        if (s->length != total)
+        {
+            if (total > CLIP_POOL_SAMPLES - g_clip_pool_used)
+            {
+                return 1;  // Pool full - CMD_CLIP_ERASE first
+            }
+
+            s->offset = g_clip_pool_used;
+            s->length = total;
+            g_clip_pool_used += total;
+        }
+        s->loaded = 0;
+    }
+    else if (s->length != total || offset != s->loaded)
+    {
+        return 1;  // Chunk of another upload / lost chunk
+    }
+
+    uint16_t space = total - offset;
+    if (count > space)
+    {
+        count = space;
+    }
+
+    if (audio_channel_unpack(&g_clip_pool[s->offset + offset], format, data, count) != 0)
+    {
+        return 1;
+    }
+
+    s->loaded += count;
+
+    return 0;
+}
+
+uint8_t clip_cache_ready(uint8_t slot)
+{
+    if (slot >= CLIP_SLOT_COUNT)
+    {
+        return 0;
+    }
+
+    const ClipSlot_t *s = &g_clip_slots[slot];
+
+    return (s->length > 0 && s->loaded == s->length);
+}
+
+uint32_t clip_cache_free(void)
+{
+    return CLIP_POOL_SAMPLES - g_clip_pool_used;
+}
+
+/* ============================================================================ */
+/* Voice */
+/* ============================================================================ */
+
+uint8_t clip_voice_start(ClipVoice_t *v, uint8_t slot, uint8_t loop, uint8_t gain)
+{
+    if (!clip_cache_ready(slot))
+    {
+        return 1;
+    }
+
+    if (gain == 0 || gain > 100)
+    {
+        gain = 100;
+    }
+
+    const ClipSlot_t *s = &g_clip_slots[slot];
+
+    v->length = s->length;
+    v->pos = 0;
+    v->loop = loop ? 1 : 0;
+    v->done = 0;
+    v->gain = ((int32_t)gain * CLIP_GAIN_UNITY) / 100;
+    v->data = &g_clip_pool[s->offset];
+
+    return 0;
+}
+
+void clip_voice_stop(ClipVoice_t *v)
+{
+    v->data = NULL;
+    v->done = 0;
+}
+
+HOT_PATH const int16_t *clip_voice_next(ClipVoice_t *v, uint16_t *n, int16_t *silence, uint8_t *ended)
+{
+    if (v->done)
+    {
+        // One-shot tail until the channel has stopped
+        memset(silence, 0, *n * sizeof(int16_t));
+        return silence;
+    }
+
+    if (v->pos >= v->length)
+    {
+        v->pos = 0;  // Loop point
+    }
+
+    uint16_t left = v->length - v->pos;
+    if (*n > left)
+    {
+        *n = left;
+    }
+
+    const int16_t *src = &v->data[v->pos];
+    v->pos += *n;
+
+    if (v->pos >= v->length && !v->loop)
+    {
+        v->done = 1;
+        *ended = 1;
+    }
+
+    return src;
+}
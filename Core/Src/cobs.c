@@ -0,0 +1,261 @@
+/**
+  ******************************************************************************
+  * @file           : cobs.c
+  * @brief          : COBS Framing and CRC-16 Implementation
+  ******************************************************************************
+  */
+
+#include "cobs.h"
+
+/* ============================================================================ */
+/* CRC-16 */
+/* ============================================================================ */
+
+uint16_t crc16_ccitt(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* ============================================================================ */
+/* COBS */
+/* ============================================================================ */
+
+uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t code_pos = 0;      // Where the current block's code byte goes
+    uint32_t out = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (src[i] != 0)
+        {
+            dst[out++] = src[i];
+            code++;
+        }
+
+        // Zero ends the block; a full block (254 data bytes) too
+        if (src[i] == 0 || code == 0xFF)
+        {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+
+    dst[code_pos] = code;
+
+    return out;
+}
+
+uint32_t cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t in = 0;
+    uint32_t out = 0;
+
+    while (in < len)
+    {
+        uint8_t code = src[in++];
+
+        if (code == 0 || (in + code - 1U) > len)
+        {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (src[in] == 0)
+            {
+                return 0;
+            }
+            dst[out++] = src[in++];
+        }
+
+        // Implicit zero after a short block, except at the very end
+        if (code != 0xFF && in < len)
+        {
+            dst[out++] = 0;
+        }
+    }
+
+    return out;
+}
+
+/* ============================================================================ */
+/* Frames */
+/* ============================================================================ */
+
+uint32_t cobs_frame_build(const uint8_t *payload, uint32_t len, uint8_t *frame)
+{
+    uint16_t crc = crc16_ccitt(payload, len);
+    uint32_t out = 0;
+    uint32_t code_pos;
+    uint8_t code = 1;
+
+    frame[out++] = COBS_DELIMITER;
+
+    // Encode payload + CRC in one pass (no staging copy)
+    code_pos = out++;
+    for (uint32_t i = 0; i < len + 2U; i++)
+    {
+        uint8_t b = (i < len) ? payload[i]
+                  : (i == len) ? (uint8_t)(crc & 0xFF) : (uint8_t)(crc >> 8);
+
+        if (b != 0)
+        {
+            frame[out++] = b;
+            code++;
+        }
+
+        if (b == 0 || code == 0xFF)
+        {
+            frame[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    frame[code_pos] = code;
+
+    frame[out++] = COBS_DELIMITER;
+
+    return out;
+}
+
+uint32_t cobs_frame_open(uint8_t *buf, uint32_t len)
+{
+    uint32_t n = cobs_decode(buf, len, buf);
+
+    if (n < 3)
+    {
+        return 0;
+    }
+
+    n -= 2;
+    if (crc16_ccitt(buf, n) != (uint16_t)(buf[n] | (buf[n + 1] << 8)))
+    {
+        return 0;
+    }
+
+    return n;
+}
+
+/* ============================================================================ */
+/* Stream Decoder */
+/* ============================================================================ */
+
+void cobs_stream_init(CobsStream_t *s, uint8_t *buf, uint32_t size)
+{
+    s->buf = buf;
+    s->size = size;
+    s->len = 0;
+    s->left = 0;
+    s->zero = 0;
+    s->active = 0;
+    s->skip = 0;
+    s->frames = 0;
+    s->bad_frames = 0;
+    s->overflows = 0;
+}
+
+/**
+ * @brief Delimiter: check the finished frame, reset for the next one
+ * @return Payload length, 0 if none / invalid
+ */
+static uint32_t cobs_stream_end(CobsStream_t *s)
+{
+    uint32_t n = 0;
+
+    if (s->active && !s->skip)
+    {
+        // Truncated block, too short for a CRC or CRC mismatch
+        if (s->left != 0 || s->len < 3 ||
+            crc16_ccitt(s->buf, s->len - 2U) !=
+            (uint16_t)(s->buf[s->len - 2U] | (s->buf[s->len - 1U] << 8)))
+        {
+            s->bad_frames++;
+        }
+        else
+        {
+            n = s->len - 2U;
+            s->frames++;
+        }
+    }
+
+    s->len = 0;
+    s->left = 0;
+    s->zero = 0;
+    s->active = 0;
+    s->skip = 0;
+
+    return n;
+}
+
+uint32_t cobs_stream_feed(CobsStream_t *s, const uint8_t *data, uint32_t len,
+                          uint32_t *payload_len)
+{
+    *payload_len = 0;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint8_t b = data[i];
+
+        if (b == COBS_DELIMITER)
+        {
+            *payload_len = cobs_stream_end(s);
+            if (*payload_len != 0)
+            {
+                return i + 1U;
+            }
+            continue;
+        }
+
+        if (s->skip)
+        {
+            continue;
+        }
+
+        s->active = 1;
+
+        if (s->left == 0)
+        {
+            // Code byte: the previous short block ended with a zero
+            if (s->zero)
+            {
+                if (s->len >= s->size)
+                {
+                    s->overflows++;
+                    s->skip = 1;
+                    continue;
+                }
+                s->buf[s->len++] = 0;
+            }
+            s->left = b - 1U;
+            s->zero = (b != 0xFF);
+        }
+        else
+        {
+            if (s->len >= s->size)
+            {
+                s->overflows++;
+                s->skip = 1;
+                continue;
+            }
+            s->buf[s->len++] = b;
+            s->left--;
+        }
+    }
+
+    return len;
+}
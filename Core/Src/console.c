@@ -0,0 +1,530 @@
+/**
+  ******************************************************************************
+  * @file           : console.c
+  * @brief          : UART3 Console Implementation
+  ******************************************************************************
+  */
+
+#include "console.h"
+#include "ring_buffer.h"
+#include "user_com.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================ */
+/* External UART3 TX path (user_com.c) */
+/* ============================================================================ */
+
+extern Queue tx_UART3_queue;
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+#define KEY_CTRL_C      0x03
+#define KEY_BS          0x08
+#define KEY_TAB         0x09
+#define KEY_ESC         0x1B
+#define KEY_DEL         0x7F
+
+// Registry, sorted by name (insertion sort on register, bsearch on lookup)
+static const ConsoleCmd_t *g_cmds[CONSOLE_MAX_CMDS];
+static uint32_t g_cmd_count = 0;
+
+static const char *g_prompt = "> ";
+
+// Line editor
+static char g_line[CONSOLE_LINE_MAX + 1];
+static uint32_t g_line_len = 0;
+static uint8_t g_esc_state = 0;         // 0: none, 1: ESC seen, 2: CSI parameters
+
+// Running job (handler != NULL while busy)
+static ConsoleJob_t g_job;
+
+/* ============================================================================ */
+/* Private Functions */
+/* ============================================================================ */
+
+static void console_echo(const char *str, uint32_t len)
+{
+    Enqueue_bytes(&tx_UART3_queue, (uint8_t *)str, len);
+}
+
+/**
+ * @brief First registry index with name >= key (first n bytes compared)
+ */
+static uint32_t console_lower_bound(const char *key, uint32_t n)
+{
+    uint32_t lo = 0;
+    uint32_t hi = g_cmd_count;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2U;
+
+        if (strncmp(g_cmds[mid]->name, key, n) < 0)
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * @brief Schema check: tokens "<name:t>" / "[name:t]", t in u/i/s,
+ *        optional ones last, at most CONSOLE_MAX_ARGS
+ * @return Number of arguments, -1 if malformed
+ */
+static int32_t console_schema_check(const char *schema, uint8_t *required)
+{
+    int32_t count = 0;
+    uint8_t optional = 0;
+    const char *p = schema;
+
+    *required = 0;
+
+    while (*p != '\0')
+    {
+        if (*p == ' ')
+        {
+            p++;
+            continue;
+        }
+
+        char close = (*p == '<') ? '>' : (*p == '[') ? ']' : 0;
+        const char *end = (close != 0) ? strchr(p, close) : NULL;
+
+        if (end == NULL || (end - p) < 4 || end[-2] != ':' ||
+            strchr("uis", end[-1]) == NULL || count >= CONSOLE_MAX_ARGS)
+        {
+            return -1;
+        }
+
+        if (close == ']')
+        {
+            optional = 1;
+        }
+        else if (optional)
+        {
+            return -1;          // Required after optional
+        }
+        else
+        {
+            (*required)++;
+        }
+
+        count++;
+        p = end + 1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Type character of argument n (schema already checked)
+ */
+static char console_schema_type(const char *schema, uint32_t n)
+{
+    const char *p = schema;
+
+    for (;;)
+    {
+        const char *end = strpbrk(p, ">]");
+
+        if (n-- == 0U)
+        {
+            return end[-1];
+        }
+        p = end + 1;
+    }
+}
+
+/**
+ * @brief Convert one argument per its schema type
+ * @return 0 on success
+ */
+static uint8_t console_parse_arg(char type, const char *tok, ConsoleArg_t *arg)
+{
+    char *end;
+
+    if (type == 's')
+    {
+        arg->s = tok;
+        return 0;
+    }
+
+    if (type == 'u')
+    {
+        if (*tok == '-')
+        {
+            return 1;
+        }
+        arg->u = (uint32_t)strtoul(tok, &end, 0);
+    }
+    else
+    {
+        arg->i = (int32_t)strtol(tok, &end, 0);
+    }
+
+    return (end == tok || *end != '\0') ? 1 : 0;
+}
+
+static void console_usage(const ConsoleCmd_t *cmd)
+{
+    printf("Usage: %s %s\r\n", cmd->name, cmd->args);
+}
+
+/**
+ * @brief Split the line, check arguments, start the job
+ */
+static void console_execute(void)
+{
+    char *argv[CONSOLE_MAX_ARGS + 2];
+    uint32_t argc = 0;
+    char *p = g_line;
+
+    g_line[g_line_len] = '\0';
+    g_line_len = 0;
+
+    // Tokens in place (the job's string arguments point here)
+    while (*p != '\0' && argc < (sizeof(argv) / sizeof(argv[0])))
+    {
+        while (*p == ' ')
+        {
+            *p++ = '\0';
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+        argv[argc++] = p;
+        while (*p != '\0' && *p != ' ')
+        {
+            p++;
+        }
+    }
+
+    if (argc == 0)
+    {
+        console_prompt();
+        return;
+    }
+
+    const ConsoleCmd_t *cmd = console_find(argv[0]);
+    if (cmd == NULL)
+    {
+        printf("Unknown command: '%s'\r\n", argv[0]);
+        printf("Type 'help' to show available commands.\r\n");
+        console_prompt();
+        return;
+    }
+
+    uint8_t required;
+    int32_t max_args = console_schema_check(cmd->args, &required);
+    uint32_t nargs = argc - 1U;
+
+    if (nargs < required || nargs > (uint32_t)max_args)
+    {
+        console_usage(cmd);
+        console_prompt();
+        return;
+    }
+
+    memset(&g_job, 0, sizeof(g_job));
+    g_job.cmd = cmd;
+    g_job.argc = (uint8_t)nargs;
+
+    for (uint32_t i = 0; i < nargs; i++)
+    {
+        char type = console_schema_type(cmd->args, i);
+
+        if (console_parse_arg(type, argv[i + 1U], &g_job.argv[i]) != 0)
+        {
+            printf("Invalid argument '%s' (%s expected)\r\n", argv[i + 1U],
+                   (type == 'u') ? "unsigned number" : "number");
+            console_usage(cmd);
+            g_job.cmd = NULL;
+            console_prompt();
+            return;
+        }
+    }
+
+    // First step right away - short commands finish here
+    if (cmd->handler(&g_job) == CONSOLE_DONE)
+    {
+        g_job.cmd = NULL;
+        console_prompt();
+    }
+}
+
+/**
+ * @brief TAB: complete the command word
+ */
+static void console_complete(void)
+{
+    // Arguments are not completed
+    if (memchr(g_line, ' ', g_line_len) != NULL)
+    {
+        console_echo("\a", 1);
+        return;
+    }
+
+    // Matches are contiguous in the sorted registry
+    uint32_t first = console_lower_bound(g_line, g_line_len);
+    uint32_t last = first;
+
+    while (last < g_cmd_count && strncmp(g_cmds[last]->name, g_line, g_line_len) == 0)
+    {
+        last++;
+    }
+
+    if (first == last)
+    {
+        console_echo("\a", 1);
+        return;
+    }
+
+    // Longest common prefix of the matches (first vs. last is enough, sorted)
+    const char *a = g_cmds[first]->name;
+    const char *b = g_cmds[last - 1U]->name;
+    uint32_t common = g_line_len;
+
+    while (a[common] != '\0' && a[common] == b[common])
+    {
+        common++;
+    }
+
+    if (common > CONSOLE_LINE_MAX - 1U)
+    {
+        common = CONSOLE_LINE_MAX - 1U;
+    }
+
+    if (common > g_line_len || (last - first) == 1U)
+    {
+        memcpy(&g_line[g_line_len], &a[g_line_len], common - g_line_len);
+        console_echo(&a[g_line_len], common - g_line_len);
+        g_line_len = common;
+
+        // Unique: the word is complete, continue with the arguments
+        if ((last - first) == 1U && g_line_len < CONSOLE_LINE_MAX)
+        {
+            g_line[g_line_len++] = ' ';
+            console_echo(" ", 1);
+        }
+        return;
+    }
+
+    // Ambiguous, nothing to add: list the candidates, redraw the line
+    console_echo("\r\n", 2);
+    for (uint32_t i = first; i < last; i++)
+    {
+        printf("%s  ", g_cmds[i]->name);
+    }
+    printf("\r\n");
+    console_prompt();
+}
+
+/**
+ * @brief Line editor, one received byte
+ */
+static void console_key(uint8_t key)
+{
+    // VT100 sequences (arrow keys: ESC [ A): drop them whole
+    if (g_esc_state == 1U)
+    {
+        g_esc_state = (key == '[') ? 2U : 0U;
+        return;
+    }
+    if (g_esc_state == 2U)
+    {
+        if (key >= 0x40U && key <= 0x7EU)
+        {
+            g_esc_state = 0;
+        }
+        return;
+    }
+
+    switch (key)
+    {
+        case '\r':
+            console_echo("\r\n", 2);
+            console_execute();
+            break;
+
+        case '\n':
+            break;              // "\r\n" terminals
+
+        case KEY_BS:
+        case KEY_DEL:
+            if (g_line_len > 0U)
+            {
+                g_line_len--;
+                console_echo("\b \b", 3);
+            }
+            break;
+
+        case KEY_TAB:
+            console_complete();
+            break;
+
+        case KEY_CTRL_C:
+            g_line_len = 0;
+            console_echo("^C\r\n", 4);
+            console_prompt();
+            break;
+
+        case KEY_ESC:
+            g_esc_state = 1;
+            break;
+
+        default:
+            if (key >= 0x20U && key < 0x7FU && g_line_len < CONSOLE_LINE_MAX)
+            {
+                g_line[g_line_len++] = (char)key;
+                console_echo((const char *)&key, 1);
+            }
+            break;
+    }
+}
+
+/* ============================================================================ */
+/* Public Functions */
+/* ============================================================================ */
+
+void console_init(const char *prompt)
+{
+    g_cmd_count = 0;
+    g_line_len = 0;
+    g_esc_state = 0;
+    g_job.cmd = NULL;
+
+    if (prompt != NULL)
+    {
+        g_prompt = prompt;
+    }
+}
+
+uint8_t console_register(const ConsoleCmd_t *cmds, uint32_t count)
+{
+    for (uint32_t n = 0; n < count; n++)
+    {
+        const ConsoleCmd_t *cmd = &cmds[n];
+        uint8_t required;
+
+        if (g_cmd_count >= CONSOLE_MAX_CMDS || cmd->name == NULL || cmd->name[0] == '\0' ||
+            cmd->handler == NULL || console_schema_check(cmd->args, &required) < 0)
+        {
+            printf("[CONSOLE] Cannot register '%s'\r\n", (cmd->name != NULL) ? cmd->name : "");
+            return 1;
+        }
+
+        uint32_t pos = console_lower_bound(cmd->name, CONSOLE_LINE_MAX);
+
+        if (pos < g_cmd_count && strcmp(g_cmds[pos]->name, cmd->name) == 0)
+        {
+            printf("[CONSOLE] Duplicate command '%s'\r\n", cmd->name);
+            return 1;
+        }
+
+        memmove(&g_cmds[pos + 1U], &g_cmds[pos], (g_cmd_count - pos) * sizeof(g_cmds[0]));
+        g_cmds[pos] = cmd;
+        g_cmd_count++;
+    }
+
+    return 0;
+}
+
+const ConsoleCmd_t *console_find(const char *name)
+{
+    uint32_t pos = console_lower_bound(name, CONSOLE_LINE_MAX);
+
+    if (pos < g_cmd_count && strcmp(g_cmds[pos]->name, name) == 0)
+    {
+        return g_cmds[pos];
+    }
+
+    return NULL;
+}
+
+void console_poll(void)
+{
+    if (g_job.cmd == NULL)
+    {
+        const uint8_t *data;
+        uint32_t len;
+
+        // Read in place from the RX ring (up to two segments per poll)
+        while ((len = UART3_RX_Peek(&data)) > 0U)
+        {
+            uint32_t run = 0;
+
+            // Typed text goes straight to the line, echoed as one run
+            while (run < len && g_esc_state == 0U && g_line_len < CONSOLE_LINE_MAX &&
+                   data[run] >= 0x20U && data[run] < 0x7FU)
+            {
+                g_line[g_line_len++] = (char)data[run++];
+            }
+
+            if (run > 0U)
+            {
+                console_echo((const char *)data, run);
+                UART3_RX_Take(run);
+                continue;
+            }
+
+            UART3_RX_Take(1);
+            console_key(data[0]);
+
+            // Command started: the rest of the input belongs to the job
+            if (g_job.cmd != NULL)
+            {
+                break;
+            }
+        }
+        return;
+    }
+
+    // Job running: only ESC / 'q' matter
+    while (UART3_RX_Len() > 0U)
+    {
+        uint8_t key = UART3_RX_Byte();
+
+        if (key == KEY_ESC || key == 'q' || key == 'Q')
+        {
+            g_job.abort = 1;
+        }
+    }
+
+    if (g_job.cmd->handler(&g_job) == CONSOLE_DONE)
+    {
+        g_job.cmd = NULL;
+        console_prompt();
+    }
+}
+
+uint8_t console_busy(void)
+{
+    return (g_job.cmd != NULL) ? 1U : 0U;
+}
+
+void console_help(void)
+{
+    for (uint32_t i = 0; i < g_cmd_count; i++)
+    {
+        const ConsoleCmd_t *cmd = g_cmds[i];
+
+        printf("  %-6s %-28s %s\r\n", cmd->name, cmd->args, cmd->help);
+    }
+}
+
+void console_prompt(void)
+{
+    printf("%s", g_prompt);
+    console_echo(g_line, g_line_len);
+}
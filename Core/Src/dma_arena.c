@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file           : dma_arena.c
+  * @brief          : Static DMA Memory Arena Implementation
+  ******************************************************************************
+  */
+
+#include "dma_arena.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================ */
+/* Linker Symbols (STM32H523CCTX_FLASH.ld) */
+/* ============================================================================ */
+
+extern uint8_t _sdma_buffer[];      // .dma_buffer start (arena first)
+extern uint8_t _edma_buffer[];      // .dma_buffer end
+extern uint8_t _sdma_region[];      // RAM_DMA start (MPU region 0)
+extern uint8_t _edma_region[];      // RAM_DMA end
+
+/* ============================================================================ */
+/* Private Types / Variables */
+/* ============================================================================ */
+
+/**
+ * @brief Pool descriptor
+ */
+typedef struct {
+    uint8_t *base;
+    uint32_t size;
+    uint32_t used;
+} DmaPool_t;
+
+/**
+ * @brief Allocation table entry
+ */
+typedef struct {
+    const char *name;
+    void *addr;
+    uint32_t size;
+    uint8_t attr;
+} DmaBlock_t;
+
+// Non-cacheable pool - placed first in .dma_buffer by the linker script
+__attribute__((section(".dma_arena"))) __attribute__((aligned(DMA_ARENA_LINE)))
+static uint8_t g_arena_noncached[DMA_ARENA_NONCACHED_SIZE];
+
+#if DMA_ARENA_CACHED_SIZE > 0
+// Cacheable pool - whole lines only, see DMA_MEM_CACHED
+__attribute__((aligned(DMA_ARENA_LINE)))
+static uint8_t g_arena_cached[DMA_ARENA_ROUND(DMA_ARENA_CACHED_SIZE)];
+#endif
+
+static DmaPool_t g_pools[2] = {
+    { g_arena_noncached, sizeof(g_arena_noncached), 0 },
+#if DMA_ARENA_CACHED_SIZE > 0
+    { g_arena_cached, sizeof(g_arena_cached), 0 },
+#else
+    { NULL, 0, 0 },
+#endif
+};
+
+static DmaBlock_t g_blocks[DMA_ARENA_MAX_BLOCKS];
+static uint8_t g_block_count = 0;
+
+/* ============================================================================ */
+/* Allocation */
+/* ============================================================================ */
+
+void *dma_arena_alloc(DmaMemAttr_t attr, size_t size, size_t align, const char *name)
+{
+    // Same buffer requested again (init re-run): hand out the existing block
+    for (uint8_t i = 0; i < g_block_count; i++)
+    {
+        if (g_blocks[i].attr == attr && strcmp(g_blocks[i].name, name) == 0 &&
+            g_blocks[i].size >= size)
+        {
+            return g_blocks[i].addr;
+        }
+    }
+
+    DmaPool_t *pool = &g_pools[(attr == DMA_MEM_CACHED) ? 1 : 0];
+
+    if (align < DMA_ARENA_LINE)
+    {
+        align = DMA_ARENA_LINE;
+    }
+
+    uint32_t start = (uint32_t)((((uintptr_t)pool->base + pool->used + align - 1) & ~(uintptr_t)(align - 1))
+                                - (uintptr_t)pool->base);
+    uint32_t bytes = DMA_ARENA_ROUND(size);
+
+    if (g_block_count >= DMA_ARENA_MAX_BLOCKS || pool->base == NULL ||
+        start + bytes > pool->size)
+    {
+        printf("[DMA] ERROR: no space for %s (%u bytes, %s pool %lu/%lu used)\r\n",
+               name, (unsigned)size, (attr == DMA_MEM_CACHED) ? "cached" : "non-cached",
+               pool->used, pool->size);
+        Error_Handler();
+        return NULL;
+    }
+
+    DmaBlock_t *b = &g_blocks[g_block_count++];
+    b->name = name;
+    b->addr = pool->base + start;
+    b->size = bytes;
+    b->attr = (uint8_t)attr;
+
+    pool->used = start + bytes;
+
+    return b->addr;
+}
+
+uint8_t dma_arena_is_noncached(const void *addr, size_t size)
+{
+    uintptr_t a = (uintptr_t)addr;
+
+    return (a >= (uintptr_t)_sdma_region && a + size <= (uintptr_t)_edma_region);
+}
+
+uint32_t dma_arena_free(DmaMemAttr_t attr)
+{
+    const DmaPool_t *pool = &g_pools[(attr == DMA_MEM_CACHED) ? 1 : 0];
+
+    return pool->size - pool->used;
+}
+
+/* ============================================================================ */
+/* Report */
+/* ============================================================================ */
+
+void dma_arena_report(void)
+{
+    uint32_t region = (uint32_t)(_edma_region - _sdma_region);
+    uint32_t placed = (uint32_t)(_edma_buffer - _sdma_buffer);
+    uint8_t ok = 1;
+
+    printf("\r\n[DMA Arena]\r\n");
+    printf("  %-18s %-10s %10s %7s\r\n", "Buffer", "Attr", "Address", "Bytes");
+
+    for (uint8_t i = 0; i < g_block_count; i++)
+    {
+        const DmaBlock_t *b = &g_blocks[i];
+        uint8_t nc = dma_arena_is_noncached(b->addr, b->size);
+
+        // Non-cached tag must really be in MPU region 0
+        if (b->attr == DMA_MEM_NONCACHED && !nc)
+        {
+            ok = 0;
+        }
+
+        printf("  %-18s %-10s 0x%08lX %7lu\r\n", b->name,
+               (b->attr == DMA_MEM_CACHED) ? "cached" : "non-cached",
+               (uint32_t)b->addr, b->size);
+    }
+
+    printf("  Non-cached pool: %lu / %lu bytes used\r\n",
+           g_pools[0].used, g_pools[0].size);
+    printf("  Cached pool    : %lu / %lu bytes used\r\n",
+           g_pools[1].used, g_pools[1].size);
+    printf("  RAM_DMA        : %lu / %lu bytes placed (0x%08lX ~ 0x%08lX)\r\n",
+           placed, region, (uint32_t)_sdma_region, (uint32_t)_edma_region - 1);
+
+    if (ok)
+    {
+        printf("  ✓ Non-cached buffers in MPU non-cacheable region\r\n");
+    }
+    else
+    {
+        printf("  ✗ ERROR: Non-cached buffer outside MPU region!\r\n");
+    }
+}
@@ -0,0 +1,102 @@
+/**
+  ******************************************************************************
+  * @file           : hot_path.c
+  * @brief          : SRAM Placement Report
+  ******************************************************************************
+  */
+
+#include "hot_path.h"
+#include "main.h"
+#include "stm32h5xx_it.h"
+#include "spi_handler.h"
+#include "audio_output.h"
+#include "audio_channel.h"
+#include "audio_mixer.h"
+#include <stdio.h>
+
+/* ============================================================================ */
+/* Linker Symbols (STM32H523CCTX_FLASH.ld) */
+/* ============================================================================ */
+
+extern uint8_t _sramfunc[];         // .RamFunc* start (SRAM)
+extern uint8_t _eramfunc[];         // .RamFunc* end
+
+// CS edge dispatch (stm32h5xx_it.c)
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/* ============================================================================ */
+/* Hot Path Table */
+/* ============================================================================ */
+
+/**
+ * @brief Entry of the placement report
+ */
+typedef struct {
+    const char *name;
+    const void *fn;
+} HotPathEntry_t;
+
+// Entry points only - static helpers carry HOT_PATH in their own file
+static const HotPathEntry_t g_hot_paths[] = {
+    { "exti15_cs_irq",              (const void *)exti15_cs_irq },
+    { "HAL_GPIO_EXTI_Callback",     (const void *)HAL_GPIO_EXTI_Callback },
+    { "spi_handler_cs_falling",     (const void *)spi_handler_cs_falling },
+    { "spi_handler_cs_rising",      (const void *)spi_handler_cs_rising },
+    { "spi_handler_update_rdy",     (const void *)spi_handler_update_rdy },
+    { "audio_channel_fill_packed",  (const void *)audio_channel_fill_packed },
+    { "audio_channel_unpack",       (const void *)audio_channel_unpack },
+    { "audio_channel_fill_adpcm",   (const void *)audio_channel_fill_adpcm },
+    { "DAC CH1 half / cplt",        (const void *)HAL_DAC_ConvHalfCpltCallbackCh1 },
+    { "DAC CH2 half / cplt",        (const void *)HAL_DACEx_ConvHalfCpltCallbackCh2 },
+    { "audio_output_dma_event",     (const void *)audio_output_dma_event },
+    { "audio_channel_render",       (const void *)audio_channel_render },
+    { "audio_mixer_process",        (const void *)audio_mixer_process },
+    { "audio_gen_render",           (const void *)audio_gen_render },
+    { "clip_voice_next",            (const void *)clip_voice_next },
+    { "audio_dsp_process",          (const void *)audio_dsp_process },
+    { "audio_dsp_upsample",         (const void *)audio_dsp_upsample },
+};
+
+/* ============================================================================ */
+/* Report */
+/* ============================================================================ */
+
+uint8_t hot_path_in_sram(const void *fn)
+{
+    // Thumb bit set in function pointers
+    uintptr_t a = (uintptr_t)fn & ~(uintptr_t)1;
+
+    return (a >= (uintptr_t)_sramfunc && a < (uintptr_t)_eramfunc);
+}
+
+void hot_path_report(void)
+{
+    uint8_t in_flash = 0;
+
+    printf("\r\n[Hot Path Placement]\r\n");
+
+    for (uint32_t i = 0; i < sizeof(g_hot_paths) / sizeof(g_hot_paths[0]); i++)
+    {
+        uint8_t sram = hot_path_in_sram(g_hot_paths[i].fn);
+
+        if (!sram)
+        {
+            in_flash++;
+        }
+
+        printf("  %-26s 0x%08lX %s\r\n", g_hot_paths[i].name,
+               (uint32_t)g_hot_paths[i].fn & ~1UL, sram ? "SRAM" : "FLASH");
+    }
+
+    printf("  SRAM code: %lu / %d bytes (0x%08lX)\r\n",
+           (uint32_t)(_eramfunc - _sramfunc), HOT_PATH_BUDGET, (uint32_t)_sramfunc);
+
+    if (in_flash == 0)
+    {
+        printf("  ✓ All hot paths in SRAM\r\n");
+    }
+    else
+    {
+        printf("  ✗ %u hot path(s) still in flash\r\n", in_flash);
+    }
+}
@@ -0,0 +1,191 @@
+/**
+  ******************************************************************************
+  * @file           : irq_prio.c
+  * @brief          : Interrupt Priority Plan and ISR Latency Measurement
+  ******************************************************************************
+  */
+
+#include "irq_prio.h"
+#include "audio_output.h"
+#include "hot_path.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================ */
+/* External TIM handles (from main.c) */
+/* ============================================================================ */
+
+extern TIM_HandleTypeDef htim1;  // DAC CH1 trigger (both in stereo lock)
+extern TIM_HandleTypeDef htim7;  // DAC CH2 trigger
+
+/* ============================================================================ */
+/* Priority Table */
+/* ============================================================================ */
+
+/**
+ * @brief Plan entry
+ */
+typedef struct {
+    IRQn_Type irq;
+    uint8_t level;
+    const char *name;
+} IrqPrioEntry_t;
+
+static const IrqPrioEntry_t g_irq_plan[] = {
+    { GPDMA2_Channel0_IRQn, IRQ_PRIO_AUDIO, "GPDMA2 CH0 (DAC CH1)" },
+    { GPDMA2_Channel1_IRQn, IRQ_PRIO_AUDIO, "GPDMA2 CH1 (DAC CH2)" },
+    { TIM2_IRQn,            IRQ_PRIO_AUDIO, "TIM2 (sample clock)" },
+    { EXTI15_IRQn,          IRQ_PRIO_SPI,   "EXTI15 (SPI CS)" },
+    { SPI1_IRQn,            IRQ_PRIO_SPI,   "SPI1" },
+    { GPDMA1_Channel4_IRQn, IRQ_PRIO_SPI,   "GPDMA1 CH4 (SPI RX)" },
+    { GPDMA1_Channel5_IRQn, IRQ_PRIO_SPI,   "GPDMA1 CH5 (SPI TX)" },
+    { USART1_IRQn,          IRQ_PRIO_COM,   "USART1" },
+    { USART3_IRQn,          IRQ_PRIO_COM,   "USART3" },
+    { GPDMA1_Channel0_IRQn, IRQ_PRIO_COM,   "GPDMA1 CH0 (USART3 RX)" },
+    { GPDMA1_Channel1_IRQn, IRQ_PRIO_COM,   "GPDMA1 CH1 (USART3 TX)" },
+    { GPDMA1_Channel2_IRQn, IRQ_PRIO_COM,   "GPDMA1 CH2 (USART1 RX)" },
+    { GPDMA1_Channel3_IRQn, IRQ_PRIO_COM,   "GPDMA1 CH3 (USART1 TX)" },
+    { TIM7_IRQn,            IRQ_PRIO_LOW,   "TIM7" },
+};
+
+#define IRQ_PLAN_SIZE   (sizeof(g_irq_plan) / sizeof(g_irq_plan[0]))
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+volatile uint8_t g_irq_lat_enabled = 0;
+volatile uint32_t g_audio_lock_max = 0;
+
+static IrqLatStats_t g_irq_lat[IRQ_LAT_COUNT];
+
+// EXTI15 probe: DWT time of the software pend (0 = none pending)
+static volatile uint32_t g_probe_t0 = 0;
+
+/* ============================================================================ */
+/* Priority Plan */
+/* ============================================================================ */
+
+void irq_prio_apply(void)
+{
+    for (uint32_t i = 0; i < IRQ_PLAN_SIZE; i++)
+    {
+        HAL_NVIC_SetPriority(g_irq_plan[i].irq, g_irq_plan[i].level, 0);
+    }
+}
+
+void irq_prio_report(void)
+{
+    printf("\r\n[IRQ Priority Plan] (0 = highest, no sub-priority)\r\n");
+
+    for (uint32_t i = 0; i < IRQ_PLAN_SIZE; i++)
+    {
+        uint32_t level = NVIC_GetPriority(g_irq_plan[i].irq);
+
+        printf("  %-24s %lu%s\r\n", g_irq_plan[i].name, level,
+               (level != g_irq_plan[i].level) ? "  ✗ (plan differs)" : "");
+    }
+
+    printf("  SysTick                  %lu\r\n", NVIC_GetPriority(SysTick_IRQn));
+    printf("  audio_lock(): BASEPRI 0x%02X (masks level >= %d)\r\n",
+           IRQ_PRIO_BASEPRI(IRQ_PRIO_AUDIO), IRQ_PRIO_AUDIO);
+}
+
+/* ============================================================================ */
+/* Latency Measurement */
+/* ============================================================================ */
+
+void irq_lat_enable(uint8_t enable)
+{
+    if (enable)
+    {
+        DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        memset(g_irq_lat, 0, sizeof(g_irq_lat));
+        g_audio_lock_max = 0;
+        g_probe_t0 = 0;
+    }
+
+    g_irq_lat_enabled = enable ? 1 : 0;
+}
+
+HOT_PATH void irq_lat_end(IrqLatId_t id, uint32_t t0, uint32_t entry)
+{
+    if (!g_irq_lat_enabled)
+    {
+        return;
+    }
+
+    IrqLatStats_t *s = &g_irq_lat[id];
+    uint32_t run = DWT->CYCCNT - t0;
+
+    s->count++;
+    if (run > s->run_max)
+    {
+        s->run_max = run;
+    }
+    if (entry > s->entry_max)
+    {
+        s->entry_max = entry;
+    }
+}
+
+HOT_PATH uint32_t irq_lat_dac_entry(uint32_t dac_channel)
+{
+    if (!g_irq_lat_enabled)
+    {
+        return 0;
+    }
+
+    // DMA event follows the trigger (update event) - counter = time since
+    TIM_TypeDef *tim = (dac_channel == DAC_CHANNEL_1 || audio_output_is_stereo_locked())
+                       ? htim1.Instance : htim7.Instance;
+
+    return tim->CNT * (tim->PSC + 1);
+}
+
+void irq_lat_probe(void)
+{
+    if (!g_irq_lat_enabled || g_probe_t0 != 0)
+    {
+        return;
+    }
+
+    // Non-zero marker (CYCCNT may read 0)
+    g_probe_t0 = DWT->CYCCNT | 1U;
+    NVIC_SetPendingIRQ(EXTI15_IRQn);
+}
+
+HOT_PATH uint32_t irq_lat_probe_taken(void)
+{
+    uint32_t t0 = g_probe_t0;
+
+    if (t0 == 0)
+    {
+        return 0;
+    }
+
+    g_probe_t0 = 0;
+
+    return DWT->CYCCNT - t0;
+}
+
+HOT_PATH void irq_lat_lock_end(uint32_t t0)
+{
+    if (!g_irq_lat_enabled)
+    {
+        return;
+    }
+
+    uint32_t held = DWT->CYCCNT - t0;
+    if (held > g_audio_lock_max)
+    {
+        g_audio_lock_max = held;
+    }
+}
+
+const IrqLatStats_t *irq_lat_get(IrqLatId_t id)
+{
+    return &g_irq_lat[id];
+}
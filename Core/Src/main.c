@@ -331,13 +331,13 @@ static void MX_GPDMA1_Init(void)
   __HAL_RCC_GPDMA1_CLK_ENABLE();
 
   /* GPDMA1 interrupt Init */
-    HAL_NVIC_SetPriority(GPDMA1_Channel0_IRQn, 2, 0);
+    HAL_NVIC_SetPriority(GPDMA1_Channel0_IRQn, 3, 0);
     HAL_NVIC_EnableIRQ(GPDMA1_Channel0_IRQn);
-    HAL_NVIC_SetPriority(GPDMA1_Channel1_IRQn, 2, 0);
+    HAL_NVIC_SetPriority(GPDMA1_Channel1_IRQn, 3, 0);
     HAL_NVIC_EnableIRQ(GPDMA1_Channel1_IRQn);
-    HAL_NVIC_SetPriority(GPDMA1_Channel2_IRQn, 2, 0);
+    HAL_NVIC_SetPriority(GPDMA1_Channel2_IRQn, 3, 0);
     HAL_NVIC_EnableIRQ(GPDMA1_Channel2_IRQn);
-    HAL_NVIC_SetPriority(GPDMA1_Channel3_IRQn, 2, 0);
+    HAL_NVIC_SetPriority(GPDMA1_Channel3_IRQn, 3, 0);
     HAL_NVIC_EnableIRQ(GPDMA1_Channel3_IRQn);
     HAL_NVIC_SetPriority(GPDMA1_Channel4_IRQn, 2, 0);
     HAL_NVIC_EnableIRQ(GPDMA1_Channel4_IRQn);
@@ -369,9 +369,9 @@ static void MX_GPDMA2_Init(void)
   __HAL_RCC_GPDMA2_CLK_ENABLE();
 
   /* GPDMA2 interrupt Init */
-    HAL_NVIC_SetPriority(GPDMA2_Channel0_IRQn, 0, 0);
+    HAL_NVIC_SetPriority(GPDMA2_Channel0_IRQn, 1, 0);
     HAL_NVIC_EnableIRQ(GPDMA2_Channel0_IRQn);
-    HAL_NVIC_SetPriority(GPDMA2_Channel1_IRQn, 0, 0);
+    HAL_NVIC_SetPriority(GPDMA2_Channel1_IRQn, 1, 0);
     HAL_NVIC_EnableIRQ(GPDMA2_Channel1_IRQn);
 
   /* USER CODE BEGIN GPDMA2_Init 1 */
@@ -682,7 +682,7 @@ static void MX_GPIO_Init(void)
   HAL_GPIO_Init(SPI1_ECTI_NSS_GPIO_Port, &GPIO_InitStruct);
 
   /* EXTI interrupt init*/
-  HAL_NVIC_SetPriority(EXTI15_IRQn, 0, 0);
+  HAL_NVIC_SetPriority(EXTI15_IRQn, 2, 0);
   HAL_NVIC_EnableIRQ(EXTI15_IRQn);
 
   /* USER CODE BEGIN MX_GPIO_Init_2 */
@@ -691,7 +691,7 @@ static void MX_GPIO_Init(void)
   // Falling edge: CS LOW -> Start SPI IT reception
   // Rising edge: CS HIGH -> Transmission complete
   printf("[GPIO] PA15 = SPI1_EXT_NSS (Software NSS + EXTI, IT mode)\r\n");
-  printf("[NVIC] EXTI15 interrupt enabled (priority 1)\r\n");
+  printf("[NVIC] EXTI15 interrupt enabled (priority 2, irq_prio.h)\r\n");
 
   /* USER CODE END MX_GPIO_Init_2 */
 }
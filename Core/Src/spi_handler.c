@@ -8,6 +8,12 @@
   */
 
 #include "spi_handler.h"
+#include "hot_path.h"
+#include "irq_prio.h"
+#include "audio_output.h"
+#include "dma_arena.h"
+#include "cache_maint.h"
+#include "spi_timing.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -36,15 +42,6 @@ static uint8_t g_rx_header;
 __attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
 static CommandPacket_t g_rx_cmd_packet;
 
-// Data packet buffer (aligned for DMA, max size)
-// NOTE: Not in .dma_buffer section (too large, ~4KB)
-//       Data packets (0xDA) not implemented yet - will add cache handling when needed
-__attribute__((aligned(32)))
-static uint8_t g_rx_data_buffer[5 + (MAX_SAMPLES_PER_PACKET * 2)];  // 4101 bytes max
-
-static DataPacketHeader_t *g_rx_data_header = (DataPacketHeader_t*)g_rx_data_buffer;
-static uint16_t *g_rx_data_samples = (uint16_t*)(g_rx_data_buffer + sizeof(DataPacketHeader_t));
-
 // Error statistics
 static SPI_ErrorStats_t g_error_stats = {0};
 
@@ -56,6 +53,9 @@ static volatile uint32_t g_cs_falling_count = 0;
 static volatile uint32_t g_cs_rising_count = 0;
 static volatile uint32_t g_last_received_bytes = 0;
 
+// Sample clock (TIM2) latched at CS rising edge (CMD_SYNC reference)
+static uint32_t g_rx_timestamp = 0;
+
 // Debug: Last received packet (for debugging without printf in ISR)
 static volatile uint8_t g_last_rx_packet[5] = {0};
 static volatile uint8_t g_last_rx_valid = 0;
@@ -64,19 +64,10 @@ static volatile uint8_t g_last_rx_valid = 0;
 __attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
 static uint8_t g_dummy_tx[5] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
-// Large RX buffer for variable-length packets
-// Size: DataPacketHeader_t (5 bytes) + MAX_SAMPLES_PER_PACKET * 2 bytes
-// = 5 + 4100*2 = 8205 bytes, rounded to 8300 for safety
-// NOTE: In regular RAM (not .dma_buffer) to save DMA space.
-//       Requires cache invalidation after DMA receive (handled in code).
-__attribute__((aligned(32)))
-static uint8_t g_rx_large_buffer[8300];
-
-// DUAL DAC MODE: Combined 32-bit buffer for simultaneous CH1+CH2 output
-// Format: buffer[i] = (CH2_sample << 16) | CH1_sample
-// Must be in non-cacheable RAM for DMA + DCACHE compatibility
-__attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
-static uint32_t g_dual_dac_buffer[AUDIO_BUFFER_SIZE];  // 4096 32-bit words = 16KB
+// Large RX buffer for variable-length packets (SPI_RX_BUFFER_SIZE bytes)
+// Cacheable DMA arena block (whole lines), allocated in spi_handler_init()
+// -> received range is invalidated in spi_handler_cs_rising() before parsing
+static uint8_t *g_rx_large_buffer = NULL;
 
 /* ============================================================================ */
 /* External DAC/TIM handles (from main.c) */
@@ -87,58 +78,33 @@ extern TIM_HandleTypeDef htim1;  // Used for DUAL DAC mode
 extern TIM_HandleTypeDef htim7;  // Legacy (not used in dual mode)
 
 /* ============================================================================ */
-/* Private Function Prototypes */
-/* ============================================================================ */
-
-static void process_command_packet(CommandPacket_t *cmd);
-static void process_data_packet(DataPacketHeader_t *header, uint16_t *samples);
-static void safe_stop_dac_dma(uint32_t dac_channel);
-
-/* ============================================================================ */
-/* Helper Functions */
+/* Private Types */
 /* ============================================================================ */
 
 /**
- * @brief  Safely stop DAC DMA without HAL_DMA_Abort hang
- * @param  dac_channel: DAC_CHANNEL_1 or DAC_CHANNEL_2
- * @note   HAL_DAC_Stop_DMA calls HAL_DMA_Abort which hangs waiting for SUSPF
- *         This function directly disables DMA and clears DAC DMA enable bit
+ * @brief Trigger timer start mode for start_playback()
  */
-static void safe_stop_dac_dma(uint32_t dac_channel)
-{
-    DMA_HandleTypeDef *hdma = (dac_channel == DAC_CHANNEL_1) ? hdac1.DMA_Handle1 : hdac1.DMA_Handle2;
-
-    if (hdma == NULL || hdma->Instance == NULL)
-    {
-        return;  // No DMA configured
-    }
-
-    DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
-
-    // Disable DMA channel directly (avoid HAL_DMA_Abort hang)
-    dma_ch->CCR &= ~DMA_CCR_EN;
-
-    // Wait for DMA to stop (with timeout)
-    uint32_t timeout = 10000;
-    while ((dma_ch->CCR & DMA_CCR_EN) && (timeout > 0))
-    {
-        timeout--;
-    }
+typedef enum {
+    PLAY_START_NOW,         // Start trigger timer immediately (CMD_PLAY)
+    PLAY_START_AT,          // Start on TIM2 tick (CMD_PLAY_AT)
+    PLAY_START_ARM_ONLY     // Arm DMA only - timer started by the other channel
+} PlayStart_t;
 
-    // Disable DAC DMA request
-    if (dac_channel == DAC_CHANNEL_1)
-    {
-        CLEAR_BIT(DAC1->CR, DAC_CR_DMAEN1);
-        hdac1.State = HAL_DAC_STATE_READY;
-    }
-    else
-    {
-        CLEAR_BIT(DAC1->CR, DAC_CR_DMAEN2);
-    }
+/* ============================================================================ */
+/* Private Function Prototypes */
+/* ============================================================================ */
 
-    // Reset DMA state
-    hdma->State = HAL_DMA_STATE_READY;
-}
+static void dispatch_packet(uint8_t *buf, uint32_t received, uint32_t rx_time);
+static void process_command_packet(CommandPacket_t *cmd, uint32_t rx_time);
+static void process_data_packet(DataPacketHeader_t *header, const uint8_t *payload);
+static void process_adpcm_packet(AdpcmPacketHeader_t *header, uint8_t *data);
+static uint8_t process_param_packet(ParamPacketHeader_t *header, const uint8_t *payload);
+static uint8_t process_clip_packet(ClipPacketHeader_t *header, const uint8_t *payload);
+static void start_playback(CommandPacket_t *cmd, AudioChannel_t *channel,
+                           uint32_t dac_channel, PlayStart_t mode, uint32_t start_tick);
+static void start_stereo_playback(CommandPacket_t *cmd, PlayStart_t mode, uint32_t start_tick);
+static void start_source_playback(CommandPacket_t *cmd, AudioChannel_t *channel, uint32_t dac_channel);
+static void use_stream_source(AudioChannel_t *channel);
 
 /* ============================================================================ */
 /* Initialization */
@@ -153,9 +119,15 @@ void spi_handler_init(SPI_HandleTypeDef *hspi,
     g_dac2_channel = dac2_ch;
     g_rx_state = SPI_STATE_WAIT_HEADER;
 
+    // RX DMA buffer (same block on re-init)
+    g_rx_large_buffer = dma_arena_alloc(DMA_MEM_CACHED, SPI_RX_BUFFER_SIZE, DMA_ARENA_LINE, "spi_rx");
+
     // Clear error statistics
     memset(&g_error_stats, 0, sizeof(g_error_stats));
 
+    // CS edge timing (DWT cycle counter)
+    spi_timing_init();
+
     printf("[SPI] Handler initialized (Protocol v1.2, CS pin selection)\r\n");
 
     // Structure size check (simplified)
@@ -180,9 +152,11 @@ void spi_handler_start(void)
     printf("[SPI] nRDY Pin: PA%lu (0x%04X) = LOW (ready)\r\n", pin_num, OT_nRDY_Pin);
 
     // Clear RX buffer
-    memset(g_rx_large_buffer, 0xFF, sizeof(g_rx_large_buffer));
+    memset(g_rx_large_buffer, 0xFF, SPI_RX_BUFFER_SIZE);
+    // No dirty line may be evicted over DMA data later
+    cache_clean_invalidate(g_rx_large_buffer, SPI_RX_BUFFER_SIZE);
 
-    printf("[SPI] Ready for DMA reception with large buffer (4100 bytes)\r\n");
+    printf("[SPI] Ready for DMA reception with large buffer (%d bytes)\r\n", SPI_RX_BUFFER_SIZE);
     printf("[SPI] Software NSS + EXTI mode enabled\r\n");
     printf("[SPI] EXTI falling edge: Start DMA reception\r\n");
     printf("[SPI] EXTI rising edge: Stop DMA and process received data\r\n");
@@ -214,29 +188,34 @@ void spi_handler_start(void)
 /* RDY Pin Control (Active Low) */
 /* ============================================================================ */
 
-void spi_handler_set_ready(uint8_t ready)
+HOT_PATH void spi_handler_set_ready(uint8_t ready)
 {
     // Active Low: ready=1 → LOW, ready=0 → HIGH
     GPIO_PinState state = ready ? GPIO_PIN_RESET : GPIO_PIN_SET;
     HAL_GPIO_WritePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin, state);
 }
 
-void spi_handler_update_rdy(void)
+HOT_PATH void spi_handler_update_rdy(void)
 {
     // IMPORTANT: During playback, always keep RDY=LOW
-    // Rationale: DAC DMA continuously consumes data from active_buffer,
-    //            so fill_buffer will be available after buffer swap (max 64ms)
+    // Rationale: DAC DMA continuously consumes data from the active buffer,
+    //            so the fill buffer will be available after buffer swap (max 64ms)
     //            This prevents Main from waiting unnecessarily between chunks
     if (g_dac1_channel->is_playing || g_dac2_channel->is_playing)
     {
-        // Always ready during playback (double buffering handles overflow)
-        spi_handler_set_ready(1);
+        // Ready during playback (double buffering handles overflow), unless
+        // every playing channel holds its jitter target (audio_jitter.h)
+        uint8_t want = (g_dac1_channel->is_playing &&
+                        audio_jitter_wants_data(&g_dac1_channel->jitter, audio_channel_depth(g_dac1_channel))) ||
+                       (g_dac2_channel->is_playing &&
+                        audio_jitter_wants_data(&g_dac2_channel->jitter, audio_channel_depth(g_dac2_channel)));
+        spi_handler_set_ready(want);
         return;
     }
 
     // Not playing - check buffer status for pre-buffering
-    uint8_t dac1_ready = (g_dac1_channel->fill_index < AUDIO_BUFFER_SIZE);
-    uint8_t dac2_ready = (g_dac2_channel->fill_index < AUDIO_BUFFER_SIZE);
+    uint8_t dac1_ready = (audio_channel_fill_level(g_dac1_channel) < AUDIO_BUFFER_SIZE);
+    uint8_t dac2_ready = (audio_channel_fill_level(g_dac2_channel) < AUDIO_BUFFER_SIZE);
 
     // Both channels must be ready for RDY=LOW
     // If either channel is full, RDY=HIGH (busy)
@@ -267,7 +246,7 @@ void spi_handler_rx_callback(SPI_HandleTypeDef *hspi)
     g_dma_rx_complete_count++;
 
     // NOTE: In CS edge-based mode, packet processing is done in spi_handler_cs_rising()
-    // This callback is only called if DMA completes the full 4100 bytes (rare)
+    // This callback is only called if DMA completes the full SPI_RX_BUFFER_SIZE bytes (rare)
     // We should NOT restart DMA here - let CS edge handlers manage it
 
     // Just return - CS rising edge handler will process the packet
@@ -306,7 +285,7 @@ void spi_handler_rx_callback(SPI_HandleTypeDef *hspi)
         if (header == HEADER_CMD)
         {
             // Process command
-            process_command_packet(&g_rx_cmd_packet);
+            process_command_packet(&g_rx_cmd_packet, g_rx_timestamp);
 
             // Restart DMA reception for next packet
             memset(&g_rx_cmd_packet, 0xFF, sizeof(CommandPacket_t));
@@ -327,7 +306,7 @@ void spi_handler_rx_callback(SPI_HandleTypeDef *hspi)
             // Parse data packet header (first 4 bytes received as CommandPacket_t)
             DataPacketHeader_t *hdr = (DataPacketHeader_t *)&g_rx_cmd_packet;
             uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
-            uint8_t channel = hdr->channel;
+            uint8_t channel = GET_DATA_CHANNEL(hdr);
 
             // Validate sample count
             if (sample_count > 0 && sample_count <= MAX_SAMPLES_PER_PACKET)
@@ -406,7 +385,75 @@ void spi_handler_error_callback(SPI_HandleTypeDef *hspi)
 /* Packet Processing */
 /* ============================================================================ */
 
-static void process_command_packet(CommandPacket_t *cmd)
+/**
+ * @brief Enter a channel state update (render path locked out, hold time measured)
+ * @param t0 Output: start cycle for cmd_unlock()
+ * @return Previous BASEPRI
+ * @note  Commands lock only their state updates - printf, HAL DAC / timer
+ *        start and DMA stop waits run with the render path enabled
+ */
+static inline __attribute__((always_inline))
+uint32_t cmd_lock(uint32_t *t0)
+{
+    uint32_t lock = audio_lock();
+
+    *t0 = irq_lat_begin();
+    return lock;
+}
+
+/**
+ * @brief Leave a cmd_lock() section
+ */
+static inline __attribute__((always_inline))
+void cmd_unlock(uint32_t lock, uint32_t t0)
+{
+    irq_lat_lock_end(t0);
+    audio_unlock(lock);
+}
+
+/**
+ * @brief Mask the SPI level (CS EXTI / SPI DMA) for a packet state update
+ * @return Previous BASEPRI (pass to spi_unlock)
+ * @note  UART1 link only - a no-op when already at the SPI level
+ */
+static inline __attribute__((always_inline))
+uint32_t spi_lock(void)
+{
+    uint32_t prev = __get_BASEPRI();
+
+    __set_BASEPRI_MAX(IRQ_PRIO_BASEPRI(IRQ_PRIO_SPI));
+    __ISB();
+    return prev;
+}
+
+/**
+ * @brief Leave a spi_lock() section
+ */
+static inline __attribute__((always_inline))
+void spi_unlock(uint32_t prev)
+{
+    __set_BASEPRI(prev);
+}
+
+/**
+ * @brief Command packet statistics (for main loop debugging)
+ */
+static inline __attribute__((always_inline))
+void count_command_packet(const CommandPacket_t *cmd)
+{
+    memcpy((void*)g_last_rx_packet, cmd, 5);
+    g_last_rx_valid = 1;
+    g_error_stats.cmd_packet_count++;
+}
+
+/**
+ * @brief Apply a command packet
+ * @param cmd Command packet
+ * @param rx_time Sample clock at the packet end (CMD_SYNC reference)
+ * @note  SPI level or main loop - channel state changes are made inside
+ *        cmd_lock() sections only
+ */
+static void process_command_packet(CommandPacket_t *cmd, uint32_t rx_time)
 {
     // Validate channel
     if (!IS_VALID_CHANNEL(cmd->channel))
@@ -423,6 +470,8 @@ static void process_command_packet(CommandPacket_t *cmd)
 
     // Decode parameter
     uint16_t param = GET_PARAM(cmd);
+    uint32_t lock;
+    uint32_t lock_t0;
 
     // Process command
     switch (cmd->command)
@@ -431,290 +480,412 @@ static void process_command_packet(CommandPacket_t *cmd)
         case CMD_PLAY:
         /* ------------------------------------------------------------------ */
         {
-            // CRITICAL FIX: Check if DMA is already running and stop it first
-            // This prevents "DMA BUSY" error when receiving multiple PLAY commands
-            DMA_HandleTypeDef *hdma_check = (dac_channel == DAC_CHANNEL_1) ?
-                                             hdac1.DMA_Handle1 : hdac1.DMA_Handle2;
+            use_stream_source(channel);
 
-            if (hdma_check != NULL && channel->is_playing)
+            if (audio_output_is_stereo_locked())
+            {
+                start_stereo_playback(cmd, PLAY_START_NOW, 0);
+            }
+            else
             {
-                // Channel is already playing - stop it first
-                printf("[CMD_PLAY] WARNING: Channel already playing - stopping first\r\n");
+                start_playback(cmd, channel, dac_channel, PLAY_START_NOW, 0);
+            }
+            break;
+        }
 
-                // Stop DMA and DAC properly (avoid HAL_DMA_Abort hang)
-                safe_stop_dac_dma(dac_channel);
+        /* ------------------------------------------------------------------ */
+        case CMD_PLAY_AT:
+        /* ------------------------------------------------------------------ */
+        {
+            // param = Master sample index to start on (after CMD_SYNC)
+            uint32_t start_tick;
 
-                // Force DMA state reset (HAL_DAC_Stop_DMA sometimes fails to clear state)
-                DMA_Channel_TypeDef *dma_ch_stop = (DMA_Channel_TypeDef *)hdma_check->Instance;
+            if (!audio_output_to_local(param, &start_tick))
+            {
+                // Not synced or target already passed - don't start out of phase
+                g_error_stats.schedule_miss_count++;
+#if (SPI_DEBUG_LEVEL >= 1)
+                printf("[CMD] PLAY_AT CH%d: tick %u missed\r\n", cmd->channel, param);
+#endif
+                break;
+            }
 
-                // Disable DMA
-                dma_ch_stop->CCR &= ~DMA_CCR_EN;
+            use_stream_source(channel);
 
-                // Wait for DMA to stop
-                uint32_t timeout = 10000;
-                while ((dma_ch_stop->CCR & DMA_CCR_EN) && timeout--) __NOP();
+            if (audio_output_is_stereo_locked())
+            {
+                start_stereo_playback(cmd, PLAY_START_AT, start_tick);
+            }
+            else
+            {
+                start_playback(cmd, channel, dac_channel, PLAY_START_AT, start_tick);
+            }
+            break;
+        }
 
-                // Clear all DMA flags
-                dma_ch_stop->CFCR = 0x00000FFF;
+        /* ------------------------------------------------------------------ */
+        case CMD_SYNC:
+        /* ------------------------------------------------------------------ */
+        {
+            // param = Master sample index at the end of this packet (CS rising)
+            lock = cmd_lock(&lock_t0);
+            audio_output_sync(param, rx_time);
+            cmd_unlock(lock, lock_t0);
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] SYNC master=%u local=%lu\r\n", param, rx_time);
+#endif
+            break;
+        }
 
-                // Reset handle states
-                hdma_check->State = HAL_DMA_STATE_READY;
-                hdma_check->ErrorCode = HAL_DMA_ERROR_NONE;
-                hdac1.State = HAL_DAC_STATE_READY;
-                hdac1.ErrorCode = HAL_DAC_ERROR_NONE;
+        /* ------------------------------------------------------------------ */
+        case CMD_STOP:
+        /* ------------------------------------------------------------------ */
+        {
+            if (audio_output_is_stereo_locked())
+            {
+                // Stereo lock: both ramps start on the same block and end
+                // together, the last channel to finish stops TIM1
+                lock = cmd_lock(&lock_t0);
+                audio_output_request_stop(DAC_CHANNEL_1, 0);
+                audio_output_request_stop(DAC_CHANNEL_2, 0);
+                cmd_unlock(lock, lock_t0);
+#if (SPI_DEBUG_LEVEL >= 2)
+                printf("[CMD] STOP (stereo)\r\n");
+#endif
+            }
+            else if (channel->is_playing)
+            {
+                // Fade out, DMA and timer stop once the ramp has been output
+                // (is_playing cleared on completion)
+                lock = cmd_lock(&lock_t0);
+                audio_output_request_stop(dac_channel, 0);
+                cmd_unlock(lock, lock_t0);
 
-                channel->is_playing = 0;
+#if (SPI_DEBUG_LEVEL >= 2)
+                printf("[CMD] STOP CH%d\r\n", cmd->channel);
+#endif
+            }
+            break;
+        }
 
-                printf("  DMA stopped and reset - ready for new PLAY command\r\n");
+        /* ------------------------------------------------------------------ */
+        case CMD_VOLUME:
+        /* ------------------------------------------------------------------ */
+        {
+            // Clamp volume to 0-100
+            if (param > 100)
+            {
+                param = 100;
             }
 
-            // Check buffer readiness and swap if ready
-            if (channel->fill_index >= AUDIO_BUFFER_SIZE)
+            // Ramped at render - heard from the next block, not after the
+            // already buffered samples
+            lock = cmd_lock(&lock_t0);
+            audio_channel_set_volume(channel, (uint8_t)param);
+            cmd_unlock(lock, lock_t0);
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] VOLUME=%d CH%d\r\n", param, cmd->channel);
+#endif
+            break;
+        }
+
+        /* ------------------------------------------------------------------ */
+        case CMD_VOLUME_RAMP:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: volume change ramp length in ms (0 = step change)
+            lock = cmd_lock(&lock_t0);
+            audio_channel_set_volume_ramp(channel, param);
+            cmd_unlock(lock, lock_t0);
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] VOLUME_RAMP=%dms CH%d\r\n", param, cmd->channel);
+#endif
+            break;
+        }
+
+        /* ------------------------------------------------------------------ */
+        case CMD_FADE:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: fade-in/out ramp length in ms (0 = hard start/stop)
+            lock = cmd_lock(&lock_t0);
+            audio_channel_set_fade_time(channel, param);
+            cmd_unlock(lock, lock_t0);
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] FADE=%dms CH%d\r\n", param, cmd->channel);
+#endif
+            break;
+        }
+
+        /* ------------------------------------------------------------------ */
+        case CMD_DITHER:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: 0 = truncate, 1 = TPDF, 2/3 = TPDF + 1st/2nd order shaping
+            lock = cmd_lock(&lock_t0);
+            uint8_t invalid = audio_channel_set_dither(channel, (uint8_t)param);
+            cmd_unlock(lock, lock_t0);
+
+            if (invalid)
             {
-                // Fill buffer is ready - swap before playback
-                // This resets fill_index to 0, making RDY=LOW after update
-                if (audio_channel_swap_buffers(channel))
-                {
 #if (SPI_DEBUG_LEVEL >= 1)
-                    printf("[CMD_PLAY] Buffer swapped (fill_index reset to 0)\r\n");
+                printf("[CMD] DITHER: invalid mode %d\r\n", param);
 #endif
-                }
+                break;
             }
-            else if (channel->fill_index == 0)
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] DITHER=%d CH%d\r\n", param, cmd->channel);
+#endif
+            break;
+        }
+
+        /* ------------------------------------------------------------------ */
+        case CMD_CONCEAL:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: 0 = fade to silence, 1 = hold last sample, 2 = repeat
+            lock = cmd_lock(&lock_t0);
+            uint8_t invalid = audio_channel_set_conceal(channel, (uint8_t)param);
+            cmd_unlock(lock, lock_t0);
+
+            if (invalid)
             {
 #if (SPI_DEBUG_LEVEL >= 1)
-                printf("[CMD_PLAY] WARNING: Buffer empty (fill_index=0)\r\n");
-                printf("            Starting with initialized buffer (may produce silence or garbage)\r\n");
+                printf("[CMD] CONCEAL: invalid mode %d\r\n", param);
 #endif
+                break;
             }
-            else
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] CONCEAL=%d CH%d\r\n", param, cmd->channel);
+#endif
+            break;
+        }
+
+        /* ------------------------------------------------------------------ */
+        case CMD_OVERSAMPLE:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: 1, 2 or 4 (both channels, DAC update rate x param)
+            lock = cmd_lock(&lock_t0);
+            HAL_StatusTypeDef status = audio_output_set_oversample((uint8_t)param);
+            cmd_unlock(lock, lock_t0);
+            if (status != HAL_OK)
             {
 #if (SPI_DEBUG_LEVEL >= 1)
-                printf("[CMD_PLAY] WARNING: Buffer partially filled (%d/%d samples)\r\n",
-                       channel->fill_index, AUDIO_BUFFER_SIZE);
-                printf("            Recommend waiting for full buffer to avoid underrun\r\n");
+                printf("[CMD] OVERSAMPLE: %s\r\n",
+                       (status == HAL_BUSY) ? "stop both channels first" : "invalid factor");
 #endif
+                break;
             }
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] OVERSAMPLE=%dx\r\n", param);
+#endif
+            break;
+        }
 
-            // Start playback
-            channel->is_playing = 1;
-            channel->underrun = 0;
-
-            // CRITICAL: Timer will be started AFTER DMA setup to prevent SUSPEND state
-            // Do NOT start timer here - it will be started after HAL_DAC_Start_DMA succeeds
+        /* ------------------------------------------------------------------ */
+        case CMD_TONE:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: [7:0] AUDIO_GEN_xxx waveform (0 = stop, fade out),
+            //        TONE_PARAM_MIX = mix over the playing source
+            if (param & ~(0x00FF | TONE_PARAM_MIX))
+            {
+#if (SPI_DEBUG_LEVEL >= 1)
+                printf("[CMD] TONE: invalid param 0x%04X\r\n", param);
+#endif
+                break;
+            }
 
-            // Check if DMA is configured for this DAC channel
-            DMA_HandleTypeDef *hdma = (dac_channel == DAC_CHANNEL_1) ?
-                                      hdac1.DMA_Handle1 : hdac1.DMA_Handle2;
+            uint8_t wave = (uint8_t)(param & 0xFF);
 
-            if (hdma != NULL)
+            if (wave == AUDIO_GEN_OFF)
             {
-                // DMA configured - use DMA mode
-                // DEBUG: Always show DAC2 start info
-                if (cmd->channel == CHANNEL_DAC2)
+                lock = cmd_lock(&lock_t0);
+                audio_mixer_stop(&channel->mixer, AUDIO_MIX_GEN);
+                if (channel->is_playing && audio_gen_active(&channel->gen))
                 {
-                    printf("[CMD_PLAY] DAC2 Starting - DMA=0x%08lX, Buf=0x%08lX, Size=%d\r\n",
-                           (uint32_t)hdma, (uint32_t)channel->active_buffer, AUDIO_BUFFER_SIZE);
+                    audio_output_request_stop(dac_channel, 0);
                 }
+                cmd_unlock(lock, lock_t0);
+                break;
+            }
+
+            if ((param & TONE_PARAM_MIX) && channel->is_playing)
+            {
+                lock = cmd_lock(&lock_t0);
+                uint8_t full = audio_mixer_add_gen(&channel->mixer, &channel->gen, wave, 100);
+                cmd_unlock(lock, lock_t0);
+
+                if (full)
+                {
 #if (SPI_DEBUG_LEVEL >= 1)
-                else
+                    printf("[CMD] TONE: no free mixer voice\r\n");
+#endif
+                }
+                break;
+            }
+
+            lock = cmd_lock(&lock_t0);
+            uint8_t invalid = audio_gen_start(&channel->gen, wave);
+            if (!invalid)
+            {
+                clip_voice_stop(&channel->clip);
+                if (channel->is_playing)
                 {
-                    printf("[CMD_PLAY] DAC CH%d, DMA=0x%08lX, Buf=0x%08lX, Size=%d\r\n",
-                           cmd->channel, (uint32_t)hdma,
-                           (uint32_t)channel->active_buffer, AUDIO_BUFFER_SIZE);
+                    audio_output_cancel_stop(dac_channel);
                 }
+            }
+            cmd_unlock(lock, lock_t0);
+
+            if (invalid)
+            {
+#if (SPI_DEBUG_LEVEL >= 1)
+                printf("[CMD] TONE: invalid waveform %d\r\n", wave);
 #endif
+                break;
+            }
 
-                // INDEPENDENT DAC MODE - Each channel uses its own DMA and trigger
-                HAL_StatusTypeDef status;
+            // Idle channel: start output now - no data packets needed
+            if (!channel->is_playing)
+            {
+                start_source_playback(cmd, channel, dac_channel);
+            }
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] TONE=%d CH%d\r\n", param, cmd->channel);
+#endif
+            break;
+        }
 
-#if (SPI_DEBUG_LEVEL >= 1)
-                printf("[CMD_PLAY] INDEPENDENT MODE: CH%d using 16-bit buffer directly\r\n", cmd->channel);
+        /* ------------------------------------------------------------------ */
+        case CMD_TONE_FREQ:
+        /* ------------------------------------------------------------------ */
+        {
+            // param: tone frequency in Hz (SINE / SQUARE, applied immediately)
+            lock = cmd_lock(&lock_t0);
+            audio_gen_set_freq(&channel->gen, param);
+            cmd_unlock(lock, lock_t0);
+#if (SPI_DEBUG_LEVEL >= 2)
+            printf("[CMD] TONE_FREQ=%dHz CH%d\r\n", param, cmd->channel);
 #endif
+            break;
+        }
 
-                // Start DAC DMA with HAL (automatically uses DHR12R1 or DHR12R2)
-                status = HAL_DAC_Start_DMA(&hdac1, dac_channel,
-                                           (uint32_t*)channel->active_buffer,
-                                           AUDIO_BUFFER_SIZE,
-                                           DAC_ALIGN_12B_R);
+        /* ------------------------------------------------------------------ */
+        case CMD_CLIP_PLAY:
+        /* ------------------------------------------------------------------ */
+        {
+            uint8_t slot = GET_CLIP_SLOT(cmd);
 
-                if (status == HAL_OK)
-                {
-                    // NOTE: HAL_DAC_Start_DMA with DAC_ALIGN_12B_R correctly sets DHR12R2
-                    // DHR12R2 address: 0x42028414 (offset 0x14 from DAC1 base)
-                    // No manual CDAR fix needed for 12-bit right-aligned mode
-                    if (dac_channel == DAC_CHANNEL_2)
-                    {
-                        uint32_t dhr12r2_addr = (uint32_t)&(DAC1->DHR12R2);
-                        printf("[DEBUG] DAC CH2: DHR12R2 address = 0x%08lX\r\n", dhr12r2_addr);
-                    }
+            // Mix over the playing source (stream keeps running)
+            if (GET_CLIP_MIX(cmd) && channel->is_playing)
+            {
+                lock = cmd_lock(&lock_t0);
+                uint8_t full = audio_mixer_add_clip(&channel->mixer, slot, GET_CLIP_LOOP(cmd), GET_CLIP_GAIN(cmd));
+                cmd_unlock(lock, lock_t0);
 
+                if (full)
+                {
 #if (SPI_DEBUG_LEVEL >= 1)
-                    printf("[CMD_PLAY] INDEPENDENT MODE: DAC DMA started successfully\r\n");
-
-                    // Debug: Check DMA registers
-                    DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
-                    printf("  DMA CCR: 0x%08lX (EN=%d)\r\n", dma_ch->CCR, (dma_ch->CCR & DMA_CCR_EN) ? 1 : 0);
-                    printf("  DMA CSR: 0x%08lX\r\n", dma_ch->CSR);
-                    printf("  DMA CBR1: %lu items\r\n", dma_ch->CBR1 & 0xFFFF);
-                    printf("  DMA CSAR: 0x%08lX\r\n", dma_ch->CSAR);
-                    printf("  DMA CDAR: 0x%08lX\r\n", dma_ch->CDAR);
+                    printf("[CMD] CLIP_PLAY: slot %d not loaded / no free voice\r\n", slot);
 #endif
                 }
+                break;
+            }
 
-                if (status != HAL_OK)
-                {
-                    // Always show error for any channel
-                    printf("[CMD_PLAY] ERROR: HAL_DAC_Start_DMA failed (CH%d): 0x%02X\r\n",
-                           cmd->channel, status);
-                    printf("  DAC State: 0x%02X, ErrorCode: 0x%08lX\r\n",
-                           hdac1.State, hdac1.ErrorCode);
-                    printf("  DMA State: 0x%02X, ErrorCode: 0x%08lX\r\n",
-                           hdma->State, hdma->ErrorCode);
-
-                    // Read DMA registers directly
-                    DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
-                    printf("  DMA CCR: 0x%08lX (EN=%d)\r\n", dma_ch->CCR, (dma_ch->CCR & DMA_CCR_EN) ? 1 : 0);
-                    printf("  DMA CSR: 0x%08lX\r\n", dma_ch->CSR);
-                    printf("  DMA CTR1: 0x%08lX\r\n", dma_ch->CTR1);
-                    printf("  DMA CBR1: 0x%08lX\r\n", dma_ch->CBR1);
-                    printf("  DMA CSAR: 0x%08lX\r\n", dma_ch->CSAR);
-                    printf("  DMA CDAR: 0x%08lX\r\n", dma_ch->CDAR);
-
-                    // Check DAC registers
-                    printf("  DAC CR: 0x%08lX\r\n", DAC1->CR);
-                    printf("  DAC SR: 0x%08lX\r\n", DAC1->SR);
-
-                    // DMA start failed - fall back to simple mode
-                    HAL_DAC_Start(&hdac1, dac_channel);
-                    HAL_DAC_SetValue(&hdac1, dac_channel, DAC_ALIGN_12B_R, 2048);
-                }
-                else
-                {
-                    // DMA started successfully - NOW start the timer
-                    // INDEPENDENT MODE: Each channel uses its own timer
-                    extern TIM_HandleTypeDef htim1;
-                    extern TIM_HandleTypeDef htim7;
-
-                    if (dac_channel == DAC_CHANNEL_1)
-                    {
-                        HAL_TIM_Base_Start(&htim1);  // CH1 uses TIM1
-#if (SPI_DEBUG_LEVEL >= 1)
-                        printf("[CMD_PLAY] Started TIM1 for DAC CH1\r\n");
-#endif
-                    }
-                    else
-                    {
-                        HAL_TIM_Base_Start(&htim7);  // CH2 uses TIM7
-                        printf("[CMD_PLAY] Started TIM7 for DAC CH2\r\n");
-
-                        // DEBUG: Check TIM7 is actually running
-                        uint32_t tim7_cnt_before = TIM7->CNT;
-                        for (volatile uint32_t i = 0; i < 100000; i++) __NOP();
-                        uint32_t tim7_cnt_after = TIM7->CNT;
-
-                        printf("[DEBUG] TIM7 CNT (before): %lu, (after): %lu\r\n", tim7_cnt_before, tim7_cnt_after);
-                        if (tim7_cnt_after != tim7_cnt_before) {
-                            printf("  ✓ TIM7 is running!\r\n");
-                        } else {
-                            printf("  ✗ TIM7 is NOT running!\r\n");
-                        }
-
-                        // DEBUG: Check TIM7 TRGO configuration
-                        uint32_t tim7_cr2 = TIM7->CR2;
-                        uint32_t mms = (tim7_cr2 >> 4) & 0x7;  // MMS bits [6:4]
-                        printf("[DEBUG] TIM7 CR2: 0x%08lX, MMS: %lu (should be 2 for Update event)\r\n",
-                               tim7_cr2, mms);
-
-                        // DEBUG: Check DAC CH2 register bits
-                        uint32_t dac_cr = DAC1->CR;
-                        printf("[DEBUG] DAC CH2 settings:\r\n");
-                        printf("  EN2=%d (bit 16)\r\n", (dac_cr & (1 << 16)) ? 1 : 0);
-                        printf("  TEN2=%d (bit 17)\r\n", (dac_cr & (1 << 17)) ? 1 : 0);
-                        printf("  TSEL2=%lu (bits 21-18, should be 6 for TIM7 TRGO)\r\n", (dac_cr >> 18) & 0xF);
-                        printf("  DMAEN2=%d (bit 28)\r\n", (dac_cr & (1 << 28)) ? 1 : 0);
-
-                        // DEBUG: Check GPDMA2_Channel1 status
-                        DMA_Channel_TypeDef *dma_ch2 = (DMA_Channel_TypeDef *)hdma->Instance;
-                        printf("[DEBUG] GPDMA2_Channel1:\r\n");
-                        printf("  CCR: 0x%08lX (EN=%d)\r\n", dma_ch2->CCR, (dma_ch2->CCR & DMA_CCR_EN) ? 1 : 0);
-                        printf("  CSR: 0x%08lX\r\n", dma_ch2->CSR);
-                        printf("  CBR1: %lu items\r\n", dma_ch2->CBR1 & 0xFFFF);
-                        printf("  CSAR: 0x%08lX (source)\r\n", dma_ch2->CSAR);
-                        printf("  CDAR: 0x%08lX (dest, should be DHR12R2=0x42028414)\r\n", dma_ch2->CDAR);
-                    }
+            lock = cmd_lock(&lock_t0);
+            uint8_t invalid = clip_voice_start(&channel->clip, slot, GET_CLIP_LOOP(cmd), GET_CLIP_GAIN(cmd));
+            if (!invalid)
+            {
+                audio_gen_stop(&channel->gen);
 
-#if (SPI_DEBUG_LEVEL >= 2)
-                    // Debug info for CH1
-                    if (dac_channel == DAC_CHANNEL_1)
-                    {
-                        DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
-                        printf("[CMD_PLAY] CH%d: DMA EN=%d, CBR1=%lu items\r\n",
-                               cmd->channel,
-                               (dma_ch->CCR & DMA_CCR_EN) ? 1 : 0,
-                               dma_ch->CBR1 & 0xFFFF);
-                    }
-#endif
+                // Playing channel: clip takes over from the next rendered block
+                if (channel->is_playing)
+                {
+                    audio_output_cancel_stop(dac_channel);
                 }
             }
-            else
+            cmd_unlock(lock, lock_t0);
+
+            if (invalid)
             {
 #if (SPI_DEBUG_LEVEL >= 1)
-                printf("[CMD_PLAY] No DMA configured - using simple mode\r\n");
+                printf("[CMD] CLIP_PLAY: slot %d not loaded\r\n", slot);
 #endif
-                // No DMA configured - use simple mode (constant value)
-                HAL_DAC_Start(&hdac1, dac_channel);
-                HAL_DAC_SetValue(&hdac1, dac_channel, DAC_ALIGN_12B_R, 2048);
+                break;
             }
 
-            // Update RDY pin after starting playback
-            // If buffer was swapped, fill_index is now 0 → RDY will be LOW (ready for more data)
-            spi_handler_update_rdy();
-
+            // Idle channel: start output now (first blocks pre-rendered by arm)
+            if (!channel->is_playing)
+            {
+                start_source_playback(cmd, channel, dac_channel);
+            }
 #if (SPI_DEBUG_LEVEL >= 2)
-            printf("[CMD] PLAY CH%d\r\n", cmd->channel);
+            printf("[CMD] CLIP_PLAY slot=%d CH%d\r\n", slot, cmd->channel);
 #endif
             break;
         }
 
         /* ------------------------------------------------------------------ */
-        case CMD_STOP:
+        case CMD_CLIP_STOP:
         /* ------------------------------------------------------------------ */
         {
-            if (channel->is_playing)
+            // Mixed clips ramp out, a clip playing as channel source fades the channel
+            lock = cmd_lock(&lock_t0);
+            audio_mixer_stop(&channel->mixer, AUDIO_MIX_CLIP);
+            if (channel->is_playing && clip_voice_active(&channel->clip))
             {
-                channel->is_playing = 0;
-
-                // Stop DAC DMA (avoid HAL_DMA_Abort hang)
-                safe_stop_dac_dma(dac_channel);
+                audio_output_request_stop(dac_channel, 0);
+            }
+            cmd_unlock(lock, lock_t0);
+            break;
+        }
 
-                // Stop TIM1 if both channels stopped (DUAL DAC MODE)
-                if (!g_dac1_channel->is_playing && !g_dac2_channel->is_playing)
-                {
-                    extern TIM_HandleTypeDef htim1;
-                    HAL_TIM_Base_Stop(&htim1);
-                }
+        /* ------------------------------------------------------------------ */
+        case CMD_CLIP_ERASE:
+        /* ------------------------------------------------------------------ */
+        {
+            // Pool regions are reused after erase - no voice may read them
+            lock = cmd_lock(&lock_t0);
+            uint8_t busy = (g_dac1_channel->is_playing && clip_voice_active(&g_dac1_channel->clip)) ||
+                           (g_dac2_channel->is_playing && clip_voice_active(&g_dac2_channel->clip)) ||
+                           audio_mixer_active(&g_dac1_channel->mixer) ||
+                           audio_mixer_active(&g_dac2_channel->mixer);
+            if (!busy)
+            {
+                clip_voice_stop(&g_dac1_channel->clip);
+                clip_voice_stop(&g_dac2_channel->clip);
+                clip_cache_erase();
+            }
+            cmd_unlock(lock, lock_t0);
 
-#if (SPI_DEBUG_LEVEL >= 2)
-                printf("[CMD] STOP CH%d\r\n", cmd->channel);
+            if (busy)
+            {
+#if (SPI_DEBUG_LEVEL >= 1)
+                printf("[CMD] CLIP_ERASE: stop clips first\r\n");
 #endif
             }
             break;
         }
 
         /* ------------------------------------------------------------------ */
-        case CMD_VOLUME:
+        case CMD_STEREO:
         /* ------------------------------------------------------------------ */
         {
-            // Clamp volume to 0-100
-            if (param > 100)
+            // param: 1 = both channels on TIM1 (locked), 0 = independent
+            lock = cmd_lock(&lock_t0);
+            HAL_StatusTypeDef status = audio_output_set_stereo_lock(param ? 1 : 0);
+            cmd_unlock(lock, lock_t0);
+
+            if (status != HAL_OK)
             {
-                param = 100;
+#if (SPI_DEBUG_LEVEL >= 1)
+                printf("[CMD] STEREO: stop both channels first\r\n");
+#endif
+                break;
             }
-
-            channel->volume = (uint8_t)param;
 #if (SPI_DEBUG_LEVEL >= 2)
-            printf("[CMD] VOLUME=%d CH%d\r\n", param, cmd->channel);
+            printf("[CMD] STEREO=%s\r\n", param ? "LOCKED" : "INDEPENDENT");
 #endif
             break;
         }
@@ -723,15 +894,17 @@ static void process_command_packet(CommandPacket_t *cmd)
         case CMD_RESET:
         /* ------------------------------------------------------------------ */
         {
-            // Stop playback
+            lock = cmd_lock(&lock_t0);
             if (channel->is_playing)
             {
-                channel->is_playing = 0;
-                safe_stop_dac_dma(dac_channel);
+                // Fade out first, channel is reset when the stop completes
+                audio_output_request_stop(dac_channel, 1);
             }
-
-            // Reset channel
-            audio_channel_reset(channel);
+            else
+            {
+                audio_channel_reset(channel);
+            }
+            cmd_unlock(lock, lock_t0);
 
 #if (SPI_DEBUG_LEVEL >= 2)
             printf("[CMD] RESET CH%d\r\n", cmd->channel);
@@ -751,19 +924,362 @@ static void process_command_packet(CommandPacket_t *cmd)
     }
 }
 
-static void process_data_packet(DataPacketHeader_t *header, uint16_t *samples)
+/**
+ * @brief Start channel playback (CMD_PLAY / CMD_PLAY_AT)
+ * @param cmd Command packet (for debug output)
+ * @param channel Audio channel
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @param mode Trigger timer start mode
+ * @param start_tick Local TIM2 tick (PLAY_START_AT only)
+ */
+static void start_playback(CommandPacket_t *cmd, AudioChannel_t *channel,
+                           uint32_t dac_channel, PlayStart_t mode, uint32_t start_tick)
 {
-    // Validate channel
-    if (!IS_VALID_CHANNEL(header->channel))
+    // CRITICAL FIX: Check if DMA is already running and stop it first
+    // This prevents "DMA BUSY" error when receiving multiple PLAY commands
+    DMA_HandleTypeDef *hdma_check = (dac_channel == DAC_CHANNEL_1) ?
+                                     hdac1.DMA_Handle1 : hdac1.DMA_Handle2;
+
+    if (hdma_check != NULL && channel->is_playing)
     {
-#if (SPI_DEBUG_LEVEL >= 1)
-        printf("[DATA] ERROR: Invalid channel %d\r\n", header->channel);
-#endif
-        return;
+        // Channel is already playing - stop it first
+        printf("[CMD_PLAY] WARNING: Channel already playing - stopping first\r\n");
+
+        // Stop DMA and DAC properly (avoid HAL_DMA_Abort hang)
+        audio_output_stop(dac_channel);
+
+        // Force DMA state reset (HAL_DAC_Stop_DMA sometimes fails to clear state)
+        DMA_Channel_TypeDef *dma_ch_stop = (DMA_Channel_TypeDef *)hdma_check->Instance;
+
+        // Disable DMA
+        dma_ch_stop->CCR &= ~DMA_CCR_EN;
+
+        // Wait for DMA to stop
+        uint32_t timeout = 10000;
+        while ((dma_ch_stop->CCR & DMA_CCR_EN) && timeout--) __NOP();
+
+        // Clear all DMA flags
+        dma_ch_stop->CFCR = 0x00000FFF;
+
+        // Reset handle states
+        hdma_check->State = HAL_DMA_STATE_READY;
+        hdma_check->ErrorCode = HAL_DMA_ERROR_NONE;
+        hdac1.State = HAL_DAC_STATE_READY;
+        hdac1.ErrorCode = HAL_DAC_ERROR_NONE;
+
+        channel->is_playing = 0;
+
+        printf("  DMA stopped and reset - ready for new PLAY command\r\n");
+    }
+
+    // Check buffer readiness and swap if ready, mark playing
+    // (the DMA stop above ran unlocked - the ring is no longer rendered)
+    uint32_t lock_t0;
+    uint32_t lock = cmd_lock(&lock_t0);
+    uint16_t fill_level = audio_channel_fill_level(channel);
+
+    // Fill buffer is ready - swap before playback
+    // The fill level drops to 0, making RDY=LOW after update
+    uint8_t swapped = (fill_level >= AUDIO_BUFFER_SIZE) && audio_channel_swap_buffers(channel);
+
+    channel->is_playing = 1;
+    channel->underrun = 0;
+    cmd_unlock(lock, lock_t0);
+
+    if (fill_level >= AUDIO_BUFFER_SIZE)
+    {
+        if (swapped)
+        {
+#if (SPI_DEBUG_LEVEL >= 1)
+            printf("[CMD_PLAY] Buffer swapped (fill level reset to 0)\r\n");
+#endif
+        }
+    }
+    else if (fill_level == 0)
+    {
+#if (SPI_DEBUG_LEVEL >= 1)
+        printf("[CMD_PLAY] WARNING: Buffer empty (fill level 0)\r\n");
+        printf("            Starting with initialized buffer (may produce silence or garbage)\r\n");
+#endif
+    }
+    else
+    {
+#if (SPI_DEBUG_LEVEL >= 1)
+        printf("[CMD_PLAY] WARNING: Buffer partially filled (%d/%d samples)\r\n",
+               fill_level, AUDIO_BUFFER_SIZE);
+        printf("            Recommend waiting for full buffer to avoid underrun\r\n");
+#endif
+    }
+
+    // CRITICAL: Timer will be started AFTER DMA setup to prevent SUSPEND state
+    // Do NOT start timer here - it will be started after HAL_DAC_Start_DMA succeeds
+
+    // Check if DMA is configured for this DAC channel
+    DMA_HandleTypeDef *hdma = (dac_channel == DAC_CHANNEL_1) ?
+                              hdac1.DMA_Handle1 : hdac1.DMA_Handle2;
+
+    if (hdma != NULL)
+    {
+        // DMA configured - use DMA mode
+        // DEBUG: Always show DAC2 start info
+        if (cmd->channel == CHANNEL_DAC2)
+        {
+            printf("[CMD_PLAY] DAC2 Starting - DMA=0x%08lX, Buf=0x%08lX, Size=%d\r\n",
+                   (uint32_t)hdma, (uint32_t)audio_channel_active(channel), AUDIO_BUFFER_SIZE);
+        }
+#if (SPI_DEBUG_LEVEL >= 1)
+        else
+        {
+            printf("[CMD_PLAY] DAC CH%d, DMA=0x%08lX, Buf=0x%08lX, Size=%d\r\n",
+                   cmd->channel, (uint32_t)hdma,
+                   (uint32_t)audio_channel_active(channel), AUDIO_BUFFER_SIZE);
+        }
+#endif
+
+        // INDEPENDENT DAC MODE - Each channel uses its own DMA and trigger
+        HAL_StatusTypeDef status;
+
+#if (SPI_DEBUG_LEVEL >= 1)
+        printf("[CMD_PLAY] INDEPENDENT MODE: CH%d using 16-bit buffer directly\r\n", cmd->channel);
+#endif
+
+        // Start DAC DMA (conversion waits for the first trigger)
+        // Unlocked: the pre-render runs before the ring is handed to the
+        // DMA IRQ, which does not render this channel until then
+        status = audio_output_arm(dac_channel, channel);
+
+        if (status == HAL_OK)
+        {
+            // NOTE: HAL_DAC_Start_DMA with DAC_ALIGN_12B_R correctly sets DHR12R2
+            // DHR12R2 address: 0x42028414 (offset 0x14 from DAC1 base)
+            // No manual CDAR fix needed for 12-bit right-aligned mode
+            if (dac_channel == DAC_CHANNEL_2)
+            {
+                uint32_t dhr12r2_addr = (uint32_t)&(DAC1->DHR12R2);
+                printf("[DEBUG] DAC CH2: DHR12R2 address = 0x%08lX\r\n", dhr12r2_addr);
+            }
+
+#if (SPI_DEBUG_LEVEL >= 1)
+            printf("[CMD_PLAY] INDEPENDENT MODE: DAC DMA started successfully\r\n");
+
+            // Debug: Check DMA registers
+            DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
+            printf("  DMA CCR: 0x%08lX (EN=%d)\r\n", dma_ch->CCR, (dma_ch->CCR & DMA_CCR_EN) ? 1 : 0);
+            printf("  DMA CSR: 0x%08lX\r\n", dma_ch->CSR);
+            printf("  DMA CBR1: %lu items\r\n", dma_ch->CBR1 & 0xFFFF);
+            printf("  DMA CSAR: 0x%08lX\r\n", dma_ch->CSAR);
+            printf("  DMA CDAR: 0x%08lX\r\n", dma_ch->CDAR);
+#endif
+        }
+
+        if (status != HAL_OK)
+        {
+            // Always show error for any channel
+            printf("[CMD_PLAY] ERROR: HAL_DAC_Start_DMA failed (CH%d): 0x%02X\r\n",
+                   cmd->channel, status);
+            printf("  DAC State: 0x%02X, ErrorCode: 0x%08lX\r\n",
+                   hdac1.State, hdac1.ErrorCode);
+            printf("  DMA State: 0x%02X, ErrorCode: 0x%08lX\r\n",
+                   hdma->State, hdma->ErrorCode);
+
+            // Read DMA registers directly
+            DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
+            printf("  DMA CCR: 0x%08lX (EN=%d)\r\n", dma_ch->CCR, (dma_ch->CCR & DMA_CCR_EN) ? 1 : 0);
+            printf("  DMA CSR: 0x%08lX\r\n", dma_ch->CSR);
+            printf("  DMA CTR1: 0x%08lX\r\n", dma_ch->CTR1);
+            printf("  DMA CBR1: 0x%08lX\r\n", dma_ch->CBR1);
+            printf("  DMA CSAR: 0x%08lX\r\n", dma_ch->CSAR);
+            printf("  DMA CDAR: 0x%08lX\r\n", dma_ch->CDAR);
+
+            // Check DAC registers
+            printf("  DAC CR: 0x%08lX\r\n", DAC1->CR);
+            printf("  DAC SR: 0x%08lX\r\n", DAC1->SR);
+
+            // DMA start failed - fall back to simple mode
+            HAL_DAC_Start(&hdac1, dac_channel);
+            HAL_DAC_SetValue(&hdac1, dac_channel, DAC_ALIGN_12B_R, 2048);
+        }
+        else
+        {
+            // DMA started successfully - NOW start the timer
+            // INDEPENDENT MODE: Each channel uses its own timer
+            if (mode == PLAY_START_ARM_ONLY)
+            {
+                // Stereo lock: DMA waits for TIM1 started by the other channel
+            }
+            else if (mode == PLAY_START_AT)
+            {
+                // Scheduled start - trigger timer armed on TIM2 tick
+                // (no debug output: printf would delay the arming)
+                audio_output_start_at(dac_channel, start_tick);
+            }
+            else if (dac_channel == DAC_CHANNEL_1)
+            {
+                audio_output_start(dac_channel);  // CH1 uses TIM1
+#if (SPI_DEBUG_LEVEL >= 1)
+                printf("[CMD_PLAY] Started TIM1 for DAC CH1\r\n");
+#endif
+            }
+            else
+            {
+                audio_output_start(dac_channel);  // CH2 uses TIM7
+                printf("[CMD_PLAY] Started TIM7 for DAC CH2\r\n");
+
+                // DEBUG: Check TIM7 is actually running
+                uint32_t tim7_cnt_before = TIM7->CNT;
+                for (volatile uint32_t i = 0; i < 100000; i++) __NOP();
+                uint32_t tim7_cnt_after = TIM7->CNT;
+
+                printf("[DEBUG] TIM7 CNT (before): %lu, (after): %lu\r\n", tim7_cnt_before, tim7_cnt_after);
+                if (tim7_cnt_after != tim7_cnt_before) {
+                    printf("  ✓ TIM7 is running!\r\n");
+                } else {
+                    printf("  ✗ TIM7 is NOT running!\r\n");
+                }
+
+                // DEBUG: Check TIM7 TRGO configuration
+                uint32_t tim7_cr2 = TIM7->CR2;
+                uint32_t mms = (tim7_cr2 >> 4) & 0x7;  // MMS bits [6:4]
+                printf("[DEBUG] TIM7 CR2: 0x%08lX, MMS: %lu (should be 2 for Update event)\r\n",
+                       tim7_cr2, mms);
+
+                // DEBUG: Check DAC CH2 register bits
+                uint32_t dac_cr = DAC1->CR;
+                printf("[DEBUG] DAC CH2 settings:\r\n");
+                printf("  EN2=%d (bit 16)\r\n", (dac_cr & (1 << 16)) ? 1 : 0);
+                printf("  TEN2=%d (bit 17)\r\n", (dac_cr & (1 << 17)) ? 1 : 0);
+                printf("  TSEL2=%lu (bits 21-18, should be 6 for TIM7 TRGO)\r\n", (dac_cr >> 18) & 0xF);
+                printf("  DMAEN2=%d (bit 28)\r\n", (dac_cr & (1 << 28)) ? 1 : 0);
+
+                // DEBUG: Check GPDMA2_Channel1 status
+                DMA_Channel_TypeDef *dma_ch2 = (DMA_Channel_TypeDef *)hdma->Instance;
+                printf("[DEBUG] GPDMA2_Channel1:\r\n");
+                printf("  CCR: 0x%08lX (EN=%d)\r\n", dma_ch2->CCR, (dma_ch2->CCR & DMA_CCR_EN) ? 1 : 0);
+                printf("  CSR: 0x%08lX\r\n", dma_ch2->CSR);
+                printf("  CBR1: %lu items\r\n", dma_ch2->CBR1 & 0xFFFF);
+                printf("  CSAR: 0x%08lX (source)\r\n", dma_ch2->CSAR);
+                printf("  CDAR: 0x%08lX (dest, should be DHR12R2=0x42028414)\r\n", dma_ch2->CDAR);
+            }
+
+#if (SPI_DEBUG_LEVEL >= 2)
+            // Debug info for CH1
+            if (dac_channel == DAC_CHANNEL_1)
+            {
+                DMA_Channel_TypeDef *dma_ch = (DMA_Channel_TypeDef *)hdma->Instance;
+                printf("[CMD_PLAY] CH%d: DMA EN=%d, CBR1=%lu items\r\n",
+                       cmd->channel,
+                       (dma_ch->CCR & DMA_CCR_EN) ? 1 : 0,
+                       dma_ch->CBR1 & 0xFFFF);
+            }
+#endif
+        }
+    }
+    else
+    {
+#if (SPI_DEBUG_LEVEL >= 1)
+        printf("[CMD_PLAY] No DMA configured - using simple mode\r\n");
+#endif
+        // No DMA configured - use simple mode (constant value)
+        HAL_DAC_Start(&hdac1, dac_channel);
+        HAL_DAC_SetValue(&hdac1, dac_channel, DAC_ALIGN_12B_R, 2048);
+    }
+
+    // Update RDY pin after starting playback
+    // If buffer was swapped, the fill level is now 0 → RDY will be LOW (ready for more data)
+    spi_handler_update_rdy();
+
+#if (SPI_DEBUG_LEVEL >= 2)
+    printf("[CMD] PLAY CH%d%s\r\n", cmd->channel, (mode == PLAY_START_AT) ? " (scheduled)" : "");
+#endif
+}
+
+/**
+ * @brief PLAY selects streamed A/B data as render source (tone / clip off)
+ * @param channel Target channel (both channels in stereo lock)
+ */
+static void use_stream_source(AudioChannel_t *channel)
+{
+    uint32_t lock_t0;
+    uint32_t lock = cmd_lock(&lock_t0);
+
+    if (audio_output_is_stereo_locked())
+    {
+        audio_gen_stop(&g_dac1_channel->gen);
+        audio_gen_stop(&g_dac2_channel->gen);
+        clip_voice_stop(&g_dac1_channel->clip);
+        clip_voice_stop(&g_dac2_channel->clip);
+    }
+    else
+    {
+        audio_gen_stop(&channel->gen);
+        clip_voice_stop(&channel->clip);
+    }
+
+    cmd_unlock(lock, lock_t0);
+}
+
+/**
+ * @brief Start an idle channel for a tone / clip source
+ * @param cmd Command packet (for debug output)
+ * @param channel Target channel
+ * @param dac_channel DAC_CHANNEL_1 or DAC_CHANNEL_2
+ * @note  Stereo lock: both channels start together as with CMD_PLAY, the
+ *        other channel keeps its own source
+ */
+static void start_source_playback(CommandPacket_t *cmd, AudioChannel_t *channel, uint32_t dac_channel)
+{
+    if (audio_output_is_stereo_locked())
+    {
+        start_stereo_playback(cmd, PLAY_START_NOW, 0);
+    }
+    else
+    {
+        start_playback(cmd, channel, dac_channel, PLAY_START_NOW, 0);
+    }
+}
+
+/**
+ * @brief Start both channels together (stereo lock)
+ * @param cmd Command packet (for debug output)
+ * @param mode PLAY_START_NOW or PLAY_START_AT
+ * @param start_tick Local TIM2 tick (PLAY_START_AT only)
+ * @note  Both DMAs are armed before the single TIM1 start -> 0 sample offset
+ */
+static void start_stereo_playback(CommandPacket_t *cmd, PlayStart_t mode, uint32_t start_tick)
+{
+    // Restart from a common stop (no channel running alone on TIM1)
+    if (g_dac1_channel->is_playing || g_dac2_channel->is_playing)
+    {
+        uint32_t lock_t0;
+        uint32_t lock = cmd_lock(&lock_t0);
+        g_dac1_channel->is_playing = 0;
+        g_dac2_channel->is_playing = 0;
+        cmd_unlock(lock, lock_t0);
+
+        audio_output_stop_stereo();
+    }
+
+    // CH2 first (arm only), CH1 starts the shared trigger
+    start_playback(cmd, g_dac2_channel, DAC_CHANNEL_2, PLAY_START_ARM_ONLY, 0);
+    start_playback(cmd, g_dac1_channel, DAC_CHANNEL_1, mode, start_tick);
+}
+
+static HOT_PATH void process_data_packet(DataPacketHeader_t *header, const uint8_t *payload)
+{
+    uint8_t ch_id = GET_DATA_CHANNEL(header);
+    uint8_t format = GET_DATA_FORMAT(header);
+
+    // Validate channel
+    if (!IS_VALID_CHANNEL(ch_id))
+    {
+#if (SPI_DEBUG_LEVEL >= 1)
+        printf("[DATA] ERROR: Invalid channel %d\r\n", ch_id);
+#endif
+        return;
     }
 
     // Select target channel
-    AudioChannel_t *channel = (header->channel == CHANNEL_DAC1) ? g_dac1_channel : g_dac2_channel;
+    AudioChannel_t *channel = (ch_id == CHANNEL_DAC1) ? g_dac1_channel : g_dac2_channel;
 
     // Accept data regardless of playing state (for pre-buffering)
     // If not playing, data will be buffered and ready for PLAY command
@@ -776,8 +1292,8 @@ static void process_data_packet(DataPacketHeader_t *header, uint16_t *samples)
     GPIO_PinState rdy_before = HAL_GPIO_ReadPin(OT_nRDY_GPIO_Port, OT_nRDY_Pin);
 #endif
 
-    // Fill channel buffer
-    uint16_t filled = audio_channel_fill(channel, samples, num_samples);
+    // Fill channel buffer (format-specific unpacking kernel)
+    uint16_t filled = audio_channel_fill_packed(channel, format, payload, num_samples);
 
     // Update RDY pin based on buffer status
     spi_handler_update_rdy();
@@ -789,21 +1305,153 @@ static void process_data_packet(DataPacketHeader_t *header, uint16_t *samples)
     {
         data_packet_debug_count++;
         GPIO_PinState rdy_after = HAL_GPIO_ReadPin(OT_nRDY_GPIO_Port, OT_nRDY_Pin);
-        uint16_t free_space = AUDIO_BUFFER_SIZE - channel->fill_index;
+        uint16_t fill_level = audio_channel_fill_level(channel);
+        uint16_t free_space = AUDIO_BUFFER_SIZE - fill_level;
 
-        printf("[DATA #%lu] DAC%d: %d samples\r\n",
-               data_packet_debug_count, header->channel + 1, filled);
+        printf("[DATA #%lu] DAC%d: %d samples (fmt=%d)\r\n",
+               data_packet_debug_count, ch_id + 1, filled, format);
         printf("           RDY: %d → %d (%s)\r\n",
                rdy_before, rdy_after,
                rdy_after == 0 ? "Ready" : "Busy");
-        printf("           Buffer free: %d samples (fill_idx=%d)\r\n",
-               free_space, channel->fill_index);
+        printf("           Buffer free: %d samples (fill=%d)\r\n",
+               free_space, fill_level);
     }
 #else
     (void)filled;  // Suppress unused warning
 #endif
 }
 
+static HOT_PATH void process_adpcm_packet(AdpcmPacketHeader_t *header, uint8_t *data)
+{
+    // Validate channel
+    if (!IS_VALID_CHANNEL(header->channel))
+    {
+#if (SPI_DEBUG_LEVEL >= 1)
+        printf("[ADPCM] ERROR: Invalid channel %d\r\n", header->channel);
+#endif
+        return;
+    }
+
+    // Validate step index (corrupt header would index past the step table)
+    if (header->step_index > ADPCM_STEP_INDEX_MAX)
+    {
+        g_error_stats.invalid_header_count++;
+        return;
+    }
+
+    // Select target channel
+    AudioChannel_t *channel = (header->channel == CHANNEL_DAC1) ? g_dac1_channel : g_dac2_channel;
+
+    // Decoder state comes from the packet header (self-contained packet)
+    AdpcmState_t state;
+    state.predictor = GET_ADPCM_PREDICTOR(header);
+    state.step_index = header->step_index;
+
+    // Decode into channel buffer (pre-buffering allowed, same as 0xDA)
+    audio_channel_fill_adpcm(channel, &state, data, GET_SAMPLE_COUNT(header));
+
+    // Update RDY pin based on buffer status
+    spi_handler_update_rdy();
+}
+
+/**
+ * @brief Apply a parameter packet (output DSP configuration)
+ * @return 0 on success, 1 if channel / param ID / length is invalid
+ */
+static uint8_t process_param_packet(ParamPacketHeader_t *header, const uint8_t *payload)
+{
+    if (!IS_VALID_CHANNEL(header->channel))
+    {
+        return 1;
+    }
+
+    AudioDsp_t *dsp = (header->channel == CHANNEL_DAC1) ? &g_dac1_channel->dsp : &g_dac2_channel->dsp;
+    uint8_t len = header->length;
+
+    // Runs in the CS EXTI IRQ under audio_lock() (see spi_handler_cs_rising)
+    // - no render block sees a half-written set
+    switch (header->param_id)
+    {
+        case PARAM_DSP_ENABLE:
+            if (len < 1)
+            {
+                return 1;
+            }
+            audio_dsp_set_enable(dsp, payload[0]);
+            break;
+
+        case PARAM_DSP_EQ_STAGES:
+            if (len < 1)
+            {
+                return 1;
+            }
+            return audio_dsp_set_eq_stages(dsp, payload[0]);
+
+        case PARAM_DSP_BIQUAD:
+        {
+            if (len < 1 + 5 * 4)
+            {
+                return 1;
+            }
+
+            AudioBiquad_t coef;
+            coef.b0 = GET_LE32(&payload[1]);
+            coef.b1 = GET_LE32(&payload[5]);
+            coef.b2 = GET_LE32(&payload[9]);
+            coef.a1 = GET_LE32(&payload[13]);
+            coef.a2 = GET_LE32(&payload[17]);
+            return audio_dsp_set_biquad(dsp, payload[0], &coef);
+        }
+
+        case PARAM_DSP_LIMITER:
+            if (len < 4)
+            {
+                return 1;
+            }
+            audio_dsp_set_limiter(dsp, GET_LE16(&payload[0]), GET_LE16(&payload[2]));
+            break;
+
+        case PARAM_JITTER:
+        {
+            if (len < 4)
+            {
+                return 1;
+            }
+
+            AudioJitter_t *jit = (header->channel == CHANNEL_DAC1) ? &g_dac1_channel->jitter : &g_dac2_channel->jitter;
+            return audio_jitter_set(jit, GET_LE16(&payload[0]), GET_LE16(&payload[2]));
+        }
+
+        case PARAM_TONE_SWEEP:
+        {
+            if (len < 6)
+            {
+                return 1;
+            }
+
+            AudioGen_t *gen = (header->channel == CHANNEL_DAC1) ? &g_dac1_channel->gen : &g_dac2_channel->gen;
+            audio_gen_set_sweep(gen, GET_LE16(&payload[0]), GET_LE16(&payload[2]), GET_LE16(&payload[4]));
+            break;
+        }
+
+        default:
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Store one clip upload chunk in the clip cache
+ * @return 0 on success, 1 if slot / format / offset is invalid or no space
+ */
+static uint8_t process_clip_packet(ClipPacketHeader_t *header, const uint8_t *payload)
+{
+    return clip_cache_write(header->slot, header->format,
+                            GET_CLIP_TOTAL(header), GET_CLIP_OFFSET(header),
+                            payload, GET_SAMPLE_COUNT(header));
+}
+
 /* ============================================================================ */
 /* Status and Diagnostics */
 /* ============================================================================ */
@@ -843,12 +1491,13 @@ void spi_handler_reset_errors(void)
  * @note Called from EXTI15 interrupt when CS goes LOW (Master starts transmission)
  * @note Starts DMA reception with large buffer for variable-length packets
  */
-void spi_handler_cs_falling(void)
+HOT_PATH void spi_handler_cs_falling(void)
 {
     // CS falling edge = Master has asserted CS = packet transmission starting
 
     // Increment counter (for debugging without printf)
     g_cs_falling_count++;
+    spi_timing_cs_falling();
 
     // Ensure SPI is in READY state before starting new DMA
     // NOTE: HAL_SPI_Abort() can take time and cause DMA start to fail!
@@ -874,9 +1523,9 @@ void spi_handler_cs_falling(void)
     // NSS rising edge will stop DMA and determine actual received bytes
     // NOTE: memset removed - causes race condition with DMA!
     // Old data in buffer doesn't matter, only received bytes are processed
-    // memset(g_rx_large_buffer, 0xFF, sizeof(g_rx_large_buffer));
+    // memset(g_rx_large_buffer, 0xFF, SPI_RX_BUFFER_SIZE);
 
-    HAL_StatusTypeDef status = HAL_SPI_Receive_DMA(g_hspi, g_rx_large_buffer, sizeof(g_rx_large_buffer));
+    HAL_StatusTypeDef status = HAL_SPI_Receive_DMA(g_hspi, g_rx_large_buffer, SPI_RX_BUFFER_SIZE);
     if (status != HAL_OK)
     {
         // DMA start failed - record state for debugging
@@ -886,30 +1535,168 @@ void spi_handler_cs_falling(void)
     }
 }
 
+/**
+ * @brief Parse one received packet and apply it
+ * @param buf Packet bytes (header byte first)
+ * @param received Packet length (>= 4)
+ * @param rx_time Sample clock at the packet end (CMD_SYNC reference)
+ * @note  SPI level: CS rising edge, or the UART1 link inside spi_lock()
+ *        (command packets excluded, see spi_handler_process_packet())
+ */
+static HOT_PATH void dispatch_packet(uint8_t *buf, uint32_t received, uint32_t rx_time)
+{
+    uint8_t header = buf[0];
+
+    // Command Packet (0xC0, 5 bytes)
+    if (header == HEADER_CMD && received >= 5)
+    {
+        CommandPacket_t *cmd = (CommandPacket_t*)buf;
+
+        // Locks only around its channel state updates (cmd_lock)
+        process_command_packet(cmd, rx_time);
+        count_command_packet(cmd);
+    }
+    // Data Packet (0xDA, 4 + N*2 / N*3/2 / N bytes)
+    else if (header == HEADER_DATA)
+    {
+        DataPacketHeader_t *hdr = (DataPacketHeader_t*)buf;
+        uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
+        uint8_t format = GET_DATA_FORMAT(hdr);
+        uint32_t expected_size = 4 + DATA_PAYLOAD_BYTES(format, sample_count);
+
+        if (!IS_VALID_SAMPLE_FORMAT(format))
+        {
+            // Unknown sample format - counted as header error (no printf!)
+            g_error_stats.invalid_header_count++;
+        }
+        // Check if all sample data received
+        else if (received >= expected_size)
+        {
+            process_data_packet(hdr, buf + 4);
+
+            // Update statistics (for main loop debugging)
+            memcpy((void*)g_last_rx_packet, hdr, 4);
+            g_last_rx_valid = 1;
+            g_error_stats.data_packet_count++;
+        }
+        else
+        {
+            // Incomplete packet - increment error counter (no printf!)
+            g_error_stats.spi_error_count++;
+        }
+    }
+    // ADPCM Data Packet (0xDB, 8 + (N+1)/2 bytes)
+    else if (header == HEADER_DATA_ADPCM && received >= sizeof(AdpcmPacketHeader_t))
+    {
+        AdpcmPacketHeader_t *hdr = (AdpcmPacketHeader_t*)buf;
+        uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
+        uint32_t expected_size = sizeof(AdpcmPacketHeader_t) + ADPCM_PAYLOAD_BYTES(sample_count);
+
+        if (IS_VALID_SAMPLE_COUNT(sample_count) && received >= expected_size)
+        {
+            process_adpcm_packet(hdr, buf + sizeof(AdpcmPacketHeader_t));
+
+            // Update statistics (for main loop debugging)
+            memcpy((void*)g_last_rx_packet, hdr, 5);
+            g_last_rx_valid = 1;
+            g_error_stats.data_packet_count++;
+            g_error_stats.adpcm_packet_count++;
+        }
+        else
+        {
+            // Incomplete packet - increment error counter (no printf!)
+            g_error_stats.spi_error_count++;
+        }
+    }
+    // Parameter Packet (0xCB, 4 + len bytes)
+    else if (header == HEADER_PARAM && received >= sizeof(ParamPacketHeader_t))
+    {
+        ParamPacketHeader_t *hdr = (ParamPacketHeader_t*)buf;
+
+        if (hdr->length > PARAM_MAX_PAYLOAD ||
+            received < sizeof(ParamPacketHeader_t) + hdr->length)
+        {
+            // Incomplete packet - increment error counter (no printf!)
+            g_error_stats.spi_error_count++;
+        }
+        else
+        {
+            uint32_t lock = audio_lock();
+            uint32_t lock_t0 = irq_lat_begin();
+            uint8_t result = process_param_packet(hdr, buf + sizeof(ParamPacketHeader_t));
+            irq_lat_lock_end(lock_t0);
+            audio_unlock(lock);
+
+            if (result)
+            {
+                // Unknown parameter / bad value - counted as header error
+                g_error_stats.invalid_header_count++;
+            }
+            else
+            {
+                memcpy((void*)g_last_rx_packet, hdr, 4);
+                g_last_rx_valid = 1;
+                g_error_stats.param_packet_count++;
+            }
+        }
+    }
+    // Clip Upload Packet (0xCC, 10 + N*2 / N*3/2 / N bytes)
+    else if (header == HEADER_CLIP && received >= sizeof(ClipPacketHeader_t))
+    {
+        ClipPacketHeader_t *hdr = (ClipPacketHeader_t*)buf;
+        uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
+        uint32_t expected_size = sizeof(ClipPacketHeader_t) +
+                                 DATA_PAYLOAD_BYTES(hdr->format, sample_count);
+
+        if (!IS_VALID_SAMPLE_COUNT(sample_count) || received < expected_size)
+        {
+            // Incomplete packet - increment error counter (no printf!)
+            g_error_stats.spi_error_count++;
+        }
+        else if (process_clip_packet(hdr, buf + sizeof(ClipPacketHeader_t)))
+        {
+            // Bad slot / format, pool full or chunk out of order
+            g_error_stats.invalid_header_count++;
+        }
+        else
+        {
+            memcpy((void*)g_last_rx_packet, hdr, 5);
+            g_last_rx_valid = 1;
+            g_error_stats.clip_packet_count++;
+        }
+    }
+    else
+    {
+        // Unknown header or invalid size - increment error counter (no printf!)
+        g_error_stats.spi_error_count++;
+    }
+}
+
 /**
  * @brief NSS rising edge handler (transmission end)
  * @note Called from EXTI15 interrupt when NSS goes HIGH (CS deasserted)
  * @note This function stops DMA, checks received bytes, and processes packet
  */
-void spi_handler_cs_rising(void)
+HOT_PATH void spi_handler_cs_rising(void)
 {
     // NSS rising edge = Master has deasserted CS = packet transfer complete
 
+    // Latch sample clock first - packet end is the CMD_SYNC reference point
+    g_rx_timestamp = audio_output_now();
+
     // Increment counter (for debugging without printf)
     g_cs_rising_count++;
 
     // 1. Calculate actual bytes received FIRST (before aborting DMA!)
     // DMA counter counts DOWN from initial value to 0
     // Received bytes = Total size - Remaining counter value
-    uint32_t total_size = sizeof(g_rx_large_buffer);  // 8300 bytes
+    uint32_t total_size = SPI_RX_BUFFER_SIZE;
     uint32_t remaining = __HAL_DMA_GET_COUNTER(g_hspi->hdmarx);
     uint32_t received = total_size - remaining;
 
     // Save for debugging (can be read from main loop)
     g_last_received_bytes = received;
-
-    // NOTE: DCACHE is disabled, so no cache invalidation needed
-    // If data is still wrong, it means buffer is not in non-cacheable RAM!
+    spi_timing_cs_rising(received);
 
     // 2. Stop ongoing DMA transfer and FULLY reset SPI
     if (g_hspi->State != HAL_SPI_STATE_READY)
@@ -929,10 +1716,10 @@ void spi_handler_cs_rising(void)
     // 3. Process packet if valid data received
     if (received >= 4)  // Minimum: 4-byte header
     {
-        // NOTE: g_rx_large_buffer cache handling:
-        // Buffer is in regular (cacheable) RAM to save DMA space.
-        // For STM32H5, DCACHE1 is managed by peripheral - manual invalidation not needed.
-        // This buffer is only used for infrequent command packets, not realtime audio.
+        // DMA has stopped: drop cached (stale) lines of the received range.
+        // The buffer starts on a line and is never written by the CPU
+        // while armed, so whole-line invalidate cannot lose data
+        cache_invalidate(g_rx_large_buffer, received);
 
         uint8_t header = g_rx_large_buffer[0];
 
@@ -947,46 +1734,7 @@ void spi_handler_cs_rising(void)
                    g_rx_large_buffer[6], g_rx_large_buffer[7]);
         }
 
-        // Command Packet (0xC0, 5 bytes)
-        if (header == HEADER_CMD && received >= 5)
-        {
-            CommandPacket_t *cmd = (CommandPacket_t*)g_rx_large_buffer;
-            process_command_packet(cmd);
-
-            // Update statistics (for main loop debugging)
-            memcpy((void*)g_last_rx_packet, cmd, 5);
-            g_last_rx_valid = 1;
-            g_error_stats.cmd_packet_count++;
-        }
-        // Data Packet (0xDA, 4 + N*2 bytes)
-        else if (header == HEADER_DATA)
-        {
-            DataPacketHeader_t *hdr = (DataPacketHeader_t*)g_rx_large_buffer;
-            uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
-            uint16_t expected_size = 4 + (sample_count * 2);
-
-            // Check if all sample data received
-            if (received >= expected_size)
-            {
-                uint16_t *samples = (uint16_t*)(g_rx_large_buffer + 4);
-                process_data_packet(hdr, samples);
-
-                // Update statistics (for main loop debugging)
-                memcpy((void*)g_last_rx_packet, hdr, 4);
-                g_last_rx_valid = 1;
-                g_error_stats.data_packet_count++;
-            }
-            else
-            {
-                // Incomplete packet - increment error counter (no printf!)
-                g_error_stats.spi_error_count++;
-            }
-        }
-        else
-        {
-            // Unknown header or invalid size - increment error counter (no printf!)
-            g_error_stats.spi_error_count++;
-        }
+        dispatch_packet(g_rx_large_buffer, received, g_rx_timestamp);
     }
     else if (received > 0)
     {
@@ -1005,6 +1753,43 @@ void spi_handler_cs_rising(void)
     EXTI->FTSR1 |= (1U << 15);   // Enable falling trigger
 }
 
+/**
+ * @brief Process a packet from another transport (UART1 bench link)
+ * @note  Main loop. Commands run unmasked and lock their channel updates
+ *        (cmd_lock). Sample / parameter / clip packets share the fill side
+ *        and counters with the SPI ISR, so only that update is applied
+ *        inside spi_lock() - no printf on that path
+ */
+void spi_handler_process_packet(uint8_t *buf, uint32_t len)
+{
+    // Frame end is the CMD_SYNC reference, as the CS rising edge on SPI
+    uint32_t rx_time = audio_output_now();
+    uint32_t prev;
+
+    if (len >= 5 && buf[0] == HEADER_CMD)
+    {
+        CommandPacket_t *cmd = (CommandPacket_t*)buf;
+
+        process_command_packet(cmd, rx_time);
+
+        prev = spi_lock();
+        count_command_packet(cmd);
+        spi_unlock(prev);
+        return;
+    }
+
+    prev = spi_lock();
+    if (len >= 4)
+    {
+        dispatch_packet(buf, len, rx_time);
+    }
+    else
+    {
+        g_error_stats.spi_error_count++;
+    }
+    spi_unlock(prev);
+}
+
 /**
  * @brief Get last received packet (for debugging)
  */
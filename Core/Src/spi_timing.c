@@ -0,0 +1,243 @@
+/**
+  ******************************************************************************
+  * @file           : spi_timing.c
+  * @brief          : SPI Transaction Timing Capture Implementation
+  ******************************************************************************
+  */
+
+#include "spi_timing.h"
+#include "hot_path.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+volatile uint32_t g_spi_edge_cycles = 0;
+
+// Two windows - edge handlers write g_win[g_active]
+static SpiTimingWindow_t g_win[2];
+static volatile uint8_t g_active = 0;
+
+static uint32_t g_cycles_per_us = 1;
+
+// Current frame
+static uint8_t g_in_frame = 0;      // CS falling seen, rising pending
+static uint32_t g_fall_cycles = 0;
+static uint32_t g_gap_us = 0;
+static uint8_t g_gap_valid = 0;     // Gap of the current frame measured
+
+// Previous frame end
+static uint8_t g_prev_valid = 0;
+static uint32_t g_prev_rise_cycles = 0;
+static uint32_t g_prev_rise_ms = 0;
+
+/* ============================================================================ */
+/* Private Functions */
+/* ============================================================================ */
+
+/**
+ * @brief Start an empty window
+ */
+static void window_clear(SpiTimingWindow_t *win, uint32_t now_ms)
+{
+    memset(win, 0, sizeof(SpiTimingWindow_t));
+    win->start_ms = now_ms;
+    win->dur_min = UINT32_MAX;
+    win->gap_min = UINT32_MAX;
+}
+
+/**
+ * @brief Log2 bin of a value (0 -> 0, 1 -> 1, 2..3 -> 2, 4..7 -> 3, ...)
+ */
+static inline __attribute__((always_inline))
+uint32_t log2_bin(uint32_t value)
+{
+    uint32_t bin = (value == 0) ? 0 : (32U - (uint32_t)__builtin_clz(value));
+
+    return (bin < SPI_TIMING_BINS) ? bin : (SPI_TIMING_BINS - 1);
+}
+
+/**
+ * @brief Lower edge of a log2 bin
+ */
+static uint32_t log2_bin_low(uint32_t bin)
+{
+    return (bin == 0) ? 0 : (1UL << (bin - 1));
+}
+
+/**
+ * @brief Print the non-empty bins of a log2 histogram ("low+:count")
+ */
+static void print_hist(const char *label, const uint32_t *hist)
+{
+    printf("  %-11s", label);
+
+    for (uint32_t i = 0; i < SPI_TIMING_BINS; i++)
+    {
+        if (hist[i] != 0)
+        {
+            printf(" %lu+:%lu", log2_bin_low(i), hist[i]);
+        }
+    }
+
+    printf("\r\n");
+}
+
+/* ============================================================================ */
+/* Initialization */
+/* ============================================================================ */
+
+void spi_timing_init(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    g_cycles_per_us = SystemCoreClock / 1000000U;
+    if (g_cycles_per_us == 0)
+    {
+        g_cycles_per_us = 1;
+    }
+
+    g_in_frame = 0;
+    g_gap_valid = 0;
+    g_prev_valid = 0;
+
+    window_clear(&g_win[0], now);
+    window_clear(&g_win[1], now);
+    g_active = 0;
+}
+
+/* ============================================================================ */
+/* Edge Recording (EXTI15) */
+/* ============================================================================ */
+
+HOT_PATH void spi_timing_cs_falling(void)
+{
+    uint32_t t = g_spi_edge_cycles;
+
+    g_fall_cycles = t;
+    g_in_frame = 1;
+    g_gap_valid = 0;
+
+    // CYCCNT wraps after ~17 s - older frame ends give no gap
+    if (g_prev_valid && (HAL_GetTick() - g_prev_rise_ms) < 10000U)
+    {
+        SpiTimingWindow_t *win = &g_win[g_active];
+        uint32_t gap_us = (t - g_prev_rise_cycles) / g_cycles_per_us;
+
+        win->gap_hist[log2_bin(gap_us)]++;
+        if (gap_us < win->gap_min)
+        {
+            win->gap_min = gap_us;
+        }
+        if (gap_us > win->gap_max)
+        {
+            win->gap_max = gap_us;
+        }
+
+        g_gap_us = gap_us;
+        g_gap_valid = 1;
+    }
+}
+
+HOT_PATH void spi_timing_cs_rising(uint32_t bytes)
+{
+    uint32_t t = g_spi_edge_cycles;
+
+    g_prev_rise_cycles = t;
+    g_prev_rise_ms = HAL_GetTick();
+    g_prev_valid = 1;
+
+    // Rising without falling (started mid-frame, missed edge)
+    if (!g_in_frame)
+    {
+        return;
+    }
+    g_in_frame = 0;
+
+    SpiTimingWindow_t *win = &g_win[g_active];
+    uint32_t dur_cycles = t - g_fall_cycles;
+    uint32_t dur_us = dur_cycles / g_cycles_per_us;
+
+    win->packets++;
+    win->bytes += bytes;
+    win->busy_cycles += dur_cycles;
+
+    win->dur_hist[log2_bin(dur_us)]++;
+    if (dur_us < win->dur_min)
+    {
+        win->dur_min = dur_us;
+    }
+    if (dur_us > win->dur_max)
+    {
+        win->dur_max = dur_us;
+    }
+
+    // bytes / ms = kB/s (sub-us frames count as 1 us)
+    win->rate_hist[log2_bin((bytes * 1000U) / ((dur_us != 0) ? dur_us : 1U))]++;
+
+    if (g_gap_valid && (dur_us + g_gap_us) != 0)
+    {
+        uint32_t duty = (dur_us * SPI_TIMING_DUTY_BINS) / (dur_us + g_gap_us);
+
+        win->duty_hist[(duty < SPI_TIMING_DUTY_BINS) ? duty : (SPI_TIMING_DUTY_BINS - 1)]++;
+    }
+}
+
+/* ============================================================================ */
+/* Windows / Report (main loop) */
+/* ============================================================================ */
+
+void spi_timing_roll(SpiTimingWindow_t *out)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t done = g_active;
+
+    // Edge handlers preempt the main loop only - the spare window is idle
+    window_clear(&g_win[done ^ 1U], now);
+    g_active = done ^ 1U;
+
+    memcpy(out, &g_win[done], sizeof(SpiTimingWindow_t));
+    out->length_ms = now - out->start_ms;
+}
+
+void spi_timing_report(const SpiTimingWindow_t *win)
+{
+    uint32_t cycles_per_ms = g_cycles_per_us * 1000U;
+
+    if (win->packets == 0 || win->length_ms == 0)
+    {
+        printf("SPI timing: no packets in %lu ms\r\n", win->length_ms);
+        return;
+    }
+
+    // Duty over the whole window (per mille) and data rates
+    uint32_t util = (uint32_t)((win->busy_cycles * 1000U) / ((uint64_t)win->length_ms * cycles_per_ms));
+    uint32_t avg_bps = (uint32_t)(((uint64_t)win->bytes * 1000U) / win->length_ms);
+    uint32_t cs_bps = (win->busy_cycles != 0)
+                      ? (uint32_t)(((uint64_t)win->bytes * cycles_per_ms * 1000U) / win->busy_cycles) : 0;
+
+    printf("SPI timing (%lu ms): %lu packets | %lu bytes | %lu B/s | CS low %lu.%lu %%\r\n",
+           win->length_ms, win->packets, win->bytes, avg_bps, util / 10, util % 10);
+    printf("  Rate while CS low: %lu B/s | packet %lu..%lu us | gap %lu..%lu us\r\n",
+           cs_bps, win->dur_min, win->dur_max,
+           (win->gap_max != 0) ? win->gap_min : 0, win->gap_max);
+
+    print_hist("Packet us:", win->dur_hist);
+    print_hist("Gap us:", win->gap_hist);
+    print_hist("Rate kB/s:", win->rate_hist);
+
+    printf("  %-11s", "Duty %:");
+    for (uint32_t i = 0; i < SPI_TIMING_DUTY_BINS; i++)
+    {
+        if (win->duty_hist[i] != 0)
+        {
+            printf(" %lu+:%lu", i * (100U / SPI_TIMING_DUTY_BINS), win->duty_hist[i]);
+        }
+    }
+    printf("\r\n");
+}
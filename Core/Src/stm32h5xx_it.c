@@ -26,7 +26,12 @@
 #include <string.h>
 #include "spi_handler.h"
 #include "audio_channel.h"
+#include "audio_output.h"
 #include "user_com.h"
+#include "hot_path.h"
+#include "irq_prio.h"
+#include "spi_timing.h"
+#include "uart_link.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -46,12 +51,6 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
-extern Queue rx_UART1_queue;
-extern struct uart_Stat_ST uart1_stat_ST;
-
-extern Queue rx_UART3_queue;
-extern struct uart_Stat_ST uart3_stat_ST;
-
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -245,20 +244,8 @@ void SysTick_Handler(void)
 void EXTI15_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI15_IRQn 0 */
-
-  // STM32H5: EXTI pending flag manual handling
-  uint32_t falling_pending = EXTI->FPR1 & (1U << 15);
-  uint32_t rising_pending = EXTI->RPR1 & (1U << 15);
-
-  // Clear ALL pending flags FIRST
-  if (falling_pending) EXTI->FPR1 = (1U << 15);
-  if (rising_pending) EXTI->RPR1 = (1U << 15);
-
-  // Only call callback if there was actually a pending flag
-  if (falling_pending || rising_pending)
-  {
-      HAL_GPIO_EXTI_Callback(SPI1_ECTI_NSS_Pin);
-  }
+  // Vector entry stays in flash (generated code), the work runs from SRAM
+  exti15_cs_irq();
   return; // Skip HAL_GPIO_EXTI_IRQHandler()
 
   /* USER CODE END EXTI15_IRQn 0 */
@@ -400,17 +387,7 @@ void USART1_IRQHandler(void)
 void USART3_IRQHandler(void)
 {
   /* USER CODE BEGIN USART3_IRQn 0 */
-	if (huart3.Instance->ISR & UART_FLAG_IDLE)
-  {
-		__HAL_UART_CLEAR_IDLEFLAG(&huart3);
-    uart3_stat_ST.dma_rx_len = DMA_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(&handle_GPDMA1_Channel0);
-		HAL_UART_AbortReceive(&huart3);
-    Enqueue_bytes(&rx_UART3_queue,uart3_stat_ST.uart_rx_DMA_buf,uart3_stat_ST.dma_rx_len);
-    uart3_stat_ST.f_uart_rcvd = 1;
-    memset(uart3_stat_ST.uart_rx_DMA_buf,0,DMA_RX_BUFFER_SIZE);
-	  HAL_UART_Receive_DMA(&huart3,uart3_stat_ST.uart_rx_DMA_buf,DMA_RX_BUFFER_SIZE);
-	}
-
+  // Idle line is handled by HAL (circular ReceiveToIdle) -> HAL_UARTEx_RxEventCallback
   /* USER CODE END USART3_IRQn 0 */
   HAL_UART_IRQHandler(&huart3);
   /* USER CODE BEGIN USART3_IRQn 1 */
@@ -448,6 +425,16 @@ void GPDMA2_Channel1_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles TIM2 global interrupt.
+  * @note  TIM2 is the shared sample clock (not configured in CubeMX),
+  *        CC1/CC2 = scheduled DAC start (see audio_output.c)
+  */
+void TIM2_IRQHandler(void)
+{
+    audio_output_tim_irq();
+}
+
 /* ============================================================================ */
 /* HAL Callback Functions */
 /* ============================================================================ */
@@ -465,6 +452,40 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
     }
 }
 
+/**
+  * @brief UART RX Event Callback (ReceiveToIdle)
+  * @note  Idle line, DMA half and full events of the circular RX ring;
+  *        Size = DMA position in the ring
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    if (huart->Instance == USART3)
+    {
+        UART3_RX_Event(Size);
+    }
+    else if (huart->Instance == USART1)
+    {
+        uart_link_rx_event(Size);
+    }
+}
+
+/**
+  * @brief UART Error Callback
+  * @note  Overrun stops DMA reception (HAL) - restart the RX ring.
+  *        Noise / framing errors keep reception running
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART3 && huart->RxState == HAL_UART_STATE_READY)
+    {
+        UART3_RX_Start();
+    }
+    else if (huart->Instance == USART1)
+    {
+        uart_link_rx_error();
+    }
+}
+
 // External audio channels (defined in user_def.c or slave_main.c)
 extern AudioChannel_t g_dac1_channel;
 extern AudioChannel_t g_dac2_channel;
@@ -495,100 +516,82 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
 
 /**
   * @brief DAC CH1 DMA Half Transfer Complete Callback
-  * @note Called when first half of buffer (0~1023) has been output
+  * @note Called when first half of the output ring has been output
+  *       Next block is rendered into it (buffer swap happens in render)
   */
-void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef *hdac)
+HOT_PATH void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef *hdac)
 {
-    // First half (0~1023) of active buffer has been output
-    // Could update first half here if needed (not used in circular buffer mode)
+    uint32_t t0 = irq_lat_begin();
+    uint32_t entry = irq_lat_dac_entry(DAC_CHANNEL_1);
 
     // DEBUG: Count half-complete events
     g_dac1_half_cplt_count++;
+
+    if (audio_output_dma_event(DAC_CHANNEL_1, 0))
+    {
+        // Fill buffer handed back / depth below jitter target - RDY may change
+        spi_handler_update_rdy();
+    }
+
+    irq_lat_end(IRQ_LAT_DAC1, t0, entry);
 }
 
 /**
   * @brief DAC CH1 DMA Transfer Complete Callback
-  * @note Called when second half of buffer (1024~2047) has been output
-  *       This is the time to swap buffers
+  * @note Called when second half of the output ring has been output
   */
-void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef *hdac)
+HOT_PATH void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef *hdac)
 {
+    uint32_t t0 = irq_lat_begin();
+    uint32_t entry = irq_lat_dac_entry(DAC_CHANNEL_1);
+
     // DEBUG: Count complete events
     g_dac1_cplt_count++;
 
-    // Second half (1024~2047) of active buffer has been output
-    // Now we need to swap buffers if fill buffer is ready
-
-    if (g_dac1_channel.fill_index >= AUDIO_BUFFER_SIZE)
+    if (audio_output_dma_event(DAC_CHANNEL_1, 1))
     {
-        // Fill buffer is ready - swap buffers
-        if (audio_channel_swap_buffers(&g_dac1_channel))
-        {
-            // Swap successful - clear underrun flag
-            audio_channel_clear_underrun(&g_dac1_channel);
-
-            // Update DMA to use new active buffer
-            // Note: In circular mode, we need to restart DAC DMA with new buffer
-            HAL_DAC_Stop_DMA(hdac, DAC_CHANNEL_1);
-            HAL_DAC_Start_DMA(hdac, DAC_CHANNEL_1,
-                            (uint32_t*)g_dac1_channel.active_buffer,
-                            AUDIO_BUFFER_SIZE,  // Number of samples (source items)
-                            DAC_ALIGN_12B_R);
-
-            // Update RDY pin (fill_index reset to 0, now ready for more data)
-            spi_handler_update_rdy();
-        }
-    }
-    else
-    {
-        // Buffer underrun - fill buffer not ready
-        g_dac1_channel.underrun = 1;
-        g_dac1_channel.underrun_count++;
+        spi_handler_update_rdy();
     }
+
+    irq_lat_end(IRQ_LAT_DAC1, t0, entry);
 }
 
 /**
   * @brief DAC CH2 DMA Half Transfer Complete Callback
   */
-void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef *hdac)
+HOT_PATH void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef *hdac)
 {
-    // First half of CH2 buffer output
+    uint32_t t0 = irq_lat_begin();
+    uint32_t entry = irq_lat_dac_entry(DAC_CHANNEL_2);
+
+    // First half of CH2 output ring done
     g_dac2_half_cplt_count++;
+
+    if (audio_output_dma_event(DAC_CHANNEL_2, 0))
+    {
+        spi_handler_update_rdy();
+    }
+
+    irq_lat_end(IRQ_LAT_DAC2, t0, entry);
 }
 
 /**
   * @brief DAC CH2 DMA Transfer Complete Callback
   */
-void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef *hdac)
+HOT_PATH void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef *hdac)
 {
-    // Second half of CH2 buffer output - swap buffers
+    uint32_t t0 = irq_lat_begin();
+    uint32_t entry = irq_lat_dac_entry(DAC_CHANNEL_2);
+
+    // Second half of CH2 output ring done
     g_dac2_cplt_count++;
 
-    if (g_dac2_channel.fill_index >= AUDIO_BUFFER_SIZE)
+    if (audio_output_dma_event(DAC_CHANNEL_2, 1))
     {
-        // Fill buffer is ready - swap buffers
-        if (audio_channel_swap_buffers(&g_dac2_channel))
-        {
-            // Swap successful
-            audio_channel_clear_underrun(&g_dac2_channel);
-
-            // Restart DAC DMA with new buffer
-            HAL_DAC_Stop_DMA(hdac, DAC_CHANNEL_2);
-            HAL_DAC_Start_DMA(hdac, DAC_CHANNEL_2,
-                            (uint32_t*)g_dac2_channel.active_buffer,
-                            AUDIO_BUFFER_SIZE,  // Number of samples (source items)
-                            DAC_ALIGN_12B_R);
-
-            // Update RDY pin (fill_index reset to 0, now ready for more data)
-            spi_handler_update_rdy();
-        }
-    }
-    else
-    {
-        // Buffer underrun
-        g_dac2_channel.underrun = 1;
-        g_dac2_channel.underrun_count++;
+        spi_handler_update_rdy();
     }
+
+    irq_lat_end(IRQ_LAT_DAC2, t0, entry);
 }
 
 /**
@@ -616,13 +619,40 @@ void HAL_DACEx_ErrorCallbackCh2(DAC_HandleTypeDef *hdac)
     g_dac2_channel.underrun = 1;
 }
 
+/**
+  * @brief CS (PA15) EXTI work, called from EXTI15_IRQHandler
+  * @note Runs from SRAM - the generated handler is only the vector entry
+  */
+HOT_PATH void exti15_cs_irq(void)
+{
+    spi_timing_stamp();                       // CS edge time (before any work)
+    uint32_t t0 = irq_lat_begin();
+    uint32_t entry = irq_lat_probe_taken();   // Software probe (irq_prio.c)
+
+    // STM32H5: EXTI pending flag manual handling
+    uint32_t falling_pending = EXTI->FPR1 & (1U << 15);
+    uint32_t rising_pending = EXTI->RPR1 & (1U << 15);
+
+    // Clear ALL pending flags FIRST
+    if (falling_pending) EXTI->FPR1 = (1U << 15);
+    if (rising_pending) EXTI->RPR1 = (1U << 15);
+
+    // Only call callback if there was actually a pending flag
+    if (falling_pending || rising_pending)
+    {
+        HAL_GPIO_EXTI_Callback(SPI1_ECTI_NSS_Pin);
+    }
+
+    irq_lat_end(IRQ_LAT_CS, t0, entry);
+}
+
 /**
   * @brief GPIO EXTI Callback
   * @note PA15 (CS) edge detection for variable-length packet reception
   *       Falling edge: Start DMA reception
   *       Rising edge: Stop DMA and process received data
   */
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+HOT_PATH void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
     if (GPIO_Pin == GPIO_PIN_15)
     {
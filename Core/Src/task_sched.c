@@ -0,0 +1,245 @@
+/**
+  ******************************************************************************
+  * @file           : task_sched.c
+  * @brief          : Cooperative Main Loop Scheduler Implementation
+  ******************************************************************************
+  */
+
+#include "task_sched.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================ */
+/* Private Types */
+/* ============================================================================ */
+
+typedef struct {
+    const char *name;
+    SchedTaskFn_t fn;
+    uint32_t period_ms;
+    uint32_t next_ms;           // Next due tick (timer tasks)
+    volatile uint32_t events;   // Pending flags (sched_signal, ISR)
+    uint8_t enabled;
+    uint32_t runs;
+    uint32_t max_cycles;
+    uint32_t late_max_ms;
+} SchedTaskEntry_t;
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+static SchedTaskEntry_t g_tasks[SCHED_MAX_TASKS];
+static uint32_t g_task_count = 0;
+
+// Passes since the last report
+static uint32_t g_passes = 0;
+static uint32_t g_report_tick = 0;
+
+/* ============================================================================ */
+/* Private Functions */
+/* ============================================================================ */
+
+static SchedTaskEntry_t *sched_entry(SchedTask_t task)
+{
+    if (task < 0 || (uint32_t)task >= g_task_count)
+    {
+        return NULL;
+    }
+    return &g_tasks[task];
+}
+
+/**
+ * @brief Take and clear the pending flags (ISRs may set more meanwhile)
+ */
+static uint32_t sched_take_events(SchedTaskEntry_t *t)
+{
+    uint32_t events;
+
+    do
+    {
+        events = __LDREXW(&t->events);
+    } while (__STREXW(0, &t->events) != 0U);
+
+    return events;
+}
+
+/* ============================================================================ */
+/* Public Functions */
+/* ============================================================================ */
+
+void sched_init(void)
+{
+    memset(g_tasks, 0, sizeof(g_tasks));
+    g_task_count = 0;
+    g_passes = 0;
+    g_report_tick = HAL_GetTick();
+
+    // Task run times (also used by spi_timing / irq_lat / benchmark)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+SchedTask_t sched_add(const char *name, SchedTaskFn_t fn, uint32_t period_ms)
+{
+    if (g_task_count >= SCHED_MAX_TASKS || fn == NULL)
+    {
+        printf("[SCHED] Cannot add task '%s'\r\n", (name != NULL) ? name : "");
+        return -1;
+    }
+
+    SchedTaskEntry_t *t = &g_tasks[g_task_count];
+
+    t->name = name;
+    t->fn = fn;
+    t->period_ms = period_ms;
+    t->next_ms = HAL_GetTick() + period_ms;
+    t->events = 0;
+    t->enabled = 1;
+
+    return (SchedTask_t)g_task_count++;
+}
+
+void sched_enable(SchedTask_t task, uint8_t enable)
+{
+    SchedTaskEntry_t *t = sched_entry(task);
+
+    if (t == NULL)
+    {
+        return;
+    }
+
+    if (enable && !t->enabled)
+    {
+        t->next_ms = HAL_GetTick() + t->period_ms;
+    }
+    t->enabled = enable ? 1 : 0;
+}
+
+void sched_set_period(SchedTask_t task, uint32_t period_ms)
+{
+    SchedTaskEntry_t *t = sched_entry(task);
+
+    if (t != NULL)
+    {
+        t->period_ms = period_ms;
+        t->next_ms = HAL_GetTick() + period_ms;
+    }
+}
+
+void sched_signal(SchedTask_t task, uint32_t events)
+{
+    SchedTaskEntry_t *t = sched_entry(task);
+
+    if (t == NULL)
+    {
+        return;
+    }
+
+    // Atomic OR: main loop and ISRs may signal the same task
+    do
+    {
+        uint32_t v = __LDREXW(&t->events);
+        if (__STREXW(v | events, &t->events) == 0U)
+        {
+            break;
+        }
+    } while (1);
+}
+
+void sched_run(void)
+{
+    g_passes++;
+
+    for (uint32_t i = 0; i < g_task_count; i++)
+    {
+        SchedTaskEntry_t *t = &g_tasks[i];
+
+        if (!t->enabled)
+        {
+            continue;
+        }
+
+        uint32_t now = HAL_GetTick();
+        uint32_t events = (t->events != 0U) ? sched_take_events(t) : 0U;
+        uint8_t due = (t->period_ms == 0U);
+
+        if (t->period_ms != 0U && (int32_t)(now - t->next_ms) >= 0)
+        {
+            uint32_t late = now - t->next_ms;
+
+            if (late > t->late_max_ms)
+            {
+                t->late_max_ms = late;
+            }
+
+            // Keep the phase; after a stall, skip the missed periods
+            t->next_ms += t->period_ms;
+            if ((int32_t)(now - t->next_ms) >= 0)
+            {
+                t->next_ms = now + t->period_ms;
+            }
+            due = 1;
+        }
+
+        if (!due && events == 0U)
+        {
+            continue;
+        }
+
+        uint32_t t0 = DWT->CYCCNT;
+        t->fn(events);
+        uint32_t cycles = DWT->CYCCNT - t0;
+
+        t->runs++;
+        if (cycles > t->max_cycles)
+        {
+            t->max_cycles = cycles;
+        }
+    }
+}
+
+uint8_t sched_get_stats(SchedTask_t task, SchedTaskStats_t *stats)
+{
+    SchedTaskEntry_t *t = sched_entry(task);
+
+    if (t == NULL)
+    {
+        return 1;
+    }
+
+    stats->name = t->name;
+    stats->period_ms = t->period_ms;
+    stats->enabled = t->enabled;
+    stats->runs = t->runs;
+    stats->max_cycles = t->max_cycles;
+    stats->late_max_ms = t->late_max_ms;
+    return 0;
+}
+
+void sched_report(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t elapsed = now - g_report_tick;
+    uint32_t cyc_per_us = SystemCoreClock / 1000000U;
+
+    printf("[SCHED] %lu passes/s\r\n",
+           (elapsed != 0U) ? (uint32_t)(((uint64_t)g_passes * 1000U) / elapsed) : 0U);
+    printf("  %-10s %8s %4s %10s %10s %8s\r\n", "task", "period", "on", "runs", "max us", "late ms");
+
+    for (uint32_t i = 0; i < g_task_count; i++)
+    {
+        SchedTaskEntry_t *t = &g_tasks[i];
+
+        printf("  %-10s %6lu ms %4s %10lu %10lu %8lu\r\n",
+               t->name, t->period_ms, t->enabled ? "yes" : "no",
+               t->runs, t->max_cycles / cyc_per_us, t->late_max_ms);
+
+        // Maxima per report window
+        t->max_cycles = 0;
+        t->late_max_ms = 0;
+    }
+
+    g_passes = 0;
+    g_report_tick = now;
+}
@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file           : telemetry.c
+  * @brief          : Binary Telemetry Frames Implementation
+  ******************************************************************************
+  */
+
+#include "telemetry.h"
+#include "spi_handler.h"
+#include "ring_buffer.h"
+#include "cobs.h"
+
+/* ============================================================================ */
+/* External UART3 TX path (user_com.c) */
+/* ============================================================================ */
+
+extern UART_HandleTypeDef huart3;
+extern Queue tx_UART3_queue;
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+static AudioChannel_t *g_channels[2] = { NULL, NULL };
+
+static uint8_t g_rate_hz = 0;
+static uint32_t g_period_ms = 0;
+static uint32_t g_last_tick = 0;
+
+static uint8_t g_seq = 0;
+static uint32_t g_dropped = 0;
+
+// Frame staging (main loop only)
+static TelemetryFrame_t g_frame;
+static uint8_t g_wire[COBS_MAX_FRAME(sizeof(TelemetryFrame_t))];
+
+/* ============================================================================ */
+/* Private Functions */
+/* ============================================================================ */
+
+static inline uint16_t sat16(uint32_t v)
+{
+    return (v > 0xFFFF) ? 0xFFFF : (uint16_t)v;
+}
+
+/**
+ * @brief Snapshot one channel
+ */
+static void capture_channel(TelemetryChannel_t *out, AudioChannel_t *ch)
+{
+    uint32_t samples, swaps, underruns, concealed, longest;
+
+    out->state = (ch->is_playing ? TELEM_CH_PLAYING : 0)
+               | ((ch->play_seq & 1U) ? TELEM_CH_ACTIVE_B : 0)
+               | ((audio_gen_active(&ch->gen) || clip_voice_active(&ch->clip)) ? TELEM_CH_LOCAL_SRC : 0)
+               | (ch->conceal.active ? TELEM_CH_CONCEAL : 0);
+    out->depth = audio_channel_depth(ch);
+
+    // Packed fields - read into locals
+    audio_channel_get_stats(ch, &samples, &swaps, &underruns);
+    audio_channel_get_underrun(ch, &concealed, &longest);
+
+    out->samples = samples;
+    out->swaps = swaps;
+    out->underruns = underruns;
+    out->underrun_samples = concealed;
+    out->underrun_max = sat16(longest);
+}
+
+/**
+ * @brief Snapshot SPI counters
+ */
+static void capture_spi(TelemetrySpi_t *out)
+{
+    SPI_ErrorStats_t s;
+
+    spi_handler_get_errors(&s);
+
+    out->cs_falling = s.cs_falling_count;
+    out->cs_rising = s.cs_rising_count;
+    out->cmd_packets = s.cmd_packet_count;
+    out->data_packets = s.data_packet_count;
+    out->spi_errors = s.spi_error_count;
+    out->adpcm_packets = (uint16_t)s.adpcm_packet_count;
+    out->param_packets = (uint16_t)s.param_packet_count;
+    out->clip_packets = (uint16_t)s.clip_packet_count;
+    out->invalid_headers = (uint16_t)s.invalid_header_count;
+    out->overflows = (uint16_t)s.overflow_count;
+    out->dma_start_fails = (uint16_t)s.dma_start_fail_count;
+    out->schedule_misses = (uint16_t)s.schedule_miss_count;
+    out->last_rx_bytes = sat16(s.last_received_bytes);
+}
+
+/* ============================================================================ */
+/* Public Functions */
+/* ============================================================================ */
+
+void telemetry_init(AudioChannel_t *dac1_ch, AudioChannel_t *dac2_ch)
+{
+    g_channels[0] = dac1_ch;
+    g_channels[1] = dac2_ch;
+
+    g_rate_hz = 0;
+    g_period_ms = 0;
+    g_seq = 0;
+    g_dropped = 0;
+}
+
+uint8_t telemetry_set_rate(uint8_t hz)
+{
+    // Frames must fit the console line (10 bits per byte, 10 % spare for text)
+    uint32_t max_hz = ((huart3.Init.BaudRate / 10U) * 9U / 10U) / sizeof(g_wire);
+
+    if (hz > TELEMETRY_MAX_HZ || hz > max_hz)
+    {
+        return 1;
+    }
+
+    g_rate_hz = hz;
+    g_period_ms = (hz != 0) ? (1000U / hz) : 0;
+    g_last_tick = HAL_GetTick();
+
+    return 0;
+}
+
+uint8_t telemetry_get_rate(void)
+{
+    return g_rate_hz;
+}
+
+uint8_t telemetry_poll(uint32_t now)
+{
+    if (g_rate_hz == 0 || g_channels[0] == NULL || (now - g_last_tick) < g_period_ms)
+    {
+        return 0;
+    }
+
+    // Fixed cadence; resync after a stall instead of bursting
+    g_last_tick += g_period_ms;
+    if ((now - g_last_tick) >= g_period_ms)
+    {
+        g_last_tick = now;
+    }
+
+    g_frame.version = TELEMETRY_VERSION;
+    g_frame.seq = g_seq++;
+    g_frame.tick_ms = now;
+    capture_channel(&g_frame.ch[0], g_channels[0]);
+    capture_channel(&g_frame.ch[1], g_channels[1]);
+    capture_spi(&g_frame.spi);
+
+    uint32_t len = cobs_frame_build((const uint8_t *)&g_frame, sizeof(g_frame), g_wire);
+
+    // Whole frame or nothing - Enqueue() overwrites the oldest byte when full
+    if (len > (uint32_t)(tx_UART3_queue.buf_size - 1U - Len_queue(&tx_UART3_queue)))
+    {
+        g_dropped++;
+        return 0;
+    }
+
+    Enqueue_bytes(&tx_UART3_queue, g_wire, len);
+
+    return 1;
+}
+
+uint32_t telemetry_get_dropped(void)
+{
+    return g_dropped;
+}
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file           : uart_link.c
+  * @brief          : UART1 Binary Packet Link Implementation
+  ******************************************************************************
+  */
+
+#include "uart_link.h"
+#include "spi_handler.h"
+#include "dma_arena.h"
+#include "cobs.h"
+#include <stdio.h>
+
+/* ============================================================================ */
+/* External Handles (from main.c) */
+/* ============================================================================ */
+
+extern UART_HandleTypeDef huart1;
+
+/* ============================================================================ */
+/* Private Variables */
+/* ============================================================================ */
+
+// Positions are absolute byte counts, ring index = count & (size - 1)
+#define UART_LINK_RING_MASK     (UART_LINK_RING_SIZE - 1U)
+
+// DMA RX ring - non-cacheable DMA arena, allocated in uart_link_init()
+static uint8_t *g_ring = NULL;
+
+static volatile uint32_t g_rx_total = 0;    // Bytes written by DMA (ISR)
+static volatile uint32_t g_rx_floor = 0;    // First valid byte after a restart (ISR)
+static uint16_t g_rx_pos = 0;               // Last DMA position seen (ISR)
+static uint32_t g_rx_taken = 0;             // Bytes decoded (main loop)
+static uint32_t g_rx_bytes = 0;
+
+static volatile uint32_t g_uart_errors = 0;
+static uint32_t g_ring_overruns = 0;
+
+// One packet (largest SPI frame) + CRC, decoded in place from the ring
+static uint8_t g_packet[SPI_RX_BUFFER_SIZE + 2U];
+static CobsStream_t g_stream;
+
+/* ============================================================================ */
+/* Private Functions */
+/* ============================================================================ */
+
+/**
+ * @brief (Re)start circular reception
+ * @note  The write count is moved to the next ring multiple so that the
+ *        ring index stays count & mask; bytes before it are dropped
+ */
+static void uart_link_rx_start(void)
+{
+    uint32_t total = (g_rx_total + UART_LINK_RING_MASK) & ~UART_LINK_RING_MASK;
+
+    g_rx_pos = 0;
+    g_rx_total = total;
+    g_rx_floor = total;
+
+    // Half / full (DMA) and idle line (UART) events -> HAL_UARTEx_RxEventCallback
+    HAL_UARTEx_ReceiveToIdle_DMA(&huart1, g_ring, UART_LINK_RING_SIZE);
+}
+
+/* ============================================================================ */
+/* Public Functions */
+/* ============================================================================ */
+
+void uart_link_init(void)
+{
+    // Same block on re-init (slave mode entered again)
+    g_ring = dma_arena_alloc(DMA_MEM_NONCACHED, UART_LINK_RING_SIZE, DMA_ARENA_LINE, "uart1_rx");
+
+    HAL_UART_AbortReceive(&huart1);
+
+    // HAL_UART_Init() would clear HDSEL - keep the single-wire mode
+    huart1.Init.BaudRate = UART_LINK_BAUD;
+    if (HAL_HalfDuplex_Init(&huart1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    HAL_UARTEx_EnableFifoMode(&huart1);     // Covers DMA arbitration at high baud
+    HAL_HalfDuplex_EnableReceiver(&huart1);
+
+    cobs_stream_init(&g_stream, g_packet, sizeof(g_packet));
+    g_rx_bytes = 0;
+    g_ring_overruns = 0;
+    g_uart_errors = 0;
+
+    uart_link_rx_start();
+    g_rx_taken = g_rx_total;
+
+    printf("[UART1] Packet link: %lu baud, %u byte ring\r\n",
+           huart1.Init.BaudRate, UART_LINK_RING_SIZE);
+}
+
+void uart_link_rx_event(uint16_t pos)
+{
+    pos &= UART_LINK_RING_MASK;
+
+    // Events come at least every half ring, so the step is unambiguous
+    g_rx_total += (uint16_t)(pos - g_rx_pos) & UART_LINK_RING_MASK;
+    g_rx_pos = pos;
+}
+
+void uart_link_rx_error(void)
+{
+    g_uart_errors++;
+
+    // Overrun stops DMA reception (HAL); noise / framing keep it running
+    if (huart1.RxState == HAL_UART_STATE_READY && g_ring != NULL)
+    {
+        uart_link_rx_start();
+    }
+}
+
+void uart_link_poll(void)
+{
+    uint32_t total, floor;
+
+    if (g_ring == NULL)
+    {
+        return;
+    }
+
+    // ISR may update between the reads - retry until stable
+    do
+    {
+        total = g_rx_total;
+        floor = g_rx_floor;
+    } while (total != g_rx_total);
+
+    // Reception restarted: older bytes are gone, the frame in progress too
+    if (g_rx_taken < floor)
+    {
+        g_rx_taken = floor;
+        g_stream.skip = 1;
+    }
+
+    // Ring lapped before the main loop got here: resync on the next delimiter
+    if ((total - g_rx_taken) >= UART_LINK_RING_SIZE)
+    {
+        g_rx_taken = total;
+        g_stream.skip = 1;
+        g_ring_overruns++;
+    }
+
+    while (g_rx_taken != total)
+    {
+        uint32_t idx = g_rx_taken & UART_LINK_RING_MASK;
+        uint32_t len = total - g_rx_taken;
+        uint32_t used, payload_len;
+
+        // Contiguous part up to the ring end
+        if (len > UART_LINK_RING_SIZE - idx)
+        {
+            len = UART_LINK_RING_SIZE - idx;
+        }
+
+        used = cobs_stream_feed(&g_stream, &g_ring[idx], len, &payload_len);
+        g_rx_taken += used;
+        g_rx_bytes += used;
+
+        if (payload_len != 0)
+        {
+            spi_handler_process_packet(g_packet, payload_len);
+        }
+    }
+}
+
+void uart_link_get_stats(UartLinkStats_t *stats)
+{
+    stats->bytes = g_rx_bytes;
+    stats->frames = g_stream.frames;
+    stats->bad_frames = g_stream.bad_frames;
+    stats->oversize = g_stream.overflows;
+    stats->ring_overruns = g_ring_overruns;
+    stats->uart_errors = g_uart_errors;
+}
@@ -13,23 +13,34 @@
 #include "ring_buffer.h"
 #include "user_com.h"
 #include "user_def.h"
+#include "dma_arena.h"
 
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart3;
 
-// UART1 queue
-Queue rx_UART1_queue;
-Queue rx_UART1_line_queue;
+// UART1 queue (RX is the binary packet link, uart_link.c)
 Queue tx_UART1_queue;
 
-// UART3 queue
-Queue rx_UART3_queue;
-Queue rx_UART3_line_queue;
+// UART3 queue (RX is read in place from the DMA ring)
 Queue tx_UART3_queue;
 
 struct uart_Stat_ST uart1_stat_ST;
 struct uart_Stat_ST uart3_stat_ST;
 
+// UART3 DMA TX buffer - non-cacheable DMA arena, allocated in init_UART_COM()
+static uint8_t *g_uart3_tx_dma_buffer = NULL;
+
+// UART3 DMA RX ring - non-cacheable DMA arena, allocated in init_UART_COM()
+// Positions are absolute byte counts, ring index = count & (size - 1)
+#define UART3_RX_MASK	(UART3_RX_RING_SIZE - 1U)
+
+static uint8_t *g_uart3_rx_ring = NULL;
+static volatile uint32_t g_uart3_rx_total = 0;	// Bytes written by DMA (ISR)
+static volatile uint32_t g_uart3_rx_floor = 0;	// First valid byte after a restart (ISR)
+static uint16_t g_uart3_rx_pos = 0;				// Last DMA position seen (ISR)
+static uint32_t g_uart3_rx_taken = 0;			// Bytes consumed (main loop)
+static uint32_t g_uart3_rx_overruns = 0;
+
 uint8_t atoh(char in_ascii)
 {
     uint8_t rtn_val;
@@ -125,24 +136,19 @@ void UART_baudrate_set(UART_HandleTypeDef *tm_hart,uint32_t baud_rate)
 void init_UART_COM(void)
 {
 
-	UART_baudrate_set(&huart1,115200);
-	UART_baudrate_set(&huart3,115200);
+	UART_baudrate_set(&huart3,UART3_BAUD_RATE);
+	HAL_UARTEx_EnableFifoMode(&huart3);		// 8-byte RX FIFO covers DMA arbitration at high baud
 
-	// uart1
-  InitQueue(&rx_UART1_line_queue,256);
-  InitQueue(&rx_UART1_queue,512);
+	// uart1 (single-wire, configured by uart_link_init() in slave mode)
   InitQueue(&tx_UART1_queue,512);
 
 	// uart3
-  InitQueue(&rx_UART3_line_queue,256);
-  InitQueue(&rx_UART3_queue,512);
   InitQueue(&tx_UART3_queue,2048);  // Increased for long initialization messages
+  g_uart3_tx_dma_buffer = dma_arena_alloc(DMA_MEM_NONCACHED, DMA_TX_BUFFER_SIZE, DMA_ARENA_LINE, "uart3_tx");
+  g_uart3_rx_ring = dma_arena_alloc(DMA_MEM_NONCACHED, UART3_RX_RING_SIZE, DMA_ARENA_LINE, "uart3_rx");
 
-//	__HAL_UART_ENABLE_IT(&huart1,UART_IT_IDLE);
-//	HAL_UART_Receive_DMA(&huart1,uart1_stat_ST.uart_rx_DMA_buf,DMA_RX_BUFFER_SIZE);
-	// UART3: IDLE 인터럽트 활성화 + 일반 DMA 수신 (작동하는 코드와 동일)
-	__HAL_UART_ENABLE_IT(&huart3,UART_IT_IDLE);
-	HAL_UART_Receive_DMA(&huart3,uart3_stat_ST.uart_rx_DMA_buf,DMA_RX_BUFFER_SIZE);
+	// UART3: circular DMA (linked list, CubeMX) + idle line / half / full events
+	UART3_RX_Start();
 }
 
 
@@ -178,69 +184,184 @@ void printf_UARTC(UART_HandleTypeDef *h_tmUART,uint8_t color,const char *str_buf
 
 
 
-COM_Idy_Typ UART3_GetLine(uint8_t *line_buf)
+/**
+ * @brief Take a consistent snapshot of the DMA write count (main loop)
+ * @return Bytes written so far; consumer positions are moved past
+ *         overwritten or discarded data
+ */
+static uint32_t uart3_rx_sync(void)
 {
-	uint16_t q_len;
-	uint8_t rx_dat;
-	COM_Idy_Typ rtn_val = NOT_LINE;
+	uint32_t total, floor;
 
-	q_len = Len_queue(&rx_UART3_queue);
-	if (q_len)
+	// ISR may update between the reads - retry until stable
+	do
 	{
-		for(uint16_t i=0;i<q_len;i++)
+		total = g_uart3_rx_total;
+		floor = g_uart3_rx_floor;
+	} while (total != g_uart3_rx_total);
+
+	// Reception restarted (error / baud change): older bytes are gone
+	if (g_uart3_rx_taken < floor)
+	{
+		g_uart3_rx_taken = floor;
+	}
+
+	// Ring lapped before the main loop got here: drop the backlog
+	if ((total - g_uart3_rx_taken) >= UART3_RX_RING_SIZE)
+	{
+		g_uart3_rx_taken = total;
+		g_uart3_rx_overruns++;
+	}
+
+	return total;
+}
+
+// ============================================================================
+// DMA circular RX implementation
+// ============================================================================
+
+/**
+ * @brief Start (or restart) UART3 circular DMA reception
+ * @note  DMA always restarts at the ring start - the write count is
+ *        advanced to the next ring multiple so indexes stay aligned,
+ *        unread bytes are discarded (uart3_rx_sync)
+ */
+void UART3_RX_Start(void)
+{
+	uint32_t total = (g_uart3_rx_total + UART3_RX_MASK) & ~UART3_RX_MASK;
+
+	if (g_uart3_rx_ring == NULL)
+	{
+		return;
+	}
+
+	g_uart3_rx_pos = 0;
+	g_uart3_rx_total = total;
+	g_uart3_rx_floor = total;
+
+	// Half / full (DMA) and idle line (UART) events -> HAL_UARTEx_RxEventCallback
+	HAL_UARTEx_ReceiveToIdle_DMA(&huart3, g_uart3_rx_ring, UART3_RX_RING_SIZE);
+}
+
+/**
+ * @brief RX event (idle line, half, full) - advance the write count
+ * @param pos DMA position in the ring (bytes written in this lap)
+ * @note  Called from HAL_UARTEx_RxEventCallback (USART3 / GPDMA1 CH0 IRQ).
+ *        Events come at least every half ring, so the step is unambiguous
+ */
+void UART3_RX_Event(uint16_t pos)
+{
+	pos &= UART3_RX_MASK;
+
+	g_uart3_rx_total += (uint16_t)(pos - g_uart3_rx_pos) & UART3_RX_MASK;
+	g_uart3_rx_pos = pos;
+}
+
+/**
+ * @brief Bytes waiting in the RX ring
+ */
+uint16_t UART3_RX_Len(void)
+{
+	return (uint16_t)(uart3_rx_sync() - g_uart3_rx_taken);
+}
+
+/**
+ * @brief Take one byte from the RX ring (key input)
+ * @return Byte, 0 if none waiting
+ */
+uint8_t UART3_RX_Byte(void)
+{
+	if (uart3_rx_sync() == g_uart3_rx_taken)
+	{
+		return 0;
+	}
+
+	return g_uart3_rx_ring[g_uart3_rx_taken++ & UART3_RX_MASK];
+}
+
+/**
+ * @brief Waiting bytes up to the ring end, read in place (console line editor)
+ * @param data Output: first waiting byte in the ring
+ * @return Contiguous bytes at data (rest follows from the ring start)
+ * @note  Release them with UART3_RX_Take()
+ */
+uint32_t UART3_RX_Peek(const uint8_t **data)
+{
+	uint32_t len = uart3_rx_sync() - g_uart3_rx_taken;
+	uint32_t idx = g_uart3_rx_taken & UART3_RX_MASK;
+
+	if (len > UART3_RX_RING_SIZE - idx)
+	{
+		len = UART3_RX_RING_SIZE - idx;
+	}
+
+	*data = &g_uart3_rx_ring[idx];
+	return len;
+}
+
+/**
+ * @brief Release bytes read through UART3_RX_Peek()
+ */
+void UART3_RX_Take(uint32_t len)
+{
+	g_uart3_rx_taken += len;
+}
+
+/**
+ * @brief Times the ring was lapped before the main loop read it
+ */
+uint32_t UART3_RX_Get_Overruns(void)
+{
+	return g_uart3_rx_overruns;
+}
+
+/**
+ * @brief Change the console baud rate
+ * @param baud_rate New baud rate (max PCLK1 / 16)
+ * @return 0 on success, 1 if TX did not drain or HAL init failed
+ * @note  Pending TX is sent at the old rate first, unread RX is dropped
+ */
+uint8_t UART3_Set_Baud(uint32_t baud_rate)
+{
+	uint32_t start = HAL_GetTick();
+
+	while (Len_queue(&tx_UART3_queue) != 0 || g_uart3_tx_busy)
+	{
+		UART3_Process_TX_Queue();
+		if ((HAL_GetTick() - start) > 1000)
 		{
-			rx_dat = Dequeue(&rx_UART3_queue);
-			Enqueue(&rx_UART3_line_queue,rx_dat);
-			#ifdef UART3_ECHO
-			printf_UARTC(&huart3,PR_NOP,"%c",rx_dat);
-			#endif
-			if (rx_dat == UART3_ETX)
-			{
-				#ifdef UART3_ECHO
-				printf_UARTC(&huart3,PR_NOP,"\n");
-				#endif
-				flush_queue(&rx_UART3_queue);
-				q_len = Len_queue(&rx_UART3_line_queue);
-				Dequeue_bytes(&rx_UART3_line_queue,line_buf,q_len);
-				line_buf[q_len-1] = 0;
-
-		  	printf_UARTC(&huart3,PR_YEL,"%s\033[%dm\r\n",line_buf,PR_INI);
-
-		  	// 유효한 명령어 체크 (help, stvc, stst, rdat, 0~6)
-		  	if
-				(
-						(strncmp((char *)line_buf,"help",4) == 0) ||
-						(strncmp((char *)line_buf,"stvc",4) == 0) ||
-						(strncmp((char *)line_buf,"stst",4) == 0) ||
-						(strncmp((char *)line_buf,"rdat",4) == 0) ||
-						// 0~6 숫자 명령어 (한 글자만)
-						(strlen((char *)line_buf) == 1 && line_buf[0] >= '0' && line_buf[0] <= '6')
-				)
-				{
-					rtn_val = RCV_LINE;
-				}
-				else
-				{
-					rtn_val = WNG_LINE;
-				}
-				break;	// escape from for()
-			}
+			return 1;
 		}
 	}
 
-	return rtn_val;
+	HAL_UART_AbortReceive(&huart3);
+
+	huart3.Init.BaudRate = baud_rate;
+	if (HAL_UART_Init(&huart3) != HAL_OK)
+	{
+		return 1;
+	}
+	HAL_UARTEx_EnableFifoMode(&huart3);
+
+	UART3_RX_Start();
+
+	return 0;
 }
 
 // ============================================================================
 // DMA-based TX implementation
 // ============================================================================
 
-// DMA TX state and buffer
+// DMA TX state
 volatile uint8_t g_uart3_tx_busy = 0;
 
-// DMA TX buffer - placed in non-cacheable RAM for DCACHE compatibility
-__attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
-static uint8_t g_uart3_tx_dma_buffer[DMA_TX_BUFFER_SIZE];
+/**
+ * @brief TX queue empty and no DMA transfer running
+ */
+uint8_t UART3_TX_Idle(void)
+{
+	return (Len_queue(&tx_UART3_queue) == 0 && !g_uart3_tx_busy) ? 1 : 0;
+}
 
 /**
  * @brief Process UART3 TX queue and start DMA transmission if not busy
@@ -248,8 +369,8 @@ static uint8_t g_uart3_tx_dma_buffer[DMA_TX_BUFFER_SIZE];
  */
 void UART3_Process_TX_Queue(void)
 {
-	// If DMA is busy, return immediately
-	if (g_uart3_tx_busy)
+	// If DMA is busy or not initialized yet, return immediately
+	if (g_uart3_tx_busy || g_uart3_tx_dma_buffer == NULL)
 	{
 		return;
 	}
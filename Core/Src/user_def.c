@@ -14,7 +14,19 @@
 #include "user_def.h"
 #include "spi_protocol.h"
 #include "audio_channel.h"
+#include "adpcm.h"
+#include "audio_dsp.h"
+#include "audio_output.h"
 #include "spi_handler.h"
+#include "dma_arena.h"
+#include "cache_maint.h"
+#include "hot_path.h"
+#include "irq_prio.h"
+#include "spi_timing.h"
+#include "telemetry.h"
+#include "uart_link.h"
+#include "console.h"
+#include "task_sched.h"
 #include "user_com.h"
 #include "stm32h5xx_it.h"  // For DAC DMA debug counters
 
@@ -24,30 +36,21 @@ extern DAC_HandleTypeDef hdac1;
 extern TIM_HandleTypeDef htim7;
 extern SPI_HandleTypeDef hspi1;
 
-extern Queue rx_UART3_queue;
 extern Queue tx_UART3_queue;
 
 extern struct uart_Stat_ST uart1_stat_ST;
-extern struct uart_Stat_ST uart3_stat_ST;
 
 
 // ============================================================================
 // Audio Buffers (aligned for DMA)
 // ============================================================================
 
-// DAC1 (CH0) buffers - placed in non-cacheable RAM_DMA for cache coherency
-__attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
-static uint16_t dac1_buffer_a[AUDIO_BUFFER_SIZE];
-
-__attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
-static uint16_t dac1_buffer_b[AUDIO_BUFFER_SIZE];
-
-// DAC2 (CH1) buffers - placed in non-cacheable RAM_DMA for cache coherency
-__attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
-static uint16_t dac2_buffer_a[AUDIO_BUFFER_SIZE];
-
-__attribute__((section(".dma_buffer"))) __attribute__((aligned(32)))
-static uint16_t dac2_buffer_b[AUDIO_BUFFER_SIZE];
+// DAC1 (CH0) / DAC2 (CH1) A/B buffers (AUDIO_BUFFER_SIZE samples each)
+// Non-cacheable DMA arena (test 3 plays them by DMA), allocated in init_proc()
+static int16_t *dac1_buffer_a = NULL;
+static int16_t *dac1_buffer_b = NULL;
+static int16_t *dac2_buffer_a = NULL;
+static int16_t *dac2_buffer_b = NULL;
 
 // Audio channels (global, used by interrupt callbacks)
 AudioChannel_t g_dac1_channel;
@@ -145,799 +148,1347 @@ int _write(int file, char *data, int len)
 }
 
 
-void test_gpio(void)
-{
-    uint32_t tick_user;
-
-    printf("\r\n=== Legacy GPIO Test ===\r\n");
-    printf("Press ESC or 'q' to exit\r\n\r\n");
-
-    tick_user = HAL_GetTick();
-
-    while(1)
-    {
-        // ESC 또는 'q' 키 입력 체크
-        if (Len_queue(&rx_UART3_queue) > 0)
-        {
-            uint8_t key = Dequeue(&rx_UART3_queue);
-            if (key == 0x1B || key == 'q' || key == 'Q')
-            {
-                printf("\r\n[EXIT] GPIO Test stopped by user\r\n");
-                return;
-            }
-        }
-
-        if (HAL_GetTick() - tick_user > 500)
-        {
-            tick_user = HAL_GetTick();
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
-            //HAL_GPIO_TogglePin(OT_LD_REV_GPIO_Port, OT_LD_REV_Pin);
-
-            printf("GPIO Toggled\r\n");
-        }
-    }
-
-}
-
-// DAC 사인파 출력 테스트 함수
-// 채널 1: 10kHz 사인파
-// 채널 2: 5kHz 사인파
-void test_dac_sine(void)
-{
-    // 샘플링 주파수: 100kHz (10us per sample)
-    // 10kHz: 10 샘플/주기 -> 인덱스 증가량 = 256/10 = 25.6
-    // 5kHz: 20 샘플/주기 -> 인덱스 증가량 = 256/20 = 12.8
-
-    // 고정소수점 연산 (8비트 소수부)
-    uint32_t phase_10khz = 0;  // 10kHz 위상 누산기
-    uint32_t phase_5khz = 0;   // 5kHz 위상 누산기
-    uint32_t phase_inc_10khz = (uint32_t)(25.6 * 256);  // 25.6 << 8
-    uint32_t phase_inc_5khz = (uint32_t)(12.8 * 256);   // 12.8 << 8
-
-    uint16_t index_10khz, index_5khz;
-    uint32_t tick_user;
-    uint32_t sample_count = 0;
-
-    // DAC 시작
-    HAL_DAC_Start(&hdac1, DAC_CHANNEL_1);
-    HAL_DAC_Start(&hdac1, DAC_CHANNEL_2);
-
-    printf("DAC Sine Wave Test Started\r\n");
-    printf("Channel 1: 10kHz, Channel 2: 5kHz\r\n");
-    printf("Press ESC or 'q' to exit\r\n\r\n");
-
-    tick_user = HAL_GetTick();
-
-    while(1)
-    {
-        // ESC 또는 'q' 키 입력 체크 (1000 샘플마다 체크)
-        if (sample_count % 1000 == 0 && Len_queue(&rx_UART3_queue) > 0)
-        {
-            uint8_t key = Dequeue(&rx_UART3_queue);
-            if (key == 0x1B || key == 'q' || key == 'Q')
-            {
-                printf("\r\n[EXIT] DAC Sine Test stopped by user\r\n");
-                HAL_DAC_Stop(&hdac1, DAC_CHANNEL_1);
-                HAL_DAC_Stop(&hdac1, DAC_CHANNEL_2);
-                return;
-            }
-        }
-
-        // 채널 1: 10kHz 사인파
-        index_10khz = (phase_10khz >> 8) & 0xFF;  // 상위 8비트를 인덱스로 사용
-        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_1, DAC_ALIGN_12B_R, sine_table[index_10khz]);
-
-        // 채널 2: 5kHz 사인파
-        index_5khz = (phase_5khz >> 8) & 0xFF;
-        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_2, DAC_ALIGN_12B_R, sine_table[index_5khz]);
-
-        // 위상 누산
-        phase_10khz += phase_inc_10khz;
-        phase_5khz += phase_inc_5khz;
-
-        // 위상 오버플로우 처리 (256 * 256 = 65536)
-        if (phase_10khz >= (SINE_TABLE_SIZE << 8))
-            phase_10khz -= (SINE_TABLE_SIZE << 8);
-        if (phase_5khz >= (SINE_TABLE_SIZE << 8))
-            phase_5khz -= (SINE_TABLE_SIZE << 8);
-
-        sample_count++;
-
-        // 1초마다 상태 출력
-        if (HAL_GetTick() - tick_user >= 1000)
-        {
-            tick_user = HAL_GetTick();
-            printf("DAC Running - %lu samples/sec\r\n", sample_count);
-            sample_count = 0;
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
-        }
-
-        // 샘플링 주파수 100kHz = 10us 딜레이
-        // 정확한 타이밍을 위해서는 타이머 인터럽트 사용 권장
-        // 여기서는 간단하게 루프로 구현 (실제 주파수는 다를 수 있음)
-        for (volatile int i = 0; i < 250; i++);  // 대략적인 딜레이 (250MHz 기준)
-    }
-}
-
 // ============================================================================
 // Phase 1: Hardware Verification Tests
 // ============================================================================
+//
+// Menu tests run as console jobs (console.h): each call does one step and
+// returns, so the scheduler keeps running the other tasks (UART3 TX, slave
+// mode, telemetry) between steps. ESC / 'q' arrives as job->abort.
+// Software-timed DAC tests write the sample that is due now (DWT time at
+// 32kHz) instead of pacing with delay loops.
 
-// Test 1: LED 블링크 테스트
-void test_led_blink(void)
+#define TEST_SAMPLE_RATE    32000U
+#define TEST_MAX_CATCHUP    64U         // 2ms - longer stalls are skipped
+
+/**
+ * @brief Samples due at TEST_SAMPLE_RATE since the last call (DWT)
+ * @param last_cyc Time of the last sample (advanced)
+ */
+static uint32_t test_samples_due(uint32_t *last_cyc)
 {
-    printf("\r\n=== Phase 1-1: LED Blink Test ===\r\n");
-    printf("Testing both LEDs (1Hz toggle)\r\n");
-    printf("Press ESC or 'q' to exit\r\n\r\n");
+    uint32_t cyc_per_sample = SystemCoreClock / TEST_SAMPLE_RATE;
+    uint32_t due = (DWT->CYCCNT - *last_cyc) / cyc_per_sample;
 
-    uint32_t tick_start = HAL_GetTick();
+    *last_cyc += due * cyc_per_sample;
+    return (due > TEST_MAX_CATCHUP) ? TEST_MAX_CATCHUP : due;
+}
 
-    while(1)
+/**
+ * @brief DAC / SPI / RDY tests need the hardware slave mode uses
+ * @return 1 if the test may run
+ */
+static uint8_t test_hw_free(void)
+{
+    if (slave_mode_running())
     {
-        // ESC 또는 'q' 키 입력 체크
-        if (Len_queue(&rx_UART3_queue) > 0)
-        {
-            uint8_t key = Dequeue(&rx_UART3_queue);
-            if (key == 0x1B || key == 'q' || key == 'Q')  // ESC or q/Q
-            {
-                printf("\r\n[EXIT] LED Blink Test stopped by user\r\n");
-                return;
-            }
-        }
-
-        if (HAL_GetTick() - tick_start >= 500)
-        {
-            tick_start = HAL_GetTick();
-
-            // 두 LED를 번갈아가며 토글
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
-            HAL_GPIO_TogglePin(OT_LD_REV_GPIO_Port, OT_LD_REV_Pin);
-
-            // 상태 출력
-            GPIO_PinState sys_state = HAL_GPIO_ReadPin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
-            GPIO_PinState rev_state = HAL_GPIO_ReadPin(OT_LD_REV_GPIO_Port, OT_LD_REV_Pin);
-
-            printf("LED_SYS: %s, LED_REV: %s\r\n",
-                   sys_state ? "ON" : "OFF",
-                   rev_state ? "ON" : "OFF");
-        }
+        printf("[BUSY] Slave mode owns DAC / SPI / RDY - reset to run this test\r\n");
+        return 0;
     }
+    return 1;
 }
 
-// Test 2: 사이렌 소리 테스트
-void test_dac_sine_wave(void)
+/**
+ * @brief DAC trigger for both channels (software-timed tests use NONE)
+ * @return 0 on success
+ */
+static uint8_t test_dac_set_trigger(uint32_t trigger)
 {
-    printf("\r\n[ENTRY] test_dac_sine_wave() called\r\n");
-
-    printf("\r\n=== Siren Sound Test ===\r\n");
-    printf("DAC1_CH1 (PA4): Siren sound (500Hz~2kHz sweep)\r\n");
-    printf("DAC1_CH2 (PA5): Siren sound (inverted phase)\r\n");
-    printf("Press ESC or 'q' to exit\r\n\r\n");
-
-    printf("[DIAG] About to read DAC registers...\r\n");
-
-    // DIAGNOSTIC: Check DAC status before starting
-    printf("[DIAG] DAC CR before start: 0x%08lX\r\n", DAC1->CR);
-    printf("[DIAG] DAC SR before start: 0x%08lX\r\n", DAC1->SR);
-    printf("[DIAG] DAC MCR: 0x%08lX\r\n", DAC1->MCR);
-
-    // FIX: Reconfigure DAC to NO TRIGGER mode for manual control
-    printf("[FIX] Reconfiguring DAC to NO TRIGGER mode...\r\n");
     DAC_ChannelConfTypeDef sConfig = {0};
     sConfig.DAC_HighFrequency = DAC_HIGH_FREQUENCY_INTERFACE_MODE_AUTOMATIC;
-    sConfig.DAC_Trigger = DAC_TRIGGER_NONE;  // No trigger - manual control
+    sConfig.DAC_Trigger = trigger;
     sConfig.DAC_OutputBuffer = DAC_OUTPUTBUFFER_ENABLE;
     sConfig.DAC_ConnectOnChipPeripheral = DAC_CHIPCONNECT_EXTERNAL;
     sConfig.DAC_UserTrimming = DAC_TRIMMING_FACTORY;
 
     if (HAL_DAC_ConfigChannel(&hdac1, &sConfig, DAC_CHANNEL_1) != HAL_OK) {
         printf("[ERROR] DAC CH1 config failed!\r\n");
-        return;
+        return 1;
     }
     if (HAL_DAC_ConfigChannel(&hdac1, &sConfig, DAC_CHANNEL_2) != HAL_OK) {
         printf("[ERROR] DAC CH2 config failed!\r\n");
-        return;
+        return 1;
     }
-    printf("[FIX] DAC reconfigured successfully\r\n");
+    return 0;
+}
 
-    // 정현파 테이블 생성 (256 샘플)
-    uint16_t sine_256[256];
-    for (int i = 0; i < 256; i++)
+// Test 1: LED 블링크 테스트
+static ConsoleStatus_t test_led_blink(ConsoleJob_t *job)
+{
+    if (job->step == 0)
+    {
+        printf("\r\n=== Phase 1-1: LED Blink Test ===\r\n");
+        printf("Testing both LEDs (1Hz toggle)\r\n");
+        printf("Press ESC or 'q' to exit\r\n\r\n");
+
+        job->tick = HAL_GetTick();
+        job->step = 1;
+        return CONSOLE_BUSY;
+    }
+
+    // ESC 또는 'q' 키 입력
+    if (job->abort)
     {
-        sine_256[i] = (uint16_t)(2048 + 2047 * sin(2.0 * M_PI * i / 256));
+        printf("\r\n[EXIT] LED Blink Test stopped by user\r\n");
+        return CONSOLE_DONE;
     }
 
-    // DAC 시작
-    HAL_StatusTypeDef status1 = HAL_DAC_Start(&hdac1, DAC_CHANNEL_1);
-    HAL_StatusTypeDef status2 = HAL_DAC_Start(&hdac1, DAC_CHANNEL_2);
+    if (HAL_GetTick() - job->tick >= 500)
+    {
+        job->tick = HAL_GetTick();
+
+        // 두 LED를 번갈아가며 토글
+        HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+        HAL_GPIO_TogglePin(OT_LD_REV_GPIO_Port, OT_LD_REV_Pin);
 
-    printf("[DIAG] HAL_DAC_Start CH1: %d, CH2: %d (0=OK)\r\n", status1, status2);
-    printf("[DIAG] DAC CR after start: 0x%08lX\r\n", DAC1->CR);
-    printf("[DIAG] DAC SR after start: 0x%08lX\r\n", DAC1->SR);
+        // 상태 출력
+        GPIO_PinState sys_state = HAL_GPIO_ReadPin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+        GPIO_PinState rev_state = HAL_GPIO_ReadPin(OT_LD_REV_GPIO_Port, OT_LD_REV_Pin);
 
-    uint32_t tick_start = HAL_GetTick();
-    uint32_t sample_count = 0;
+        printf("LED_SYS: %s, LED_REV: %s\r\n",
+               sys_state ? "ON" : "OFF",
+               rev_state ? "ON" : "OFF");
+    }
+
+    return CONSOLE_BUSY;
+}
 
-    // 사이렌 주파수 제어 (500Hz ~ 2000Hz 스윕)
-    float frequency = 500.0f;  // 시작 주파수
-    float freq_direction = 1.0f;  // 1: 올라가는 중, -1: 내려가는 중
-    float phase = 0.0f;
+// Test 2: 사이렌 소리 테스트
+static struct {
+    uint16_t sine_256[256];
+    float frequency;        // 현재 주파수 (500Hz ~ 2000Hz)
+    float freq_direction;   // 1: 올라가는 중, -1: 내려가는 중
+    float phase;
+    uint32_t last_cyc;      // DWT time of the last sample
+    uint32_t updates;       // DAC writes (scheduler passes)
+} g_siren;
+
+static ConsoleStatus_t test_dac_sine_wave(ConsoleJob_t *job)
+{
     const float freq_step = 0.025f;  // 주파수 변화 속도 (약 1.5초에 걸쳐 변화)
     const float sample_rate = 32000.0f;  // 32kHz 샘플레이트
 
-    printf("Siren sound started (500Hz~2kHz sweep)\r\n");
-
-    while(1)
+    if (job->step == 0)
     {
-        // ESC 또는 'q' 키 입력 체크 (1000 샘플마다 체크)
-        if (sample_count % 1000 == 0 && Len_queue(&rx_UART3_queue) > 0)
+        if (!test_hw_free())
         {
-            uint8_t key = Dequeue(&rx_UART3_queue);
-            if (key == 0x1B || key == 'q' || key == 'Q')
-            {
-                printf("\r\n[EXIT] Siren Sound Test stopped by user\r\n");
-                HAL_DAC_Stop(&hdac1, DAC_CHANNEL_1);
-                HAL_DAC_Stop(&hdac1, DAC_CHANNEL_2);
-
-                // RESTORE: Reconfigure DAC back to TIM1 trigger mode for DMA operation
-                printf("[RESTORE] Reconfiguring DAC to TIM1 TRIGGER mode...\r\n");
-                DAC_ChannelConfTypeDef sConfig_restore = {0};
-                sConfig_restore.DAC_HighFrequency = DAC_HIGH_FREQUENCY_INTERFACE_MODE_AUTOMATIC;
-                sConfig_restore.DAC_Trigger = DAC_TRIGGER_T1_TRGO;  // TIM1 trigger
-                sConfig_restore.DAC_OutputBuffer = DAC_OUTPUTBUFFER_ENABLE;
-                sConfig_restore.DAC_ConnectOnChipPeripheral = DAC_CHIPCONNECT_EXTERNAL;
-                sConfig_restore.DAC_UserTrimming = DAC_TRIMMING_FACTORY;
-
-                if (HAL_DAC_ConfigChannel(&hdac1, &sConfig_restore, DAC_CHANNEL_1) != HAL_OK) {
-                    printf("[ERROR] DAC CH1 restore failed!\r\n");
-                }
-                if (HAL_DAC_ConfigChannel(&hdac1, &sConfig_restore, DAC_CHANNEL_2) != HAL_OK) {
-                    printf("[ERROR] DAC CH2 restore failed!\r\n");
-                }
-                printf("[RESTORE] DAC restored to TIM1 trigger mode\r\n");
-
-                return;
-            }
+            return CONSOLE_DONE;
         }
 
-        // 위상을 테이블 인덱스로 변환
-        uint16_t index = (uint16_t)phase & 0xFF;
-
-        // CH1: 사이렌 소리
-        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_1, DAC_ALIGN_12B_R, sine_256[index]);
-
-        // CH2: 역위상 사이렌 (스테레오 효과)
-        uint16_t index_inv = (index + 128) & 0xFF;
-        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_2, DAC_ALIGN_12B_R, sine_256[index_inv]);
+        printf("\r\n=== Siren Sound Test ===\r\n");
+        printf("DAC1_CH1 (PA4): Siren sound (500Hz~2kHz sweep)\r\n");
+        printf("DAC1_CH2 (PA5): Siren sound (inverted phase)\r\n");
+        printf("Press ESC or 'q' to exit\r\n\r\n");
 
-        // 위상 증가 (주파수에 비례)
-        phase += (frequency * 256.0f) / sample_rate;
-        if (phase >= 256.0f)
-            phase -= 256.0f;
+        // DIAGNOSTIC: Check DAC status before starting
+        printf("[DIAG] DAC CR before start: 0x%08lX\r\n", DAC1->CR);
+        printf("[DIAG] DAC SR before start: 0x%08lX\r\n", DAC1->SR);
+        printf("[DIAG] DAC MCR: 0x%08lX\r\n", DAC1->MCR);
 
-        // 주파수 스윕 (500Hz ~ 2000Hz)
-        frequency += freq_direction * freq_step;
-        if (frequency >= 2000.0f)
+        // FIX: Reconfigure DAC to NO TRIGGER mode for manual control
+        printf("[FIX] Reconfiguring DAC to NO TRIGGER mode...\r\n");
+        if (test_dac_set_trigger(DAC_TRIGGER_NONE) != 0)
         {
-            frequency = 2000.0f;
-            freq_direction = -1.0f;  // 내려가기 시작
+            return CONSOLE_DONE;
         }
-        else if (frequency <= 500.0f)
+        printf("[FIX] DAC reconfigured successfully\r\n");
+
+        // 정현파 테이블 생성 (256 샘플)
+        for (int i = 0; i < 256; i++)
         {
-            frequency = 500.0f;
-            freq_direction = 1.0f;   // 올라가기 시작
+            g_siren.sine_256[i] = (uint16_t)(2048 + 2047 * sin(2.0 * M_PI * i / 256));
         }
+        g_siren.frequency = 500.0f;
+        g_siren.freq_direction = 1.0f;
+        g_siren.phase = 0.0f;
+        g_siren.updates = 0;
+
+        // DAC 시작
+        HAL_StatusTypeDef status1 = HAL_DAC_Start(&hdac1, DAC_CHANNEL_1);
+        HAL_StatusTypeDef status2 = HAL_DAC_Start(&hdac1, DAC_CHANNEL_2);
+
+        printf("[DIAG] HAL_DAC_Start CH1: %d, CH2: %d (0=OK)\r\n", status1, status2);
+        printf("[DIAG] DAC CR after start: 0x%08lX\r\n", DAC1->CR);
+        printf("[DIAG] DAC SR after start: 0x%08lX\r\n", DAC1->SR);
+        printf("Siren sound started (500Hz~2kHz sweep)\r\n");
+
+        g_siren.last_cyc = DWT->CYCCNT;
+        job->tick = HAL_GetTick();
+        job->count = 0;
+        job->step = 1;
+        return CONSOLE_BUSY;
+    }
 
-        sample_count++;
+    // ESC 또는 'q' 키 입력
+    if (job->abort)
+    {
+        printf("\r\n[EXIT] Siren Sound Test stopped by user\r\n");
+        HAL_DAC_Stop(&hdac1, DAC_CHANNEL_1);
+        HAL_DAC_Stop(&hdac1, DAC_CHANNEL_2);
 
-        // 1초마다 상태 출력
-        if (HAL_GetTick() - tick_start >= 1000)
+        // RESTORE: Reconfigure DAC back to TIM1 trigger mode for DMA operation
+        printf("[RESTORE] Reconfiguring DAC to TIM1 TRIGGER mode...\r\n");
+        if (test_dac_set_trigger(DAC_TRIGGER_T1_TRGO) == 0)
         {
-            tick_start = HAL_GetTick();
-            printf("Siren: %.0fHz | Samples: %lu/sec\r\n", frequency, sample_count);
-            sample_count = 0;
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+            printf("[RESTORE] DAC restored to TIM1 trigger mode\r\n");
         }
-
-        // 대략 32kHz 샘플레이트
-        for (volatile int i = 0; i < 100; i++);
+        return CONSOLE_DONE;
     }
-}
 
-// Test 3: DAC DMA Sine Wave Test (버퍼를 사인파로 채우기)
-void test_dac_dma_sine(void)
-{
-    printf("\r\n=== DAC DMA Sine Wave Test (5 seconds) ===\r\n");
-    printf("DAC1 (PA4): 1kHz sine wave\r\n");
-    printf("DAC2 (PA5): 500Hz sine wave\r\n");
-    printf("Playing for 5 seconds...\r\n\r\n");
+    // 지난 호출 이후 지난 샘플만큼 위상 / 주파수 진행
+    uint32_t due = test_samples_due(&g_siren.last_cyc);
 
-    // DAC1 버퍼를 1kHz 사인파로 채우기
-    // 샘플레이트: 32kHz, 1kHz = 32 샘플/주기
-    for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
+    for (uint32_t n = 0; n < due; n++)
     {
-        uint16_t table_index = (i * SINE_TABLE_SIZE / 32) % SINE_TABLE_SIZE;
-        dac1_buffer_a[i] = sine_table[table_index];
-        dac1_buffer_b[i] = sine_table[table_index];
-    }
+        // 위상 증가 (주파수에 비례)
+        g_siren.phase += (g_siren.frequency * 256.0f) / sample_rate;
+        if (g_siren.phase >= 256.0f)
+            g_siren.phase -= 256.0f;
 
-    // DAC2 버퍼를 500Hz 사인파로 채우기 (다른 주파수)
-    // 500Hz = 64 샘플/주기
-    for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
-    {
-        uint16_t table_index = (i * SINE_TABLE_SIZE / 64) % SINE_TABLE_SIZE;
-        dac2_buffer_a[i] = sine_table[table_index];
-        dac2_buffer_b[i] = sine_table[table_index];
+        // 주파수 스윕 (500Hz ~ 2000Hz)
+        g_siren.frequency += g_siren.freq_direction * freq_step;
+        if (g_siren.frequency >= 2000.0f)
+        {
+            g_siren.frequency = 2000.0f;
+            g_siren.freq_direction = -1.0f;  // 내려가기 시작
+        }
+        else if (g_siren.frequency <= 500.0f)
+        {
+            g_siren.frequency = 500.0f;
+            g_siren.freq_direction = 1.0f;   // 올라가기 시작
+        }
     }
 
-    printf("[INIT] Buffers filled with sine waves\r\n");
-
-    // Start TIM1 (DAC trigger, 32kHz)
-    extern TIM_HandleTypeDef htim1;
-    HAL_TIM_Base_Start(&htim1);
-    printf("[INIT] TIM1 started (32kHz trigger)\r\n");
-
-    // Start DAC DMA for both channels
-    HAL_StatusTypeDef status1 = HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_1,
-                                                   (uint32_t*)dac1_buffer_a,
-                                                   AUDIO_BUFFER_SIZE,
-                                                   DAC_ALIGN_12B_R);
-
-    HAL_StatusTypeDef status2 = HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_2,
-                                                   (uint32_t*)dac2_buffer_a,
-                                                   AUDIO_BUFFER_SIZE,
-                                                   DAC_ALIGN_12B_R);
-
-    if (status1 == HAL_OK && status2 == HAL_OK)
+    if (due != 0)
     {
-        printf("[PLAY] DAC1 & DAC2 DMA started successfully\r\n");
-        printf("[PLAY] Playing...\r\n");
+        // 위상을 테이블 인덱스로 변환
+        uint16_t index = (uint16_t)g_siren.phase & 0xFF;
 
-        // Play for 5 seconds
-        HAL_Delay(5000);
+        // CH1: 사이렌 소리
+        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_1, DAC_ALIGN_12B_R, g_siren.sine_256[index]);
 
-        // Stop DAC DMA
-        HAL_DAC_Stop_DMA(&hdac1, DAC_CHANNEL_1);
-        HAL_DAC_Stop_DMA(&hdac1, DAC_CHANNEL_2);
+        // CH2: 역위상 사이렌 (스테레오 효과)
+        uint16_t index_inv = (index + 128) & 0xFF;
+        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_2, DAC_ALIGN_12B_R, g_siren.sine_256[index_inv]);
 
-        printf("\r\n[STOP] Playback stopped after 5 seconds\r\n");
-        printf("Test completed.\r\n");
+        job->count += due;
+        g_siren.updates++;
     }
-    else
+
+    // 1초마다 상태 출력
+    if (HAL_GetTick() - job->tick >= 1000)
     {
-        printf("[ERROR] DAC DMA start failed: CH1=%d, CH2=%d\r\n", status1, status2);
+        job->tick = HAL_GetTick();
+        printf("Siren: %.0fHz | Samples: %lu/sec | DAC updates: %lu/sec\r\n",
+               g_siren.frequency, job->count, g_siren.updates);
+        job->count = 0;
+        g_siren.updates = 0;
+        HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
     }
+
+    return CONSOLE_BUSY;
 }
 
-// Test 4: DAC Quick Test (5초 출력)
-void test_dac_quick(void)
+// Test 3: DAC DMA Sine Wave Test (버퍼를 사인파로 채우기)
+static ConsoleStatus_t test_dac_dma_sine(ConsoleJob_t *job)
 {
-    printf("\r\n=== DAC Quick Test (5 seconds) ===\r\n");
-    printf("DAC1_CH1 (PA4): 1kHz sine wave for 5 seconds\r\n");
-    printf("Check output with oscilloscope\r\n\r\n");
-
-    // 정현파 테이블 생성 (32 샘플)
-    uint16_t sine_32[32];
-    for (int i = 0; i < 32; i++)
+    if (job->step == 0)
     {
-        sine_32[i] = (uint16_t)(2048 + 2047 * sin(2.0 * M_PI * i / 32));
-    }
+        if (!test_hw_free())
+        {
+            return CONSOLE_DONE;
+        }
 
-    // DAC 시작
-    HAL_DAC_Start(&hdac1, DAC_CHANNEL_1);
+        printf("\r\n=== DAC DMA Sine Wave Test (5 seconds) ===\r\n");
+        printf("DAC1 (PA4): 1kHz sine wave\r\n");
+        printf("DAC2 (PA5): 500Hz sine wave\r\n");
+        printf("Playing for 5 seconds...\r\n\r\n");
 
-    uint32_t tick_start = HAL_GetTick();
-    uint32_t index = 0;
-    uint32_t sample_count = 0;
+        // DAC1 버퍼를 1kHz 사인파로 채우기
+        // 샘플레이트: 32kHz, 1kHz = 32 샘플/주기
+        for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
+        {
+            uint16_t table_index = (i * SINE_TABLE_SIZE / 32) % SINE_TABLE_SIZE;
+            dac1_buffer_a[i] = sine_table[table_index];
+            dac1_buffer_b[i] = sine_table[table_index];
+        }
+
+        // DAC2 버퍼를 500Hz 사인파로 채우기 (다른 주파수)
+        // 500Hz = 64 샘플/주기
+        for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
+        {
+            uint16_t table_index = (i * SINE_TABLE_SIZE / 64) % SINE_TABLE_SIZE;
+            dac2_buffer_a[i] = sine_table[table_index];
+            dac2_buffer_b[i] = sine_table[table_index];
+        }
 
-    printf("DAC output started...\r\n");
+        printf("[INIT] Buffers filled with sine waves\r\n");
 
-    // 5초간 실행
-    while((HAL_GetTick() - tick_start) < 5000)
-    {
-        // CH1: 1kHz (32kHz / 32 = 1kHz)
-        HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_1, DAC_ALIGN_12B_R, sine_32[index]);
-        index = (index + 1) % 32;
-        sample_count++;
+        // Start TIM1 (DAC trigger, 32kHz)
+        extern TIM_HandleTypeDef htim1;
+        HAL_TIM_Base_Start(&htim1);
+        printf("[INIT] TIM1 started (32kHz trigger)\r\n");
 
-        // 대략 32kHz 샘플레이트 (250MHz / 약 7800 = 32kHz)
-        for (volatile int i = 0; i < 100; i++);
+        // Start DAC DMA for both channels
+        HAL_StatusTypeDef status1 = HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_1,
+                                                       (uint32_t*)dac1_buffer_a,
+                                                       AUDIO_BUFFER_SIZE,
+                                                       DAC_ALIGN_12B_R);
 
-        // LED 토글 (1초마다)
-        if (sample_count % 32000 == 0)
+        HAL_StatusTypeDef status2 = HAL_DAC_Start_DMA(&hdac1, DAC_CHANNEL_2,
+                                                       (uint32_t*)dac2_buffer_a,
+                                                       AUDIO_BUFFER_SIZE,
+                                                       DAC_ALIGN_12B_R);
+
+        if (status1 != HAL_OK || status2 != HAL_OK)
         {
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+            printf("[ERROR] DAC DMA start failed: CH1=%d, CH2=%d\r\n", status1, status2);
+            return CONSOLE_DONE;
         }
-    }
 
-    // DAC 정지
-    HAL_DAC_Stop(&hdac1, DAC_CHANNEL_1);
-
-    printf("DAC output stopped.\r\n");
-    printf("Total samples: %lu (approx. %lu samples/sec)\r\n", sample_count, sample_count / 5);
-    printf("\r\nTest completed. Returning to menu...\r\n");
-}
+        printf("[PLAY] DAC1 & DAC2 DMA started successfully\r\n");
+        printf("[PLAY] Playing...\r\n");
 
-// Test 4: UART 하드웨어 루프백 테스트
-void test_uart_loopback(void)
-{
-    printf("\r\n=== UART Hardware Loopback Test ===\r\n");
-    printf("Short PB10 (TX) and PB1 (RX) together with a wire!\r\n");
-    printf("Press any key to start...\r\n\r\n");
+        job->tick = HAL_GetTick();
+        job->step = 1;
+        return CONSOLE_BUSY;
+    }
 
-    // 키 입력 대기
-    while(!__HAL_UART_GET_FLAG(&huart3, UART_FLAG_RXNE))
+    // Play for 5 seconds (DMA runs by itself)
+    uint32_t elapsed = HAL_GetTick() - job->tick;
+    if (!job->abort && elapsed < 5000)
     {
-        HAL_Delay(10);
+        return CONSOLE_BUSY;
     }
-    (void)(huart3.Instance->RDR);  // 버퍼 클리어
 
-    printf("Starting loopback test...\r\n\r\n");
+    // Stop DAC DMA
+    HAL_DAC_Stop_DMA(&hdac1, DAC_CHANNEL_1);
+    HAL_DAC_Stop_DMA(&hdac1, DAC_CHANNEL_2);
 
-    uint32_t success = 0;
-    uint32_t fail = 0;
-
-    for(uint8_t test_char = 'A'; test_char <= 'Z'; test_char++)
-    {
-        // TX로 문자 전송
-        HAL_UART_Transmit(&huart3, &test_char, 1, 100);
+    printf("\r\n[STOP] Playback stopped after %lu ms%s\r\n", elapsed,
+           job->abort ? " (by user)" : "");
+    printf("Test completed.\r\n");
+    return CONSOLE_DONE;
+}
 
-        // RX로 수신 대기 (100ms)
-        uint32_t timeout = HAL_GetTick();
-        uint8_t rx_char = 0;
-        uint8_t received = 0;
+// Test 4: DAC Quick Test (5초 출력)
+static ConsoleStatus_t test_dac_quick(ConsoleJob_t *job)
+{
+    // 정현파 테이블 (32 샘플, 32kHz / 32 = 1kHz)
+    static uint16_t sine_32[32];
+    static uint32_t index;
+    static uint32_t last_cyc;
 
-        while((HAL_GetTick() - timeout) < 100)
+    if (job->step == 0)
+    {
+        if (!test_hw_free())
         {
-            if(__HAL_UART_GET_FLAG(&huart3, UART_FLAG_RXNE))
-            {
-                rx_char = huart3.Instance->RDR & 0xFF;
-                received = 1;
-                break;
-            }
+            return CONSOLE_DONE;
         }
 
-        if(received && (rx_char == test_char))
-        {
-            printf("✓ TX='%c' RX='%c' - OK\r\n", test_char, rx_char);
-            success++;
-        }
-        else
+        printf("\r\n=== DAC Quick Test (5 seconds) ===\r\n");
+        printf("DAC1_CH1 (PA4): 1kHz sine wave for 5 seconds\r\n");
+        printf("Check output with oscilloscope\r\n\r\n");
+
+        for (int i = 0; i < 32; i++)
         {
-            printf("✗ TX='%c' RX='%c' (0x%02X) - FAIL\r\n", test_char, rx_char, rx_char);
-            fail++;
+            sine_32[i] = (uint16_t)(2048 + 2047 * sin(2.0 * M_PI * i / 32));
         }
+        index = 0;
+
+        // DAC 시작
+        HAL_DAC_Start(&hdac1, DAC_CHANNEL_1);
+        printf("DAC output started...\r\n");
 
-        HAL_Delay(50);
+        last_cyc = DWT->CYCCNT;
+        job->tick = HAL_GetTick();
+        job->count = 0;
+        job->step = 1;
+        return CONSOLE_BUSY;
     }
 
-    printf("\r\n=== Test Results ===\r\n");
-    printf("Success: %lu\r\n", success);
-    printf("Fail: %lu\r\n", fail);
+    // 5초간 실행 (ESC / 'q'로 조기 종료)
+    uint32_t elapsed = HAL_GetTick() - job->tick;
+    if (job->abort || elapsed >= 5000)
+    {
+        // DAC 정지
+        HAL_DAC_Stop(&hdac1, DAC_CHANNEL_1);
+
+        printf("DAC output stopped.\r\n");
+        printf("Total samples: %lu (approx. %lu samples/sec)\r\n", job->count,
+               (elapsed != 0) ? (uint32_t)(((uint64_t)job->count * 1000U) / elapsed) : 0);
+        printf("\r\nTest completed. Returning to menu...\r\n");
+        return CONSOLE_DONE;
+    }
 
-    if(success == 26 && fail == 0)
+    uint32_t due = test_samples_due(&last_cyc);
+    if (due == 0)
     {
-        printf("\r\n** UART HARDWARE IS WORKING! **\r\n");
-        printf("** Problem is likely with your terminal connection **\r\n");
+        return CONSOLE_BUSY;
     }
-    else
+
+    // CH1: 1kHz (32kHz / 32 = 1kHz)
+    index = (index + due) % 32;
+    HAL_DAC_SetValue(&hdac1, DAC_CHANNEL_1, DAC_ALIGN_12B_R, sine_32[index]);
+
+    // LED 토글 (1초마다)
+    if ((job->count + due) / 32000 != job->count / 32000)
     {
-        printf("\r\n** UART HARDWARE PROBLEM **\r\n");
-        printf("Check UART3 GPIO configuration (PB1/PB10)\r\n");
+        HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
     }
+    job->count += due;
 
-    printf("\r\nReturning to menu...\r\n");
-    HAL_Delay(3000);
+    return CONSOLE_BUSY;
 }
 
-// Test 5: UART Echo 테스트
-void test_uart_echo(void)
-{
-    printf("\r\n=== UART Echo Test ===\r\n");
-    printf("Type any character and it will be echoed back\r\n");
-    printf("Press ESC to exit\r\n\r\n");
+// Test 5: SPI 통신 테스트
+// Polled receive split into job steps: each call waits at most
+// SPI_TEST_POLL_MS, a field keeps its deadline (job->tick) and the bytes
+// already received (job->count) across calls
+#define SPI_TEST_POLL_MS        2
+
+enum {
+    SPI_TEST_HEADER = 1,        // Header byte
+    SPI_TEST_CMD_BODY,          // Command packet: 5 more bytes
+    SPI_TEST_DATA_HEADER,       // Data packet: 4 more header bytes
+    SPI_TEST_PAYLOAD            // Data packet: samples (discarded)
+};
+
+static struct {
+    uint32_t packet_count;
+    uint32_t cmd_packet_count;
+    uint32_t data_packet_count;
+    uint32_t error_count;
+    uint8_t rx[8];              // Packet header
+    uint8_t dummy[256];         // Payload chunk (discarded)
+    uint16_t payload_left;
+} g_spi_test;
 
-    uint8_t rxChar;
-    uint32_t char_count = 0;
+/**
+ * @brief Continue receiving a field (one job step)
+ * @param size Field size, job->count bytes of it already received
+ * @param timeout_ms Deadline for the field from job->tick
+ * @return HAL_OK when complete, HAL_BUSY while pending, HAL_TIMEOUT past
+ *         the deadline, HAL_ERROR on an SPI error
+ */
+static HAL_StatusTypeDef spi_test_receive(ConsoleJob_t *job, uint8_t *dst, uint16_t size,
+                                          uint32_t timeout_ms)
+{
+    uint16_t left = size - (uint16_t)job->count;
+    HAL_StatusTypeDef status = HAL_SPI_Receive(&hspi1, &dst[job->count], left, SPI_TEST_POLL_MS);
 
-    while(1)
+    if (status != HAL_TIMEOUT)
     {
-        // 무한 대기로 문자 받기
-        HAL_StatusTypeDef status = HAL_UART_Receive(&huart3, &rxChar, 1, HAL_MAX_DELAY);
-
-        if (status == HAL_OK)
-        {
-            char_count++;
+        return status;
+    }
 
-            // ESC (0x1B) 입력 시 종료
-            if (rxChar == 0x1B)
-            {
-                printf("\r\n\r\nEcho test ended. Received %lu characters.\r\n", char_count);
-                break;
-            }
+    // Timed out part way: RxXferCount is what was still missing
+    job->count += left - hspi1.RxXferCount;
 
-            // 받은 문자 에코백
-            printf("RX: '%c' (0x%02X)\r\n", rxChar, rxChar);
+    return ((HAL_GetTick() - job->tick) >= timeout_ms) ? HAL_TIMEOUT : HAL_BUSY;
+}
 
-            // LED 토글
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
-        }
-        else
+static ConsoleStatus_t test_spi_communication(ConsoleJob_t *job)
+{
+    if (job->step == 0)
+    {
+        if (!test_hw_free())
         {
-            printf("[ERROR] UART receive failed: %d\r\n", status);
-            break;
+            return CONSOLE_DONE;
         }
-    }
 
-    printf("Returning to menu...\r\n");
-    HAL_Delay(1000);
-}
+        printf("\r\n=== SPI Communication Test ===\r\n");
+        printf("Protocol v1.2 - Slave ID removed (CS pin selection)\r\n");
+        printf("Phase 2-2: Data Packet + DAC Output Test\r\n\r\n");
 
-// Test 5: SPI 통신 테스트
-void test_spi_communication(void)
-{
-    printf("\r\n=== SPI Communication Test ===\r\n");
-    UART3_Process_TX_Queue();  // 즉시 출력
-    HAL_Delay(10);
-
-    printf("Protocol v1.2 - Slave ID removed (CS pin selection)\r\n");
-    printf("Phase 2-2: Data Packet + DAC Output Test\r\n\r\n");
-    UART3_Process_TX_Queue();  // 즉시 출력
-    HAL_Delay(10);
-
-    printf("IMPORTANT: Master must send SPI packets!\r\n");
-    printf("- Refer to SLAVE_DATA_PACKET_TEST_GUIDE_20251107.md\r\n");
-    printf("- Master should send: SPITEST DATA 0\r\n\r\n");
-    UART3_Process_TX_Queue();  // 즉시 출력
-    HAL_Delay(10);
-
-    printf("Waiting for SPI packets from Master...\r\n");
-    printf("Press ESC or 'q' to exit\r\n\r\n");
-    UART3_Process_TX_Queue();  // 즉시 출력
-    HAL_Delay(10);
-
-    // SPI 수신 버퍼
-    uint8_t rx_buffer[10];
-    uint32_t packet_count = 0;
-    uint32_t cmd_packet_count = 0;
-    uint32_t data_packet_count = 0;
-    uint32_t error_count = 0;
-    uint32_t timeout_count = 0;
-    uint32_t tick_start = HAL_GetTick();
-
-    // TIM7 시작 (DAC 트리거용, 32kHz)
-    HAL_TIM_Base_Start(&htim7);
-    printf("[INIT] TIM7 started for DAC trigger (32kHz)\r\n");
-    UART3_Process_TX_Queue();
-    HAL_Delay(10);
+        printf("IMPORTANT: Master must send SPI packets!\r\n");
+        printf("- Refer to SLAVE_DATA_PACKET_TEST_GUIDE_20251107.md\r\n");
+        printf("- Master should send: SPITEST DATA 0\r\n\r\n");
 
-    // RDY 핀 LOW (준비됨, Active Low)
-    HAL_GPIO_WritePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin, GPIO_PIN_RESET);
-    printf("[INIT] RDY pin set LOW (ready)\r\n");
-    UART3_Process_TX_Queue();
-    HAL_Delay(10);
+        printf("Waiting for SPI packets from Master...\r\n");
+        printf("Press ESC or 'q' to exit\r\n\r\n");
 
-    printf("\r\n[READY] Slave is now ready to receive SPI packets\r\n");
-    printf("[READY] Listening on SPI1...\r\n\r\n");
-    UART3_Process_TX_Queue();
-    HAL_Delay(10);
+        memset(&g_spi_test, 0, sizeof(g_spi_test));
 
-    while(1)
+        // TIM7 시작 (DAC 트리거용, 32kHz)
+        HAL_TIM_Base_Start(&htim7);
+        printf("[INIT] TIM7 started for DAC trigger (32kHz)\r\n");
+
+        // RDY 핀 LOW (준비됨, Active Low)
+        HAL_GPIO_WritePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin, GPIO_PIN_RESET);
+        printf("[INIT] RDY pin set LOW (ready)\r\n");
+
+        printf("\r\n[READY] Slave is now ready to receive SPI packets\r\n");
+        printf("[READY] Listening on SPI1...\r\n\r\n");
+
+        job->step = SPI_TEST_HEADER;
+        return CONSOLE_BUSY;
+    }
+
+    // ESC 또는 'q' 키 입력
+    if (job->abort)
     {
-        // SPI 수신에만 집중! (UART 처리는 패킷 수신 후에만)
+        printf("\r\n[EXIT] SPI Test stopped. Total=%lu, CMD=%lu, DATA=%lu\r\n",
+               g_spi_test.packet_count, g_spi_test.cmd_packet_count, g_spi_test.data_packet_count);
+        return CONSOLE_DONE;
+    }
+
+    HAL_StatusTypeDef status;
 
-        // SPI 헤더 1바이트 수신 (타임아웃 10ms)
-        HAL_StatusTypeDef status = HAL_SPI_Receive(&hspi1, rx_buffer, 1, 10);
+    // SPI 헤더 1바이트 수신 (타임아웃 1ms, 다음 호출에서 다시 대기)
+    if (job->step == SPI_TEST_HEADER)
+    {
+        status = HAL_SPI_Receive(&hspi1, g_spi_test.rx, 1, 1);
 
         if (status == HAL_OK)
         {
-            uint8_t header = rx_buffer[0];
+            uint8_t header = g_spi_test.rx[0];
 
-            // Command Packet (0xC0)
-            if (header == HEADER_CMD)
-            {
-                // 나머지 5바이트 수신 (총 6바이트, 타임아웃 500ms로 증가)
-                status = HAL_SPI_Receive(&hspi1, &rx_buffer[1], 5, 500);
-                if (status == HAL_OK)
-                {
-                    CommandPacket_t *cmd = (CommandPacket_t *)rx_buffer;
-                    packet_count++;
-                    cmd_packet_count++;
-
-                    printf("[CMD #%lu] Ch=%d, Cmd=0x%02X, Param=%d\r\n",
-                           cmd_packet_count,
-                           cmd->channel,
-                           cmd->command,
-                           GET_PARAM(cmd));
-
-                    // Hardware CS already selected this slave
-                    printf("  -> ");
-                    switch(cmd->command)
-                    {
-                        case CMD_PLAY:
-                            printf("PLAY command\r\n");
-                            break;
-                        case CMD_STOP:
-                            printf("STOP command\r\n");
-                            break;
-                        case CMD_VOLUME:
-                            printf("VOLUME command (vol=%d)\r\n", GET_PARAM(cmd));
-                            break;
-                        case CMD_RESET:
-                            printf("RESET command\r\n");
-                            break;
-                        default:
-                            printf("Unknown command\r\n");
-                    }
-
-                    // 명령 패킷 처리 완료, UART 출력
-                    UART3_Process_TX_Queue();
-                }
-                else
-                {
-                    error_count++;
-                    printf("[ERROR] Received CMD header (0xC0) but body failed (status=%d)\r\n", status);
-                    UART3_Process_TX_Queue();
-                }
-            }
-            // Data Packet (0xDA)
-            else if (header == HEADER_DATA)
+            // Command Packet (0xC0): 나머지 5바이트, Data Packet (0xDA): 나머지 4바이트 헤더
+            if (header == HEADER_CMD || header == HEADER_DATA)
             {
-                // 나머지 4바이트 헤더 수신
-                status = HAL_SPI_Receive(&hspi1, &rx_buffer[1], 4, 100);
-                if (status == HAL_OK)
-                {
-                    DataPacketHeader_t *hdr = (DataPacketHeader_t *)rx_buffer;
-                    uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
-                    packet_count++;
-                    data_packet_count++;
-
-                    printf("[DATA #%lu] Ch=%d, Samples=%d\r\n",
-                           data_packet_count,
-                           hdr->channel,
-                           sample_count);
-
-                    // Hardware CS already selected this slave
-                    printf("  -> (%d bytes audio data)\r\n", sample_count * 2);
-
-                    // 샘플 데이터 버리기 (읽지만 처리하지 않음)
-                    uint8_t dummy[256];
-                    uint16_t bytes_to_read = sample_count * 2;
-                    while (bytes_to_read > 0)
-                    {
-                        uint16_t chunk = (bytes_to_read > 256) ? 256 : bytes_to_read;
-                        HAL_SPI_Receive(&hspi1, dummy, chunk, 1000);
-                        bytes_to_read -= chunk;
-                    }
-
-                    // 데이터 패킷 처리 완료, UART 출력
-                    UART3_Process_TX_Queue();
-                }
-                else
-                {
-                    error_count++;
-                    printf("[ERROR] Failed to receive DATA packet header (status=%d)\r\n", status);
-                    UART3_Process_TX_Queue();
-                }
+                // LED 토글 (패킷 수신 시에만)
+                HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+
+                job->step = (header == HEADER_CMD) ? SPI_TEST_CMD_BODY : SPI_TEST_DATA_HEADER;
+                job->tick = HAL_GetTick();
+                job->count = 0;
             }
             // Unknown Header (0xFF는 노이즈이므로 조용히 무시)
             else if (header != 0xFF)
             {
-                error_count++;
+                g_spi_test.error_count++;
                 printf("[ERROR] Unknown header: 0x%02X\r\n", header);
-                UART3_Process_TX_Queue();
-            }
-
-            // LED 토글 (패킷 수신 시에만)
-            if (header == HEADER_CMD || header == HEADER_DATA)
-            {
-                HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
             }
         }
         else if (status != HAL_TIMEOUT)
         {
             // 타임아웃이 아닌 실제 SPI 에러
-            error_count++;
+            g_spi_test.error_count++;
             printf("[ERROR] SPI receive error (status=%d)\r\n", status);
-            UART3_Process_TX_Queue();  // 에러 메시지만 즉시 출력
         }
         // HAL_TIMEOUT은 조용히 무시 (정상, Master가 아직 전송 안 함)
 
-        // ESC 키 체크 (10ms마다 한 번만)
-        static uint32_t last_key_check = 0;
-        if ((HAL_GetTick() - last_key_check) >= 10)
-        {
-            last_key_check = HAL_GetTick();
-
-            if (Len_queue(&rx_UART3_queue) > 0)
-            {
-                uint8_t key = Dequeue(&rx_UART3_queue);
-                if (key == 0x1B || key == 'q' || key == 'Q')
-                {
-                    printf("\r\n[EXIT] SPI Test stopped. Total=%lu, CMD=%lu, DATA=%lu\r\n",
-                           packet_count, cmd_packet_count, data_packet_count);
-                    UART3_Process_TX_Queue();
-                    HAL_Delay(100);
-                    return;
-                }
-            }
-        }
+        return CONSOLE_BUSY;
     }
-}
 
-// Test 6: RDY 핀 토글 테스트
-void test_rdy_pin(void)
-{
-    printf("\r\n=== Phase 1-4: RDY Pin Toggle Test ===\r\n");
-    printf("RDY Pin (PA8) toggling at 1Hz\r\n");
-    printf("Check with oscilloscope or LED\r\n");
-    printf("Press ESC or 'q' to exit\r\n\r\n");
+    if (job->step == SPI_TEST_CMD_BODY)
+    {
+        status = spi_test_receive(job, &g_spi_test.rx[1], 5, 500);
+        if (status == HAL_BUSY)
+        {
+            return CONSOLE_BUSY;
+        }
+        job->step = SPI_TEST_HEADER;
 
-    // RDY 핀을 출력으로 재설정 (테스트용)
-    GPIO_InitTypeDef GPIO_InitStruct = {0};
-    GPIO_InitStruct.Pin = OT_nRDY_Pin;
-    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-    GPIO_InitStruct.Pull = GPIO_NOPULL;
-    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
-    HAL_GPIO_Init(OT_nRDY_GPIO_Port, &GPIO_InitStruct);
+        if (status != HAL_OK)
+        {
+            g_spi_test.error_count++;
+            printf("[ERROR] Received CMD header (0xC0) but body failed (status=%d)\r\n", status);
+            return CONSOLE_BUSY;
+        }
 
-    // 초기값 LOW
-    HAL_GPIO_WritePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin, GPIO_PIN_RESET);
+        CommandPacket_t *cmd = (CommandPacket_t *)g_spi_test.rx;
+        g_spi_test.packet_count++;
+        g_spi_test.cmd_packet_count++;
 
-    printf("RDY pin configured as output\r\n");
+        printf("[CMD #%lu] Ch=%d, Cmd=0x%02X, Param=%d\r\n",
+               g_spi_test.cmd_packet_count,
+               cmd->channel,
+               cmd->command,
+               GET_PARAM(cmd));
 
-    uint32_t tick_start = HAL_GetTick();
-    uint32_t toggle_count = 0;
+        // Hardware CS already selected this slave
+        printf("  -> ");
+        switch(cmd->command)
+        {
+            case CMD_PLAY:
+                printf("PLAY command\r\n");
+                break;
+            case CMD_STOP:
+                printf("STOP command\r\n");
+                break;
+            case CMD_VOLUME:
+                printf("VOLUME command (vol=%d)\r\n", GET_PARAM(cmd));
+                break;
+            case CMD_RESET:
+                printf("RESET command\r\n");
+                break;
+            default:
+                printf("Unknown command\r\n");
+        }
+        return CONSOLE_BUSY;
+    }
 
-    while(1)
+    if (job->step == SPI_TEST_DATA_HEADER)
     {
-        // ESC 또는 'q' 키 입력 체크
-        if (Len_queue(&rx_UART3_queue) > 0)
+        status = spi_test_receive(job, &g_spi_test.rx[1], 4, 100);
+        if (status == HAL_BUSY)
         {
-            uint8_t key = Dequeue(&rx_UART3_queue);
-            if (key == 0x1B || key == 'q' || key == 'Q')
-            {
-                printf("\r\n[EXIT] RDY Pin Test stopped by user\r\n");
-                return;
-            }
+            return CONSOLE_BUSY;
         }
+        job->step = SPI_TEST_HEADER;
 
-        if (HAL_GetTick() - tick_start >= 100)
+        if (status != HAL_OK)
         {
-            tick_start = HAL_GetTick();
+            g_spi_test.error_count++;
+            printf("[ERROR] Failed to receive DATA packet header (status=%d)\r\n", status);
+            return CONSOLE_BUSY;
+        }
 
-            // RDY 핀 토글
-            HAL_GPIO_TogglePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin);
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+        DataPacketHeader_t *hdr = (DataPacketHeader_t *)g_spi_test.rx;
+        uint16_t sample_count = GET_SAMPLE_COUNT(hdr);
+        g_spi_test.packet_count++;
+        g_spi_test.data_packet_count++;
 
-            toggle_count++;
+        uint8_t format = GET_DATA_FORMAT(hdr);
+        uint16_t payload_bytes = (uint16_t)DATA_PAYLOAD_BYTES(format, sample_count);
 
-            GPIO_PinState rdy_state = HAL_GPIO_ReadPin(OT_nRDY_GPIO_Port, OT_nRDY_Pin);
+        printf("[DATA #%lu] Ch=%d, Fmt=%d, Samples=%d\r\n",
+               g_spi_test.data_packet_count,
+               GET_DATA_CHANNEL(hdr),
+               format,
+               sample_count);
 
-            if (toggle_count % 10 == 0)
-            {
-                printf("RDY: %s (toggles: %lu)\r\n",
-                       rdy_state ? "HIGH" : "LOW",
-                       toggle_count);
-            }
+        // Hardware CS already selected this slave
+        printf("  -> (%d bytes audio data)\r\n", payload_bytes);
+
+        g_spi_test.payload_left = payload_bytes;
+        if (payload_bytes != 0)
+        {
+            job->step = SPI_TEST_PAYLOAD;
+            job->tick = HAL_GetTick();
+            job->count = 0;
         }
+        return CONSOLE_BUSY;
     }
-}
 
-// ============================================================================
-// Test Menu System
-// ============================================================================
+    // 샘플 데이터 버리기 (읽지만 처리하지 않음), 256바이트 단위 (타임아웃 1000ms)
+    uint16_t chunk = (g_spi_test.payload_left > sizeof(g_spi_test.dummy))
+                     ? sizeof(g_spi_test.dummy) : g_spi_test.payload_left;
 
-// ============================================================================
-// Slave Mode Functions
-// ============================================================================
+    status = spi_test_receive(job, g_spi_test.dummy, chunk, 1000);
+    if (status == HAL_BUSY)
+    {
+        return CONSOLE_BUSY;
+    }
+
+    // Chunk timed out: the rest of the packet is dropped, back to headers
+    g_spi_test.payload_left = (status == HAL_OK) ? (g_spi_test.payload_left - chunk) : 0;
+    job->tick = HAL_GetTick();
+    job->count = 0;
+    if (g_spi_test.payload_left == 0)
+    {
+        job->step = SPI_TEST_HEADER;
+    }
+
+    return CONSOLE_BUSY;
+}
+
+// Test 6: RDY 핀 토글 테스트
+static ConsoleStatus_t test_rdy_pin(ConsoleJob_t *job)
+{
+    if (job->step == 0)
+    {
+        if (!test_hw_free())
+        {
+            return CONSOLE_DONE;
+        }
+
+        printf("\r\n=== Phase 1-4: RDY Pin Toggle Test ===\r\n");
+        printf("RDY Pin (PA8) toggling at 1Hz\r\n");
+        printf("Check with oscilloscope or LED\r\n");
+        printf("Press ESC or 'q' to exit\r\n\r\n");
+
+        // RDY 핀을 출력으로 재설정 (테스트용)
+        GPIO_InitTypeDef GPIO_InitStruct = {0};
+        GPIO_InitStruct.Pin = OT_nRDY_Pin;
+        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+        HAL_GPIO_Init(OT_nRDY_GPIO_Port, &GPIO_InitStruct);
+
+        // 초기값 LOW
+        HAL_GPIO_WritePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin, GPIO_PIN_RESET);
+
+        printf("RDY pin configured as output\r\n");
+
+        job->tick = HAL_GetTick();
+        job->count = 0;
+        job->step = 1;
+        return CONSOLE_BUSY;
+    }
+
+    // ESC 또는 'q' 키 입력
+    if (job->abort)
+    {
+        printf("\r\n[EXIT] RDY Pin Test stopped by user\r\n");
+        return CONSOLE_DONE;
+    }
+
+    if (HAL_GetTick() - job->tick >= 100)
+    {
+        job->tick = HAL_GetTick();
+
+        // RDY 핀 토글
+        HAL_GPIO_TogglePin(OT_nRDY_GPIO_Port, OT_nRDY_Pin);
+        HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+
+        job->count++;
+
+        GPIO_PinState rdy_state = HAL_GPIO_ReadPin(OT_nRDY_GPIO_Port, OT_nRDY_Pin);
+
+        if (job->count % 10 == 0)
+        {
+            printf("RDY: %s (toggles: %lu)\r\n",
+                   rdy_state ? "HIGH" : "LOW",
+                   job->count);
+        }
+    }
+
+    return CONSOLE_BUSY;
+}
+
+// ============================================================================
+// Kernel Benchmarks (DWT cycle counter)
+// ============================================================================
+
+#define BENCH_SAMPLES   1024
+
+/**
+ * @brief Enable DWT cycle counter (CPU clock cycles)
+ * @note  Never reset: CYCCNT is the free-running clock of sched, irq_lat
+ *        and spi_timing - measurements take differences only
+ */
+static void bench_cycle_counter_init(void)
+{
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Print one benchmark result line
+ * @param name Kernel name
+ * @param cycles Total cycles for BENCH_SAMPLES samples
+ * @note  CPU load is reported for 2 channels x 32kHz
+ */
+static void bench_report(const char *name, uint32_t cycles)
+{
+    uint32_t sysclk = HAL_RCC_GetSysClockFreq();
+    uint32_t cyc_x100 = (cycles * 100) / BENCH_SAMPLES;           // cycles/sample x100
+    uint32_t load_x1000 = (uint32_t)(((uint64_t)cycles * 2 * 32000 * 1000) /
+                                     ((uint64_t)BENCH_SAMPLES * sysclk));  // % x10
+
+    printf("  %-24s %5lu.%02lu cyc/sample | CPU @2x32kHz: %lu.%lu%%\r\n",
+           name, cyc_x100 / 100, cyc_x100 % 100, load_x1000 / 10, load_x1000 % 10);
+}
+
+/**
+ * @brief Run the output DSP chain over BENCH_SAMPLES in render blocks
+ * @param pcm_in Test signal (16-bit offset-binary)
+ * @param enable AUDIO_DSP_EN_xxx stages to measure
+ * @return Total cycles (block processing only)
+ */
+static uint32_t bench_dsp(const uint16_t *pcm_in, uint8_t enable)
+{
+    static AudioDsp_t dsp;
+    static int32_t work[AUDIO_BLOCK_SIZE];
+
+    // 8 kHz low-pass (RBJ, Q = 0.707) in every stage - typical coefficients
+    const AudioBiquad_t lp = {
+        .b0 = (int32_t)(0.29289322 * AUDIO_DSP_Q30_ONE),
+        .b1 = (int32_t)(0.58578644 * AUDIO_DSP_Q30_ONE),
+        .b2 = (int32_t)(0.29289322 * AUDIO_DSP_Q30_ONE),
+        .a1 = 0,
+        .a2 = (int32_t)(0.17157288 * AUDIO_DSP_Q30_ONE),
+    };
+
+    audio_dsp_init(&dsp);
+    for (uint8_t s = 0; s < AUDIO_DSP_MAX_BIQUADS; s++)
+    {
+        audio_dsp_set_biquad(&dsp, s, &lp);
+    }
+    audio_dsp_set_eq_stages(&dsp, AUDIO_DSP_MAX_BIQUADS);
+    audio_dsp_set_limiter(&dsp, 16000, AUDIO_DSP_RELEASE_DEFAULT);  // Limiter active on peaks
+    audio_dsp_set_enable(&dsp, enable);
+
+    uint32_t cycles = 0;
+    uint32_t irq_state = __get_PRIMASK();
+    __disable_irq();
+
+    for (int blk = 0; blk < BENCH_SAMPLES; blk += AUDIO_BLOCK_SIZE)
+    {
+        for (int i = 0; i < AUDIO_BLOCK_SIZE; i++)
+        {
+            work[i] = (int16_t)(pcm_in[blk + i] ^ 0x8000);
+        }
+
+        uint32_t t0 = DWT->CYCCNT;
+        audio_dsp_process(&dsp, work, AUDIO_BLOCK_SIZE);
+        cycles += DWT->CYCCNT - t0;
+    }
+
+    if (!irq_state)
+    {
+        __enable_irq();
+    }
+
+    return cycles;
+}
+
+/**
+ * @brief Render BENCH_SAMPLES in 32-sample blocks
+ * @param pcm_in Test signal (16-bit offset-binary)
+ * @param dither AUDIO_DITHER_xxx
+ * @param oversample 1, 2 or 4
+ * @return Total cycles (render only, per 32kHz input sample count)
+ * @note  Uses the DAC1 staging buffers (test menu only, not while streaming)
+ */
+static uint32_t bench_render(uint16_t *pcm_in, uint8_t dither, uint8_t oversample)
+{
+    static AudioChannel_t ch;
+    static uint16_t out[AUDIO_BLOCK_SIZE * AUDIO_OVERSAMPLE_MAX];
+
+    audio_channel_init(&ch, dac1_buffer_a, dac1_buffer_b);
+    for (int n = 0; n < AUDIO_BUFFER_SIZE; n += BENCH_SAMPLES)
+    {
+        audio_channel_fill(&ch, pcm_in, BENCH_SAMPLES);
+    }
+    audio_channel_swap_buffers(&ch);
+
+    // Unity gain (no ramp) so only the quantizer differs between modes
+    audio_channel_set_fade_time(&ch, 0);
+    audio_channel_fade_in(&ch);
+    audio_channel_set_dither(&ch, dither);
+    audio_channel_set_oversample(&ch, oversample);
+
+    uint32_t irq_state = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t t0 = DWT->CYCCNT;
+    for (int blk = 0; blk < BENCH_SAMPLES; blk += AUDIO_BLOCK_SIZE)
+    {
+        audio_channel_render(&ch, out, AUDIO_BLOCK_SIZE);
+    }
+    uint32_t cycles = DWT->CYCCNT - t0;
+
+    if (!irq_state)
+    {
+        __enable_irq();
+    }
+
+    return cycles;
+}
+
+/**
+ * @brief Worst render block, ICACHE warm vs. invalidated before each block
+ * @param pcm_in Test signal (16-bit offset-binary)
+ * @param cold 1 = invalidate ICACHE before each block (flash fetch worst case)
+ * @return Maximum cycles of one AUDIO_BLOCK_SIZE render (TPDF + NS2, 4x)
+ * @note  Hot path code in SRAM (hot_path.h) is not affected by the invalidate,
+ *        remaining spread comes from HAL / const tables in flash
+ */
+static uint32_t bench_render_worst(uint16_t *pcm_in, uint8_t cold)
+{
+    static AudioChannel_t ch;
+    static uint16_t out[AUDIO_BLOCK_SIZE * AUDIO_OVERSAMPLE_MAX];
+    uint32_t worst = 0;
+
+    audio_channel_init(&ch, dac1_buffer_a, dac1_buffer_b);
+    for (int n = 0; n < AUDIO_BUFFER_SIZE; n += BENCH_SAMPLES)
+    {
+        audio_channel_fill(&ch, pcm_in, BENCH_SAMPLES);
+    }
+    audio_channel_swap_buffers(&ch);
+
+    audio_channel_set_fade_time(&ch, 0);
+    audio_channel_fade_in(&ch);
+    audio_channel_set_dither(&ch, AUDIO_DITHER_NS2);
+    audio_channel_set_oversample(&ch, 4);
+
+    uint32_t irq_state = __get_PRIMASK();
+    __disable_irq();
+
+    for (int blk = 0; blk < BENCH_SAMPLES; blk += AUDIO_BLOCK_SIZE)
+    {
+        if (cold)
+        {
+            HAL_ICACHE_Invalidate();
+        }
+
+        uint32_t t0 = DWT->CYCCNT;
+        audio_channel_render(&ch, out, AUDIO_BLOCK_SIZE);
+        uint32_t cycles = DWT->CYCCNT - t0;
+
+        if (cycles > worst)
+        {
+            worst = cycles;
+        }
+    }
+
+    if (!irq_state)
+    {
+        __enable_irq();
+    }
+
+    return worst;
+}
+
+/**
+ * @brief audio_channel_fill_adpcm() loop built into flash (.text) for the
+ *        placement comparison
+ * @note  Same loop and inline kernel as the SRAM copy in audio_channel.c,
+ *        without the claim / commit bookkeeping (static there)
+ */
+static __attribute__((noinline)) uint16_t bench_fill_adpcm_flash(AdpcmState_t *st, const uint8_t *data,
+                                                                 uint16_t count, int16_t *dst)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint8_t byte = data[i >> 1];
+        uint8_t code = (i & 1) ? (byte >> 4) : (byte & 0x0F);
+
+        dst[i] = adpcm_decode_sample(st, code);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Worst ADPCM packet fill block, SRAM (hot path) vs. flash copy
+ * @param adpcm ADPCM payload of BENCH_SAMPLES samples
+ * @param flash 1 = bench_fill_adpcm_flash(), 0 = audio_channel_fill_adpcm() (SRAM)
+ * @param cold 1 = invalidate ICACHE before each block (flash fetch worst case)
+ * @return Maximum cycles of one AUDIO_BLOCK_SIZE fill
+ */
+static uint32_t bench_fill_adpcm_worst(const uint8_t *adpcm, uint8_t flash, uint8_t cold)
+{
+    static AudioChannel_t ch;
+    AdpcmState_t st;
+    uint32_t worst = 0;
+
+    // BENCH_SAMPLES fit in the fill buffer - every block is decoded
+    audio_channel_init(&ch, dac1_buffer_a, dac1_buffer_b);
+    adpcm_init(&st);
+
+    uint32_t irq_state = __get_PRIMASK();
+    __disable_irq();
+
+    for (int blk = 0; blk < BENCH_SAMPLES; blk += AUDIO_BLOCK_SIZE)
+    {
+        const uint8_t *in = &adpcm[ADPCM_PAYLOAD_BYTES(blk)];
+
+        if (cold)
+        {
+            HAL_ICACHE_Invalidate();
+        }
+
+        uint32_t t0 = DWT->CYCCNT;
+        if (flash)
+        {
+            bench_fill_adpcm_flash(&st, in, AUDIO_BLOCK_SIZE, &dac1_buffer_b[blk]);
+        }
+        else
+        {
+            audio_channel_fill_adpcm(&ch, &st, in, AUDIO_BLOCK_SIZE);
+        }
+        uint32_t cycles = DWT->CYCCNT - t0;
+
+        if (cycles > worst)
+        {
+            worst = cycles;
+        }
+    }
+
+    if (!irq_state)
+    {
+        __enable_irq();
+    }
+
+    return worst;
+}
+
+/**
+ * @brief Run the voice mixer over BENCH_SAMPLES in render blocks
+ * @param pcm_in Test signal (16-bit offset-binary, also used as the clip)
+ * @param voices Number of mixed voices (0~AUDIO_MIX_VOICES)
+ * @param kind AUDIO_MIX_CLIP (looped clip) or AUDIO_MIX_GEN (sine)
+ * @return Total cycles (mixer stage only)
+ * @note  Re-initializes the clip cache (test menu only, slave mode starts empty)
+ */
+static uint32_t bench_mix(const uint16_t *pcm_in, uint8_t voices, uint8_t kind)
+{
+    static AudioMixer_t mix;
+    static AudioGen_t gen;
+    static int16_t src[AUDIO_BLOCK_SIZE];
+    static int16_t out[AUDIO_BLOCK_SIZE];
+
+    // Wire format is 16-bit LE - the test signal can be stored as is
+    clip_cache_init();
+    clip_cache_write(0, SAMPLE_FORMAT_16BIT, BENCH_SAMPLES, 0, (const uint8_t *)pcm_in, BENCH_SAMPLES);
+    audio_gen_init(&gen, 1);
+
+    audio_mixer_init(&mix);
+    for (uint8_t v = 0; v < voices; v++)
+    {
+        if (kind == AUDIO_MIX_GEN)
+        {
+            audio_mixer_add_gen(&mix, &gen, AUDIO_GEN_SINE, 50);
+        }
+        else
+        {
+            audio_mixer_add_clip(&mix, 0, 1, 50);
+        }
+    }
+
+    for (int i = 0; i < AUDIO_BLOCK_SIZE; i++)
+    {
+        src[i] = (int16_t)(pcm_in[i] ^ 0x8000);
+    }
+
+    // First block ramps the voices in - measure steady state only
+    audio_mixer_process(&mix, src, out, AUDIO_BLOCK_SIZE);
+
+    uint32_t irq_state = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t t0 = DWT->CYCCNT;
+    for (int blk = 0; blk < BENCH_SAMPLES; blk += AUDIO_BLOCK_SIZE)
+    {
+        audio_mixer_process(&mix, src, out, AUDIO_BLOCK_SIZE);
+    }
+    uint32_t cycles = DWT->CYCCNT - t0;
+
+    if (!irq_state)
+    {
+        __enable_irq();
+    }
+
+    return cycles;
+}
+
+// Test 7: Kernel benchmark (cycles per sample)
+// One section per step; the next one starts when the console output has
+// mostly drained, so the report never overruns the UART3 TX queue
+static ConsoleStatus_t test_kernel_benchmark(ConsoleJob_t *job)
+{
+    static uint16_t pcm_in[BENCH_SAMPLES];
+    static uint8_t adpcm_buf[ADPCM_PAYLOAD_BYTES(BENCH_SAMPLES)];
+    static AudioChannel_t ch;
+
+    if (job->abort)
+    {
+        printf("\r\n[EXIT] Benchmark stopped by user\r\n");
+        return CONSOLE_DONE;
+    }
+
+    if (job->step != 0 && Len_queue(&tx_UART3_queue) > (tx_UART3_queue.buf_size / 4))
+    {
+        return CONSOLE_BUSY;
+    }
+
+    switch (job->step++)
+    {
+        case 0:
+        {
+            // Kernels run on the DAC1 A/B buffers and the clip cache, with
+            // IRQs masked (up to a few ms each)
+            if (!test_hw_free())
+            {
+                return CONSOLE_DONE;
+            }
+
+            printf("\r\n=== Kernel Benchmark (DWT cycles, %d samples) ===\r\n", BENCH_SAMPLES);
+            printf("SYSCLK: %lu MHz\r\n\r\n", HAL_RCC_GetSysClockFreq() / 1000000);
+
+            bench_cycle_counter_init();
+
+            // Test signal: 1kHz sine @ 32kHz (16-bit offset-binary)
+            for (int i = 0; i < BENCH_SAMPLES; i++)
+            {
+                pcm_in[i] = (uint16_t)(sine_table[(i * SINE_TABLE_SIZE / 32) % SINE_TABLE_SIZE] << 4);
+            }
+
+            // ADPCM fill target (fill buffer empty, nothing published)
+            audio_channel_init(&ch, dac1_buffer_a, dac1_buffer_b);
+
+            uint32_t irq_state = __get_PRIMASK();
+            __disable_irq();
+
+            // IMA-ADPCM encode (host-side reference, for comparison only)
+            AdpcmState_t enc;
+            adpcm_init(&enc);
+            uint32_t t0 = DWT->CYCCNT;
+            adpcm_encode(&enc, pcm_in, BENCH_SAMPLES, adpcm_buf);
+            uint32_t enc_cycles = DWT->CYCCNT - t0;
+
+            // IMA-ADPCM decode in the fill path (packet payload -> fill buffer)
+            AdpcmState_t dec;
+            adpcm_init(&dec);
+            t0 = DWT->CYCCNT;
+            uint16_t filled = audio_channel_fill_adpcm(&ch, &dec, adpcm_buf, BENCH_SAMPLES);
+            uint32_t dec_cycles = DWT->CYCCNT - t0;
+
+            if (!irq_state)
+            {
+                __enable_irq();
+            }
+
+            // Round-trip error (sanity check of the codec pair, fill buffer = slot 1)
+            const int16_t *pcm_out = audio_channel_slot(&ch, 1);
+            uint32_t max_err = 0;
+            for (int i = 0; i < filled; i++)
+            {
+                int32_t err = (int32_t)pcm_out[i] - (int16_t)(pcm_in[i] ^ 0x8000);
+                if (err < 0) err = -err;
+                if ((uint32_t)err > max_err) max_err = (uint32_t)err;
+            }
+
+            bench_report("adpcm_encode", enc_cycles);
+            bench_report("fill_adpcm (decode)", dec_cycles);
+            printf("  ADPCM round-trip max error: %lu LSB (16-bit)\r\n", max_err);
+            return CONSOLE_BUSY;
+        }
+
+        case 1:
+            // Output DSP chain (per render block, all stages enabled)
+            printf("\r\n");
+            bench_report("dsp_eq (4 biquads)", bench_dsp(pcm_in, AUDIO_DSP_EN_EQ));
+            bench_report("dsp_dc_block", bench_dsp(pcm_in, AUDIO_DSP_EN_DC));
+            bench_report("dsp_limiter", bench_dsp(pcm_in, AUDIO_DSP_EN_LIMIT));
+            bench_report("dsp_chain (all)", bench_dsp(pcm_in, AUDIO_DSP_EN_MASK));
+            return CONSOLE_BUSY;
+
+        case 2:
+            // Render (gain + 16 -> 12-bit quantizer), per dither mode
+            printf("\r\n");
+            bench_report("render (truncate)", bench_render(pcm_in, AUDIO_DITHER_OFF, 1));
+            bench_report("render (TPDF)", bench_render(pcm_in, AUDIO_DITHER_TPDF, 1));
+            bench_report("render (TPDF + NS1)", bench_render(pcm_in, AUDIO_DITHER_NS1, 1));
+            bench_report("render (TPDF + NS2)", bench_render(pcm_in, AUDIO_DITHER_NS2, 1));
+            return CONSOLE_BUSY;
+
+        case 3:
+        {
+            // Oversampling (upsampler + quantizer at 64/128 kHz)
+            printf("\r\n");
+            bench_report("render 2x (truncate)", bench_render(pcm_in, AUDIO_DITHER_OFF, 2));
+            bench_report("render 4x (truncate)", bench_render(pcm_in, AUDIO_DITHER_OFF, 4));
+            bench_report("render 4x (TPDF + NS2)", bench_render(pcm_in, AUDIO_DITHER_NS2, 4));
+
+            // Worst block (4x + NS2), hot path placement vs. ICACHE misses
+            uint32_t worst_warm = bench_render_worst(pcm_in, 0);
+            uint32_t worst_cold = bench_render_worst(pcm_in, 1);
+            printf("  %-24s %5lu cyc/block | ICACHE cold: %lu cyc/block (%s)\r\n",
+                   "render worst block", worst_warm, worst_cold,
+                   hot_path_in_sram((const void *)audio_channel_render) ? "SRAM" : "FLASH");
+
+            // ADPCM packet fill from SRAM and from flash (code placement only,
+            // the step / index tables are in flash for both)
+            printf("  %-24s SRAM %lu / %lu | FLASH %lu / %lu cyc/block (warm / ICACHE cold)\r\n",
+                   "fill_adpcm worst",
+                   bench_fill_adpcm_worst(adpcm_buf, 0, 0), bench_fill_adpcm_worst(adpcm_buf, 0, 1),
+                   bench_fill_adpcm_worst(adpcm_buf, 1, 0), bench_fill_adpcm_worst(adpcm_buf, 1, 1));
+            return CONSOLE_BUSY;
+        }
+
+        default:
+        {
+            // Voice mixer (stream + N voices), cost per added voice
+            printf("\r\n");
+            uint32_t mix0 = bench_mix(pcm_in, 0, AUDIO_MIX_CLIP);
+            uint32_t mix_clip = bench_mix(pcm_in, AUDIO_MIX_VOICES, AUDIO_MIX_CLIP);
+            uint32_t mix_gen = bench_mix(pcm_in, AUDIO_MIX_VOICES, AUDIO_MIX_GEN);
+            bench_report("mixer (0 voices)", mix0);
+            bench_report("mixer (4 clip voices)", mix_clip);
+            bench_report("mixer (4 sine voices)", mix_gen);
+            bench_report("  per clip voice", (mix_clip - mix0) / AUDIO_MIX_VOICES);
+            bench_report("  per sine voice", (mix_gen - mix0) / AUDIO_MIX_VOICES);
+
+            printf("\r\nBenchmark completed.\r\n");
+            return CONSOLE_DONE;
+        }
+    }
+}
+
+// ============================================================================
+// Test Menu System
+// ============================================================================
+
+/**
+ * @brief Print queue depth statistics of one channel (ms @ 32kHz)
+ */
+static void print_jitter(AudioChannel_t *ch)
+{
+    AudioJitterReport_t rep;
+    uint32_t per_ms = AUDIO_SAMPLE_RATE / 1000;
+
+    audio_jitter_report(&ch->jitter, &rep);
+    if (rep.events == 0)
+    {
+        return;
+    }
+
+    printf("  Depth ms: min %lu | p1 %lu | p5 %lu | p50 %lu | p95 %lu | max %lu (target %lu)\r\n",
+           rep.min / per_ms, rep.p1 / per_ms, rep.p5 / per_ms, rep.p50 / per_ms,
+           rep.p95 / per_ms, rep.max / per_ms, ch->jitter.target / per_ms);
+    printf("  Below %lu ms: %lu ms of %lu ms\r\n",
+           ch->jitter.low / per_ms, rep.below_ms, rep.events);
+}
+
+// ============================================================================
+// Slave Mode Functions
+// ============================================================================
+//
+// run_slave_mode() initializes the audio path and adds the slave tasks to
+// the scheduler; it returns right away and streaming keeps running while
+// the console runs commands and tests (main loop: run_test_menu()).
+
+#define SLAVE_EV_STATUS     (1U << 0)   // Print STATUS now ('status' command)
+
+static uint8_t g_slave_running = 0;
+static SchedTask_t g_task_status = -1;  // STATUS text (10s / SLAVE_EV_STATUS)
+static SchedTask_t g_task_led = -1;     // Alive LED (1s menu, 500ms slave)
+
+static void slave_poll_task(uint32_t events)
+{
+    (void)events;
+
+    // Packets from the UART1 link (same path as SPI)
+    uart_link_poll();
+
+    // Telemetry frame (when due) goes out with the printf queue
+    telemetry_poll(HAL_GetTick());
+}
+
+static void slave_probe_task(uint32_t events)
+{
+    (void)events;
+
+    // EXTI15 entry probe (measurement mode, once per ms)
+    if (g_irq_lat_enabled)
+    {
+        irq_lat_probe();
+    }
+}
+
+static void slave_status_task(uint32_t events)
+{
+    // Bus timing since the last status (one window per status). Rolled
+    // before the telemetry check, so the window never grows unbounded
+    SpiTimingWindow_t spi_win;
+    spi_timing_roll(&spi_win);
+
+    // Every 10 seconds (reduced frequency to avoid blocking SPI), or on request
+    // Telemetry frames carry the same counters while enabled
+    if (!(events & SLAVE_EV_STATUS) && telemetry_get_rate() != 0)
+    {
+        return;
+    }
+
+    // Get statistics
+    uint32_t dac1_samples, dac1_swaps, dac1_underruns;
+    uint32_t dac2_samples, dac2_swaps, dac2_underruns;
+    uint32_t dac1_gap, dac1_gap_max, dac2_gap, dac2_gap_max;
+
+    audio_channel_get_stats(&g_dac1_channel, &dac1_samples, &dac1_swaps, &dac1_underruns);
+    audio_channel_get_stats(&g_dac2_channel, &dac2_samples, &dac2_swaps, &dac2_underruns);
+
+    SPI_ErrorStats_t spi_errors;
+    spi_handler_get_errors(&spi_errors);
+
+    printf("\r\n[STATUS] --------------------\r\n");
+    printf("DAC1: %s | Samples: %lu | Swaps: %lu | Underruns: %lu\r\n",
+           g_dac1_channel.is_playing ? "PLAY" : "STOP",
+           dac1_samples, dac1_swaps, dac1_underruns);
+    printf("  DMA IRQ: HalfCplt=%lu | Cplt=%lu\r\n",
+           g_dac1_half_cplt_count, g_dac1_cplt_count);
+    audio_channel_get_underrun(&g_dac1_channel, &dac1_gap, &dac1_gap_max);
+    printf("  Underrun: %lu samples concealed | longest %lu\r\n", dac1_gap, dac1_gap_max);
+    print_jitter(&g_dac1_channel);
+    printf("DAC2: %s | Samples: %lu | Swaps: %lu | Underruns: %lu\r\n",
+           g_dac2_channel.is_playing ? "PLAY" : "STOP",
+           dac2_samples, dac2_swaps, dac2_underruns);
+    printf("  DMA IRQ: HalfCplt=%lu | Cplt=%lu\r\n",
+           g_dac2_half_cplt_count, g_dac2_cplt_count);
+    audio_channel_get_underrun(&g_dac2_channel, &dac2_gap, &dac2_gap_max);
+    printf("  Underrun: %lu samples concealed | longest %lu\r\n", dac2_gap, dac2_gap_max);
+    print_jitter(&g_dac2_channel);
+    printf("SPI:  CS_Fall: %lu | CS_Rise: %lu\r\n",
+           spi_errors.cs_falling_count,
+           spi_errors.cs_rising_count);
+    printf("      CMD: %lu | DATA: %lu | Errors: %lu\r\n",
+           spi_errors.cmd_packet_count,
+           spi_errors.data_packet_count,
+           spi_errors.spi_error_count);
+    printf("      Last RX: %lu bytes | DMA Fail: %lu\r\n",
+           spi_errors.last_received_bytes,
+           spi_errors.dma_start_fail_count);
+    printf("      SPI State: 0x%02X | Last Fail State: 0x%02lX\r\n",
+           (unsigned int)hspi1.State,
+           spi_errors.last_spi_state);
+    UartLinkStats_t link;
+    uart_link_get_stats(&link);
+    printf("UART1: %lu bytes | Frames: %lu | Bad: %lu | Oversize: %lu | Overrun: %lu | Err: %lu\r\n",
+           link.bytes, link.frames, link.bad_frames, link.oversize,
+           link.ring_overruns, link.uart_errors);
+    printf("UART3: %lu baud | RX ring overruns: %lu\r\n",
+           huart3.Init.BaudRate, UART3_RX_Get_Overruns());
+    const CacheMaintStats_t *cm = cache_maint_get_stats();
+    printf("      Cache: inval %lu | clean %lu | lines %lu | misaligned %lu | err %lu\r\n",
+           cm->invalidate_count, cm->clean_count, cm->line_count,
+           cm->misaligned_count, cm->error_count);
+    printf("      Clock: %lu ticks | PLAY_AT missed: %lu | Stereo: %s\r\n",
+           audio_output_now(),
+           spi_errors.schedule_miss_count,
+           audio_output_is_stereo_locked() ? "LOCKED" : "INDEP");
+
+    spi_timing_report(&spi_win);
+
+    if (g_irq_lat_enabled)
+    {
+        static const char *const lat_names[IRQ_LAT_COUNT] = { "DAC1", "DAC2", "CS" };
+        uint32_t cyc_per_us = SystemCoreClock / 1000000U;
+
+        for (uint32_t i = 0; i < IRQ_LAT_COUNT; i++)
+        {
+            const IrqLatStats_t *lat = irq_lat_get((IrqLatId_t)i);
+            printf("IRQ %-4s: n %lu | entry max %lu cyc (%lu us) | run max %lu cyc (%lu us)\r\n",
+                   lat_names[i], lat->count,
+                   lat->entry_max, lat->entry_max / cyc_per_us,
+                   lat->run_max, lat->run_max / cyc_per_us);
+        }
+        printf("          audio_lock max %lu cyc\r\n", g_audio_lock_max);
+    }
+
+    // Show last received packet
+    uint8_t last_pkt[5];
+    if (spi_handler_get_last_packet(last_pkt))
+    {
+        printf("LAST_RX: %02X %02X %02X %02X %02X\r\n",
+               last_pkt[0], last_pkt[1], last_pkt[2], last_pkt[3], last_pkt[4]);
+    }
+
+    printf("----------------------------\r\n");
+}
+
+uint8_t slave_mode_running(void)
+{
+    return g_slave_running;
+}
+
+/**
+ * @brief Initialize and run slave mode
+ * @note This is the main application mode for audio streaming
+ */
+void run_slave_mode(void)
+{
+    if (g_slave_running)
+    {
+        printf("[SLAVE] Already running\r\n");
+        return;
+    }
 
-/**
- * @brief Initialize and run slave mode
- * @note This is the main application mode for audio streaming
- */
-void run_slave_mode(void)
-{
     printf("\r\n");
     printf("========================================\r\n");
     printf("  STM32H523 Slave MCU - Audio Streaming\r\n");
@@ -953,10 +1504,27 @@ void run_slave_mode(void)
     audio_channel_init(&g_dac2_channel, dac2_buffer_a, dac2_buffer_b);
     printf("[INIT] Audio channels initialized\r\n");
 
+    // Initialize output control (TIM2 sample clock for scheduled start)
+    audio_output_init(&g_dac1_channel, &g_dac2_channel);
+    printf("[INIT] Sample clock (TIM2) started\r\n");
+
+    // Clip cache (empty until 0xCC uploads)
+    clip_cache_init();
+    printf("[INIT] Clip cache: %d slots, %lu samples free\r\n", CLIP_SLOT_COUNT, clip_cache_free());
+
     // Initialize SPI handler
     spi_handler_init(&hspi1, &g_dac1_channel, &g_dac2_channel);
     printf("[INIT] SPI handler initialized\r\n");
 
+    // Binary status frames (off until 't')
+    telemetry_init(&g_dac1_channel, &g_dac2_channel);
+
+    // Same packets over UART1 (bench streaming from a PC)
+    uart_link_init();
+
+    // Final DMA memory plan (A/B buffers, output rings, SPI RX, UART RX/TX)
+    dma_arena_report();
+
     // Note: EXTI for PA15 (CS pin) is already configured by CubeMX
     // No need to call spi_handler_init_nss_exti() anymore
 
@@ -964,304 +1532,267 @@ void run_slave_mode(void)
     spi_handler_start();
     printf("[INIT] SPI reception started\r\n");
 
+    // Main loop work as scheduler tasks (runs next to the console)
+    sched_add("slave", slave_poll_task, 0);
+    sched_add("irq_probe", slave_probe_task, 1);
+    g_task_status = sched_add("status", slave_status_task, 10000);
+    sched_set_period(g_task_led, 500);
+    g_slave_running = 1;
+
     printf("\r\n** Slave ready - waiting for Master commands **\r\n");
-    printf("** Press ESC or 'q' to exit to menu **\r\n\r\n");
+    printf("** Console stays available: 'status', 'telem [hz]', 'lat', 'jclr', 'tasks' **\r\n\r\n");
+}
 
-    // Main loop - monitor status
-    uint32_t last_status_tick = 0;
-    uint32_t led_toggle_tick = 0;
+// ============================================================================
+// Test Menu System
+// ============================================================================
 
-    while(1)
+// 0: Start slave mode (tasks keep streaming, the console stays usable)
+static ConsoleStatus_t menu_slave_mode(ConsoleJob_t *job)
+{
+    (void)job;
+    run_slave_mode();
+    return CONSOLE_DONE;
+}
+
+static uint8_t menu_slave_check(void)
+{
+    if (!g_slave_running)
+    {
+        printf("Slave mode not running ('0' starts it)\r\n");
+        return 0;
+    }
+    return 1;
+}
+
+// status: STATUS block now (also while telemetry replaces it)
+static ConsoleStatus_t menu_status(ConsoleJob_t *job)
+{
+    (void)job;
+    if (menu_slave_check())
     {
-        uint32_t now = HAL_GetTick();
+        sched_signal(g_task_status, SLAVE_EV_STATUS);
+    }
+    return CONSOLE_DONE;
+}
+
+// telem: set rate, or step off / 1 / 10 / 100 Hz without argument
+static ConsoleStatus_t menu_telem(ConsoleJob_t *job)
+{
+    static const uint8_t rates[] = { 0, 1, 10, 100 };
+    uint32_t next = 0;
 
-        // Process TX queue for non-blocking printf (DMA-based)
-        UART3_Process_TX_Queue();
+    if (!menu_slave_check())
+    {
+        return CONSOLE_DONE;
+    }
 
-        // ESC 또는 'q' 키 입력 체크
-        if (Len_queue(&rx_UART3_queue) > 0)
+    if (job->argc != 0)
+    {
+        next = job->argv[0].u;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < sizeof(rates); i++)
         {
-            uint8_t key = Dequeue(&rx_UART3_queue);
-            if (key == 0x1B || key == 'q' || key == 'Q')
+            if (rates[i] == telemetry_get_rate())
             {
-                printf("\r\n[EXIT] Slave Mode stopped by user\r\n");
-                return;
+                next = rates[(i + 1) % sizeof(rates)];
             }
         }
+    }
+
+    if (next > 255 || telemetry_set_rate((uint8_t)next) != 0)
+    {
+        printf("[TELEM] %lu Hz out of range (max %d)\r\n", next, TELEMETRY_MAX_HZ);
+    }
+    printf("[TELEM] %u Hz (dropped %lu)\r\n", telemetry_get_rate(), telemetry_get_dropped());
+    return CONSOLE_DONE;
+}
 
-        // Toggle LED to show alive
-        if ((now - led_toggle_tick) >= 500)
+// baud: console baud rate (terminal must follow). The notice is sent at
+// the old rate first, RX bytes not yet read are dropped by the switch
+static ConsoleStatus_t menu_baud(ConsoleJob_t *job)
+{
+    uint32_t rate = job->argv[0].u;
+
+    if (job->step == 0)
+    {
+        // USART3 kernel clock = PCLK1, 16x oversampling
+        uint32_t max = HAL_RCC_GetPCLK1Freq() / 16U;
+
+        if (rate < 1200 || rate > max)
         {
-            led_toggle_tick = now;
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
+            printf("[BAUD] %lu out of range (1200 ~ %lu)\r\n", rate, max);
+            return CONSOLE_DONE;
         }
 
-        // Print status every 10 seconds (reduced frequency to avoid blocking SPI)
-        if ((now - last_status_tick) >= 10000)
-        {
-            last_status_tick = now;
-
-            // Get statistics
-            uint32_t dac1_samples, dac1_swaps, dac1_underruns;
-            uint32_t dac2_samples, dac2_swaps, dac2_underruns;
-
-            audio_channel_get_stats(&g_dac1_channel, &dac1_samples, &dac1_swaps, &dac1_underruns);
-            audio_channel_get_stats(&g_dac2_channel, &dac2_samples, &dac2_swaps, &dac2_underruns);
-
-            SPI_ErrorStats_t spi_errors;
-            spi_handler_get_errors(&spi_errors);
-
-            printf("\r\n[STATUS] --------------------\r\n");
-            printf("DAC1: %s | Samples: %lu | Swaps: %lu | Underruns: %lu\r\n",
-                   g_dac1_channel.is_playing ? "PLAY" : "STOP",
-                   dac1_samples, dac1_swaps, dac1_underruns);
-            printf("  DMA IRQ: HalfCplt=%lu | Cplt=%lu\r\n",
-                   g_dac1_half_cplt_count, g_dac1_cplt_count);
-            printf("DAC2: %s | Samples: %lu | Swaps: %lu | Underruns: %lu\r\n",
-                   g_dac2_channel.is_playing ? "PLAY" : "STOP",
-                   dac2_samples, dac2_swaps, dac2_underruns);
-            printf("  DMA IRQ: HalfCplt=%lu | Cplt=%lu\r\n",
-                   g_dac2_half_cplt_count, g_dac2_cplt_count);
-            printf("SPI:  CS_Fall: %lu | CS_Rise: %lu\r\n",
-                   spi_errors.cs_falling_count,
-                   spi_errors.cs_rising_count);
-            printf("      CMD: %lu | DATA: %lu | Errors: %lu\r\n",
-                   spi_errors.cmd_packet_count,
-                   spi_errors.data_packet_count,
-                   spi_errors.spi_error_count);
-            printf("      Last RX: %lu bytes | DMA Fail: %lu\r\n",
-                   spi_errors.last_received_bytes,
-                   spi_errors.dma_start_fail_count);
-            printf("      SPI State: 0x%02X | Last Fail State: 0x%02lX\r\n",
-                   (unsigned int)hspi1.State,
-                   spi_errors.last_spi_state);
-
-            // Show last received packet
-            uint8_t last_pkt[5];
-            if (spi_handler_get_last_packet(last_pkt))
-            {
-                printf("LAST_RX: %02X %02X %02X %02X %02X\r\n",
-                       last_pkt[0], last_pkt[1], last_pkt[2], last_pkt[3], last_pkt[4]);
-            }
+        printf("[BAUD] %lu -> %lu baud, switch the terminal\r\n", huart3.Init.BaudRate, rate);
+        job->tick = HAL_GetTick();
+        job->step = 1;
+        return CONSOLE_BUSY;
+    }
 
-            printf("----------------------------\r\n");
-        }
+    // uart3_tx_task drains the queue (UART3_Set_Baud() waits up to 1 s)
+    if (!UART3_TX_Idle() && (HAL_GetTick() - job->tick) < 1000)
+    {
+        return CONSOLE_BUSY;
+    }
 
-        // Low power mode (wake on interrupt)
-        // HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+    if (UART3_Set_Baud(rate) != 0)
+    {
+        printf("[BAUD] Failed, UART3 at %lu baud\r\n", huart3.Init.BaudRate);
     }
+    return CONSOLE_DONE;
 }
 
-// ============================================================================
-// Test Menu System
-// ============================================================================
+// lat: IRQ latency measurement on / off
+static ConsoleStatus_t menu_lat(ConsoleJob_t *job)
+{
+    (void)job;
+    irq_lat_enable(!g_irq_lat_enabled);
+    printf("[IRQ] Latency measurement %s\r\n", g_irq_lat_enabled ? "ON" : "OFF");
+    return CONSOLE_DONE;
+}
 
-void show_test_menu(void)
+// jclr: clear jitter statistics
+static ConsoleStatus_t menu_jclr(ConsoleJob_t *job)
 {
-    printf("\r\n");
-    printf("========================================\r\n");
-    printf("  STM32H523 Slave - Test Menu\r\n");
-    printf("========================================\r\n");
-    printf("0. Run Slave Mode (Main Application)\r\n");
-    printf("1. LED Blink Test\r\n");
-    printf("2. Siren Sound Test (DAC)\r\n");
-    printf("3. DAC Quick Test (1kHz, 5 sec)\r\n");
-    printf("4. RDY Pin Toggle Test\r\n");
-    printf("5. SPI Communication Test\r\n");
-    printf("6. DAC DMA Sine Wave Test (5 sec playback)\r\n");
-    printf("----------------------------------------\r\n");
-    printf("Select test (0-6): ");
+    (void)job;
+    if (menu_slave_check())
+    {
+        audio_jitter_clear(&g_dac1_channel.jitter);
+        audio_jitter_clear(&g_dac2_channel.jitter);
+        printf("[JITTER] Statistics cleared\r\n");
+    }
+    return CONSOLE_DONE;
 }
 
-void run_test_menu(void)
+// tasks: scheduler table (run counts, longest run, timer lateness)
+static ConsoleStatus_t menu_tasks(ConsoleJob_t *job)
 {
-    COM_Idy_Typ rcv_rtn_stat = NOT_LINE;
-    char rcv_cmd[20] = "";
-    uint32_t led_toggle = 0;
+    (void)job;
+    sched_report();
+    return CONSOLE_DONE;
+}
 
-    // 처음 한 번만 메뉴 출력
+static ConsoleStatus_t menu_help(ConsoleJob_t *job)
+{
+    (void)job;
     show_test_menu();
-    printf("\r\nType 'help' to show menu again.\r\n");
-    printf("Ready for commands...\r\n\r\n");
-
-    while(1)
-    {
-        // Process TX queue for non-blocking printf (DMA-based)
-        UART3_Process_TX_Queue();
-
-        // UART3 IDLE 인터럽트로 수신된 명령어 확인
-        rcv_rtn_stat = UART3_GetLine(uart3_stat_ST.rcv_line_buf);
+    return CONSOLE_DONE;
+}
 
-        if (rcv_rtn_stat == RCV_LINE)
-        {
-            // 수신된 명령어 파싱
-            printf("[DEBUG] Raw RX: '%s' (len=%d)\r\n", uart3_stat_ST.rcv_line_buf, strlen((char*)uart3_stat_ST.rcv_line_buf));
-            sscanf((char *)uart3_stat_ST.rcv_line_buf, "%s", rcv_cmd);
-            printf("[DEBUG] Parsed: '%s' (len=%d)\r\n", rcv_cmd, strlen(rcv_cmd));
+// stvc 명령어 - 속도 제어 (dev_num, dir, speed)
+static ConsoleStatus_t menu_stvc(ConsoleJob_t *job)
+{
+    printf("STVC command: dev=%lu, dir=%s, speed=%lu\r\n",
+           job->argv[0].u, job->argv[1].s, job->argv[2].u);
+    // TODO: 실제 속도 제어 로직 구현
+    return CONSOLE_DONE;
+}
 
-            // 빈 명령어 무시
-            if (strlen(rcv_cmd) == 0)
-            {
-                printf("[DEBUG] Empty command, skipping\r\n");
-                continue;
-            }
+// stst 명령어 - 강제 정지 (dev_num)
+static ConsoleStatus_t menu_stst(ConsoleJob_t *job)
+{
+    printf("STST command: dev=%lu (force stop)\r\n", job->argv[0].u);
+    // TODO: 실제 정지 로직 구현
+    return CONSOLE_DONE;
+}
 
-            // help 명령어 - 메뉴 재출력
-            if (strcmp(rcv_cmd, "help") == 0)
-            {
-                show_test_menu();
-                printf("\r\nReady for commands...\r\n\r\n");
-            }
-            // 테스트 명령어 (0-6)
-            else if (strlen(rcv_cmd) == 1 && rcv_cmd[0] >= '0' && rcv_cmd[0] <= '6')
-            {
-                printf("[DEBUG] Received command: '%c'\r\n", rcv_cmd[0]);
-                switch(rcv_cmd[0])
-                {
-                    case '0':
-                        printf("[CMD] 0: Run Slave Mode (Main Application)\r\n");
-                        run_slave_mode();
-                        break;
-
-                    case '1':
-                        printf("[CMD] 1: LED Blink Test\r\n");
-                        test_led_blink();
-                        break;
-
-                    case '2':
-                        printf("[CMD] 2: Siren Sound Test (DAC)\r\n");
-                        test_dac_sine_wave();
-                        break;
-
-                    case '3':
-                        printf("[CMD] 3: DAC Quick Test (1kHz, 5 sec)\r\n");
-                        test_dac_quick();
-                        break;
-
-                    case '4':
-                        printf("[CMD] 4: RDY Pin Toggle Test\r\n");
-                        test_rdy_pin();
-                        break;
-
-                    case '5':
-                        printf("[CMD] 5: SPI Communication Test\r\n");
-                        test_spi_communication();
-                        break;
-
-                    case '6':
-                        printf("[CMD] 6: DAC DMA Sine Wave Test\r\n");
-                        test_dac_dma_sine();
-                        break;
-                }
-
-                // 테스트 종료 후 안내 메시지
-                printf("\r\nTest completed. Type 'help' for menu.\r\n\r\n");
-            }
-            // stvc 명령어 - 속도 제어 (dev_num, dir, speed)
-            else if (strncmp(rcv_cmd, "stvc", 4) == 0)
-            {
-                char rcv_dummy_data[3][20];
-                uint8_t dev_num = 0;
-                int sc_rtn = sscanf((char *)&uart3_stat_ST.rcv_line_buf[5], "%s %s %s",
-                                    rcv_dummy_data[0], rcv_dummy_data[1], rcv_dummy_data[2]);
-                if (sc_rtn == 3)
-                {
-                    sscanf((char *)&uart3_stat_ST.rcv_line_buf[5], "%hhd", &dev_num);
-                    printf("STVC command: dev=%d, dir=%s, speed=%s\r\n",
-                           dev_num, rcv_dummy_data[1], rcv_dummy_data[2]);
-                    // TODO: 실제 속도 제어 로직 구현
-                }
-                else
-                {
-                    printf("Invalid STVC format. Usage: stvc <dev_num> <dir> <speed>\r\n");
-                }
-                printf("\r\n");
-            }
-            // stst 명령어 - 강제 정지 (dev_num)
-            else if (strncmp(rcv_cmd, "stst", 4) == 0)
-            {
-                char rcv_dummy_data[20];
-                uint8_t dev_num = 0;
-                int sc_rtn = sscanf((char *)&uart3_stat_ST.rcv_line_buf[5], "%s", rcv_dummy_data);
-                if (sc_rtn == 1)
-                {
-                    sscanf((char *)&uart3_stat_ST.rcv_line_buf[5], "%hhd", &dev_num);
-                    printf("STST command: dev=%d (force stop)\r\n", dev_num);
-                    // TODO: 실제 정지 로직 구현
-                }
-                else
-                {
-                    printf("Invalid STST format. Usage: stst <dev_num>\r\n");
-                }
-                printf("\r\n");
-            }
-            // 알 수 없는 명령어
-            else
-            {
-                printf("Unknown command: '%s'\r\n", rcv_cmd);
-                printf("Type 'help' to show available commands.\r\n\r\n");
-            }
+// Menu commands (console_register() sorts them, 'help' lists them)
+static const ConsoleCmd_t g_menu_cmds[] = {
+    { "0",     "",                           "Run Slave Mode (Main Application)",       menu_slave_mode },
+    { "1",     "",                           "LED Blink Test",                          test_led_blink },
+    { "2",     "",                           "Siren Sound Test (DAC)",                  test_dac_sine_wave },
+    { "3",     "",                           "DAC Quick Test (1kHz, 5 sec)",            test_dac_quick },
+    { "4",     "",                           "RDY Pin Toggle Test",                     test_rdy_pin },
+    { "5",     "",                           "SPI Communication Test",                  test_spi_communication },
+    { "6",     "",                           "DAC DMA Sine Wave Test (5 sec playback)", test_dac_dma_sine },
+    { "7",     "",                           "Kernel Benchmark (DWT cycles)",           test_kernel_benchmark },
+    { "baud",  "<rate:u>",                   "Console baud rate (set terminal too)",    menu_baud },
+    { "help",  "",                           "Show this menu",                          menu_help },
+    { "jclr",  "",                           "Clear jitter statistics (slave)",         menu_jclr },
+    { "lat",   "",                           "IRQ latency measurement on/off",          menu_lat },
+    { "status", "",                          "Print STATUS now (slave)",                menu_status },
+    { "stvc",  "<dev:u> <dir:s> <speed:u>",  "Speed control",                           menu_stvc },
+    { "stst",  "<dev:u>",                    "Force stop",                              menu_stst },
+    { "tasks", "",                           "Scheduler tasks (runs, max time)",        menu_tasks },
+    { "telem", "[hz:u]",                     "Telemetry rate (0/1/10/100, slave)",      menu_telem },
+};
 
-            // 명령어 버퍼 클리어
-            memset(rcv_cmd, 0, sizeof(rcv_cmd));
-        }
+void show_test_menu(void)
+{
+    printf("\r\n");
+    printf("========================================\r\n");
+    printf("  STM32H523 Slave - Test Menu\r\n");
+    printf("========================================\r\n");
+    console_help();
+    printf("----------------------------------------\r\n");
+    printf("TAB completes commands, ESC or 'q' stops a running test\r\n");
+}
 
-        // LED 토글 (시스템 동작 표시, 1초마다)
-        if ((HAL_GetTick() - led_toggle) >= 1000)
-        {
-            led_toggle = HAL_GetTick();
-            HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
-        }
+// Console: line input, one step of the running command
+static void console_task(uint32_t events)
+{
+    (void)events;
+    console_poll();
+}
 
-        // CPU 부하 감소를 위한 짧은 딜레이
-        // (IDLE 인터럽트가 동작하므로 명령어 수신에는 영향 없음)
-        HAL_Delay(10);
+// Alive LED (tests that drive the LEDs run as console jobs - skip then)
+static void led_task(uint32_t events)
+{
+    (void)events;
+    if (!console_busy())
+    {
+        HAL_GPIO_TogglePin(OT_LD_SYS_GPIO_Port, OT_LD_SYS_Pin);
     }
 }
 
-// ============================================================================
-// Legacy Functions
-// ============================================================================
-
+// Non-blocking printf (DMA-based TX queue)
+static void uart3_tx_task(uint32_t events)
+{
+    (void)events;
+    UART3_Process_TX_Queue();
+}
 
-void proc_uart3(void)
+void run_test_menu(void)
 {
-	COM_Idy_Typ rcv_rtn_stat = NOT_LINE;
-	char rcv_cmd[20]="";
-	char rcv_dummy_data[20]="";
-	uint8_t dev_num=0;
-	int sc_rtn;
+    console_init("> ");
+    console_register(g_menu_cmds, sizeof(g_menu_cmds) / sizeof(g_menu_cmds[0]));
 
-	rcv_rtn_stat = UART3_GetLine(uart3_stat_ST.rcv_line_buf);
+    sched_add("console", console_task, 0);
+    g_task_led = sched_add("led", led_task, g_slave_running ? 500 : 1000);
+    sched_add("uart3_tx", uart3_tx_task, 0);
 
-	if (rcv_rtn_stat == RCV_LINE)
-	{
-		printf_UARTC(&huart3,PR_YEL,"%s\r\n",(char *)uart3_stat_ST.rcv_line_buf);
-		sscanf((char *)uart3_stat_ST.rcv_line_buf,"%s",rcv_cmd);
-		printf_UARTC(&huart3,PR_YEL,"cmd : %s\r\n",rcv_cmd);
-
-		if (strncmp((char *)rcv_cmd,"stvc",4) == 0)	// 속도 제어 명령 (dev_num,dir,speed)
-		{
-			sc_rtn = sscanf((char *)&uart3_stat_ST.rcv_line_buf[5],"%s %s %s",rcv_dummy_data,rcv_dummy_data,rcv_dummy_data);
-			if (sc_rtn == 3)
-			{
-				sscanf((char *)&uart3_stat_ST.rcv_line_buf[5],"%hhd",&dev_num);
-			}
-		}
-		else if (strncmp((char *)rcv_cmd,"stst",4) == 0)	// 강제 정지 명령 (dev_num)
-		{
-			sc_rtn = sscanf((char *)&uart3_stat_ST.rcv_line_buf[5],"%s",rcv_dummy_data);
-			if (sc_rtn == 1)
-			{
-				sscanf((char *)&uart3_stat_ST.rcv_line_buf[5],"%hhd",&dev_num);
-			}
-		}
-	}
+    // 처음 한 번만 메뉴 출력
+    show_test_menu();
+    printf("\r\nType 'help' to show menu again.\r\n\r\n");
+    console_prompt();
+
+    // Main loop: everything runs as scheduler tasks
+    while(1)
+    {
+        sched_run();
+    }
 }
 
 void init_proc(void)
 {
 	init_UART_COM();
+
+    // Main loop tasks are added by run_slave_mode() / run_test_menu()
+    sched_init();
+
+    // NVIC 우선순위 계획 적용 (irq_prio.h)
+    irq_prio_apply();
+
+    // A/B buffers from the DMA arena (before any test uses them)
+    dac1_buffer_a = dma_arena_alloc(DMA_MEM_NONCACHED, AUDIO_BUFFER_SIZE * sizeof(int16_t), DMA_ARENA_LINE, "dac1_buffer_a");
+    dac1_buffer_b = dma_arena_alloc(DMA_MEM_NONCACHED, AUDIO_BUFFER_SIZE * sizeof(int16_t), DMA_ARENA_LINE, "dac1_buffer_b");
+    dac2_buffer_a = dma_arena_alloc(DMA_MEM_NONCACHED, AUDIO_BUFFER_SIZE * sizeof(int16_t), DMA_ARENA_LINE, "dac2_buffer_a");
+    dac2_buffer_b = dma_arena_alloc(DMA_MEM_NONCACHED, AUDIO_BUFFER_SIZE * sizeof(int16_t), DMA_ARENA_LINE, "dac2_buffer_b");
+
     // 사인파 룩업 테이블 초기화 (레거시 테스트용)
     init_sine_table();
 
@@ -1324,25 +1855,16 @@ void init_proc(void)
         printf("[DCACHE] ✗ DISABLED\r\n");
     }
 
-    // DMA 버퍼 주소 출력
-    printf("\r\n[DMA Buffer Addresses]\r\n");
-    printf("  dac1_buffer_a:        0x%08lX\r\n", (uint32_t)dac1_buffer_a);
-    printf("  dac1_buffer_b:        0x%08lX\r\n", (uint32_t)dac1_buffer_b);
-    printf("  dac2_buffer_a:        0x%08lX\r\n", (uint32_t)dac2_buffer_a);
-    printf("  dac2_buffer_b:        0x%08lX\r\n", (uint32_t)dac2_buffer_b);
-    printf("  g_rx_cmd_packet:      0x%08lX\r\n", spi_handler_get_rx_buffer_addr());
-    printf("  g_uart3_tx_dma_buf:   0x%08lX\r\n", UART3_Get_TX_Buffer_Addr());
-
-    // MPU 영역 확인
-    printf("\r\n[Verification]\r\n");
-    if ((uint32_t)dac1_buffer_a >= 0x2003C000 &&
-        (uint32_t)dac1_buffer_a < 0x20044000 &&
-        spi_handler_get_rx_buffer_addr() >= 0x2003C000 &&
-        spi_handler_get_rx_buffer_addr() < 0x20044000) {
-        printf("  ✓ All DMA buffers in MPU non-cacheable region\r\n");
-    } else {
-        printf("  ✗ ERROR: Buffers NOT in MPU region!\r\n");
-    }
+    // DMA 버퍼 배치 (arena 할당표 + MPU 영역 확인)
+    // SPI RX / output rings are added when slave mode initializes
+    dma_arena_report();
+    printf("  g_rx_cmd_packet:      0x%08lX (.dma_buffer)\r\n", spi_handler_get_rx_buffer_addr());
+
+    // ISR 코드 배치 (SRAM / FLASH)
+    hot_path_report();
+
+    // 인터럽트 우선순위 (계획 vs NVIC)
+    irq_prio_report();
 
     printf("========================================\r\n\r\n");
 }
@@ -1352,14 +1874,9 @@ void run_proc(void)
     init_proc();
 
     // 기본 동작 모드 선택:
-    // Option 1: 자동으로 slave 모드 실행 (배포용)
+    // Option 1: 부팅 시 slave 모드 시작 (배포용)
     // run_slave_mode();
 
-    // Option 2: 테스트 메뉴 표시 (개발/디버그용)
+    // 콘솔 + 메인 루프 (스케줄러, Option 1의 slave 태스크도 여기서 실행)
     run_test_menu();
-
-    // Option 3: 특정 테스트 직접 실행
-    // test_led_blink();
-    // test_dac_sine_wave();
-    // test_rdy_pin();
 }
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file           : main.h
+  * @brief          : Host Stand-in for Core/Inc/main.h (HAL types used by
+  *                   the modules under test)
+  ******************************************************************************
+  * @attention
+  *
+  * Only what the tested sources touch. Peripherals are plain structs owned
+  * by the test, HAL calls are implemented by the test (models).
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+
+typedef enum {
+    HAL_OK = 0x00,
+    HAL_ERROR = 0x01,
+    HAL_BUSY = 0x02,
+    HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+/* DCACHE1 (cache_maint.c) */
+typedef struct {
+    volatile uint32_t CR;
+} DCACHE_TypeDef;
+
+typedef struct {
+    DCACHE_TypeDef *Instance;
+} DCACHE_HandleTypeDef;
+
+#define DCACHE_CR_EN    (1UL << 0)
+
+extern DCACHE_TypeDef test_dcache1;
+#define DCACHE1         (&test_dcache1)
+
+HAL_StatusTypeDef HAL_DCACHE_InvalidateByAddr(DCACHE_HandleTypeDef *hdcache, const uint32_t *addr, uint32_t size);
+HAL_StatusTypeDef HAL_DCACHE_CleanByAddr(DCACHE_HandleTypeDef *hdcache, const uint32_t *addr, uint32_t size);
+HAL_StatusTypeDef HAL_DCACHE_CleanInvalidByAddr(DCACHE_HandleTypeDef *hdcache, const uint32_t *addr, uint32_t size);
+
+/* DWT cycle counter, HAL tick (spi_timing.c) */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} DCB_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk  (1UL << 0)
+#define DCB_DEMCR_TRCENA_Msk    (1UL << 24)
+
+extern DWT_Type test_dwt;
+extern DCB_Type test_dcb;
+#define DWT             (&test_dwt)
+#define DCB             (&test_dcb)
+
+extern uint32_t SystemCoreClock;
+uint32_t HAL_GetTick(void);
+
+#endif /* __MAIN_H */
@@ -0,0 +1,345 @@
+/**
+  ******************************************************************************
+  * @file           : test_adpcm.c
+  * @brief          : IMA-ADPCM Host Test (Core/Src/adpcm.c)
+  ******************************************************************************
+  * @attention
+  *
+  * - Step / index tables against the published IMA/DVI tables
+  * - Encoder and decoder bit-exact against a reference codec written from
+  *   the IMA recommended practice (predictor tracked from vpdiff, not via
+  *   the decoder as adpcm.c does)
+  * - Round trip: SNR of a sine, silence, full-scale square (clamping),
+  *   odd sample counts, packet restart from the header state
+  *
+  ******************************************************************************
+  */
+
+#include "adpcm.h"
+#include "test_common.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_SAMPLES   4096
+
+/* ============================================================================ */
+/* Reference Codec (IMA/DVI ADPCM, 1992 recommended practice) */
+/* ============================================================================ */
+
+static const int ref_step[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int ref_index[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+typedef struct {
+    int valpred;
+    int index;
+} RefState_t;
+
+static int ref_clamp_index(int index)
+{
+    return (index < 0) ? 0 : (index > 88) ? 88 : index;
+}
+
+static int ref_clamp_pcm(int v)
+{
+    return (v > 32767) ? 32767 : (v < -32768) ? -32768 : v;
+}
+
+static uint8_t ref_encode_sample(RefState_t *st, int sample)
+{
+    int step = ref_step[st->index];
+    int diff = sample - st->valpred;
+    int sign = (diff < 0) ? 8 : 0;
+    int delta = 0;
+    int vpdiff = step >> 3;
+
+    if (sign)
+    {
+        diff = -diff;
+    }
+    if (diff >= step)
+    {
+        delta = 4;
+        diff -= step;
+        vpdiff += step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        delta |= 2;
+        diff -= step;
+        vpdiff += step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        delta |= 1;
+        vpdiff += step;
+    }
+
+    st->valpred = ref_clamp_pcm(sign ? (st->valpred - vpdiff) : (st->valpred + vpdiff));
+    st->index = ref_clamp_index(st->index + ref_index[delta]);
+
+    return (uint8_t)(delta | sign);
+}
+
+static int ref_decode_sample(RefState_t *st, uint8_t code)
+{
+    int step = ref_step[st->index];
+    int vpdiff = step >> 3;
+
+    if (code & 4) vpdiff += step;
+    if (code & 2) vpdiff += step >> 1;
+    if (code & 1) vpdiff += step >> 2;
+
+    st->valpred = ref_clamp_pcm((code & 8) ? (st->valpred - vpdiff) : (st->valpred + vpdiff));
+    st->index = ref_clamp_index(st->index + ref_index[code & 0x0F]);
+
+    return st->valpred;
+}
+
+/* ============================================================================ */
+/* Test Signals (offset-binary, as on the wire) */
+/* ============================================================================ */
+
+static uint16_t g_in[N_SAMPLES];
+static uint16_t g_out[N_SAMPLES];
+static uint8_t g_enc[ADPCM_PAYLOAD_BYTES(N_SAMPLES)];
+
+static void make_sine(double freq, double amplitude)
+{
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        double v = amplitude * 32767.0 * sin(2.0 * M_PI * freq * i / 32000.0);
+        g_in[i] = (uint16_t)((int16_t)lrint(v) ^ 0x8000);
+    }
+}
+
+static void make_square(void)
+{
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        g_in[i] = ((i / 40) & 1) ? 0xFFFF : 0x0000;
+    }
+}
+
+static void make_noise(void)
+{
+    uint32_t x = 0x2545F491u;
+
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        g_in[i] = (uint16_t)(x >> 16);
+    }
+}
+
+static double snr_db(uint32_t count, uint32_t skip)
+{
+    double sig = 0.0;
+    double err = 0.0;
+
+    for (uint32_t i = skip; i < count; i++)
+    {
+        double s = (double)(int16_t)(g_in[i] ^ 0x8000);
+        double e = (double)(int16_t)(g_out[i] ^ 0x8000) - s;
+        sig += s * s;
+        err += e * e;
+    }
+
+    return (err == 0.0) ? 999.0 : 10.0 * log10(sig / err);
+}
+
+/* ============================================================================ */
+/* Tests */
+/* ============================================================================ */
+
+static void test_tables(void)
+{
+    for (int i = 0; i <= ADPCM_STEP_INDEX_MAX; i++)
+    {
+        CHECK(adpcm_step_table[i] == ref_step[i], "step[%d] = %d, expected %d",
+              i, adpcm_step_table[i], ref_step[i]);
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        CHECK(adpcm_index_table[i] == ref_index[i], "index[%d] = %d, expected %d",
+              i, adpcm_index_table[i], ref_index[i]);
+    }
+}
+
+/**
+ * @brief Encode g_in with adpcm.c and the reference, compare codes and
+ *        decoded samples, return the round-trip SNR
+ */
+static double check_codec(const char *name, uint32_t count)
+{
+    AdpcmState_t enc;
+    AdpcmState_t dec;
+    RefState_t ref_enc = { 0, 0 };
+    RefState_t ref_dec = { 0, 0 };
+    uint32_t code_mismatch = 0;
+    uint32_t pcm_mismatch = 0;
+
+    adpcm_init(&enc);
+    uint32_t bytes = adpcm_encode(&enc, g_in, count, g_enc);
+    CHECK(bytes == ADPCM_PAYLOAD_BYTES(count), "%s: %u bytes for %u samples", name, bytes, count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t code = (i & 1) ? (g_enc[i >> 1] >> 4) : (g_enc[i >> 1] & 0x0F);
+        uint8_t ref_code = ref_encode_sample(&ref_enc, (int16_t)(g_in[i] ^ 0x8000));
+
+        if (code != ref_code)
+        {
+            code_mismatch++;
+        }
+    }
+
+    // Odd count: the unused high nibble is zero
+    if (count & 1)
+    {
+        CHECK((g_enc[count >> 1] & 0xF0) == 0, "%s: padding nibble 0x%X", name, g_enc[count >> 1] >> 4);
+    }
+
+    // Encoder state = reference predictor after the last sample
+    CHECK(enc.predictor == ref_enc.valpred && enc.step_index == ref_enc.index,
+          "%s: encoder state %d/%u, reference %d/%d", name,
+          enc.predictor, enc.step_index, ref_enc.valpred, ref_enc.index);
+
+    memset(g_out, 0xA5, sizeof(g_out));
+    adpcm_init(&dec);
+    uint32_t decoded = adpcm_decode(&dec, g_enc, count, g_out);
+    CHECK(decoded == count, "%s: decoded %u of %u", name, decoded, count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t code = (i & 1) ? (g_enc[i >> 1] >> 4) : (g_enc[i >> 1] & 0x0F);
+        uint16_t ref = (uint16_t)ref_decode_sample(&ref_dec, code) ^ 0x8000;
+
+        if (g_out[i] != ref)
+        {
+            pcm_mismatch++;
+        }
+    }
+
+    // Nothing written past count
+    if (count < N_SAMPLES)
+    {
+        CHECK(g_out[count] == 0xA5A5, "%s: sample %u overwritten", name, count);
+    }
+
+    CHECK(code_mismatch == 0, "%s: %u codes differ from the reference encoder", name, code_mismatch);
+    CHECK(pcm_mismatch == 0, "%s: %u samples differ from the reference decoder", name, pcm_mismatch);
+
+    // Decoder and encoder end in the same state (bit-identical tracking)
+    CHECK(dec.predictor == enc.predictor && dec.step_index == enc.step_index,
+          "%s: decoder state %d/%u, encoder %d/%u", name,
+          dec.predictor, dec.step_index, enc.predictor, enc.step_index);
+
+    return snr_db(count, 64);
+}
+
+static void test_round_trip(void)
+{
+    double snr;
+
+    // 1 kHz / 3 kHz sine, -6 dBFS (steady state after 2 ms of step adaptation)
+    make_sine(1000.0, 0.5);
+    snr = check_codec("sine 1k", N_SAMPLES);
+    printf("  sine 1 kHz -6 dBFS: SNR %.1f dB\n", snr);
+    CHECK(snr > 30.0, "sine 1k SNR %.1f dB", snr);
+
+    make_sine(3000.0, 0.5);
+    snr = check_codec("sine 3k", N_SAMPLES);
+    printf("  sine 3 kHz -6 dBFS: SNR %.1f dB\n", snr);
+    CHECK(snr > 20.0, "sine 3k SNR %.1f dB", snr);
+
+    // Silence: decoder idles within +/-1 step of 7 around mid-scale
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        g_in[i] = 0x8000;
+    }
+    (void)check_codec("silence", N_SAMPLES);
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        int err = abs((int16_t)(g_out[i] ^ 0x8000));
+        if (err > 7)
+        {
+            CHECK(err <= 7, "silence: sample %d = %d", i, err);
+            break;
+        }
+    }
+
+    // Full-scale square (predictor clamping at both rails)
+    make_square();
+    (void)check_codec("square", N_SAMPLES);
+
+    // White noise (step index up to 88)
+    make_noise();
+    (void)check_codec("noise", N_SAMPLES);
+
+    // Odd sample counts (last byte holds one sample)
+    make_sine(1000.0, 0.5);
+    (void)check_codec("odd 1", 1);
+    (void)check_codec("odd 4095", N_SAMPLES - 1);
+}
+
+/**
+ * @brief Packets carry their start state: decoding packet 2 from the header
+ *        state gives the same samples as one continuous stream
+ */
+static void test_packet_restart(void)
+{
+    const uint32_t first = 1001;           // Odd split - packet 2 starts byte-aligned
+    AdpcmState_t enc;
+    AdpcmState_t dec;
+    static uint8_t pkt1[ADPCM_PAYLOAD_BYTES(N_SAMPLES)];
+    static uint8_t pkt2[ADPCM_PAYLOAD_BYTES(N_SAMPLES)];
+    static uint16_t cont[N_SAMPLES];
+
+    make_sine(440.0, 0.8);
+
+    // Continuous reference
+    adpcm_init(&enc);
+    adpcm_encode(&enc, g_in, N_SAMPLES, g_enc);
+    adpcm_init(&dec);
+    adpcm_decode(&dec, g_enc, N_SAMPLES, cont);
+
+    // Two packets, header state taken after packet 1
+    adpcm_init(&enc);
+    adpcm_encode(&enc, g_in, first, pkt1);
+    AdpcmState_t header = enc;
+    adpcm_encode(&enc, &g_in[first], N_SAMPLES - first, pkt2);
+
+    // Packet 1 lost: packet 2 alone decodes identically
+    dec = header;
+    adpcm_decode(&dec, pkt2, N_SAMPLES - first, g_out);
+    CHECK(memcmp(g_out, &cont[first], (N_SAMPLES - first) * sizeof(uint16_t)) == 0,
+          "packet 2 differs from the continuous stream");
+}
+
+int main(void)
+{
+    test_tables();
+    test_round_trip();
+    test_packet_restart();
+
+    return TEST_RESULT("test_adpcm");
+}
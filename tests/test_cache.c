@@ -0,0 +1,424 @@
+/**
+  ******************************************************************************
+  * @file           : test_cache.c
+  * @brief          : DCACHE Range Maintenance Host Test (Core/Src/cache_maint.c)
+  ******************************************************************************
+  * @attention
+  *
+  * The HAL_DCACHE_xxxByAddr calls are backed by a write-back, write-allocate
+  * line model over a RAM array. The CPU goes through the model (cpu_read /
+  * cpu_write), the DMA reads and writes the RAM array directly, so a line
+  * the CPU holds goes stale as soon as the DMA writes behind it:
+  *
+  * - RX: DMA writes after the CPU cached the buffer - invalidate makes the
+  *   new data visible, also for sizes / starts off the line grid
+  * - TX: CPU writes stay in dirty lines - clean makes them visible to the
+  *   DMA, also for partial first / last lines
+  * - memset of an RX buffer: without clean + invalidate an eviction
+  *   overwrites DMA data
+  * - Partial line invalidate drops the neighbour's dirty bytes (the reason
+  *   the arena aligns buffers); such calls are counted
+  * - Size 0 and DCACHE disabled are no-ops
+  *
+  * Built with -no-pie: cache_maint.c passes addresses as uint32_t.
+  *
+  ******************************************************************************
+  */
+
+#include "cache_maint.h"
+#include "main.h"
+#include "test_common.h"
+#include <stdint.h>
+#include <string.h>
+
+#define RAM_SIZE    1024
+#define RAM_LINES   (RAM_SIZE / CACHE_LINE_SIZE)
+
+/* ============================================================================ */
+/* Cache Model */
+/* ============================================================================ */
+
+DCACHE_TypeDef test_dcache1 = { .CR = DCACHE_CR_EN };
+DCACHE_HandleTypeDef hdcache1 = { .Instance = &test_dcache1 };
+
+// RAM as the DMA sees it
+static uint8_t g_ram[RAM_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// One slot per RAM line (no capacity misses - eviction is explicit)
+static struct {
+    uint8_t valid;
+    uint8_t dirty;
+    uint8_t data[CACHE_LINE_SIZE];
+} g_line[RAM_LINES];
+
+// HAL calls with a range off the line grid (cache_maint.c must widen)
+static uint32_t g_hal_unaligned = 0;
+
+static uint32_t line_of(uintptr_t addr)
+{
+    return (uint32_t)((addr - (uintptr_t)g_ram) / CACHE_LINE_SIZE);
+}
+
+static void line_fill(uint32_t n)
+{
+    if (!g_line[n].valid)
+    {
+        memcpy(g_line[n].data, &g_ram[n * CACHE_LINE_SIZE], CACHE_LINE_SIZE);
+        g_line[n].valid = 1;
+        g_line[n].dirty = 0;
+    }
+}
+
+static void line_write_back(uint32_t n)
+{
+    if (g_line[n].valid && g_line[n].dirty)
+    {
+        memcpy(&g_ram[n * CACHE_LINE_SIZE], g_line[n].data, CACHE_LINE_SIZE);
+        g_line[n].dirty = 0;
+    }
+}
+
+static uint8_t cpu_read(uint32_t offset)
+{
+    uint32_t n = offset / CACHE_LINE_SIZE;
+
+    line_fill(n);
+    return g_line[n].data[offset % CACHE_LINE_SIZE];
+}
+
+static void cpu_write(uint32_t offset, uint8_t value)
+{
+    uint32_t n = offset / CACHE_LINE_SIZE;
+
+    line_fill(n);
+    g_line[n].data[offset % CACHE_LINE_SIZE] = value;
+    g_line[n].dirty = 1;
+}
+
+/**
+ * @brief Capacity eviction at some later point: dirty lines go to RAM
+ */
+static void cache_evict_all(void)
+{
+    for (uint32_t n = 0; n < RAM_LINES; n++)
+    {
+        line_write_back(n);
+        g_line[n].valid = 0;
+    }
+}
+
+/**
+ * @brief Test data by RAM offset: two seeds never agree on a byte
+ */
+static uint8_t pattern(uint32_t offset, uint8_t seed)
+{
+    return (uint8_t)(offset * 7u + seed);
+}
+
+/**
+ * @brief Fresh model; RAM holds seed 0 (differs from every test seed)
+ */
+static void cache_reset(void)
+{
+    for (uint32_t i = 0; i < RAM_SIZE; i++)
+    {
+        g_ram[i] = pattern(i, 0);
+    }
+    memset(g_line, 0, sizeof(g_line));
+    g_hal_unaligned = 0;
+    test_dcache1.CR = DCACHE_CR_EN;
+}
+
+/**
+ * @brief Lines of a HAL range (the H5 HAL works on whole lines)
+ */
+static void hal_range(const uint32_t *addr, uint32_t size, uint32_t *first, uint32_t *count)
+{
+    uintptr_t a = (uintptr_t)addr;
+
+    if ((a | size) & (CACHE_LINE_SIZE - 1))
+    {
+        g_hal_unaligned++;
+    }
+    *first = line_of(a);
+    *count = size / CACHE_LINE_SIZE;
+}
+
+HAL_StatusTypeDef HAL_DCACHE_InvalidateByAddr(DCACHE_HandleTypeDef *hdcache, const uint32_t *addr, uint32_t size)
+{
+    uint32_t first, count;
+
+    hal_range(addr, size, &first, &count);
+    for (uint32_t n = first; n < first + count; n++)
+    {
+        g_line[n].valid = 0;            // Dirty data is lost
+        g_line[n].dirty = 0;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DCACHE_CleanByAddr(DCACHE_HandleTypeDef *hdcache, const uint32_t *addr, uint32_t size)
+{
+    uint32_t first, count;
+
+    hal_range(addr, size, &first, &count);
+    for (uint32_t n = first; n < first + count; n++)
+    {
+        line_write_back(n);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DCACHE_CleanInvalidByAddr(DCACHE_HandleTypeDef *hdcache, const uint32_t *addr, uint32_t size)
+{
+    uint32_t first, count;
+
+    hal_range(addr, size, &first, &count);
+    for (uint32_t n = first; n < first + count; n++)
+    {
+        line_write_back(n);
+        g_line[n].valid = 0;
+    }
+    return HAL_OK;
+}
+
+/* ============================================================================ */
+/* Helpers */
+/* ============================================================================ */
+
+/**
+ * @brief CPU reads a range (lines now cached)
+ */
+static void cpu_touch(uint32_t offset, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        (void)cpu_read(offset + i);
+    }
+}
+
+static void dma_write(uint32_t offset, uint32_t size, uint8_t seed)
+{
+    for (uint32_t i = 0; i < size; i++)
+    {
+        g_ram[offset + i] = pattern(offset + i, seed);
+    }
+}
+
+/**
+ * @return Bytes the CPU sees differently from the pattern
+ */
+static uint32_t cpu_mismatch(uint32_t offset, uint32_t size, uint8_t seed)
+{
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (cpu_read(offset + i) != pattern(offset + i, seed))
+        {
+            bad++;
+        }
+    }
+    return bad;
+}
+
+/**
+ * @return Bytes the DMA sees differently from the pattern
+ */
+static uint32_t dma_mismatch(uint32_t offset, uint32_t size, uint8_t seed)
+{
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (g_ram[offset + i] != pattern(offset + i, seed))
+        {
+            bad++;
+        }
+    }
+    return bad;
+}
+
+/* ============================================================================ */
+/* Tests */
+/* ============================================================================ */
+
+static void test_lines(void)
+{
+    uint32_t start;
+
+    CHECK(cache_maint_lines(0x20000000, 0, &start) == 0, "size 0");
+    CHECK(cache_maint_lines(0x20000000, 32, &start) == 32 && start == 0x20000000, "one line");
+    CHECK(cache_maint_lines(0x20000000, 33, &start) == 64 && start == 0x20000000, "tail byte");
+    CHECK(cache_maint_lines(0x2000001F, 1, &start) == 32 && start == 0x20000000, "last byte of a line");
+    CHECK(cache_maint_lines(0x2000001F, 2, &start) == 64 && start == 0x20000000, "straddles two lines");
+    CHECK(cache_maint_lines(0x20000005, 100, &start) == 128 && start == 0x20000000,
+          "5 + 100 bytes -> %u", cache_maint_lines(0x20000005, 100, &start));
+}
+
+/**
+ * @brief RX: the CPU holds stale lines, the DMA writes behind them
+ */
+static void test_rx_stale(uint32_t offset, uint32_t size, const char *name)
+{
+    const CacheMaintStats_t *st = cache_maint_get_stats();
+    uint32_t misaligned = st->misaligned_count;
+    uint8_t aligned = ((offset | size) & (CACHE_LINE_SIZE - 1)) == 0;
+
+    cache_reset();
+    cpu_touch(offset, size);
+    dma_write(offset, size, 0x11);
+
+    // Without maintenance the CPU reads the old bytes
+    CHECK(cpu_mismatch(offset, size, 0x11) == size, "%s: model did not go stale", name);
+
+    cache_invalidate(&g_ram[offset], size);
+    CHECK(cpu_mismatch(offset, size, 0x11) == 0, "%s: %u stale bytes after invalidate",
+          name, cpu_mismatch(offset, size, 0x11));
+    CHECK(g_hal_unaligned == 0, "%s: HAL got an unwidened range", name);
+    CHECK(st->misaligned_count == misaligned + (aligned ? 0 : 1),
+          "%s: misaligned_count %u -> %u", name, misaligned, st->misaligned_count);
+}
+
+/**
+ * @brief TX: CPU writes sit in dirty lines until cleaned
+ */
+static void test_tx_dirty(uint32_t offset, uint32_t size, const char *name)
+{
+    cache_reset();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        cpu_write(offset + i, pattern(offset + i, 0x22));
+    }
+
+    CHECK(dma_mismatch(offset, size, 0x22) == size, "%s: model wrote through", name);
+
+    cache_clean(&g_ram[offset], size);
+    CHECK(dma_mismatch(offset, size, 0x22) == 0, "%s: DMA sees %u old bytes after clean",
+          name, dma_mismatch(offset, size, 0x22));
+    CHECK(g_hal_unaligned == 0, "%s: HAL got an unwidened range", name);
+
+    // Clean keeps the lines: CPU still reads its own data
+    CHECK(cpu_mismatch(offset, size, 0x22) == 0, "%s: clean dropped CPU data", name);
+}
+
+/**
+ * @brief memset of an RX buffer before the next DMA
+ */
+static void test_rx_memset(void)
+{
+    const uint32_t offset = 64;
+    const uint32_t size = 256;
+
+    // Without clean + invalidate: eviction overwrites the DMA data
+    cache_reset();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        cpu_write(offset + i, pattern(offset + i, 0x01));
+    }
+    dma_write(offset, size, 0x33);
+    cache_evict_all();
+    CHECK(dma_mismatch(offset, size, 0x33) == size, "eviction did not overwrite DMA data");
+
+    // With clean + invalidate before the DMA starts
+    cache_reset();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        cpu_write(offset + i, pattern(offset + i, 0x01));
+    }
+    cache_clean_invalidate(&g_ram[offset], size);
+    dma_write(offset, size, 0x33);
+    cache_evict_all();
+    CHECK(dma_mismatch(offset, size, 0x33) == 0, "DMA data lost to an eviction");
+    CHECK(cpu_mismatch(offset, size, 0x33) == 0, "CPU does not see the DMA data");
+}
+
+/**
+ * @brief Partial line invalidate: the neighbour sharing the line loses its
+ *        dirty bytes (documented hazard, counted), clean + invalidate keeps them
+ */
+static void test_shared_line(void)
+{
+    const CacheMaintStats_t *st = cache_maint_get_stats();
+    const uint32_t buf = 8;             // RX buffer shares line 0 with byte 0..7
+    const uint32_t size = 40;
+
+    cache_reset();
+    cpu_write(0, 0xAB);                 // Neighbour variable, dirty
+    uint32_t misaligned = st->misaligned_count;
+    cache_invalidate(&g_ram[buf], size);
+    CHECK(st->misaligned_count == misaligned + 1, "partial line not counted");
+    CHECK(cpu_read(0) != 0xAB, "model kept dirty data over an invalidate");
+
+    cache_reset();
+    cpu_write(0, 0xAB);
+    cache_clean_invalidate(&g_ram[buf], size);
+    dma_write(buf, size, 0x44);
+    cache_invalidate(&g_ram[buf], size);
+    CHECK(cpu_read(0) == 0xAB, "clean + invalidate lost the neighbour byte");
+    CHECK(cpu_mismatch(buf, size, 0x44) == 0, "RX data stale");
+}
+
+static void test_noop(void)
+{
+    const CacheMaintStats_t *st = cache_maint_get_stats();
+    CacheMaintStats_t before = *st;
+
+    cache_reset();
+    cpu_touch(0, 64);
+    dma_write(0, 64, 0x55);
+
+    cache_invalidate(&g_ram[0], 0);
+    cache_clean(&g_ram[0], 0);
+    cache_clean_invalidate(&g_ram[0], 0);
+    CHECK(memcmp(&before, st, sizeof(before)) == 0, "size 0 changed the statistics");
+    CHECK(cpu_mismatch(0, 64, 0x55) == 64, "size 0 touched the cache");
+
+    test_dcache1.CR = 0;
+    cache_invalidate(&g_ram[0], 64);
+    cache_clean(&g_ram[0], 64);
+    CHECK(memcmp(&before, st, sizeof(before)) == 0, "DCACHE off changed the statistics");
+    CHECK(cpu_mismatch(0, 64, 0x55) == 64, "DCACHE off touched the cache");
+}
+
+static void test_stats(void)
+{
+    const CacheMaintStats_t *st = cache_maint_get_stats();
+    CacheMaintStats_t before = *st;
+
+    cache_reset();
+    cache_invalidate(&g_ram[5], 100);           // 4 lines
+    cache_clean(&g_ram[64], 64);                // 2 lines
+    cache_clean_invalidate(&g_ram[128], 1);     // 1 line
+
+    CHECK(st->invalidate_count == before.invalidate_count + 1, "invalidate_count");
+    CHECK(st->clean_count == before.clean_count + 2, "clean_count");
+    CHECK(st->line_count == before.line_count + 7, "line_count +%u",
+          st->line_count - before.line_count);
+    CHECK(st->misaligned_count == before.misaligned_count + 2, "misaligned_count +%u",
+          st->misaligned_count - before.misaligned_count);
+    CHECK(st->error_count == 0, "error_count %u", st->error_count);
+}
+
+int main(void)
+{
+    CHECK((uintptr_t)g_ram <= UINT32_MAX, "RAM array above 4 GB (build with -no-pie)");
+
+    test_lines();
+
+    test_rx_stale(0, 256, "rx aligned");
+    test_rx_stale(32, 100, "rx size off-grid");
+    test_rx_stale(37, 64, "rx start off-grid");
+    test_rx_stale(3, 1, "rx one byte");
+
+    test_tx_dirty(0, 128, "tx aligned");
+    test_tx_dirty(96, 77, "tx size off-grid");
+    test_tx_dirty(13, 50, "tx start off-grid");
+
+    test_rx_memset();
+    test_shared_line();
+    test_noop();
+    test_stats();
+
+    return TEST_RESULT("test_cache");
+}
@@ -0,0 +1,293 @@
+/**
+  ******************************************************************************
+  * @file           : test_channel_stress.c
+  * @brief          : A/B Hand-off Stress Host Test (audio_channel.c, 2 threads)
+  ******************************************************************************
+  * @attention
+  *
+  * One producer thread (audio_channel_fill / fill_packed, the CS EXTI side)
+  * and one consumer thread (audio_channel_render / reset, the DAC DMA side)
+  * share a channel through fill_seq / play_seq / flush_req / flush_ack only.
+  * Both yield at random points, so the threads interleave inside the
+  * hand-off as well (the host may have a single core, like the target).
+  *
+  * Sample k is sent as a unique 12-bit code (k mod 4095, mid-scale 2048
+  * skipped), rendered at unity gain without dither, so every DAC value
+  * names the stream sample it came from. The consumer renders at most
+  * audio_channel_depth() samples per call (no real underrun), sometimes
+  * into the unpublished fill buffer (live), and resets at random points.
+  *
+  * Checked on the recorded output, per reset epoch:
+  * - Silence (2048) only before the first sample of the epoch
+  * - Then exactly the producer's samples from its first write after the
+  *   reset (flush_ack changed), consecutive: none lost, none repeated
+  * - The last epoch ends with the last sample produced
+  * - No underrun (concealment) and no stale sample after a reset
+  *
+  ******************************************************************************
+  */
+
+#include "audio_channel.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_SAMPLES       2000000
+#define MAX_RESETS      400
+#define RESET_ODDS      1000            // Per render call (~ every 16 ms)
+#define OUT_MAX         (N_SAMPLES + (MAX_RESETS + 2) * 3 * AUDIO_BUFFER_SIZE)
+#define SILENCE         2048
+
+static int16_t g_buf_a[AUDIO_BUFFER_SIZE];
+static int16_t g_buf_b[AUDIO_BUFFER_SIZE];
+static AudioChannel_t g_ch;
+
+// Producer: first sample written in each epoch (flush_ack value)
+static uint32_t g_seg_start[MAX_RESETS + 1];
+static uint8_t g_seg_valid[MAX_RESETS + 1];
+static uint32_t g_produced;
+static volatile int g_producer_done;
+static volatile int g_in_fill;          // Producer between claim and commit
+
+// Consumer: DAC output, start of each epoch in it
+static uint16_t g_out[OUT_MAX];
+static uint32_t g_out_len;
+static uint32_t g_reset_pos[MAX_RESETS + 1];
+static uint32_t g_resets;
+static uint32_t g_live_renders;
+static uint32_t g_inflight_resets;
+
+/* ============================================================================ */
+/* Helpers */
+/* ============================================================================ */
+
+static uint32_t rng_next(uint32_t *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+/**
+ * @brief DAC code of stream sample k (never mid-scale)
+ */
+static uint16_t code_of(uint32_t k)
+{
+    uint16_t m = (uint16_t)(k % 4095);
+
+    return (m >= SILENCE) ? (m + 1) : m;
+}
+
+/* ============================================================================ */
+/* Threads */
+/* ============================================================================ */
+
+static void *producer(void *arg)
+{
+    uint32_t rng = 0x9E3779B9u;
+    uint32_t k = 0;
+    static uint16_t wire[AUDIO_BUFFER_SIZE];
+    static uint8_t bytes[AUDIO_BUFFER_SIZE * 2];
+
+    while (k < N_SAMPLES)
+    {
+        // Mostly packet sized, sometimes a whole buffer (long fill, more
+        // chances to be preempted between claim and commit)
+        uint32_t r = rng_next(&rng);
+        uint16_t n = 1 + ((r & 0xF000) ? r % (AUDIO_BLOCK_SIZE * 2) : r % AUDIO_BUFFER_SIZE);
+        uint16_t done;
+
+        if (n > N_SAMPLES - k)
+        {
+            n = (uint16_t)(N_SAMPLES - k);
+        }
+        for (uint16_t i = 0; i < n; i++)
+        {
+            wire[i] = (uint16_t)(code_of(k + i) << 4);
+            bytes[2 * i] = (uint8_t)wire[i];
+            bytes[2 * i + 1] = (uint8_t)(wire[i] >> 8);
+        }
+
+        // flush_ack is the producer's own field
+        uint32_t ack = g_ch.flush_ack;
+
+        g_in_fill = 1;
+        if (rng_next(&rng) & 1)
+        {
+            done = audio_channel_fill(&g_ch, wire, n);
+        }
+        else
+        {
+            done = audio_channel_fill_packed(&g_ch, SAMPLE_FORMAT_16BIT, bytes, n);
+        }
+        g_in_fill = 0;
+
+        if (g_ch.flush_ack != ack && g_ch.flush_ack <= MAX_RESETS)
+        {
+            g_seg_start[g_ch.flush_ack] = k;
+            g_seg_valid[g_ch.flush_ack] = 1;
+        }
+
+        k += done;
+
+        if (done < n || (rng_next(&rng) % 4) == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    g_produced = k;
+    __atomic_store_n(&g_producer_done, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    uint32_t rng = 0x2545F491u;
+
+    for (;;)
+    {
+        int done = __atomic_load_n(&g_producer_done, __ATOMIC_ACQUIRE);
+        uint16_t depth = audio_channel_depth(&g_ch);
+
+        if (depth == 0)
+        {
+            if (done)
+            {
+                break;      // Depth read after the last fill: all played
+            }
+            sched_yield();
+            continue;
+        }
+
+        uint16_t n = 1 + rng_next(&rng) % (AUDIO_BLOCK_SIZE * 2);
+        if (n > depth)
+        {
+            n = depth;
+        }
+        if (g_out_len + n > OUT_MAX)
+        {
+            break;
+        }
+
+        audio_channel_render(&g_ch, &g_out[g_out_len], n);
+        g_out_len += n;
+
+        if (g_ch.live_index > 0)
+        {
+            g_live_renders++;
+        }
+
+        // Reset while streaming (not after the end - the tail is checked),
+        // more often while a fill is in flight (as from the DMA IRQ stop)
+        uint8_t inflight = g_in_fill;
+        uint32_t odds = inflight ? 4 : RESET_ODDS;
+
+        if (!done && g_resets < MAX_RESETS && (rng_next(&rng) % odds) == 0)
+        {
+            g_inflight_resets += inflight;
+            audio_channel_reset(&g_ch);
+            audio_channel_fade_in(&g_ch);
+            g_reset_pos[++g_resets] = g_out_len;
+        }
+
+        if ((rng_next(&rng) % 4) == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/* ============================================================================ */
+/* Check */
+/* ============================================================================ */
+
+/**
+ * @brief Check one epoch of the output
+ * @return Last stream sample played in it, -1 if none
+ */
+static int64_t check_epoch(uint32_t e, uint32_t from, uint32_t to)
+{
+    uint32_t i = from;
+
+    // Active buffer after reset / stale buffers play as silence
+    while (i < to && g_out[i] == SILENCE)
+    {
+        i++;
+    }
+    if (i == to)
+    {
+        return -1;
+    }
+
+    CHECK(g_seg_valid[e], "epoch %u: data at output %u, producer never acked it", e, i);
+    if (!g_seg_valid[e])
+    {
+        return -1;
+    }
+
+    uint32_t k = g_seg_start[e];
+    CHECK(g_out[i] == code_of(k), "epoch %u: first code %u, expected %u (sample %u)",
+          e, g_out[i], code_of(k), k);
+
+    for (; i < to; i++, k++)
+    {
+        if (g_out[i] != code_of(k))
+        {
+            CHECK(g_out[i] == code_of(k), "epoch %u: output %u = code %u, expected %u (sample %u)",
+                  e, i, g_out[i], code_of(k), k);
+            return -1;
+        }
+    }
+
+    return (int64_t)k - 1;
+}
+
+int main(void)
+{
+    pthread_t prod;
+    pthread_t cons;
+
+    audio_channel_init(&g_ch, g_buf_a, g_buf_b);
+    audio_channel_set_fade_time(&g_ch, 0);
+    audio_channel_fade_in(&g_ch);
+    g_seg_valid[0] = 1;                 // Epoch 0 starts with sample 0
+
+    pthread_create(&cons, NULL, consumer, NULL);
+    pthread_create(&prod, NULL, producer, NULL);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    CHECK(g_out_len < OUT_MAX, "output log full");
+
+    int64_t last = -1;
+    uint32_t played = 0;
+
+    g_reset_pos[0] = 0;
+    for (uint32_t e = 0; e <= g_resets; e++)
+    {
+        uint32_t to = (e < g_resets) ? g_reset_pos[e + 1] : g_out_len;
+
+        last = check_epoch(e, g_reset_pos[e], to);
+        if (last >= 0)
+        {
+            played += (uint32_t)(last - g_seg_start[e] + 1);
+        }
+    }
+
+    CHECK(last == (int64_t)g_produced - 1, "last epoch ends at sample %lld of %u",
+          (long long)last, g_produced);
+    CHECK(g_ch.underrun_count == 0, "%u underruns (depth said data was there)", g_ch.underrun_count);
+    CHECK(g_live_renders > 0, "live fill buffer path not reached");
+
+    printf("  %u samples produced, %u played, %u resets (%u during a fill), %u swaps, %u live renders\n",
+           g_produced, played, g_resets, g_inflight_resets, g_ch.buffer_swaps, g_live_renders);
+
+    return TEST_RESULT("test_channel_stress");
+}
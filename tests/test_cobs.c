@@ -0,0 +1,342 @@
+/**
+  ******************************************************************************
+  * @file           : test_cobs.c
+  * @brief          : COBS Framing / CRC-16 Host Test (Core/Src/cobs.c)
+  ******************************************************************************
+  * @attention
+  *
+  * - CRC-16/CCITT-FALSE check value and a bitwise reference
+  * - COBS encode against the published example vectors (zero runs,
+  *   254 / 255-byte blocks), decode of malformed bodies
+  * - Round trip of random buffers (no zeros, all zeros, mixed) around the
+  *   254-byte block boundary: no 0x00 in the output, size within
+  *   COBS_MAX_ENCODED()
+  * - Frames (uart_link / telemetry wire format): build / open, CRC
+  *   rejects corrupted bytes, stream decoder over noise, chunked input,
+  *   bad frames and payload buffer overflow
+  *
+  ******************************************************************************
+  */
+
+#include "cobs.h"
+#include "test_common.h"
+#include <string.h>
+
+#define MAX_LEN     1100
+
+static uint8_t g_src[MAX_LEN];
+static uint8_t g_enc[COBS_MAX_FRAME(MAX_LEN)];
+static uint8_t g_dec[MAX_LEN + 2];
+
+/* ============================================================================ */
+/* Helpers */
+/* ============================================================================ */
+
+static uint32_t rng_next(uint32_t *x)
+{
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+/**
+ * @brief Random bytes, zero_odds = 1 in n bytes is 0 (0 = none, 1 = all)
+ */
+static void fill_random(uint8_t *buf, uint32_t len, uint32_t zero_odds, uint32_t *seed)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint8_t b = (uint8_t)(1 + rng_next(seed) % 255);
+
+        if (zero_odds != 0 && (rng_next(seed) % zero_odds) == 0)
+        {
+            b = 0;
+        }
+        buf[i] = b;
+    }
+}
+
+static uint8_t has_zero(const uint8_t *buf, uint32_t len)
+{
+    return memchr(buf, 0, len) != NULL;
+}
+
+/* ============================================================================ */
+/* Tests */
+/* ============================================================================ */
+
+static void test_crc(void)
+{
+    uint32_t seed = 0x1234567u;
+
+    CHECK(crc16_ccitt((const uint8_t *)"123456789", 9) == 0x29B1, "check value 0x%04X",
+          crc16_ccitt((const uint8_t *)"123456789", 9));
+    CHECK(crc16_ccitt(NULL, 0) == 0xFFFF, "empty = init");
+
+    // Bytewise reference (table-free, MSB first)
+    fill_random(g_src, 300, 8, &seed);
+    uint16_t ref = 0xFFFF;
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            uint16_t in = (uint16_t)((g_src[i] >> bit) & 1);
+            uint16_t msb = (uint16_t)(ref >> 15);
+            ref = (uint16_t)(ref << 1);
+            if (msb ^ in)
+            {
+                ref ^= 0x1021;
+            }
+        }
+    }
+    CHECK(crc16_ccitt(g_src, 300) == ref, "300 bytes: 0x%04X, reference 0x%04X",
+          crc16_ccitt(g_src, 300), ref);
+}
+
+static void check_vector(const char *name, const uint8_t *in, uint32_t len,
+                         const uint8_t *expect, uint32_t expect_len)
+{
+    uint32_t n = cobs_encode(in, len, g_enc);
+
+    CHECK(n == expect_len && memcmp(g_enc, expect, expect_len) == 0,
+          "%s: encoded %u bytes, expected %u", name, n, expect_len);
+
+    uint32_t m = cobs_decode(g_enc, n, g_dec);
+    CHECK(m == len && memcmp(g_dec, in, len) == 0, "%s: decoded %u bytes", name, m);
+}
+
+static void test_vectors(void)
+{
+    static const uint8_t z1[] = { 0x00 };
+    static const uint8_t z1e[] = { 0x01, 0x01 };
+    static const uint8_t z2[] = { 0x00, 0x00 };
+    static const uint8_t z2e[] = { 0x01, 0x01, 0x01 };
+    static const uint8_t a[] = { 0x00, 0x11, 0x00 };
+    static const uint8_t ae[] = { 0x01, 0x02, 0x11, 0x01 };
+    static const uint8_t b[] = { 0x11, 0x22, 0x00, 0x33 };
+    static const uint8_t be[] = { 0x03, 0x11, 0x22, 0x02, 0x33 };
+    static const uint8_t c[] = { 0x11, 0x22, 0x33, 0x44 };
+    static const uint8_t ce[] = { 0x05, 0x11, 0x22, 0x33, 0x44 };
+    static const uint8_t d[] = { 0x11, 0x00, 0x00, 0x00 };
+    static const uint8_t de[] = { 0x02, 0x11, 0x01, 0x01, 0x01 };
+
+    check_vector("00", z1, sizeof(z1), z1e, sizeof(z1e));
+    check_vector("00 00", z2, sizeof(z2), z2e, sizeof(z2e));
+    check_vector("00 11 00", a, sizeof(a), ae, sizeof(ae));
+    check_vector("11 22 00 33", b, sizeof(b), be, sizeof(be));
+    check_vector("11 22 33 44", c, sizeof(c), ce, sizeof(ce));
+    check_vector("11 00 00 00", d, sizeof(d), de, sizeof(de));
+
+    // 01..FF (255 bytes): full 254-byte block, then a 1-byte block
+    static uint8_t in255[255];
+    static uint8_t exp255[257];
+    for (uint32_t i = 0; i < 255; i++)
+    {
+        in255[i] = (uint8_t)(i + 1);
+    }
+    exp255[0] = 0xFF;
+    memcpy(&exp255[1], in255, 254);
+    exp255[255] = 0x02;
+    exp255[256] = 0xFF;
+    check_vector("01..FF", in255, 255, exp255, 257);
+
+    // 01..FE (254 bytes): one full block - decodes without a trailing zero
+    uint32_t n = cobs_encode(in255, 254, g_enc);
+    CHECK(g_enc[0] == 0xFF && memcmp(&g_enc[1], in255, 254) == 0, "01..FE: block 0xFF");
+    CHECK(n <= COBS_MAX_ENCODED(254U), "01..FE: %u bytes", n);
+    CHECK(cobs_decode(g_enc, n, g_dec) == 254 && memcmp(g_dec, in255, 254) == 0,
+          "01..FE: round trip");
+
+    // 00 01..FE (255 bytes): zero, then one full block
+    static uint8_t in0[255];
+    in0[0] = 0;
+    memcpy(&in0[1], in255, 254);
+    n = cobs_encode(in0, 255, g_enc);
+    CHECK(g_enc[0] == 0x01 && g_enc[1] == 0xFF, "00 01..FE: codes %02X %02X", g_enc[0], g_enc[1]);
+    CHECK(cobs_decode(g_enc, n, g_dec) == 255 && memcmp(g_dec, in0, 255) == 0,
+          "00 01..FE: round trip");
+}
+
+static void test_malformed(void)
+{
+    static const uint8_t overrun[] = { 0x05, 0x11, 0x22 };        // Block past the end
+    static const uint8_t zero_code[] = { 0x02, 0x11, 0x00, 0x22 }; // Delimiter as code
+    static const uint8_t zero_data[] = { 0x03, 0x11, 0x00 };       // Delimiter in data
+
+    CHECK(cobs_decode(overrun, sizeof(overrun), g_dec) == 0, "overrun accepted");
+    CHECK(cobs_decode(zero_code, sizeof(zero_code), g_dec) == 0, "zero code accepted");
+    CHECK(cobs_decode(zero_data, sizeof(zero_data), g_dec) == 0, "zero data accepted");
+}
+
+static void test_round_trip(void)
+{
+    static const uint32_t lens[] = { 0, 1, 2, 253, 254, 255, 256, 507, 508, 509, 762, MAX_LEN };
+    static const uint32_t odds[] = { 0, 1, 2, 16, 300 };
+    uint32_t seed = 0xC0B5u;
+    uint32_t fails = 0;
+
+    for (uint32_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+    {
+        for (uint32_t o = 0; o < sizeof(odds) / sizeof(odds[0]); o++)
+        {
+            uint32_t len = lens[l];
+
+            fill_random(g_src, len, odds[o], &seed);
+            uint32_t n = cobs_encode(g_src, len, g_enc);
+            uint32_t m = cobs_decode(g_enc, n, g_dec);
+
+            if (has_zero(g_enc, n) || n > COBS_MAX_ENCODED(len) ||
+                m != len || memcmp(g_dec, g_src, len) != 0)
+            {
+                fails++;
+                printf("  len %u, zero 1/%u: encoded %u (max %u), decoded %u\n",
+                       len, odds[o], n, COBS_MAX_ENCODED(len), m);
+            }
+        }
+    }
+    CHECK(fails == 0, "%u round trips failed", fails);
+}
+
+static void test_frames(void)
+{
+    static const uint32_t lens[] = { 1, 2, 251, 252, 253, 254, 255, 600 };
+    uint32_t seed = 0xF7A3Eu;
+    uint32_t fails = 0;
+
+    for (uint32_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+    {
+        uint32_t len = lens[l];
+
+        // Odd entries zero-free: payload + CRC cross the 254-byte block
+        fill_random(g_src, len, (l & 1) ? 0 : 4, &seed);
+        uint32_t n = cobs_frame_build(g_src, len, g_enc);
+
+        if (g_enc[0] != 0 || g_enc[n - 1] != 0 || has_zero(&g_enc[1], n - 2) ||
+            n > COBS_MAX_FRAME(len))
+        {
+            fails++;
+            printf("  frame %u: %u bytes (max %u), bad delimiters\n", len, n, COBS_MAX_FRAME(len));
+            continue;
+        }
+
+        // Body decoded in place
+        uint32_t m = cobs_frame_open(&g_enc[1], n - 2);
+        if (m != len || memcmp(&g_enc[1], g_src, len) != 0)
+        {
+            fails++;
+            printf("  frame %u: opened %u bytes\n", len, m);
+        }
+
+        // Any corrupted byte (never 0x00 - that is a delimiter) is rejected
+        uint32_t accepted = 0;
+        for (uint32_t i = 1; i < n - 1; i++)
+        {
+            n = cobs_frame_build(g_src, len, g_enc);
+            g_enc[i] = (uint8_t)((g_enc[i] ^ 0x5A) ? (g_enc[i] ^ 0x5A) : 0x01);
+            accepted += (cobs_frame_open(&g_enc[1], n - 2) != 0);
+        }
+        if (accepted != 0)
+        {
+            fails++;
+            printf("  frame %u: %u corrupted frames accepted\n", len, accepted);
+        }
+    }
+    CHECK(fails == 0, "%u frame checks failed", fails);
+
+    // Payload too short for a CRC
+    static const uint8_t tiny[] = { 0x02, 0x11 };
+    uint8_t buf[2];
+    memcpy(buf, tiny, sizeof(buf));
+    CHECK(cobs_frame_open(buf, sizeof(buf)) == 0, "1-byte body accepted");
+}
+
+static void test_stream(void)
+{
+    static uint8_t wire[8192];
+    static uint8_t payloads[6][300];
+    static const uint32_t lens[6] = { 5, 254, 1, 300, 253, 40 };
+    uint8_t buf[302];
+    CobsStream_t s;
+    uint32_t seed = 0x51DEu;
+    uint32_t w = 0;
+
+    // Noise, frames, a corrupted frame, zero runs between frames
+    fill_random(wire, 17, 0, &seed);
+    w = 17;
+    for (uint32_t f = 0; f < 6; f++)
+    {
+        // Frame 3 has no zeros: a full 254-byte block mid-frame
+        fill_random(payloads[f], lens[f], (f == 3) ? 0 : 3, &seed);
+        uint32_t n = cobs_frame_build(payloads[f], lens[f], &wire[w]);
+
+        if (f == 2)
+        {
+            wire[w + 2] ^= 0x20;        // Frame 2 fails the CRC
+        }
+        w += n;
+        if (f == 3)
+        {
+            memset(&wire[w], 0, 5);
+            w += 5;
+        }
+    }
+
+    cobs_stream_init(&s, buf, sizeof(buf));
+
+    // Random chunk sizes, re-fed from where a frame stopped the decoder
+    uint32_t pos = 0;
+    uint32_t got = 0;
+    uint8_t seen[6] = { 0 };
+    while (pos < w)
+    {
+        uint32_t chunk = 1 + rng_next(&seed) % 97;
+        uint32_t plen;
+
+        if (chunk > w - pos)
+        {
+            chunk = w - pos;
+        }
+        pos += cobs_stream_feed(&s, &wire[pos], chunk, &plen);
+
+        if (plen != 0)
+        {
+            // Frames in order, frame 2 missing
+            uint32_t f = (got < 2) ? got : got + 1;
+            CHECK(f < 6 && plen == lens[f] && memcmp(buf, payloads[f], plen) == 0,
+                  "frame %u: %u bytes", f, plen);
+            if (f < 6)
+            {
+                seen[f] = 1;
+            }
+            got++;
+        }
+    }
+
+    CHECK(got == 5 && s.frames == 5, "%u payloads, %u frames", got, s.frames);
+    CHECK(!seen[2] && s.bad_frames >= 1, "corrupted frame: %u bad", s.bad_frames);
+    CHECK(s.overflows == 0, "%u overflows", s.overflows);
+
+    // Payload buffer too small: dropped and counted, next frame still decodes
+    uint8_t small[64];
+    uint32_t plen;
+    cobs_stream_init(&s, small, sizeof(small));
+    w = cobs_frame_build(payloads[3], 300, wire);
+    w += cobs_frame_build(payloads[0], 5, &wire[w]);
+    pos = cobs_stream_feed(&s, wire, w, &plen);
+    CHECK(plen == 5 && memcmp(small, payloads[0], 5) == 0 && pos == w,
+          "after overflow: %u bytes", plen);
+    CHECK(s.overflows == 1 && s.frames == 1, "%u overflows, %u frames", s.overflows, s.frames);
+}
+
+int main(void)
+{
+    test_crc();
+    test_vectors();
+    test_malformed();
+    test_round_trip();
+    test_frames();
+    test_stream();
+
+    return TEST_RESULT("test_cobs");
+}
@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file           : test_common.h
+  * @brief          : Minimal Host Test Helpers (no framework)
+  ******************************************************************************
+  * @attention
+  *
+  * CHECK() records a failure and keeps going, so one run lists every
+  * broken case. main() ends with TEST_RESULT(): exit code 0 = all passed.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TEST_COMMON_H
+#define __TEST_COMMON_H
+
+#include <stdio.h>
+
+static int g_test_failures = 0;
+static int g_test_checks = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        g_test_checks++;                                                    \
+        if (!(cond)) {                                                      \
+            g_test_failures++;                                              \
+            printf("  FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond);        \
+            printf(__VA_ARGS__);                                            \
+            printf("\n");                                                   \
+        }                                                                   \
+    } while (0)
+
+#define TEST_RESULT(name)                                                   \
+    (printf("%s: %d checks, %d failed\n", (name), g_test_checks,            \
+            g_test_failures), (g_test_failures != 0) ? 1 : 0)
+
+#endif /* __TEST_COMMON_H */
@@ -0,0 +1,234 @@
+/**
+  ******************************************************************************
+  * @file           : test_dither.c
+  * @brief          : 16 -> 12-bit Quantizer THD+N Host Test (audio_channel.c)
+  ******************************************************************************
+  * @attention
+  *
+  * A 1 kHz sine is streamed through audio_channel_render() (A/B hand-off,
+  * unity gain, no oversampling) once per AUDIO_DITHER_xxx mode. The 12-bit
+  * output is analysed with a coherent FFT (1024 cycles in 32768 samples):
+  *
+  *   THD+N     everything but the fundamental and DC, re fundamental
+  *   in-band   THD+N in 20 Hz .. 4 kHz (harmonics 2..4 included)
+  *   spur      largest of harmonics 2..9
+  *
+  * Expected:
+  * - Truncate: lowest total noise, but correlated error (harmonic spurs)
+  * - TPDF: spurs gone, noise floor raised (~ +4.8 dB)
+  * - NS1 / NS2: total noise higher, in-band noise lower in that order
+  *
+  ******************************************************************************
+  */
+
+#include "audio_channel.h"
+#include "test_common.h"
+#include <complex.h>
+#include <math.h>
+#include <string.h>
+
+#define N_FFT       32768
+#define CYCLES      1024                    // 1 kHz @ 32 kHz
+#define SETTLE      (AUDIO_BUFFER_SIZE * 2) // Silent A buffer + first B
+#define INBAND_HZ   4000.0
+
+static int16_t g_buf_a[AUDIO_BUFFER_SIZE];
+static int16_t g_buf_b[AUDIO_BUFFER_SIZE];
+static uint16_t g_dac[SETTLE + N_FFT];
+static double complex g_fft[N_FFT];
+
+typedef struct {
+    double thdn_db;
+    double inband_db;
+    double spur_db;
+} Quality_t;
+
+/* ============================================================================ */
+/* Signal Path */
+/* ============================================================================ */
+
+/**
+ * @brief Stream a sine through the channel, keep the fill buffer topped up
+ *        between render blocks (producer and consumer on one thread)
+ */
+static void render_sine(uint8_t mode, double amplitude)
+{
+    static AudioChannel_t ch;
+    static uint16_t wire[AUDIO_BLOCK_SIZE];
+    uint32_t produced = 0;
+    uint32_t total = SETTLE + N_FFT;
+
+    audio_channel_init(&ch, g_buf_a, g_buf_b);
+    audio_channel_set_fade_time(&ch, 0);
+    audio_channel_fade_in(&ch);
+    CHECK(audio_channel_set_dither(&ch, mode) == 0, "mode %u rejected", mode);
+
+    for (uint32_t pos = 0; pos < total; pos += AUDIO_BLOCK_SIZE)
+    {
+        // Producer: as much as fits
+        for (;;)
+        {
+            for (int i = 0; i < AUDIO_BLOCK_SIZE; i++)
+            {
+                double v = amplitude * 32767.0 *
+                           sin(2.0 * M_PI * CYCLES * (double)(produced + i) / N_FFT);
+                wire[i] = (uint16_t)((int16_t)lrint(v) ^ 0x8000);
+            }
+            if (audio_channel_fill(&ch, wire, AUDIO_BLOCK_SIZE) != AUDIO_BLOCK_SIZE)
+            {
+                break;
+            }
+            produced += AUDIO_BLOCK_SIZE;
+        }
+
+        audio_channel_render(&ch, &g_dac[pos], AUDIO_BLOCK_SIZE);
+    }
+
+    CHECK(ch.underrun_count == 0, "mode %u: %u underruns", mode, ch.underrun_count);
+}
+
+/* ============================================================================ */
+/* Analysis */
+/* ============================================================================ */
+
+static void fft(double complex *x, uint32_t n)
+{
+    for (uint32_t i = 1, j = 0; i < n; i++)
+    {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            double complex t = x[i];
+            x[i] = x[j];
+            x[j] = t;
+        }
+    }
+
+    for (uint32_t len = 2; len <= n; len <<= 1)
+    {
+        double complex w_len = cexp(-2.0 * I * M_PI / len);
+        for (uint32_t i = 0; i < n; i += len)
+        {
+            double complex w = 1.0;
+            for (uint32_t k = 0; k < len / 2; k++)
+            {
+                double complex u = x[i + k];
+                double complex v = x[i + k + len / 2] * w;
+                x[i + k] = u + v;
+                x[i + k + len / 2] = u - v;
+                w *= w_len;
+            }
+        }
+    }
+}
+
+static Quality_t analyse(void)
+{
+    double fund = 0.0;
+    double noise = 0.0;
+    double inband = 0.0;
+    double spur = 0.0;
+    uint32_t inband_max = (uint32_t)(INBAND_HZ * N_FFT / AUDIO_SAMPLE_RATE);
+    uint32_t inband_min = (uint32_t)(20.0 * N_FFT / AUDIO_SAMPLE_RATE) + 1;
+
+    // 12-bit codes -> LSB around mid-scale
+    for (uint32_t i = 0; i < N_FFT; i++)
+    {
+        g_fft[i] = (double)g_dac[SETTLE + i] - 2048.0;
+    }
+    fft(g_fft, N_FFT);
+
+    // One-sided power, DC excluded
+    for (uint32_t k = 1; k < N_FFT / 2; k++)
+    {
+        double p = 2.0 * creal(g_fft[k] * conj(g_fft[k]));
+
+        if (k == CYCLES)
+        {
+            fund = p;
+            continue;
+        }
+
+        noise += p;
+
+        if ((k % CYCLES) == 0 && k <= 9 * CYCLES && p > spur)
+        {
+            spur = p;
+        }
+        if (k >= inband_min && k <= inband_max)
+        {
+            inband += p;
+        }
+    }
+
+    Quality_t q = {
+        .thdn_db = 10.0 * log10(noise / fund),
+        .inband_db = 10.0 * log10(inband / fund),
+        .spur_db = 10.0 * log10(spur / fund),
+    };
+    return q;
+}
+
+/* ============================================================================ */
+/* Tests */
+/* ============================================================================ */
+
+static void test_noise_floor(double amplitude, Quality_t *q)
+{
+    static const char *names[] = { "truncate", "TPDF", "TPDF+NS1", "TPDF+NS2" };
+
+    printf("  sine 1 kHz %.0f dBFS      THD+N   in-band   spur (dB re fundamental)\n",
+           20.0 * log10(amplitude));
+    for (uint8_t mode = AUDIO_DITHER_OFF; mode <= AUDIO_DITHER_MAX; mode++)
+    {
+        render_sine(mode, amplitude);
+        q[mode] = analyse();
+        printf("    %-10s %13.1f %9.1f %6.1f\n", names[mode],
+               q[mode].thdn_db, q[mode].inband_db, q[mode].spur_db);
+    }
+}
+
+int main(void)
+{
+    Quality_t q[AUDIO_DITHER_MAX + 1];
+
+    // Quiet passage (-40 dBFS = 20 LSB of the 12-bit DAC): truncation
+    // distortion is at its worst here
+    test_noise_floor(0.01, q);
+
+    // Dither decorrelates the error: no harmonic spur above the noise
+    CHECK(q[AUDIO_DITHER_OFF].spur_db > q[AUDIO_DITHER_TPDF].spur_db + 10.0,
+          "TPDF spur %.1f dB, truncate %.1f dB", q[AUDIO_DITHER_TPDF].spur_db, q[AUDIO_DITHER_OFF].spur_db);
+    CHECK(q[AUDIO_DITHER_NS2].spur_db < q[AUDIO_DITHER_OFF].spur_db - 10.0,
+          "NS2 spur %.1f dB", q[AUDIO_DITHER_NS2].spur_db);
+
+    // Total noise: TPDF adds the dither, shaping adds more (pushed up)
+    CHECK(q[AUDIO_DITHER_TPDF].thdn_db > q[AUDIO_DITHER_OFF].thdn_db,
+          "TPDF THD+N %.1f <= truncate %.1f", q[AUDIO_DITHER_TPDF].thdn_db, q[AUDIO_DITHER_OFF].thdn_db);
+    CHECK(q[AUDIO_DITHER_NS1].thdn_db > q[AUDIO_DITHER_TPDF].thdn_db,
+          "NS1 THD+N %.1f <= TPDF %.1f", q[AUDIO_DITHER_NS1].thdn_db, q[AUDIO_DITHER_TPDF].thdn_db);
+    CHECK(q[AUDIO_DITHER_NS2].thdn_db > q[AUDIO_DITHER_NS1].thdn_db,
+          "NS2 THD+N %.1f <= NS1 %.1f", q[AUDIO_DITHER_NS2].thdn_db, q[AUDIO_DITHER_NS1].thdn_db);
+
+    // In-band noise floor: NS2 < NS1 < TPDF, and NS2 beats truncation
+    CHECK(q[AUDIO_DITHER_NS1].inband_db < q[AUDIO_DITHER_TPDF].inband_db - 3.0,
+          "NS1 in-band %.1f, TPDF %.1f", q[AUDIO_DITHER_NS1].inband_db, q[AUDIO_DITHER_TPDF].inband_db);
+    CHECK(q[AUDIO_DITHER_NS2].inband_db < q[AUDIO_DITHER_NS1].inband_db - 3.0,
+          "NS2 in-band %.1f, NS1 %.1f", q[AUDIO_DITHER_NS2].inband_db, q[AUDIO_DITHER_NS1].inband_db);
+    CHECK(q[AUDIO_DITHER_NS2].inband_db < q[AUDIO_DITHER_OFF].inband_db - 3.0,
+          "NS2 in-band %.1f, truncate %.1f", q[AUDIO_DITHER_NS2].inband_db, q[AUDIO_DITHER_OFF].inband_db);
+
+    // Loud passage (-6 dBFS): 12-bit limit is -68 dB THD+N re -6 dBFS
+    test_noise_floor(0.5, q);
+    for (uint8_t mode = AUDIO_DITHER_OFF; mode <= AUDIO_DITHER_MAX; mode++)
+    {
+        CHECK(q[mode].thdn_db < -50.0, "mode %u THD+N %.1f dB at -6 dBFS", mode, q[mode].thdn_db);
+    }
+
+    return TEST_RESULT("test_dither");
+}
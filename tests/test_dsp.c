@@ -0,0 +1,398 @@
+/**
+  ******************************************************************************
+  * @file           : test_dsp.c
+  * @brief          : Output DSP Chain Host Test (Core/Src/audio_dsp.c)
+  ******************************************************************************
+  * @attention
+  *
+  * Fixed-point stages against double-precision references, run in render
+  * blocks (AUDIO_BLOCK_SIZE) like the firmware:
+  * - 4-stage biquad EQ (RBJ low-pass / peaking / high-shelf / high-pass)
+  * - DC blocker (noise on a DC offset, residual offset after settling)
+  * - Limiter: same envelope definition in floating point, peak ceiling,
+  *   transparency below threshold, two peaks inside one lookahead window
+  *
+  ******************************************************************************
+  */
+
+#include "audio_dsp.h"
+#include "audio_channel.h"
+#include "test_common.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_SAMPLES   (AUDIO_BLOCK_SIZE * 512)
+#define FS          ((double)AUDIO_SAMPLE_RATE)
+
+static int32_t g_in[N_SAMPLES];
+static int32_t g_out[N_SAMPLES];
+static double g_ref[N_SAMPLES];
+
+/* ============================================================================ */
+/* Helpers */
+/* ============================================================================ */
+
+static void run_blocks(AudioDsp_t *dsp)
+{
+    memcpy(g_out, g_in, sizeof(g_out));
+    for (int blk = 0; blk < N_SAMPLES; blk += AUDIO_BLOCK_SIZE)
+    {
+        audio_dsp_process(dsp, &g_out[blk], AUDIO_BLOCK_SIZE);
+    }
+}
+
+static double rms_error(int skip)
+{
+    double sum = 0.0;
+
+    for (int i = skip; i < N_SAMPLES; i++)
+    {
+        double e = (double)g_out[i] - g_ref[i];
+        sum += e * e;
+    }
+    return sqrt(sum / (N_SAMPLES - skip));
+}
+
+static double max_error(int skip)
+{
+    double worst = 0.0;
+
+    for (int i = skip; i < N_SAMPLES; i++)
+    {
+        double e = fabs((double)g_out[i] - g_ref[i]);
+        if (e > worst)
+        {
+            worst = e;
+        }
+    }
+    return worst;
+}
+
+static void make_noise(int32_t amplitude)
+{
+    uint32_t x = 0x9E3779B9u;
+
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        g_in[i] = (int32_t)(x % (2U * (uint32_t)amplitude + 1U)) - amplitude;
+    }
+}
+
+/* ============================================================================ */
+/* Biquad EQ */
+/* ============================================================================ */
+
+typedef struct {
+    double b0, b1, b2, a1, a2;
+} RefBiquad_t;
+
+/**
+ * @brief RBJ cookbook designs (normalized to a0 = 1)
+ */
+static RefBiquad_t rbj(char type, double f0, double q, double gain_db)
+{
+    double w0 = 2.0 * M_PI * f0 / FS;
+    double cw = cos(w0);
+    double alpha = sin(w0) / (2.0 * q);
+    double a = pow(10.0, gain_db / 40.0);
+    double b0, b1, b2, a0, a1, a2;
+
+    switch (type)
+    {
+        case 'l':   // Low-pass
+            b0 = (1.0 - cw) / 2.0; b1 = 1.0 - cw; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        case 'h':   // High-pass
+            b0 = (1.0 + cw) / 2.0; b1 = -(1.0 + cw); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        case 'p':   // Peaking EQ
+            b0 = 1.0 + alpha * a; b1 = -2.0 * cw; b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a; a1 = -2.0 * cw; a2 = 1.0 - alpha / a;
+            break;
+        default:    // High shelf
+        {
+            double sa = 2.0 * sqrt(a) * alpha;
+            b0 = a * ((a + 1.0) + (a - 1.0) * cw + sa);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cw);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cw - sa);
+            a0 = (a + 1.0) - (a - 1.0) * cw + sa;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cw);
+            a2 = (a + 1.0) - (a - 1.0) * cw - sa;
+            break;
+        }
+    }
+
+    RefBiquad_t c = { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+    return c;
+}
+
+static AudioBiquad_t to_q30(const RefBiquad_t *c)
+{
+    AudioBiquad_t q = {
+        .b0 = (int32_t)lrint(c->b0 * AUDIO_DSP_Q30_ONE),
+        .b1 = (int32_t)lrint(c->b1 * AUDIO_DSP_Q30_ONE),
+        .b2 = (int32_t)lrint(c->b2 * AUDIO_DSP_Q30_ONE),
+        .a1 = (int32_t)lrint(c->a1 * AUDIO_DSP_Q30_ONE),
+        .a2 = (int32_t)lrint(c->a2 * AUDIO_DSP_Q30_ONE),
+    };
+    return q;
+}
+
+static void test_biquad(void)
+{
+    const RefBiquad_t stages[AUDIO_DSP_MAX_BIQUADS] = {
+        rbj('h', 40.0, 0.707, 0.0),
+        rbj('p', 1000.0, 1.0, 6.0),
+        rbj('s', 6000.0, 0.707, -4.0),
+        rbj('l', 12000.0, 0.707, 0.0),
+    };
+    AudioDsp_t dsp;
+
+    audio_dsp_init(&dsp);
+    for (uint8_t s = 0; s < AUDIO_DSP_MAX_BIQUADS; s++)
+    {
+        AudioBiquad_t q = to_q30(&stages[s]);
+        CHECK(audio_dsp_set_biquad(&dsp, s, &q) == 0, "stage %u", s);
+    }
+    CHECK(audio_dsp_set_biquad(&dsp, AUDIO_DSP_MAX_BIQUADS, &(AudioBiquad_t){ 0 }) == 1, "stage index not checked");
+    CHECK(audio_dsp_set_eq_stages(&dsp, AUDIO_DSP_MAX_BIQUADS + 1) == 1, "stage count not checked");
+    audio_dsp_set_eq_stages(&dsp, AUDIO_DSP_MAX_BIQUADS);
+    audio_dsp_set_enable(&dsp, AUDIO_DSP_EN_EQ);
+
+    make_noise(12000);
+    run_blocks(&dsp);
+
+    // Double-precision DF1 cascade with the same (unquantized) designs
+    double st[AUDIO_DSP_MAX_BIQUADS][4] = { { 0 } };
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        double x = g_in[i];
+        for (int s = 0; s < AUDIO_DSP_MAX_BIQUADS; s++)
+        {
+            const RefBiquad_t *c = &stages[s];
+            double *z = st[s];
+            double y = c->b0 * x + c->b1 * z[0] + c->b2 * z[1] - c->a1 * z[2] - c->a2 * z[3];
+            z[1] = z[0]; z[0] = x;
+            z[3] = z[2]; z[2] = y;
+            x = y;
+        }
+        g_ref[i] = x;
+    }
+
+    // Truncation per stage (>> 30, error feedback) plus Q30 coefficient rounding
+    double err = max_error(0);
+    double rms = rms_error(0);
+    printf("  EQ (4 stages) vs double: max error %.2f LSB, rms %.2f LSB\n", err, rms);
+    CHECK(err <= 8.0, "EQ max error %.2f LSB", err);
+    CHECK(rms <= 2.0, "EQ rms error %.2f LSB", rms);
+
+    // Flat EQ (init coefficients) is bit-transparent
+    audio_dsp_init(&dsp);
+    audio_dsp_set_eq_stages(&dsp, AUDIO_DSP_MAX_BIQUADS);
+    audio_dsp_set_enable(&dsp, AUDIO_DSP_EN_EQ);
+    run_blocks(&dsp);
+    CHECK(memcmp(g_out, g_in, sizeof(g_out)) == 0, "flat EQ changes the signal");
+}
+
+/* ============================================================================ */
+/* DC Blocker */
+/* ============================================================================ */
+
+static void test_dc_block(void)
+{
+    const double pole = 0.998;
+    AudioDsp_t dsp;
+
+    audio_dsp_init(&dsp);
+    audio_dsp_set_enable(&dsp, AUDIO_DSP_EN_DC);
+
+    // Noise on a DC offset
+    make_noise(8000);
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        g_in[i] += 6000;
+    }
+    run_blocks(&dsp);
+
+    double x1 = 0.0;
+    double y1 = 0.0;
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        double y = g_in[i] - x1 + pole * y1;
+        x1 = g_in[i];
+        y1 = y;
+        g_ref[i] = y;
+    }
+
+    double err = max_error(0);
+    printf("  DC blocker vs double: max error %.2f LSB\n", err);
+    CHECK(err <= 4.0, "DC blocker max error %.2f LSB", err);
+
+    // Offset removed after settling (~10 Hz corner, last 4096 samples)
+    double mean = 0.0;
+    for (int i = N_SAMPLES - 4096; i < N_SAMPLES; i++)
+    {
+        mean += g_out[i];
+    }
+    mean /= 4096.0;
+    CHECK(fabs(mean) < 100.0, "DC blocker residual offset %.1f", mean);
+}
+
+/* ============================================================================ */
+/* Limiter */
+/* ============================================================================ */
+
+/**
+ * @brief Floating-point limiter with the documented envelope:
+ *        window minimum of thr/|x| over the delay line, hold, linear release,
+ *        moving average over the lookahead applied to the delayed sample
+ */
+static void ref_limiter(double thr, double release, const int32_t *in, double *out, int n)
+{
+    const int L = AUDIO_DSP_LOOKAHEAD;
+    double req[AUDIO_DSP_LOOKAHEAD];
+    double hist[AUDIO_DSP_LOOKAHEAD];
+    double env = 1.0;
+    int hold = 0;
+
+    for (int k = 0; k < L; k++)
+    {
+        req[k] = 1.0;
+        hist[k] = 1.0;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        double ax = fabs((double)in[i]);
+        req[i % L] = (ax > thr) ? thr / ax : 1.0;
+
+        double min = 1.0;
+        for (int k = 0; k < L; k++)
+        {
+            min = fmin(min, req[k]);
+        }
+
+        if (min < env)
+        {
+            env = min;
+            hold = L;
+        }
+        else if (hold > 0)
+        {
+            hold--;
+        }
+        else if (env < min)
+        {
+            env = fmin(env + release, min);
+        }
+
+        double gain = 0.0;
+        for (int k = 0; k < L; k++)
+        {
+            gain += hist[k];
+        }
+        gain /= L;
+        hist[i % L] = env;
+
+        out[i] = (i >= L) ? in[i - L] * gain : 0.0;
+    }
+}
+
+static void setup_limiter(AudioDsp_t *dsp, uint16_t threshold)
+{
+    audio_dsp_init(dsp);
+    audio_dsp_set_limiter(dsp, threshold, AUDIO_DSP_RELEASE_DEFAULT);
+    audio_dsp_set_enable(dsp, AUDIO_DSP_EN_LIMIT);
+}
+
+static int32_t peak_abs(int skip)
+{
+    int32_t peak = 0;
+
+    for (int i = skip; i < N_SAMPLES; i++)
+    {
+        int32_t a = abs(g_out[i]);
+        if (a > peak)
+        {
+            peak = a;
+        }
+    }
+    return peak;
+}
+
+static void test_limiter(void)
+{
+    const uint16_t thr = 16000;
+    const double release = 1.0 / (AUDIO_DSP_RELEASE_DEFAULT * AUDIO_SAMPLE_RATE / 1000.0);
+    AudioDsp_t dsp;
+
+    // Below threshold: pure AUDIO_DSP_LOOKAHEAD delay, bit-exact
+    setup_limiter(&dsp, thr);
+    make_noise(thr);
+    run_blocks(&dsp);
+    int delayed_ok = 1;
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        int32_t expect = (i >= AUDIO_DSP_LOOKAHEAD) ? g_in[i - AUDIO_DSP_LOOKAHEAD] : 0;
+        if (g_out[i] != expect)
+        {
+            delayed_ok = 0;
+            break;
+        }
+    }
+    CHECK(delayed_ok, "limiter below threshold is not a plain delay");
+
+    // Loud noise with EQ-style overshoot: ceiling and float reference
+    setup_limiter(&dsp, thr);
+    make_noise(40000);
+    run_blocks(&dsp);
+    ref_limiter(thr, release, g_in, g_ref, N_SAMPLES);
+
+    int32_t peak = peak_abs(0);
+    double err = max_error(0);
+    printf("  limiter (noise +8 dB over threshold): peak %d (thr %u), vs double %.2f LSB\n",
+           peak, thr, err);
+    CHECK(peak <= thr + 1, "limiter peak %d above threshold %u", peak, thr);
+    // Required gain has 15-bit resolution (1.2 LSB at 40000)
+    CHECK(err <= 3.0, "limiter max error vs reference %.2f LSB", err);
+
+    // Two peaks inside one lookahead window: the later, larger one must not
+    // restart the attack and let the earlier one through
+    setup_limiter(&dsp, thr);
+    memset(g_in, 0, sizeof(g_in));
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        g_in[i] = (i & 1) ? 8000 : -8000;
+    }
+    g_in[1000] = 24000;                             // gain 0.667 needed
+    g_in[1000 + AUDIO_DSP_LOOKAHEAD / 2] = 32000;   // gain 0.5, 16 samples later
+    g_in[3000] = 30000;
+    g_in[3000 + AUDIO_DSP_LOOKAHEAD - 1] = -32767;  // last slot of the window
+    run_blocks(&dsp);
+
+    CHECK(abs(g_out[1000 + AUDIO_DSP_LOOKAHEAD]) <= thr + 1, "first peak %d", g_out[1000 + AUDIO_DSP_LOOKAHEAD]);
+    CHECK(abs(g_out[1000 + AUDIO_DSP_LOOKAHEAD * 3 / 2]) <= thr + 1, "second peak %d",
+          g_out[1000 + AUDIO_DSP_LOOKAHEAD * 3 / 2]);
+    CHECK(abs(g_out[3000 + AUDIO_DSP_LOOKAHEAD]) <= thr + 1, "third peak %d", g_out[3000 + AUDIO_DSP_LOOKAHEAD]);
+    CHECK(peak_abs(0) <= thr + 1, "peak %d above threshold", peak_abs(0));
+
+    // Released back to unity long after the peaks (release 50 ms + hold)
+    int32_t late = g_out[N_SAMPLES - 1];
+    int32_t src = g_in[N_SAMPLES - 1 - AUDIO_DSP_LOOKAHEAD];
+    CHECK(late == src, "not released: %d, input %d", late, src);
+}
+
+int main(void)
+{
+    test_biquad();
+    test_dc_block();
+    test_limiter();
+
+    return TEST_RESULT("test_dsp");
+}
@@ -0,0 +1,208 @@
+/**
+  ******************************************************************************
+  * @file           : test_spi_timing.c
+  * @brief          : SPI Transaction Timing Host Test (spi_timing.c)
+  ******************************************************************************
+  * @attention
+  *
+  * CS edges are replayed with DWT CYCCNT and the HAL tick under test
+  * control (250 MHz core clock) and the windows are checked field by
+  * field: duration / gap / rate / duty histograms, min / max, the CYCCNT
+  * wrap, the 10 s gap limit, a rising edge without falling, and the
+  * window roll (completed window returned, next one empty).
+  *
+  ******************************************************************************
+  */
+
+#include "spi_timing.h"
+#include "test_common.h"
+#include <string.h>
+
+#define CORE_HZ     250000000U
+#define CYC_PER_US  (CORE_HZ / 1000000U)
+
+DWT_Type test_dwt;
+DCB_Type test_dcb;
+uint32_t SystemCoreClock = CORE_HZ;
+
+static uint32_t g_tick;
+
+uint32_t HAL_GetTick(void)
+{
+    return g_tick;
+}
+
+/* ============================================================================ */
+/* Helpers */
+/* ============================================================================ */
+
+/**
+ * @brief One CS frame: falling at CYCCNT t, rising dur_us later
+ */
+static void frame(uint32_t t, uint32_t dur_us, uint32_t bytes)
+{
+    test_dwt.CYCCNT = t;
+    spi_timing_stamp();
+    spi_timing_cs_falling();
+
+    test_dwt.CYCCNT = t + dur_us * CYC_PER_US;
+    spi_timing_stamp();
+    spi_timing_cs_rising(bytes);
+}
+
+static uint32_t hist_sum(const uint32_t *hist, uint32_t bins)
+{
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < bins; i++)
+    {
+        sum += hist[i];
+    }
+    return sum;
+}
+
+/* ============================================================================ */
+/* Tests */
+/* ============================================================================ */
+
+static void test_init(void)
+{
+    SpiTimingWindow_t win;
+
+    g_tick = 100;
+    spi_timing_init();
+
+    CHECK(test_dcb.DEMCR & DCB_DEMCR_TRCENA_Msk, "trace not enabled");
+    CHECK(test_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk, "CYCCNT not started");
+
+    g_tick = 600;
+    spi_timing_roll(&win);
+    CHECK(win.packets == 0 && win.bytes == 0, "fresh window not empty");
+    CHECK(win.start_ms == 100 && win.length_ms == 500, "window %lu + %lu ms",
+          (unsigned long)win.start_ms, (unsigned long)win.length_ms);
+    CHECK(win.dur_min == UINT32_MAX && win.gap_min == UINT32_MAX, "min not reset");
+}
+
+static void test_frames(void)
+{
+    SpiTimingWindow_t win;
+
+    g_tick = 0;
+    spi_timing_init();
+
+    // 100 us, 64 bytes, no previous frame: no gap, no duty
+    frame(1000, 100, 64);
+    // 300 us gap, 100 us, 64 bytes: duty 25 %
+    frame(1000 + 400 * CYC_PER_US, 100, 64);
+    // 20 ms packet (saturates the last bin), 1 ms gap
+    frame(1000 + 1500 * CYC_PER_US, 20000, 2048);
+
+    g_tick = 1000;
+    spi_timing_roll(&win);
+
+    CHECK(win.packets == 3, "%lu packets", (unsigned long)win.packets);
+    CHECK(win.bytes == 64 + 64 + 2048, "%lu bytes", (unsigned long)win.bytes);
+    CHECK(win.busy_cycles == (uint64_t)(100 + 100 + 20000) * CYC_PER_US, "busy %llu",
+          (unsigned long long)win.busy_cycles);
+    CHECK(win.dur_min == 100 && win.dur_max == 20000, "dur %lu..%lu",
+          (unsigned long)win.dur_min, (unsigned long)win.dur_max);
+    CHECK(win.gap_min == 300 && win.gap_max == 1000, "gap %lu..%lu",
+          (unsigned long)win.gap_min, (unsigned long)win.gap_max);
+
+    // 100 us -> bin 7 (64..127), 20000 us -> last bin
+    CHECK(win.dur_hist[7] == 2, "dur bin 7 = %lu", (unsigned long)win.dur_hist[7]);
+    CHECK(win.dur_hist[SPI_TIMING_BINS - 1] == 1, "dur last bin = %lu",
+          (unsigned long)win.dur_hist[SPI_TIMING_BINS - 1]);
+
+    // 300 us -> bin 9 (256..511), 1000 us -> bin 10 (512..1023)
+    CHECK(win.gap_hist[9] == 1 && win.gap_hist[10] == 1, "gap bins %lu %lu",
+          (unsigned long)win.gap_hist[9], (unsigned long)win.gap_hist[10]);
+    CHECK(hist_sum(win.gap_hist, SPI_TIMING_BINS) == 2, "gap count");
+
+    // 64 B / 100 us = 640 kB/s -> bin 10, 2048 B / 20 ms = 102 kB/s -> bin 7
+    CHECK(win.rate_hist[10] == 2 && win.rate_hist[7] == 1, "rate bins %lu %lu",
+          (unsigned long)win.rate_hist[10], (unsigned long)win.rate_hist[7]);
+
+    // Duty 100 / 400 = 25 % -> bin 2, 20000 / 21000 = 95 % -> bin 9
+    CHECK(win.duty_hist[2] == 1 && win.duty_hist[9] == 1, "duty bins %lu %lu",
+          (unsigned long)win.duty_hist[2], (unsigned long)win.duty_hist[9]);
+    CHECK(hist_sum(win.duty_hist, SPI_TIMING_DUTY_BINS) == 2, "duty count");
+
+    spi_timing_report(&win);
+}
+
+static void test_wrap_and_idle(void)
+{
+    SpiTimingWindow_t win;
+
+    g_tick = 0;
+    spi_timing_init();
+
+    // Packet across the CYCCNT wrap
+    frame(0xFFFFFFFFu - 50 * CYC_PER_US, 200, 32);
+
+    // Next frame after 10 s idle: CYCCNT may have wrapped, no gap
+    g_tick = 10000;
+    frame(1234, 200, 32);
+
+    // Rising without falling: no packet, but it ends the previous frame
+    test_dwt.CYCCNT = 5000000;
+    spi_timing_stamp();
+    spi_timing_cs_rising(99);
+
+    frame(5000000 + 50 * CYC_PER_US, 10, 1);
+
+    g_tick = 12000;
+    spi_timing_roll(&win);
+
+    CHECK(win.packets == 3, "%lu packets", (unsigned long)win.packets);
+    CHECK(win.bytes == 32 + 32 + 1, "%lu bytes (stray rising counted?)", (unsigned long)win.bytes);
+    CHECK(win.dur_max == 200, "wrapped packet %lu us", (unsigned long)win.dur_max);
+    CHECK(hist_sum(win.gap_hist, SPI_TIMING_BINS) == 1, "%lu gaps (10 s idle counted?)",
+          (unsigned long)hist_sum(win.gap_hist, SPI_TIMING_BINS));
+    CHECK(win.gap_min == 50 && win.gap_max == 50, "gap %lu..%lu",
+          (unsigned long)win.gap_min, (unsigned long)win.gap_max);
+}
+
+static void test_roll(void)
+{
+    SpiTimingWindow_t win;
+
+    g_tick = 0;
+    spi_timing_init();
+
+    frame(0, 100, 10);
+    g_tick = 1000;
+    spi_timing_roll(&win);
+    CHECK(win.packets == 1 && win.bytes == 10, "window 1: %lu packets",
+          (unsigned long)win.packets);
+
+    // Gap across the roll lands in the new window
+    frame(1000 * 1000 * CYC_PER_US, 100, 20);
+    frame(1000 * 1000 * CYC_PER_US + 200 * CYC_PER_US, 100, 30);
+    g_tick = 2500;
+    spi_timing_roll(&win);
+    CHECK(win.packets == 2 && win.bytes == 50, "window 2: %lu packets, %lu bytes",
+          (unsigned long)win.packets, (unsigned long)win.bytes);
+    CHECK(win.start_ms == 1000 && win.length_ms == 1500, "window 2: %lu + %lu ms",
+          (unsigned long)win.start_ms, (unsigned long)win.length_ms);
+    CHECK(hist_sum(win.gap_hist, SPI_TIMING_BINS) == 2, "window 2: %lu gaps",
+          (unsigned long)hist_sum(win.gap_hist, SPI_TIMING_BINS));
+
+    // Nothing since: empty, and the first window's data is gone
+    g_tick = 3000;
+    spi_timing_roll(&win);
+    CHECK(win.packets == 0 && hist_sum(win.dur_hist, SPI_TIMING_BINS) == 0,
+          "window 3 not empty");
+    spi_timing_report(&win);
+}
+
+int main(void)
+{
+    test_init();
+    test_frames();
+    test_wrap_and_idle();
+    test_roll();
+
+    return TEST_RESULT("test_spi_timing");
+}
@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""
+Telemetry decoder / plotter for the STM32H523 audio slave (UART3 console).
+
+Frames (Core/Inc/telemetry.h, Core/Inc/cobs.h):
+    0x00 | COBS( TelemetryFrame_t | CRC16-CCITT-FALSE LE ) | 0x00
+
+Console text between frames is passed through to stdout, so the script can
+stay attached while the slave prints normally. Enable frames with the
+console command 'telem <hz>' in slave mode (0 / 1 / 10 / 100 Hz).
+
+Usage:
+    python3 tools/telemetry.py /dev/ttyUSB0                 # one line per second
+    python3 tools/telemetry.py /dev/ttyUSB0 --csv log.csv   # every frame to CSV
+    python3 tools/telemetry.py /dev/ttyUSB0 --plot          # live plot (matplotlib)
+
+Requires pyserial (pip install pyserial), matplotlib for --plot.
+"""
+
+import argparse
+import collections
+import struct
+import sys
+import time
+
+TELEMETRY_VERSION = 1
+
+# TelemetryFrame_t (packed, little-endian)
+HEADER = struct.Struct("<BBI")
+CHANNEL = struct.Struct("<BHIIIIH")
+SPI = struct.Struct("<IIIII8H")
+FRAME_SIZE = HEADER.size + 2 * CHANNEL.size + SPI.size   # 84
+
+CH_FIELDS = ("state", "depth", "samples", "swaps", "underruns",
+             "underrun_samples", "underrun_max")
+SPI_FIELDS = ("cs_falling", "cs_rising", "cmd_packets", "data_packets", "spi_errors",
+              "adpcm_packets", "param_packets", "clip_packets", "invalid_headers",
+              "overflows", "dma_start_fails", "schedule_misses", "last_rx_bytes")
+
+# 16-bit counters in the frame (wrap, unwrapped below)
+SPI_WRAP16 = ("adpcm_packets", "param_packets", "clip_packets", "invalid_headers",
+              "overflows", "dma_start_fails", "schedule_misses")
+
+SAMPLE_RATE = 32000
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def is_text(data):
+    return all(32 <= b < 127 or b in (9, 10, 13, 27) for b in data)
+
+
+def open_frame(body):
+    """Payload of one frame body (between delimiters), None if invalid."""
+    raw = cobs_decode(body)
+    if raw is None or len(raw) < 3:
+        return None
+    payload, crc = raw[:-2], raw[-2] | (raw[-1] << 8)
+    if crc16_ccitt(payload) != crc:
+        return None
+    return payload
+
+
+def parse_frame(payload):
+    if len(payload) != FRAME_SIZE or payload[0] != TELEMETRY_VERSION:
+        return None
+    version, seq, tick = HEADER.unpack_from(payload, 0)
+    off = HEADER.size
+    channels = []
+    for _ in range(2):
+        channels.append(dict(zip(CH_FIELDS, CHANNEL.unpack_from(payload, off))))
+        off += CHANNEL.size
+    spi = dict(zip(SPI_FIELDS, SPI.unpack_from(payload, off)))
+    return {"seq": seq, "tick": tick, "ch": channels, "spi": spi}
+
+
+class Unwrapper:
+    """Extend 16-bit wrapping counters to monotonic values."""
+
+    def __init__(self):
+        self.last = {}
+        self.total = {}
+
+    def __call__(self, key, value):
+        if key in self.last:
+            self.total[key] += (value - self.last[key]) & 0xFFFF
+        else:
+            self.total[key] = value
+        self.last[key] = value
+        return self.total[key]
+
+
+class Stream:
+    """Split the serial byte stream into frames and console text."""
+
+    def __init__(self, on_frame, on_text):
+        self.buf = bytearray()
+        self.on_frame = on_frame
+        self.on_text = on_text
+        self.bad = 0
+        self.last_frame = 0.0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            end = self.buf.find(b"\x00")
+            if end < 0:
+                # Plain console output (no frames for a while) - pass it through
+                idle = time.monotonic() - self.last_frame > 1.0
+                if self.buf and ((idle and is_text(self.buf)) or len(self.buf) > 4096):
+                    self.on_text(bytes(self.buf))
+                    self.buf.clear()
+                return
+            body = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if not body:
+                continue
+            payload = open_frame(body)
+            frame = parse_frame(payload) if payload is not None else None
+            if frame is not None:
+                self.last_frame = time.monotonic()
+                self.on_frame(frame)
+            elif is_text(body):
+                self.on_text(body)
+            else:
+                self.bad += 1
+
+
+class Monitor:
+    """Unwrap counters, count lost frames, derive per-second rates."""
+
+    def __init__(self, csv_file=None):
+        self.unwrap = Unwrapper()
+        self.prev_seq = None
+        self.lost = 0
+        self.frames = 0
+        self.history = collections.deque(maxlen=2000)
+        self.csv = csv_file
+        self.last_print = None
+        if self.csv:
+            cols = ["tick", "seq"]
+            cols += ["dac%d_%s" % (i + 1, f) for i in range(2) for f in CH_FIELDS]
+            cols += ["spi_" + f for f in SPI_FIELDS]
+            self.csv.write(",".join(cols) + "\n")
+
+    def on_frame(self, f):
+        if self.prev_seq is not None:
+            self.lost += (f["seq"] - self.prev_seq - 1) & 0xFF
+        self.prev_seq = f["seq"]
+        self.frames += 1
+
+        for key in SPI_WRAP16:
+            f["spi"][key] = self.unwrap(key, f["spi"][key])
+
+        if self.csv:
+            row = [f["tick"], f["seq"]]
+            row += [ch[k] for ch in f["ch"] for k in CH_FIELDS]
+            row += [f["spi"][k] for k in SPI_FIELDS]
+            self.csv.write(",".join(str(v) for v in row) + "\n")
+
+        self.history.append(f)
+        if self.last_print is None or f["tick"] - self.last_print["tick"] >= 1000:
+            if self.last_print is not None:
+                self.print_rates(self.last_print, f)
+            self.last_print = f
+
+    @staticmethod
+    def rate(a, b, get):
+        dt = (b["tick"] - a["tick"]) & 0xFFFFFFFF
+        return (get(b) - get(a)) * 1000.0 / dt if dt else 0.0
+
+    def print_rates(self, a, b):
+        parts = ["t=%8.1fs" % (b["tick"] / 1000.0)]
+        for i in range(2):
+            ch = b["ch"][i]
+            sps = self.rate(a, b, lambda f: f["ch"][i]["samples"])
+            und = b["ch"][i]["underruns"] - a["ch"][i]["underruns"]
+            parts.append("DAC%d %s %5.0f S/s depth %4.1fms und +%d" % (
+                i + 1, "PLAY" if ch["state"] & 1 else "stop", sps,
+                ch["depth"] * 1000.0 / SAMPLE_RATE, und))
+        pps = self.rate(a, b, lambda f: f["spi"]["cs_rising"])
+        dps = self.rate(a, b, lambda f: f["spi"]["data_packets"])
+        parts.append("SPI %5.0f pkt/s (data %5.0f) err %d" % (
+            pps, dps, b["spi"]["spi_errors"]))
+        parts.append("lost %d" % self.lost)
+        print(" | ".join(parts), flush=True)
+
+
+def plot_loop(port, stream, monitor):
+    import matplotlib.pyplot as plt
+
+    fig, (ax_depth, ax_rate) = plt.subplots(2, 1, sharex=True)
+    plt.ion()
+    plt.show()
+
+    while plt.fignum_exists(fig.number):
+        stream.feed(port.read(port.in_waiting or 1))
+        if len(monitor.history) < 2:
+            continue
+        h = list(monitor.history)
+        t = [f["tick"] / 1000.0 for f in h]
+
+        ax_depth.cla()
+        for i in range(2):
+            ax_depth.plot(t, [f["ch"][i]["depth"] * 1000.0 / SAMPLE_RATE for f in h],
+                          label="DAC%d" % (i + 1))
+        ax_depth.set_ylabel("queued (ms)")
+        ax_depth.legend(loc="upper left")
+
+        ax_rate.cla()
+        for i in range(2):
+            r = [Monitor.rate(a, b, lambda f: f["ch"][i]["samples"]) for a, b in zip(h, h[1:])]
+            ax_rate.plot(t[1:], r, label="DAC%d S/s" % (i + 1))
+        ax_rate.set_ylabel("samples / s")
+        ax_rate.set_xlabel("slave time (s)")
+        ax_rate.legend(loc="upper left")
+
+        plt.pause(0.05)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Audio slave telemetry decoder")
+    ap.add_argument("port", help="serial port (UART3 console)")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--csv", help="write every frame to a CSV file")
+    ap.add_argument("--plot", action="store_true", help="live plot (matplotlib)")
+    ap.add_argument("--quiet", action="store_true", help="hide console text")
+    args = ap.parse_args()
+
+    import serial
+
+    csv_file = open(args.csv, "w") if args.csv else None
+    monitor = Monitor(csv_file)
+
+    def on_text(text):
+        if not args.quiet:
+            sys.stdout.write(text.decode("ascii", "replace"))
+            sys.stdout.flush()
+
+    stream = Stream(monitor.on_frame, on_text)
+
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        try:
+            if args.plot:
+                plot_loop(port, stream, monitor)
+            else:
+                while True:
+                    stream.feed(port.read(port.in_waiting or 1))
+        except KeyboardInterrupt:
+            pass
+
+    print("\nframes %d | lost %d | bad %d" % (monitor.frames, monitor.lost, stream.bad))
+    if csv_file:
+        csv_file.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+"""
+Bench streamer for the STM32H523 audio slave over the UART1 packet link.
+
+Sends the SPI packet set (Core/Inc/spi_protocol.h) over UART1, one packet
+per frame (Core/Inc/uart_link.h, Core/Inc/cobs.h):
+    0x00 | COBS( packet | CRC16-CCITT-FALSE LE ) | 0x00
+
+The slave applies the packets like SPI packets (same buffers, same
+counters), so this replaces the Master for soak tests from a PC.
+
+UART1 is single-wire (PB14) and only receives, there is no RDY. Packets
+are paced on the PC clock at the sample rate; with --telemetry the
+slave's telemetry frames (UART3, tools/telemetry.py, enable 10 Hz with
+'telem 10' in slave mode) trim the pace to hold the queued depth at the target
+and give the rate the DACs actually played.
+
+Usage:
+    python3 tools/uart_stream.py /dev/ttyUSB1                          # 1 kHz tone, both DACs
+    python3 tools/uart_stream.py /dev/ttyUSB1 --wav music_32k.wav --format 12
+    python3 tools/uart_stream.py /dev/ttyUSB1 --telemetry /dev/ttyUSB0 --seconds 600
+
+Requires pyserial (pip install pyserial).
+"""
+
+import argparse
+import array
+import binascii
+import math
+import os
+import sys
+import threading
+import time
+import wave
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import telemetry  # noqa: E402  (frame decoder, same directory)
+
+SAMPLE_RATE = 32000
+AUDIO_BUFFER_SIZE = 2048            # Samples per A/B buffer (spi_protocol.h)
+
+HEADER_CMD = 0xC0
+HEADER_DATA = 0xDA
+CMD_PLAY = 0x01
+CMD_STOP = 0x02
+CMD_STEREO = 0x06
+
+FORMATS = {16: 0, 12: 1, 8: 2}      # bits -> SAMPLE_FORMAT_xxx
+
+
+# ---------------------------------------------------------------------------
+# Framing
+# ---------------------------------------------------------------------------
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) - same as cobs.c."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def cobs_encode(data):
+    out = bytearray()
+    for part in bytes(data).split(b"\x00"):
+        while len(part) >= 254:
+            out.append(0xFF)
+            out += part[:254]
+            part = part[254:]
+        out.append(len(part) + 1)
+        out += part
+    return bytes(out)
+
+
+def frame(packet):
+    crc = crc16_ccitt(packet)
+    return b"\x00" + cobs_encode(packet + bytes((crc & 0xFF, crc >> 8))) + b"\x00"
+
+
+# ---------------------------------------------------------------------------
+# Packets
+# ---------------------------------------------------------------------------
+
+def command(channel, cmd, param=0):
+    return bytes((HEADER_CMD, channel, cmd, (param >> 8) & 0xFF, param & 0xFF))
+
+
+def pack_samples(samples, bits):
+    """Signed 16-bit samples -> unsigned payload of the sample format."""
+    u = [(s + 32768) & 0xFFFF for s in samples]
+    if bits == 16:
+        a = array.array("H", u)
+        if sys.byteorder == "big":
+            a.byteswap()
+        return a.tobytes()
+    if bits == 8:
+        return bytes(v >> 8 for v in u)
+
+    # 12-bit: 2 samples in 3 bytes, odd count ends with 2 bytes
+    v = [x >> 4 for x in u]
+    out = bytearray()
+    for i in range(0, len(v) - 1, 2):
+        s0, s1 = v[i], v[i + 1]
+        out += bytes((s0 & 0xFF, (s0 >> 8) | ((s1 & 0x0F) << 4), s1 >> 4))
+    if len(v) & 1:
+        out += bytes((v[-1] & 0xFF, v[-1] >> 8))
+    return bytes(out)
+
+
+def data_packet(channel, samples, bits):
+    n = len(samples)
+    head = bytes((HEADER_DATA, (FORMATS[bits] << 4) | channel, n >> 8, n & 0xFF))
+    return head + pack_samples(samples, bits)
+
+
+# ---------------------------------------------------------------------------
+# Sources (blocks of signed 16-bit samples per DAC)
+# ---------------------------------------------------------------------------
+
+class ToneSource:
+    def __init__(self, freq, level):
+        self.step = 2.0 * math.pi * freq / SAMPLE_RATE
+        self.amp = 32767.0 * level
+        self.phase = 0.0
+
+    def read(self, n):
+        block = [int(self.amp * math.sin(self.phase + i * self.step)) for i in range(n)]
+        self.phase = (self.phase + n * self.step) % (2.0 * math.pi)
+        return block, block
+
+
+class WavSource:
+    def __init__(self, path, loop):
+        self.wav = wave.open(path, "rb")
+        self.loop = loop
+        if self.wav.getsampwidth() != 2:
+            raise SystemExit("%s: 16-bit PCM WAV required" % path)
+        if self.wav.getframerate() != SAMPLE_RATE:
+            raise SystemExit("%s: %d Hz - resample to %d Hz first (sox in.wav -r %d out.wav)"
+                             % (path, self.wav.getframerate(), SAMPLE_RATE, SAMPLE_RATE))
+        self.channels = self.wav.getnchannels()
+
+    def read(self, n):
+        raw = self.wav.readframes(n)
+        if len(raw) < n * 2 * self.channels and self.loop:
+            self.wav.rewind()
+            raw += self.wav.readframes(n - len(raw) // (2 * self.channels))
+        if not raw:
+            return None, None
+        a = array.array("h", raw)
+        if sys.byteorder == "big":
+            a.byteswap()
+        left = list(a[0::self.channels])
+        right = list(a[1::self.channels]) if self.channels > 1 else left
+        return left, right
+
+
+# ---------------------------------------------------------------------------
+# Slave telemetry (UART3) - played rate and depth feedback
+# ---------------------------------------------------------------------------
+
+class TelemetryReader(threading.Thread):
+    def __init__(self, port, show_console):
+        super().__init__(daemon=True)
+        self.port = port
+        self.show_console = show_console
+        self.lock = threading.Lock()
+        self.first = None
+        self.last = None
+        self.stream = telemetry.Stream(self.on_frame, self.on_text)
+
+    def on_frame(self, f):
+        with self.lock:
+            if self.first is None:
+                self.first = f
+            self.last = f
+
+    def on_text(self, text):
+        if self.show_console:
+            sys.stdout.write(text.decode("ascii", "replace"))
+            sys.stdout.flush()
+
+    def latest(self):
+        with self.lock:
+            return self.first, self.last
+
+    def run(self):
+        while True:
+            self.stream.feed(self.port.read(self.port.in_waiting or 1))
+
+
+# ---------------------------------------------------------------------------
+# Streaming
+# ---------------------------------------------------------------------------
+
+def main():
+    ap = argparse.ArgumentParser(description="Stream audio to the slave over UART1")
+    ap.add_argument("port", help="serial port wired to UART1 (PB14)")
+    ap.add_argument("--baud", type=int, default=3000000, help="UART_LINK_BAUD (default 3000000)")
+    src = ap.add_mutually_exclusive_group()
+    src.add_argument("--tone", type=float, default=1000.0, help="sine frequency in Hz (default)")
+    src.add_argument("--wav", help="16-bit WAV at 32 kHz (mono or stereo)")
+    ap.add_argument("--level", type=float, default=0.5, help="tone level 0..1")
+    ap.add_argument("--loop", action="store_true", help="repeat the WAV file")
+    ap.add_argument("--channel", choices=("1", "2", "both"), default="both")
+    ap.add_argument("--format", type=int, choices=sorted(FORMATS), default=16,
+                    help="sample format in bits")
+    ap.add_argument("--samples", type=int, default=512, help="samples per data packet")
+    ap.add_argument("--prebuffer", type=int, default=AUDIO_BUFFER_SIZE,
+                    help="samples queued before PLAY (default one buffer)")
+    ap.add_argument("--seconds", type=float, default=0, help="stop after N seconds (0 = run)")
+    ap.add_argument("--telemetry", help="UART3 console port (telemetry frames)")
+    ap.add_argument("--telemetry-baud", type=int, default=115200)
+    ap.add_argument("--console", action="store_true", help="show UART3 console text")
+    args = ap.parse_args()
+
+    if not 0 < args.samples <= AUDIO_BUFFER_SIZE:
+        ap.error("--samples must be 1..%d" % AUDIO_BUFFER_SIZE)
+
+    import serial
+
+    channels = {"1": [0], "2": [1], "both": [0, 1]}[args.channel]
+    source = WavSource(args.wav, args.loop) if args.wav else ToneSource(args.tone, args.level)
+
+    link = serial.Serial(args.port, args.baud, timeout=0.1, write_timeout=2)
+    reader = None
+    if args.telemetry:
+        reader = TelemetryReader(serial.Serial(args.telemetry, args.telemetry_baud, timeout=0.1),
+                                 args.console)
+        reader.start()
+
+    sent = 0                    # Samples per channel
+    wire = 0                    # Bytes on the line
+    link_bytes_per_s = args.baud / 10.0
+
+    def send_block(n):
+        nonlocal sent, wire
+        left, right = source.read(n)
+        if left is None:
+            return False
+        out = bytearray()
+        for ch in channels:
+            out += frame(data_packet(ch, left if ch == 0 else right, args.format))
+        link.write(out)
+        sent += len(left)
+        wire += len(out)
+        return True
+
+    def send_cmd(ch, cmd, param=0):
+        nonlocal wire
+        out = frame(command(ch, cmd, param))
+        link.write(out)
+        wire += len(out)
+
+    # Both DACs on one trigger, PLAY on DAC1 starts both
+    send_cmd(0, CMD_STEREO, 1 if len(channels) == 2 else 0)
+
+    while sent < args.prebuffer:
+        if not send_block(min(args.samples, args.prebuffer - sent)):
+            break
+    link.flush()
+    send_cmd(channels[0], CMD_PLAY)
+
+    start = time.monotonic()
+    sent_at_play = sent
+    credit = 0.0                # Samples due but not sent
+    trim = 0.0                  # Pace correction (fraction of the rate)
+    last_t = start
+    last_report = (start, sent, wire)
+    tel_report = None
+    ended = False
+
+    print("Streaming %s to DAC%s, %d-bit, %d samples/packet, %d baud" % (
+        "WAV" if args.wav else "%.0f Hz tone" % args.tone,
+        "1+2" if len(channels) == 2 else str(channels[0] + 1),
+        args.format, args.samples, args.baud), flush=True)
+
+    try:
+        while not ended:
+            now = time.monotonic()
+            if args.seconds and now - start >= args.seconds:
+                break
+
+            credit += (now - last_t) * SAMPLE_RATE * (1.0 + trim)
+            last_t = now
+            while credit >= args.samples:
+                if not send_block(args.samples):
+                    ended = True
+                    break
+                credit -= args.samples
+
+            # Hold the slave's queue at the prebuffer depth
+            if reader is not None:
+                first, last = reader.latest()
+                if last is not None:
+                    depth = max(last["ch"][ch]["depth"] for ch in channels)
+                    trim = max(-0.01, min(0.01, (args.prebuffer - depth) / (2.0 * SAMPLE_RATE)))
+
+            if now - last_report[0] >= 1.0:
+                t0, s0, w0 = last_report
+                dt = now - t0
+                parts = ["t=%7.1fs" % (now - start),
+                         "sent %6.0f S/s/ch" % ((sent - s0) / dt),
+                         "%6.1f KB/s (%3.0f%% link)" % ((wire - w0) / dt / 1024.0,
+                                                        100.0 * (wire - w0) / dt / link_bytes_per_s)]
+                if reader is not None:
+                    first, last = reader.latest()
+                    if tel_report is not None and last is not tel_report:
+                        for ch in channels:
+                            sps = telemetry.Monitor.rate(tel_report, last,
+                                                         lambda f, c=ch: f["ch"][c]["samples"])
+                            und = last["ch"][ch]["underruns"] - tel_report["ch"][ch]["underruns"]
+                            parts.append("DAC%d %6.0f S/s depth %5.1fms und +%d" % (
+                                ch + 1, sps, last["ch"][ch]["depth"] * 1000.0 / SAMPLE_RATE, und))
+                        parts.append("trim %+5.0f ppm" % (trim * 1e6))
+                    tel_report = last
+                print(" | ".join(parts), flush=True)
+                last_report = (now, sent, wire)
+
+            time.sleep(0.001)
+    except KeyboardInterrupt:
+        pass
+
+    elapsed = time.monotonic() - start
+    send_cmd(channels[0], CMD_STOP)
+    link.flush()
+
+    print("\nsent %d samples/ch in %.1f s: %.1f S/s (%.3f%% of %d), %.1f KB/s on the line" % (
+        sent - sent_at_play, elapsed, (sent - sent_at_play) / elapsed,
+        100.0 * (sent - sent_at_play) / elapsed / SAMPLE_RATE, SAMPLE_RATE,
+        wire / elapsed / 1024.0))
+
+    if reader is not None:
+        first, last = reader.latest()
+        if first is not None and last is not first:
+            for ch in channels:
+                sps = telemetry.Monitor.rate(first, last, lambda f, c=ch: f["ch"][c]["samples"])
+                und = last["ch"][ch]["underruns"] - first["ch"][ch]["underruns"]
+                print("DAC%d played %.1f S/s, underruns %d" % (ch + 1, sps, und))
+        else:
+            print("no telemetry frames - enable them with 'telem 10' in slave mode")
+
+
+if __name__ == "__main__":
+    main()